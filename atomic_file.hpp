@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Whole-file replacement that readers and crashes never see half done: the
+// new contents go to `path`.tmp, which is fsynced and renamed over `path`,
+// then the directory is fsynced so the rename itself is durable. rename()
+// replaces an existing file atomically on POSIX; Windows refuses to rename
+// over one, so there the old file is removed first, leaving a short window
+// with neither.
+namespace AtomicFile {
+
+    // Flushes a file's or directory's data to disk by path; best-effort on Windows
+    inline bool syncPath(const std::string& path) {
+#ifdef _WIN32
+        (void)path;
+        return true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+#endif
+    }
+
+    inline std::string parentDir(const std::string& path) {
+        auto slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? "." : path.substr(0, slash);
+    }
+
+    // Replaces `path` with what `fill` writes; `fill` returns false on failure
+    inline bool write(const std::string& path, const std::function<bool(std::FILE*)>& fill, std::string& error) {
+        const std::string tmp = path + ".tmp";
+        std::FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) {
+            error = "could not create " + tmp;
+            return false;
+        }
+        bool ok = fill(f) && std::fflush(f) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(f)) == 0;
+#else
+        ok = ok && ::fsync(fileno(f)) == 0;
+#endif
+        ok = std::fclose(f) == 0 && ok;
+        if (!ok) {
+            std::remove(tmp.c_str());
+            error = "could not write " + tmp;
+            return false;
+        }
+#ifdef _WIN32
+        std::remove(path.c_str());
+#endif
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            error = "could not rename " + tmp + " to " + path;
+            return false;
+        }
+        syncPath(parentDir(path));
+        return true;
+    }
+
+    inline bool write(const std::string& path, const std::string& data, std::string& error) {
+        return write(path, [&](std::FILE* f) { return std::fwrite(data.data(), 1, data.size(), f) == data.size(); }, error);
+    }
+
+} // namespace AtomicFile
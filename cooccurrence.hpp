@@ -0,0 +1,444 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "atomic_file.hpp"
+#include "env.hpp"
+#include "seed_permutation.hpp"
+#include "seed_util.hpp"
+#include "tools/feature_columns.hpp"
+
+// Co-occurrence counts over ante-1 outputs, used by tools/cooccurrence.cpp.
+// Each seed is generated once into a feature row (tools/feature_columns.hpp).
+// Every axis (e.g. the jokers in the first N shop slots, or the two blind
+// tags) then becomes a set of distinct item ids, and each requested pair of
+// axes adds 1 to counts[a][b] for every a in one set and b in the other. A
+// cell is thus the number of seeds where both items appear; on a pair of an
+// axis with itself the diagonal equals that axis's marginal count.
+//
+// Each thread tallies into its own dense matrices (150 x 150 u64 for jokers)
+// and the tables are summed at the end, so the hot loop does no locking.
+// Packs are generated last and cost about a third of a seed's time, so they
+// are skipped when no axis reads them.
+//
+// Binary layout (little-endian): "BCOC" magic, u32 format version, u64
+// envConfigHash, i64 game version, u32 shop slots, u64 seeds counted, u32
+// axis count, then per axis: u16 name length, name, u32 size, size x u64
+// marginal counts; u32 pair count, then per pair: u32 row axis, u32 column
+// axis, rows x columns u64 counts, row-major.
+namespace Cooccurrence {
+
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr uint64_t CHUNK_SEEDS = 65536;  // Seeds a thread claims at a time
+    constexpr size_t MAX_SET = 32;           // Largest set an axis can produce
+
+    enum class Category { JOKER, TAROT, PLANET, SPECTRAL, TAG, VOUCHER, BOSS, PACK };
+
+    struct Axis {
+        std::string name;
+        Category category;
+        bool shop = false;  // Item axes: shop slots
+        bool pack = false;  // Item axes: cards of the opened first pack
+
+        size_t size() const {
+            switch (category) {
+                case Category::JOKER: return static_cast<size_t>(Items::Joker::COUNT);
+                case Category::TAROT: return static_cast<size_t>(Items::Tarot::COUNT);
+                case Category::PLANET: return static_cast<size_t>(Items::Planet::COUNT);
+                case Category::SPECTRAL: return static_cast<size_t>(Items::Spectral::COUNT);
+                case Category::TAG: return static_cast<size_t>(Items::Tag::COUNT);
+                case Category::VOUCHER: return static_cast<size_t>(Items::Voucher::COUNT);
+                case Category::BOSS: return static_cast<size_t>(Items::Boss::COUNT);
+                case Category::PACK: return static_cast<size_t>(Items::Pack::COUNT);
+            }
+            return 0;
+        }
+
+        std::string label(size_t id) const {
+            switch (category) {
+                case Category::JOKER: return Items::toString(static_cast<Items::Joker>(id));
+                case Category::TAROT: return Items::toString(static_cast<Items::Tarot>(id));
+                case Category::PLANET: return Items::toString(static_cast<Items::Planet>(id));
+                case Category::SPECTRAL: return Items::toString(static_cast<Items::Spectral>(id));
+                case Category::TAG: return Items::toString(static_cast<Items::Tag>(id));
+                case Category::VOUCHER: return Items::toString(static_cast<Items::Voucher>(id));
+                case Category::BOSS: return Items::toString(static_cast<Items::Boss>(id));
+                case Category::PACK: return Items::toString(static_cast<Items::Pack>(id));
+            }
+            return std::string();
+        }
+    };
+
+    // Axis names: boss, voucher, tag, pack (both shop packs), and for items
+    // joker, tarot, planet, spectral (shop and first pack), each also as
+    // shop_<item> or pack_<item>
+    inline bool parseAxis(const std::string& name, Axis& out) {
+        static const struct { const char* name; Category category; bool item; } known[] = {
+            {"joker", Category::JOKER, true}, {"tarot", Category::TAROT, true},
+            {"planet", Category::PLANET, true}, {"spectral", Category::SPECTRAL, true},
+            {"tag", Category::TAG, false}, {"voucher", Category::VOUCHER, false},
+            {"boss", Category::BOSS, false}, {"pack", Category::PACK, false},
+        };
+        std::string base = name;
+        bool shop = true, pack = true;
+        if (base.compare(0, 5, "shop_") == 0) {
+            base = base.substr(5);
+            pack = false;
+        } else if (base.compare(0, 5, "pack_") == 0) {
+            base = base.substr(5);
+            shop = false;
+        }
+        for (const auto& k : known) {
+            if (base != k.name || (!k.item && base != name)) continue;
+            out.name = name;
+            out.category = k.category;
+            out.shop = k.item && shop;
+            out.pack = k.item && pack;
+            return true;
+        }
+        return false;
+    }
+
+    inline const char* axisHelp() {
+        return "boss, voucher, tag, pack, joker, tarot, planet, spectral; items also as shop_<item> or pack_<item>";
+    }
+
+    // Feature row of one seed, as Schema::extract writes it
+    struct Row {
+        uint16_t values[6 + FeatureColumns::PACK_CARDS + 2 * FeatureColumns::MAX_SHOP_SLOTS];
+        void set(size_t column, uint64_t, uint16_t value) { values[column] = value; }
+    };
+
+    // Row positions, in Schema column order
+    constexpr size_t COL_BOSS = 0, COL_VOUCHER = 1, COL_TAG = 2, COL_PACK = 4, COL_PACK_CARD = 6,
+                     COL_SHOP = COL_PACK_CARD + FeatureColumns::PACK_CARDS;
+
+    using IdSet = std::array<uint16_t, MAX_SET>;
+
+    // Distinct ids of `axis` in a row; returns how many were written to `ids`
+    inline size_t collect(const Axis& axis, const Row& row, int shopSlots, IdSet& ids) {
+        const size_t limit = axis.size();
+        size_t n = 0;
+        auto add = [&](uint16_t id) {
+            if (id >= limit) return;
+            for (size_t i = 0; i < n; i++) {
+                if (ids[i] == id) return;
+            }
+            ids[n++] = id;
+        };
+        FeatureColumns::Kind kind = FeatureColumns::Kind::NONE;
+        switch (axis.category) {
+            case Category::BOSS: add(row.values[COL_BOSS]); return n;
+            case Category::VOUCHER: add(row.values[COL_VOUCHER]); return n;
+            case Category::TAG: add(row.values[COL_TAG]); add(row.values[COL_TAG + 1]); return n;
+            case Category::PACK:
+                add(row.values[COL_PACK]);
+                add(row.values[COL_PACK + 1]);
+                return n;
+            case Category::JOKER: kind = FeatureColumns::Kind::JOKER; break;
+            case Category::TAROT: kind = FeatureColumns::Kind::TAROT; break;
+            case Category::PLANET: kind = FeatureColumns::Kind::PLANET; break;
+            case Category::SPECTRAL: kind = FeatureColumns::Kind::SPECTRAL; break;
+        }
+        auto addItem = [&](uint16_t code) {
+            if (static_cast<FeatureColumns::Kind>(code >> 8) == kind) add(code & 0xFF);
+        };
+        if (axis.pack) {
+            for (size_t c = COL_PACK_CARD; c < COL_SHOP; c++) addItem(row.values[c]);
+        }
+        if (axis.shop) {
+            for (size_t c = COL_SHOP; c < COL_SHOP + static_cast<size_t>(shopSlots); c++) addItem(row.values[c]);
+        }
+        return n;
+    }
+
+    struct Matrix {
+        uint32_t rowAxis = 0, colAxis = 0;
+        std::vector<uint64_t> counts;  // rows x columns, row-major
+    };
+
+    // Counts for a set of axis pairs; one per thread while scanning, then summed
+    class Table {
+    public:
+        uint64_t envHash = 0;
+        int64_t gameVersion = 0;
+        int shopSlots = 4;
+        uint64_t seeds = 0;
+        std::vector<Axis> axes;
+        std::vector<std::vector<uint64_t>> marginals;  // Per axis: seeds containing each id
+        std::vector<Matrix> matrices;
+
+        // Empty table for `pairs` ("row_axis:col_axis"); axes are shared between pairs
+        bool init(const std::vector<std::string>& pairs, int slots, std::string& error) {
+            shopSlots = slots;
+            for (const auto& p : pairs) {
+                const size_t colon = p.find(':');
+                if (colon == std::string::npos) {
+                    error = "expected ROW_AXIS:COLUMN_AXIS, got '" + p + "'";
+                    return false;
+                }
+                Matrix m;
+                if (!addAxis(p.substr(0, colon), m.rowAxis, error) || !addAxis(p.substr(colon + 1), m.colAxis, error)) return false;
+                m.counts.assign(axes[m.rowAxis].size() * axes[m.colAxis].size(), 0);
+                matrices.push_back(std::move(m));
+            }
+            return true;
+        }
+
+        // Same shape, zeroed: a thread's private tally
+        Table emptyCopy() const {
+            Table t = *this;
+            t.seeds = 0;
+            for (auto& m : t.marginals) std::fill(m.begin(), m.end(), 0);
+            for (auto& m : t.matrices) std::fill(m.counts.begin(), m.counts.end(), 0);
+            return t;
+        }
+
+        // Whether any axis reads the shop packs or their cards
+        bool needsPacks() const {
+            for (const auto& a : axes) {
+                if (a.pack || a.category == Category::PACK) return true;
+            }
+            return false;
+        }
+
+        void add(const Row& row) {
+            seeds++;
+            for (size_t a = 0; a < axes.size(); a++) {
+                setSizes[a] = collect(axes[a], row, shopSlots, sets[a]);
+                for (size_t i = 0; i < setSizes[a]; i++) marginals[a][sets[a][i]]++;
+            }
+            for (auto& m : matrices) {
+                const size_t cols = axes[m.colAxis].size();
+                const IdSet& rowIds = sets[m.rowAxis];
+                const IdSet& colIds = sets[m.colAxis];
+                for (size_t i = 0; i < setSizes[m.rowAxis]; i++) {
+                    uint64_t* line = &m.counts[rowIds[i] * cols];
+                    for (size_t j = 0; j < setSizes[m.colAxis]; j++) line[colIds[j]]++;
+                }
+            }
+        }
+
+        bool sameShape(const Table& o, std::string& error) const {
+            if (o.envHash != envHash || o.gameVersion != gameVersion) {
+                error = "tables were counted with different envs";
+                return false;
+            }
+            bool same = o.shopSlots == shopSlots && o.axes.size() == axes.size() && o.matrices.size() == matrices.size();
+            for (size_t a = 0; same && a < axes.size(); a++) same = o.axes[a].name == axes[a].name;
+            for (size_t m = 0; same && m < matrices.size(); m++) {
+                same = o.matrices[m].rowAxis == matrices[m].rowAxis && o.matrices[m].colAxis == matrices[m].colAxis;
+            }
+            if (!same) error = "tables count different shop slots, axes or pairs";
+            return same;
+        }
+
+        // Adds `o`'s counts; the shapes must match (sameShape)
+        void merge(const Table& o) {
+            seeds += o.seeds;
+            for (size_t a = 0; a < marginals.size(); a++) {
+                for (size_t i = 0; i < marginals[a].size(); i++) marginals[a][i] += o.marginals[a][i];
+            }
+            for (size_t m = 0; m < matrices.size(); m++) {
+                auto& dst = matrices[m].counts;
+                const auto& src = o.matrices[m].counts;
+                for (size_t i = 0; i < dst.size(); i++) dst[i] += src[i];
+            }
+        }
+
+        // One line per non-zero cell: both items, the seeds holding both and
+        // each alone, and lift = P(a and b) / (P(a) P(b)). A pair of an axis
+        // with itself lists each unordered pair once (row item <= column item).
+        void writeCsv(std::ostream& out) const {
+            out << "row_axis,row_item,col_axis,col_item,count,row_count,col_count,seeds,lift\n";
+            for (const auto& m : matrices) {
+                const Axis& ra = axes[m.rowAxis];
+                const Axis& ca = axes[m.colAxis];
+                const size_t cols = ca.size();
+                for (size_t i = 0; i < ra.size(); i++) {
+                    for (size_t j = m.rowAxis == m.colAxis ? i : 0; j < cols; j++) {
+                        const uint64_t n = m.counts[i * cols + j];
+                        if (!n) continue;
+                        const uint64_t ri = marginals[m.rowAxis][i], cj = marginals[m.colAxis][j];
+                        const double lift = static_cast<double>(n) * static_cast<double>(seeds) /
+                                            (static_cast<double>(ri) * static_cast<double>(cj));
+                        out << ra.name << "," << quote(ra.label(i)) << "," << ca.name << "," << quote(ca.label(j)) << ","
+                            << n << "," << ri << "," << cj << "," << seeds << "," << std::setprecision(6) << lift << "\n";
+                    }
+                }
+            }
+        }
+
+        // Writes `path`.tmp and renames it into place
+        bool write(const std::string& path, std::string& error) const {
+            std::string out("BCOC", 4);
+            put(out, FORMAT_VERSION, 4);
+            put(out, envHash, 8);
+            put(out, static_cast<uint64_t>(gameVersion), 8);
+            put(out, static_cast<uint64_t>(shopSlots), 4);
+            put(out, seeds, 8);
+            put(out, axes.size(), 4);
+            for (size_t a = 0; a < axes.size(); a++) {
+                put(out, axes[a].name.size(), 2);
+                out += axes[a].name;
+                put(out, marginals[a].size(), 4);
+                for (uint64_t v : marginals[a]) put(out, v, 8);
+            }
+            put(out, matrices.size(), 4);
+            for (const auto& m : matrices) {
+                put(out, m.rowAxis, 4);
+                put(out, m.colAxis, 4);
+                for (uint64_t v : m.counts) put(out, v, 8);
+            }
+            return AtomicFile::write(path, out, error);
+        }
+
+        bool read(const std::string& path, std::string& error) {
+            std::ifstream f(path, std::ios::binary);
+            const std::string in((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            *this = Table();
+            size_t pos = 0;
+            auto get = [&](int bytes, uint64_t& v) {
+                if (in.size() - pos < static_cast<size_t>(bytes)) return false;
+                v = 0;
+                for (int i = 0; i < bytes; i++) v |= static_cast<uint64_t>(static_cast<uint8_t>(in[pos + i])) << (i * 8);
+                pos += bytes;
+                return true;
+            };
+            uint64_t version = 0, game = 0, slots = 0, count = 0;
+            if (in.size() < 4 || in.compare(0, 4, "BCOC") != 0) {
+                error = path + " is not a co-occurrence table";
+                return false;
+            }
+            pos = 4;
+            if (!get(4, version) || version != FORMAT_VERSION) {
+                error = path + " has unsupported format version";
+                return false;
+            }
+            bool ok = get(8, envHash) && get(8, game) && get(4, slots) && get(8, seeds) && get(4, count);
+            gameVersion = static_cast<int64_t>(game);
+            shopSlots = static_cast<int>(slots);
+            for (uint64_t a = 0; ok && a < count; a++) {
+                uint64_t len, size;
+                ok = get(2, len) && in.size() - pos >= len;
+                if (!ok) break;
+                Axis axis;
+                ok = parseAxis(in.substr(pos, static_cast<size_t>(len)), axis);
+                pos += static_cast<size_t>(len);
+                ok = ok && get(4, size) && size == axis.size();
+                std::vector<uint64_t> m(static_cast<size_t>(ok ? size : 0));
+                for (auto& x : m) ok = ok && get(8, x);
+                axes.push_back(axis);
+                marginals.push_back(std::move(m));
+            }
+            ok = ok && get(4, count);
+            for (uint64_t i = 0; ok && i < count; i++) {
+                Matrix m;
+                uint64_t r, c;
+                ok = get(4, r) && get(4, c) && r < axes.size() && c < axes.size();
+                if (!ok) break;
+                m.rowAxis = static_cast<uint32_t>(r);
+                m.colAxis = static_cast<uint32_t>(c);
+                m.counts.resize(axes[m.rowAxis].size() * axes[m.colAxis].size());
+                for (auto& x : m.counts) ok = ok && get(8, x);
+                matrices.push_back(std::move(m));
+            }
+            if (!ok || pos != in.size()) {
+                error = path + ": truncated or corrupt table";
+                return false;
+            }
+            sets.resize(axes.size());
+            setSizes.resize(axes.size());
+            return true;
+        }
+
+    private:
+        static void put(std::string& out, uint64_t v, int bytes) {
+            for (int i = 0; i < bytes; i++) out.push_back(static_cast<char>(v >> (i * 8)));
+        }
+
+        static std::string quote(const std::string& s) {
+            std::string out = "\"";
+            for (char c : s) out += c == '"' ? std::string("\"\"") : std::string(1, c);
+            return out + "\"";
+        }
+
+        bool addAxis(const std::string& name, uint32_t& index, std::string& error) {
+            for (size_t a = 0; a < axes.size(); a++) {
+                if (axes[a].name == name) {
+                    index = static_cast<uint32_t>(a);
+                    return true;
+                }
+            }
+            Axis axis;
+            if (!parseAxis(name, axis)) {
+                error = "unknown axis '" + name + "' (axes: " + axisHelp() + ")";
+                return false;
+            }
+            index = static_cast<uint32_t>(axes.size());
+            axes.push_back(axis);
+            marginals.emplace_back(axis.size(), 0);
+            sets.emplace_back();
+            setSizes.push_back(0);
+            return true;
+        }
+
+        // Scratch for add(): each axis's ids in the current seed
+        std::vector<IdSet> sets;
+        std::vector<size_t> setSizes;
+    };
+
+    // Counts `count` seeds from seed number `start`, or with `sample`, the
+    // seeds at positions start .. start + count of that permutation. Each of
+    // `threads` threads claims CHUNK_SEEDS at a time into its own table;
+    // `progress(done)` is called after each chunk (from any thread, serialized).
+    inline Table scan(const Table& shape, const EnvConfig& env, uint64_t start, uint64_t count, const SeedPermutation* sample,
+                      unsigned int threads, const std::function<void(uint64_t)>& progress = nullptr) {
+        const FeatureColumns::Schema schema(shape.shopSlots);
+        const bool packs = shape.needsPacks();
+        const uint64_t chunks = (count + CHUNK_SEEDS - 1) / CHUNK_SEEDS;
+        std::vector<Table> partial(std::max(1u, threads), shape.emptyCopy());
+        std::atomic<uint64_t> nextChunk{0};
+        std::atomic<uint64_t> done{0};
+        std::mutex progressMutex;
+
+        auto worker = [&](Table& table) {
+            Row row;
+            for (uint64_t c = nextChunk++; c < chunks; c = nextChunk++) {
+                const uint64_t begin = start + c * CHUNK_SEEDS;
+                const uint64_t end = std::min(start + count, begin + CHUNK_SEEDS);
+                for (uint64_t i = begin; i < end; i++) {
+                    schema.extract(numberToSeed(sample ? sample->at(i) : i), env, row, 0, packs);
+                    table.add(row);
+                }
+                const uint64_t total = done += end - begin;
+                if (progress) {
+                    std::lock_guard<std::mutex> lk(progressMutex);
+                    progress(total);
+                }
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < partial.size(); t++) pool.emplace_back(worker, std::ref(partial[t]));
+        worker(partial[0]);
+        for (auto& t : pool) t.join();
+
+        Table total = shape.emptyCopy();
+        total.envHash = envConfigHash(env);
+        total.gameVersion = env.version;
+        for (const auto& p : partial) total.merge(p);
+        return total;
+    }
+}
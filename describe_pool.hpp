@@ -0,0 +1,175 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "seed_util.hpp"
+
+// --describe: runs the filter's describeMatch() for matches found during the
+// scan, so tools get each match's JSON without starting one --describe-match
+// process per seed. Matches go into a bounded queue served by a few
+// low-priority threads. Each result is appended as one JSON line to a file
+// next to the match CSV:
+//
+//   {"seed": "ABCD1234", "filter": "...", "level": 1, "name": "...", "describe": {...}}
+//
+// "filter" is the filter's getName(), so readers can tell files of different
+// filters apart. "describe" is null when the filter has nothing to add. submit() never
+// waits. When the queue is full, the match is written straight away with
+// "dropped": true and no description, and searching continues. A later
+// --describe-match pass can fill in just those seeds.
+class DescribePool {
+public:
+    using Describe = std::function<std::string(const std::string& seed)>;
+    using LevelName = std::function<std::string(int level)>;
+
+    // Below the search threads, but still making progress on a busy machine
+    static constexpr int NICE = 10;
+
+    DescribePool(std::string filterName, Describe describeFn, LevelName levelNameFn, size_t queueCapacity)
+        : filter(std::move(filterName)), describe(std::move(describeFn)), levelName(std::move(levelNameFn)), capacity(queueCapacity) {}
+
+    ~DescribePool() { finish(); }
+
+    // Appends to `path` and starts `threads` workers
+    bool start(const std::string& path, unsigned int threads) {
+        out.open(path, std::ios::app);
+        if (!out.is_open()) return false;
+        for (unsigned int i = 0; i < threads; i++) workers.emplace_back(&DescribePool::run, this);
+        return true;
+    }
+
+    void submit(uint64_t number, uint16_t level) {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            if (queue.size() < capacity) {
+                queue.push_back({number, level});
+                ready.notify_one();
+                return;
+            }
+        }
+        write(number, level, std::string(), true);
+    }
+
+    // Describes what is still queued, then stops the workers
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            if (stopping) return;
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto& t : workers) t.join();
+        workers.clear();
+        out.flush();
+    }
+
+    // One record as written to the file, newline included. `json` is the
+    // filter's describeMatch() output; empty becomes null.
+    static std::string formatLine(const std::string& filter, const std::string& seed, int level, const std::string& name, std::string json) {
+        // One record per line, whatever the filter's formatting
+        for (char& c : json) {
+            if (c == '\n' || c == '\r') c = ' ';
+        }
+        return head(filter, seed, level, name) + ", \"describe\": " + (json.empty() ? std::string("null") : json) + "}\n";
+    }
+
+    uint64_t described() const {
+        std::lock_guard<std::mutex> lk(outMutex);
+        return describedCount;
+    }
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lk(outMutex);
+        return droppedCount;
+    }
+    size_t queued() const {
+        std::lock_guard<std::mutex> lk(mutex);
+        return queue.size();
+    }
+
+private:
+    struct Item {
+        uint64_t number;
+        uint16_t level;
+    };
+
+    static std::string escape(const std::string& s) {
+        std::string r;
+        for (char c : s) {
+            if (c == '"' || c == '\\') r += '\\';
+            if (c == '\n') {
+                r += "\\n";
+                continue;
+            }
+            r += c;
+        }
+        return r;
+    }
+
+    // A record's fields up to "name"
+    static std::string head(const std::string& filter, const std::string& seed, int level, const std::string& name) {
+        return "{\"seed\": \"" + seed + "\", \"filter\": \"" + escape(filter) + "\", \"level\": " + std::to_string(level) +
+               ", \"name\": \"" + escape(name) + "\"";
+    }
+
+    void run() {
+#if defined(__linux__)
+        // Linux applies nice values per thread
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), NICE);
+#endif
+        for (;;) {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lk(mutex);
+                ready.wait(lk, [&] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                item = queue.front();
+                queue.pop_front();
+            }
+            std::string json;
+            try {
+                json = describe(numberToSeed(item.number));
+            } catch (...) {
+                json.clear();
+            }
+            write(item.number, item.level, json, false);
+        }
+    }
+
+    void write(uint64_t number, uint16_t level, const std::string& json, bool wasDropped) {
+        const std::string seed = numberToSeed(number);
+        const std::string line = wasDropped ? head(filter, seed, level, levelName(level)) + ", \"dropped\": true}\n"
+                                            : formatLine(filter, seed, level, levelName(level), json);
+        std::lock_guard<std::mutex> lk(outMutex);
+        out << line;
+        if (wasDropped) droppedCount++;
+        else describedCount++;
+    }
+
+    const std::string filter;
+    Describe describe;
+    LevelName levelName;
+    const size_t capacity;
+    mutable std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Item> queue;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+    mutable std::mutex outMutex;
+    std::ofstream out;
+    uint64_t describedCount = 0;
+    uint64_t droppedCount = 0;
+};
@@ -1,17 +1,220 @@
 #include "env.hpp"
+#include <atomic>
 #include <mutex>
 #include <fstream>
 #include <sstream>
+#include <cctype>
 
 static EnvConfig g_env;
 static std::mutex g_env_mutex;
+static std::atomic<uint64_t> g_env_generation{0};
 
 void setGlobalEnv(const EnvConfig& e) {
     std::lock_guard<std::mutex> lk(g_env_mutex);
     g_env = e;
+    g_env_generation.fetch_add(1, std::memory_order_release);
 }
 
 EnvConfig getGlobalEnv() {
     std::lock_guard<std::mutex> lk(g_env_mutex);
     return g_env;
 }
+
+uint64_t getGlobalEnvGeneration() {
+    return g_env_generation.load(std::memory_order_acquire);
+}
+
+// FNV-1a over every field, with lengths and separators so that adjacent
+// strings cannot alias
+namespace {
+    struct EnvHasher {
+        uint64_t h = 14695981039346656037ull;
+        void bytes(const void* data, size_t n) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < n; i++) {
+                h ^= p[i];
+                h *= 1099511628211ull;
+            }
+        }
+        void u64(uint64_t v) {
+            for (int i = 0; i < 8; i++) {
+                unsigned char b = static_cast<unsigned char>(v >> (i * 8));
+                bytes(&b, 1);
+            }
+        }
+        void str(const std::string& s) {
+            u64(s.size());
+            bytes(s.data(), s.size());
+        }
+        void strings(const std::vector<std::string>& v) {
+            u64(v.size());
+            for (const auto& s : v) str(s);
+        }
+    };
+}
+
+uint64_t envConfigHash(const EnvConfig& e) {
+    EnvHasher h;
+    h.str(e.deck);
+    h.str(e.stake);
+    h.u64(e.showman);
+    h.str(e.tag);
+    h.strings(e.unlockedTags);
+    h.u64(e.freshProfile);
+    h.u64(e.freshRun);
+    h.u64(static_cast<uint64_t>(static_cast<int64_t>(e.sixesFactor)));
+    h.u64(static_cast<uint64_t>(static_cast<int64_t>(e.version)));
+    h.u64(e.forceAllContent);
+    h.u64(e.selectedOptionsSet);
+    if (e.selectedOptionsSet) {
+        h.u64(e.selectedOptions.size());
+        for (bool b : e.selectedOptions) h.u64(b);
+    }
+    h.strings(e.unlockedJokers);
+    return h.h;
+}
+
+bool loadEnvFile(const std::string& path, EnvConfig& out) {
+    std::ifstream ef(path);
+    if (!ef.is_open()) return false;
+    std::stringstream ssin;
+    ssin << ef.rdbuf();
+    return parseEnvJson(ssin.str(), out);
+}
+
+bool parseEnvJson(const std::string& txt, EnvConfig& out) {
+    try {
+        EnvConfig e;
+        // lightweight parsing: look for keys and extract simple values (robust to spacing)
+        auto find_str = [&](const std::string& key) -> std::string {
+            auto pos = txt.find('"' + key + '"');
+            if (pos == std::string::npos) return std::string();
+            auto colon = txt.find(':', pos);
+            if (colon == std::string::npos) return std::string();
+            auto start = txt.find_first_not_of(" \t\n\r", colon+1);
+            if (start == std::string::npos) return std::string();
+            if (txt[start] == '"') {
+                auto end = txt.find('"', start+1);
+                if (end == std::string::npos) return std::string();
+                return txt.substr(start+1, end-start-1);
+            } else {
+                // read until comma or brace
+                auto end = txt.find_first_of(",}\n\r", start);
+                if (end == std::string::npos) end = txt.size();
+                return txt.substr(start, end-start);
+            }
+        };
+
+        std::string v;
+        v = find_str("deck"); if (!v.empty()) e.deck = v;
+        v = find_str("stake"); if (!v.empty()) e.stake = v;
+        v = find_str("tag"); if (!v.empty()) e.tag = v;
+        // Lightweight parse for unlockedTags: look for "unlockedTags" and extract a simple array of strings
+        auto posUT = txt.find("\"unlockedTags\"");
+        if (posUT != std::string::npos) {
+            auto bracket = txt.find('[', posUT);
+            if (bracket != std::string::npos) {
+                auto endb = txt.find(']', bracket);
+                if (endb != std::string::npos && endb > bracket) {
+                    std::string body = txt.substr(bracket+1, endb - bracket - 1);
+                    size_t p = 0;
+                    while (p < body.size()) {
+                        // find next quote
+                        auto q1 = body.find('"', p);
+                        if (q1 == std::string::npos) break;
+                        auto q2 = body.find('"', q1+1);
+                        if (q2 == std::string::npos) break;
+                        std::string tagname = body.substr(q1+1, q2 - q1 - 1);
+                        if (!tagname.empty()) e.unlockedTags.push_back(tagname);
+                        p = q2 + 1;
+                    }
+                }
+            }
+        }
+        // Lightweight parse for unlockedJokers (fallback)
+        auto posUJ = txt.find("\"unlockedJokers\"");
+        if (posUJ != std::string::npos) {
+            auto bracket = txt.find('[', posUJ);
+            if (bracket != std::string::npos) {
+                auto endb = txt.find(']', bracket);
+                if (endb != std::string::npos && endb > bracket) {
+                    std::string body = txt.substr(bracket+1, endb - bracket - 1);
+                    size_t p = 0;
+                    while (p < body.size()) {
+                        auto q1 = body.find('"', p);
+                        if (q1 == std::string::npos) break;
+                        auto q2 = body.find('"', q1+1);
+                        if (q2 == std::string::npos) break;
+                        std::string jname = body.substr(q1+1, q2 - q1 - 1);
+                        if (!jname.empty()) e.unlockedJokers.push_back(jname);
+                        p = q2 + 1;
+                    }
+                }
+            }
+        }
+        v = find_str("showman"); if (!v.empty()) e.showman = (v.find("true") != std::string::npos);
+        v = find_str("sixesFactor"); if (!v.empty()) e.sixesFactor = std::stoi(v);
+        v = find_str("version"); if (!v.empty()) e.version = std::stol(v);
+        v = find_str("forceAllContent"); if (!v.empty()) e.forceAllContent = (v.find("true") != std::string::npos);
+        v = find_str("freshProfile"); if (!v.empty()) e.freshProfile = (v.find("true") != std::string::npos);
+        v = find_str("freshRun"); if (!v.empty()) e.freshRun = (v.find("true") != std::string::npos);
+
+        // Lightweight attempt to parse selectedOptions: look for "selectedOptions" and extract a simple array
+        auto posSo = txt.find("\"selectedOptions\"");
+        if (posSo != std::string::npos) {
+            auto bracket = txt.find('[', posSo);
+            if (bracket != std::string::npos) {
+                auto endb = txt.find(']', bracket);
+                if (endb != std::string::npos && endb > bracket) {
+                    std::string body = txt.substr(bracket+1, endb - bracket - 1);
+                    // Split by commas and trim
+                    std::vector<std::string> parts;
+                    size_t p = 0;
+                    while (p < body.size()) {
+                        auto comma = body.find(',', p);
+                        if (comma == std::string::npos) comma = body.size();
+                        std::string token = body.substr(p, comma - p);
+                        // trim
+                        auto l = token.find_first_not_of(" \t\n\r");
+                        auto r = token.find_last_not_of(" \t\n\r");
+                        if (l != std::string::npos && r != std::string::npos) token = token.substr(l, r - l + 1);
+                        else token = "";
+                        if (!token.empty()) parts.push_back(token);
+                        p = comma + 1;
+                    }
+                    // Determine if parts are booleans or indices
+                    bool allBool = true; bool allInt = true;
+                    for (auto &tkn : parts) {
+                        std::string tl = tkn;
+                        for (auto &c : tl) c = (char)std::tolower(c);
+                        if (!(tl == "true" || tl == "false")) allBool = false;
+                        try { std::stoul(tkn); } catch(...) { allInt = false; }
+                    }
+                    if (allBool && parts.size() == 61) {
+                        e.selectedOptions.clear(); e.selectedOptions.resize(61);
+                        for (size_t i = 0; i < 61 && i < parts.size(); ++i) {
+                            auto tl = parts[i]; for (auto &c : tl) c = (char)std::tolower(c);
+                            e.selectedOptions[i] = (tl == "true");
+                        }
+                        e.selectedOptionsSet = true;
+                    } else if (allInt) {
+                        e.selectedOptions = std::vector<bool>(61, false);
+                        for (auto &tkn : parts) {
+                            try {
+                                int idx = std::stoi(tkn);
+                                if (idx >= 0 && idx < 61) e.selectedOptions[idx] = true;
+                            } catch (...) { }
+                        }
+                        e.selectedOptionsSet = true;
+                    }
+                }
+            }
+        }
+
+        out = e;
+        return true;
+    } catch (...) {
+        // Malformed numbers: leave `out` untouched
+        return false;
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -24,3 +25,13 @@ struct EnvConfig {
 
 void setGlobalEnv(const EnvConfig& e);
 EnvConfig getGlobalEnv();
+// Incremented on every setGlobalEnv(); lets hot paths cache env-derived state cheaply
+uint64_t getGlobalEnvGeneration();
+// Stable 64-bit hash of every EnvConfig field; stored with results that are
+// only valid for one configuration (seed index shards)
+uint64_t envConfigHash(const EnvConfig& e);
+// Lightweight JSON env-file parser (the fallback used by immolate --env).
+// Returns false and leaves `out` untouched if the file cannot be read or parsed.
+bool loadEnvFile(const std::string& path, EnvConfig& out);
+// The same parser over JSON text already in memory
+bool parseEnvJson(const std::string& text, EnvConfig& out);
@@ -0,0 +1,452 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+
+#include "atomic_file.hpp"
+#include "mapped_file.hpp"
+
+// Columnar per-seed feature shards and a bitmap query engine, used by
+// tools/feature_indexer.cpp. Where seed_index.hpp keeps only the seeds that
+// hit fixed events, a feature shard stores the generated values themselves
+// (one row per seed, one fixed-width column per output), so any predicate
+// over those outputs can be answered later without re-simulating.
+//
+// Shard layout (little-endian): "BFCL" magic, u32 format version, u64
+// envConfigHash, i64 game version, u64 rangeStart, u64 rangeEnd, u32 column
+// count, then per column: u16 name length, name, u8 width (1 or 2 bytes),
+// u64 file offset of its data. Column data is 64-byte aligned; row i is seed
+// number rangeStart + i.
+namespace FeatureIndex {
+
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr const char* SHARD_SUFFIX = ".bfcol";
+    constexpr uint64_t CHUNK_ROWS = 65536;       // Rows per bitmap chunk
+    constexpr uint32_t ARRAY_MAX = 4096;          // Larger chunks switch to a bitset
+
+    struct ShardHeader {
+        uint64_t envHash = 0;
+        int64_t gameVersion = 0;
+        uint64_t rangeStart = 0;
+        uint64_t rangeEnd = 0;
+
+        uint64_t rows() const { return rangeEnd - rangeStart; }
+    };
+
+    struct ColumnSpec {
+        std::string name;
+        uint8_t width;  // Bytes per value: 1 or 2
+    };
+
+    namespace detail {
+        inline void put(std::string& out, uint64_t v, int bytes) {
+            for (int i = 0; i < bytes; i++) out.push_back(static_cast<char>(v >> (i * 8)));
+        }
+
+        inline uint64_t get(const uint8_t* p, int bytes) {
+            uint64_t v = 0;
+            for (int i = 0; i < bytes; i++) v |= static_cast<uint64_t>(p[i]) << (i * 8);
+            return v;
+        }
+
+        inline uint64_t align64(uint64_t v) { return (v + 63) & ~63ull; }
+    }
+
+    inline std::string shardFileName(uint64_t rangeStart, uint64_t rangeEnd) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "features_%013llu_%013llu%s",
+                      static_cast<unsigned long long>(rangeStart), static_cast<unsigned long long>(rangeEnd), SHARD_SUFFIX);
+        return buf;
+    }
+
+    // Collects one shard in memory; values are little-endian in the file
+    class ShardWriter {
+    public:
+        ShardWriter(const ShardHeader& h, const std::vector<ColumnSpec>& columns) : hdr(h), specs(columns) {
+            for (const auto& c : specs) data.emplace_back(static_cast<size_t>(h.rows()) * c.width, '\0');
+        }
+
+        void set(size_t column, uint64_t row, uint16_t value) {
+            char* p = &data[column][static_cast<size_t>(row) * specs[column].width];
+            p[0] = static_cast<char>(value);
+            if (specs[column].width == 2) p[1] = static_cast<char>(value >> 8);
+        }
+
+        // Writes `path`.tmp and renames it into place
+        bool write(const std::string& path, std::string& error) const {
+            std::string head("BFCL", 4);
+            detail::put(head, FORMAT_VERSION, 4);
+            detail::put(head, hdr.envHash, 8);
+            detail::put(head, static_cast<uint64_t>(hdr.gameVersion), 8);
+            detail::put(head, hdr.rangeStart, 8);
+            detail::put(head, hdr.rangeEnd, 8);
+            detail::put(head, specs.size(), 4);
+            uint64_t dirBytes = 0;
+            for (const auto& c : specs) dirBytes += 2 + c.name.size() + 1 + 8;
+            uint64_t offset = detail::align64(head.size() + dirBytes);
+            std::vector<uint64_t> offsets;
+            for (size_t i = 0; i < specs.size(); i++) {
+                offsets.push_back(offset);
+                offset = detail::align64(offset + data[i].size());
+            }
+            for (size_t i = 0; i < specs.size(); i++) {
+                detail::put(head, specs[i].name.size(), 2);
+                head += specs[i].name;
+                detail::put(head, specs[i].width, 1);
+                detail::put(head, offsets[i], 8);
+            }
+
+            return AtomicFile::write(path, [&](std::FILE* f) {
+                bool ok = std::fwrite(head.data(), 1, head.size(), f) == head.size();
+                uint64_t pos = head.size();
+                const std::string pad(64, '\0');
+                for (size_t i = 0; ok && i < specs.size(); i++) {
+                    ok = std::fwrite(pad.data(), 1, offsets[i] - pos, f) == offsets[i] - pos &&
+                         std::fwrite(data[i].data(), 1, data[i].size(), f) == data[i].size();
+                    pos = offsets[i] + data[i].size();
+                }
+                return ok;
+            }, error);
+        }
+
+    private:
+        ShardHeader hdr;
+        std::vector<ColumnSpec> specs;
+        std::vector<std::string> data;
+    };
+
+    // Read-only view of a shard file (mapped_file.hpp)
+    class MappedShard {
+    public:
+        MappedShard() = default;
+        MappedShard(const MappedShard&) = delete;
+        MappedShard& operator=(const MappedShard&) = delete;
+        ~MappedShard() { unmap(); }
+
+        bool open(const std::string& path, std::string& error) {
+            unmap();
+            if (!file.open(path, error)) return false;
+            const uint8_t* base = file.data();
+            const uint64_t size = file.size();
+            if (size < 44 || std::memcmp(base, "BFCL", 4) != 0) {
+                error = path + " is not a feature shard";
+                return false;
+            }
+            if (detail::get(base + 4, 4) != FORMAT_VERSION) {
+                error = path + " has unsupported format version";
+                return false;
+            }
+            hdr.envHash = detail::get(base + 8, 8);
+            hdr.gameVersion = static_cast<int64_t>(detail::get(base + 16, 8));
+            hdr.rangeStart = detail::get(base + 24, 8);
+            hdr.rangeEnd = detail::get(base + 32, 8);
+            const uint64_t count = detail::get(base + 40, 4);
+            uint64_t pos = 44;
+            for (uint64_t i = 0; i < count; i++) {
+                if (pos + 2 > size) break;
+                const uint64_t nameLen = detail::get(base + pos, 2);
+                if (pos + 2 + nameLen + 9 > size) break;
+                Column c;
+                c.name.assign(reinterpret_cast<const char*>(base + pos + 2), static_cast<size_t>(nameLen));
+                c.width = base[pos + 2 + nameLen];
+                const uint64_t offset = detail::get(base + pos + 3 + nameLen, 8);
+                if ((c.width != 1 && c.width != 2) || offset + hdr.rows() * c.width > size) break;
+                c.data = base + offset;
+                columns.push_back(c);
+                pos += 2 + nameLen + 9;
+            }
+            if (columns.size() != count) {
+                error = path + ": corrupt column directory";
+                columns.clear();
+                return false;
+            }
+            return true;
+        }
+
+        const ShardHeader& header() const { return hdr; }
+        uint64_t rows() const { return hdr.rows(); }
+        size_t columnCount() const { return columns.size(); }
+        const std::string& columnName(size_t i) const { return columns[i].name; }
+
+        int findColumn(const std::string& name) const {
+            for (size_t i = 0; i < columns.size(); i++) {
+                if (columns[i].name == name) return static_cast<int>(i);
+            }
+            return -1;
+        }
+
+        uint16_t value(size_t column, uint64_t row) const {
+            const Column& c = columns[column];
+            return c.width == 1 ? c.data[row] : static_cast<uint16_t>(c.data[2 * row] | (c.data[2 * row + 1] << 8));
+        }
+
+    private:
+        struct Column {
+            std::string name;
+            uint8_t width = 1;
+            const uint8_t* data = nullptr;
+        };
+
+        void unmap() {
+            file.close();
+            columns.clear();
+        }
+
+        MappedFile file;
+        ShardHeader hdr;
+        std::vector<Column> columns;
+    };
+
+    // Row set for one chunk of CHUNK_ROWS rows, stored either as a sorted
+    // array of row offsets (sparse) or as a bitset (dense)
+    class ChunkSet {
+    public:
+        bool empty() const { return dense ? count == 0 : rows.empty(); }
+        uint32_t cardinality() const { return dense ? count : static_cast<uint32_t>(rows.size()); }
+
+        // Rows of [0, n) satisfying `test`
+        template<typename Test>
+        static ChunkSet scan(uint32_t n, Test test) {
+            ChunkSet s;
+            s.dense = true;
+            s.bits.assign(CHUNK_ROWS / 64, 0);
+            for (uint32_t r = 0; r < n; r++) {
+                if (test(r)) s.bits[r >> 6] |= 1ull << (r & 63);
+            }
+            s.recount();
+            s.compact();
+            return s;
+        }
+
+        // Keeps the rows for which `test` holds. Sparse sets probe each row;
+        // dense sets scan the whole chunk and AND the words
+        template<typename Test>
+        void filter(uint32_t n, Test test) {
+            if (!dense) {
+                rows.erase(std::remove_if(rows.begin(), rows.end(), [&](uint16_t r) { return !test(r); }), rows.end());
+                return;
+            }
+            ChunkSet other = scan(n, test);
+            intersectWith(other);
+        }
+
+        void intersectWith(const ChunkSet& o) {
+            if (dense && o.dense) {
+                for (size_t w = 0; w < bits.size(); w++) bits[w] &= o.bits[w];
+                recount();
+                compact();
+            } else if (dense) {
+                std::vector<uint16_t> out;
+                for (uint16_t r : o.rows) if (contains(r)) out.push_back(r);
+                makeSparse(std::move(out));
+            } else if (o.dense) {
+                rows.erase(std::remove_if(rows.begin(), rows.end(), [&](uint16_t r) { return !o.contains(r); }), rows.end());
+            } else {
+                std::vector<uint16_t> out;
+                std::set_intersection(rows.begin(), rows.end(), o.rows.begin(), o.rows.end(), std::back_inserter(out));
+                rows.swap(out);
+            }
+        }
+
+        bool contains(uint16_t r) const {
+            return dense ? (bits[r >> 6] >> (r & 63)) & 1 : std::binary_search(rows.begin(), rows.end(), r);
+        }
+
+        template<typename Fn>
+        void forEach(Fn fn) const {
+            if (!dense) {
+                for (uint16_t r : rows) fn(r);
+                return;
+            }
+            for (size_t w = 0; w < bits.size(); w++) {
+                uint64_t word = bits[w];
+                while (word) {
+                    fn(static_cast<uint32_t>(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        bool isDense() const { return dense; }
+
+    private:
+        void recount() {
+            count = 0;
+            for (uint64_t w : bits) count += static_cast<uint32_t>(__builtin_popcountll(w));
+        }
+
+        // Switch to the array form once the set is small enough
+        void compact() {
+            if (!dense || count > ARRAY_MAX) return;
+            std::vector<uint16_t> out;
+            out.reserve(count);
+            forEach([&](uint32_t r) { out.push_back(static_cast<uint16_t>(r)); });
+            makeSparse(std::move(out));
+        }
+
+        void makeSparse(std::vector<uint16_t> r) {
+            dense = false;
+            rows = std::move(r);
+            bits.clear();
+            count = 0;
+        }
+
+        bool dense = false;
+        uint32_t count = 0;
+        std::vector<uint64_t> bits;
+        std::vector<uint16_t> rows;
+    };
+
+    // True for a row when any of `columns` holds an accepted value (or none
+    // does, if `negate`)
+    struct Predicate {
+        std::string text;
+        std::vector<std::string> columns;
+        std::shared_ptr<std::bitset<65536>> accept = std::make_shared<std::bitset<65536>>();
+        bool negate = false;
+    };
+
+    // Predicates bound to one shard's column indexes
+    class BoundQuery {
+    public:
+        bool bind(const MappedShard& shard, const std::vector<Predicate>& predicates, std::string& error) {
+            this->shard = &shard;
+            bound.clear();
+            for (const auto& p : predicates) {
+                Bound b;
+                b.pred = &p;
+                for (const auto& name : p.columns) {
+                    int c = shard.findColumn(name);
+                    if (c < 0) {
+                        error = "shard has no column '" + name + "'";
+                        return false;
+                    }
+                    b.columns.push_back(static_cast<size_t>(c));
+                }
+                bound.push_back(b);
+            }
+            return true;
+        }
+
+        bool test(size_t predicate, uint64_t row) const {
+            const Bound& b = bound[predicate];
+            bool hit = false;
+            for (size_t c : b.columns) {
+                if ((*b.pred->accept)[shard->value(c, row)]) {
+                    hit = true;
+                    break;
+                }
+            }
+            return hit != b.pred->negate;
+        }
+
+        size_t size() const { return bound.size(); }
+
+        // Evaluates every predicate over one chunk, most selective first
+        ChunkSet evaluateChunk(uint64_t chunk, const std::vector<size_t>& order) const {
+            const uint64_t first = chunk * CHUNK_ROWS;
+            const uint32_t n = static_cast<uint32_t>(std::min(CHUNK_ROWS, shard->rows() - first));
+            ChunkSet set = ChunkSet::scan(n, [&](uint32_t r) { return test(order[0], first + r); });
+            for (size_t i = 1; i < order.size() && !set.empty(); i++) {
+                set.filter(n, [&](uint32_t r) { return test(order[i], first + r); });
+            }
+            return set;
+        }
+
+    private:
+        struct Bound {
+            const Predicate* pred;
+            std::vector<size_t> columns;
+        };
+        const MappedShard* shard = nullptr;
+        std::vector<Bound> bound;
+    };
+
+    // Orders predicates by their hit rate on a sample of rows so the chunk
+    // sets shrink as early as possible
+    inline std::vector<size_t> selectivityOrder(const BoundQuery& q, uint64_t rows) {
+        std::vector<std::pair<uint64_t, size_t>> hits;
+        const uint64_t sample = std::min<uint64_t>(rows, 8192);
+        for (size_t p = 0; p < q.size(); p++) {
+            uint64_t h = 0;
+            for (uint64_t r = 0; r < sample; r++) h += q.test(p, r * (rows / std::max<uint64_t>(sample, 1)));
+            hits.emplace_back(h, p);
+        }
+        std::stable_sort(hits.begin(), hits.end());
+        std::vector<size_t> order;
+        for (const auto& h : hits) order.push_back(h.second);
+        return order;
+    }
+
+    // Seed numbers matching every predicate across `shards`, ascending within
+    // each shard. Chunks are spread over `threads` workers.
+    inline bool runQuery(const std::vector<const MappedShard*>& shards, const std::vector<Predicate>& predicates,
+                         unsigned int threads, std::vector<uint64_t>& out, std::string& error) {
+        out.clear();
+        if (predicates.empty()) {
+            error = "no predicates";
+            return false;
+        }
+        struct Task {
+            size_t shard;
+            uint64_t chunk;
+        };
+        std::vector<BoundQuery> queries(shards.size());
+        std::vector<std::vector<size_t>> orders(shards.size());
+        std::vector<Task> tasks;
+        for (size_t s = 0; s < shards.size(); s++) {
+            if (!queries[s].bind(*shards[s], predicates, error)) return false;
+            orders[s] = selectivityOrder(queries[s], shards[s]->rows());
+            const uint64_t chunks = (shards[s]->rows() + CHUNK_ROWS - 1) / CHUNK_ROWS;
+            for (uint64_t c = 0; c < chunks; c++) tasks.push_back({s, c});
+        }
+
+        std::vector<std::vector<uint64_t>> results(tasks.size());
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t t = next++; t < tasks.size(); t = next++) {
+                const Task& task = tasks[t];
+                ChunkSet set = queries[task.shard].evaluateChunk(task.chunk, orders[task.shard]);
+                const uint64_t base = shards[task.shard]->header().rangeStart + task.chunk * CHUNK_ROWS;
+                set.forEach([&](uint32_t r) { results[t].push_back(base + r); });
+            }
+        };
+        if (threads <= 1) {
+            worker();
+        } else {
+            std::vector<std::thread> pool;
+            for (unsigned int i = 0; i < threads; i++) pool.emplace_back(worker);
+            for (auto& th : pool) th.join();
+        }
+        for (const auto& r : results) out.insert(out.end(), r.begin(), r.end());
+        return true;
+    }
+
+    // Feature shard files in `dir`, in range order
+    inline std::vector<std::string> listShards(const std::string& dir) {
+        std::vector<std::string> files;
+        DIR* d = opendir(dir.c_str());
+        if (!d) return files;
+        const std::string suffix = SHARD_SUFFIX;
+        while (dirent* ent = readdir(d)) {
+            std::string n = ent->d_name;
+            if (n.size() > suffix.size() && n.compare(0, 9, "features_") == 0 &&
+                n.compare(n.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                files.push_back(dir + "/" + n);
+            }
+        }
+        closedir(d);
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+}
@@ -1,15 +1,18 @@
 #pragma once
 
 #include "filter_base.hpp"
+#include "../instance_batch.hpp"
 
 // optional simulator helper
 #include "../tools/describe_simulator.hpp"
 #include <sstream>
 
 
-class AnyLegendaryFilter : public SearchFilter {
+class AnyLegendaryFilter final : public SearchFilter {
 public:
     int apply(const std::string& seed, std::ostream& debugOut = std::cout) override {
+        HOT_STAGES(stages);
+        HOT_STAGE_NEXT(stages, "legendary.setup");
         Instance::Instance inst(seed);
         EnvConfig e = getGlobalEnv();
         if (!e.deck.empty()) inst.setDeck(e.deck);
@@ -20,7 +23,9 @@ public:
         inst.setForceAllContent(e.forceAllContent);
         inst.initLocks(1, e.freshProfile, e.freshRun);
 
+        HOT_STAGE_NEXT(stages, "legendary.tag");
         if(inst.nextTag_enum(1) != Items::Tag::CHARM_TAG) return 0;
+        HOT_STAGE_NEXT(stages, "legendary.arcana");
         auto cards = inst.nextArcanaPack_enum(5, 1);
         bool foundSoul = false;
 
@@ -37,6 +42,7 @@ public:
         }
         if (!foundSoul) return 0;
         
+        HOT_STAGE_NEXT(stages, "legendary.joker");
         auto legendary = inst.nextJoker_enum("sou", 1, false).joker;
         if (legendary == Items::Joker::PERKEO) return 1;
         if (legendary == Items::Joker::TRIBOULET) return 2;
@@ -46,6 +52,55 @@ public:
         return 0;
     }
 
+    // Same checks as apply(), interleaving up to Instance::MAX_INTERLEAVE seeds per group
+    void applyBatch(Span<const std::string> seeds, Span<uint16_t> levels) override {
+        Instance::forEachLaneGroup(seeds.size(), seeds.size(), [&](auto lanes, size_t offset, size_t count) {
+            applyLanes<decltype(lanes)::value>(seeds.data() + offset, count, levels.data() + offset);
+        });
+    }
+
+    template<size_t N>
+    void applyLanes(const std::string* seeds, size_t count, uint16_t* levels) {
+        using Batch = Instance::InstanceBatch<N>;
+        Batch& batch = Instance::threadBatch<N>(1);
+        uint64_t alive = batch.reset(seeds, count);
+        for (size_t l = 0; l < count; l++) levels[l] = 0;
+
+        Items::Tag tags[N];
+        batch.nextTag(1, alive, tags);
+        for (size_t l = 0; l < count; l++) {
+            if (tags[l] != Items::Tag::CHARM_TAG) alive &= ~Batch::laneBit(l);
+        }
+        if (!alive) return;
+
+        typename Batch::ArcanaPack pack;
+        batch.nextArcanaPack(5, 1, alive, pack);
+        uint64_t soul = 0;
+        for (int i = 0; i < pack.size; i++) {
+            for (size_t l = 0; l < count; l++) {
+                if (!(alive & Batch::laneBit(l))) continue;
+                bool hit = (pack.isSpectral[i] & Batch::laneBit(l))
+                    ? pack.spectrals[i][l] == Items::Spectral::SPECTRAL_THE_SOUL
+                    : pack.tarots[i][l] == Items::Tarot::SPECIAL_THE_SOUL;
+                if (hit) soul |= Batch::laneBit(l);
+            }
+        }
+        alive &= soul;
+        if (!alive) return;
+
+        Items::OptimizedJokerData jokers[N];
+        batch.nextJoker("sou", 1, false, alive, jokers);
+        for (size_t l = 0; l < count; l++) {
+            if (!(alive & Batch::laneBit(l))) continue;
+            Items::Joker legendary = jokers[l].joker;
+            if (legendary == Items::Joker::PERKEO) levels[l] = 1;
+            else if (legendary == Items::Joker::TRIBOULET) levels[l] = 2;
+            else if (legendary == Items::Joker::YORICK) levels[l] = 3;
+            else if (legendary == Items::Joker::CHICOT) levels[l] = 4;
+            else if (legendary == Items::Joker::CANIO) levels[l] = 5;
+        }
+    }
+
     std::vector<std::string> getResultNames() const override {
         return {"Perkeo", "Triboulet", "Yorick", "Chicot", "Canio"};
     }
@@ -130,6 +185,8 @@ public:
     }
 };
 
+#define SELECTED_FILTER_TYPE AnyLegendaryFilter
+
 std::unique_ptr<SearchFilter> createFilter() {
     return std::make_unique<AnyLegendaryFilter>();
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "filter_base.hpp"
+#include "../shop_stream.hpp"
+#include <sstream>
+
+// Blueprint in an ante 1-2 shop within a reroll budget, read lazily from the
+// shop queues (shop_stream.hpp) so a seed only draws as far as the budget or
+// the first Blueprint. Levels rank by the fewest rerolls the ante needs.
+class BlueprintRerollFilter final : public SearchFilter {
+public:
+    static constexpr int LAST_ANTE = 2;
+    static constexpr int BUDGETS[3] = {0, 5, 10};
+
+    int apply(const std::string& seed, std::ostream& debugOut = std::cout) override {
+        (void)debugOut;
+        ShopStream::Lookahead shop(seed, getGlobalEnv());
+        return level(shop, nullptr);
+    }
+
+    std::vector<std::string> getResultNames() const override {
+        return {"Blueprint without rerolls", "Blueprint within 5 rerolls", "Blueprint within 10 rerolls"};
+    }
+
+    std::string getName() const override {
+        return "Blueprint Reroll Filter";
+    }
+
+    std::string describeMatch(const std::string& seed) const override {
+        ShopStream::Lookahead shop(seed, getGlobalEnv());
+        ShopStream::Hit hit;
+        const int idx = level(shop, &hit);
+        if (!idx) return std::string();
+        std::ostringstream out;
+        out << "{\"index\": " << idx << ", \"name\": \"Blueprint Reroll Filter\", \"cards\": ["
+            << "{\"name\": \"Blueprint\", \"slot\": \"joker\", \"position\": " << hit.slot.index
+            << ", \"count\": 1, \"turn\": 0, \"when\": \"shop_joker\", \"ante\": " << hit.slot.ante
+            << ", \"visit\": " << hit.slot.visit << ", \"reroll\": " << hit.slot.reroll << "}]}";
+        return out.str();
+    }
+
+private:
+    // Smallest budget that reaches a Blueprint; larger budgets reuse the cards already drawn
+    static int level(ShopStream::Lookahead& shop, ShopStream::Hit* hit) {
+        for (int i = 0; i < 3; i++) {
+            if (shop.findJoker(Items::Joker::BLUEPRINT, 1, LAST_ANTE, BUDGETS[i], hit)) return i + 1;
+        }
+        return 0;
+    }
+};
+
+constexpr int BlueprintRerollFilter::BUDGETS[3];
+
+#define SELECTED_FILTER_TYPE BlueprintRerollFilter
+
+std::unique_ptr<SearchFilter> createFilter() {
+    return std::make_unique<BlueprintRerollFilter>();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "filter_base.hpp"
+#include "../run_engine.hpp"
+#include <sstream>
+
+// Perkeo from The Soul within the first three antes, found by playing the run
+// with RunEngine: every Charm or Ethereal Tag is taken by skipping its blind,
+// every Arcana and Spectral pack in the shops is opened, and every Soul is
+// used. The shop queue is never generated: nothing in it can be a Soul, and
+// no joker is bought from it.
+class DeepPerkeoFilter final : public SearchFilter {
+public:
+    static constexpr int ANTES = 3;
+
+    struct SoulPolicy : RunEngine::Policy {
+        int perkeoAnte = 0;           // Ante Perkeo was gained in, 0 if not yet
+        std::string source;           // How the Soul's pack was reached
+
+        bool skip(RunEngine::State&, RunEngine::Blind, Items::Tag tag) {
+            return tag == Items::Tag::CHARM_TAG || tag == Items::Tag::ETHEREAL_TAG;
+        }
+        bool buyVoucher(RunEngine::State&, Items::Voucher) { return false; }
+        bool open(RunEngine::State&, Items::Pack offer) {
+            const Items::Pack type = Items::convertPackData(offer).type;
+            return type == Items::Pack::ARCANA_PACK || type == Items::Pack::SPECTRAL_PACK;
+        }
+        uint32_t pick(RunEngine::State&, const RunEngine::Pack& pack) {
+            uint32_t mask = 0;
+            for (int i = 0; i < pack.size; i++) {
+                const RunEngine::Card& c = pack.cards[i];
+                if ((c.type == RunEngine::Card::Type::TAROT && c.item.tarot == Items::Tarot::SPECIAL_THE_SOUL) ||
+                    (c.type == RunEngine::Card::Type::SPECTRAL && c.item.spectral == Items::Spectral::SPECTRAL_THE_SOUL)) {
+                    mask |= 1u << i;
+                }
+            }
+            if (mask) source = std::string(Items::toString(pack.offer)) + (pack.fromTag ? " (tag)" : " (shop)");
+            return mask;
+        }
+        void gained(RunEngine::State& s, const Items::OptimizedJokerData& joker, RunEngine::Source) {
+            if (joker.joker != Items::Joker::PERKEO) return;
+            perkeoAnte = s.ante;
+            s.stop();
+        }
+    };
+
+    static RunEngine::Config config() {
+        RunEngine::Config c;
+        c.antes = ANTES;
+        c.shopSlots = 0;
+        return c;
+    }
+
+    int apply(const std::string& seed, std::ostream& debugOut = std::cout) override {
+        (void)debugOut;
+        SoulPolicy policy;
+        RunEngine::Engine<SoulPolicy> engine(policy, config());
+        engine.run(seed, getGlobalEnv());
+        return policy.perkeoAnte;
+    }
+
+    std::vector<std::string> getResultNames() const override {
+        return {"Perkeo by ante 1", "Perkeo by ante 2", "Perkeo by ante 3"};
+    }
+
+    std::string getName() const override {
+        return "Deep Perkeo Filter";
+    }
+
+    std::string describeMatch(const std::string& seed) const override {
+        SoulPolicy policy;
+        RunEngine::Engine<SoulPolicy> engine(policy, config());
+        engine.run(seed, getGlobalEnv());
+        if (!policy.perkeoAnte) return std::string();
+        std::ostringstream out;
+        out << "{\"index\": " << policy.perkeoAnte << ", \"name\": \"Deep Perkeo Filter\", \"cards\": ["
+            << "{\"name\": \"Perkeo\", \"slot\": \"joker\", \"position\": -1, \"count\": 1, \"turn\": 0, \"when\": \"pack_open\", "
+            << "\"ante\": " << policy.perkeoAnte << ", \"pack\": \"" << policy.source << "\"}]}";
+        return out.str();
+    }
+};
+
+#define SELECTED_FILTER_TYPE DeepPerkeoFilter
+
+std::unique_ptr<SearchFilter> createFilter() {
+    return std::make_unique<DeepPerkeoFilter>();
+}
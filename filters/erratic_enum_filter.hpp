@@ -1,11 +1,14 @@
 #pragma once
 
 #include "filter_base.hpp"
+#include "../starting_deck.hpp"
 
 // Erratic Deck synergy search across early shop items (ante 1)
 // Sets deck to "Erratic Deck" and looks for combos that benefit from
 // randomized ranks/suits: Smeared packages, suit scalers + suit conversion,
 // face engines with Pareidolia, straight/flush enablers, and parity engines.
+// The last levels also read the seed's starting deck (starting_deck.hpp),
+// which is only generated once the shop holds the joker they need.
 
 std::unique_ptr<SearchFilter> createFilter() {
     auto filterFunc = [](const std::string& seed, std::ostream& debugOut) -> int {
@@ -88,6 +91,26 @@ std::unique_ptr<SearchFilter> createFilter() {
         // Bonus: Four Fingers + Superposition (straight/Ace synergy)
         if (has(Items::Joker::SUPERPOSITION) && (four_fingers || has(Items::Joker::SHORTCUT))) return 12;
 
+        // Deck-dependent payoffs: the shop joker first, then the deck it needs
+        const bool hack = has(Items::Joker::HACK);
+        if (!suit_scaler && !has(Items::Joker::ROUGH_GEM) && !face_support && !hack) return 0;
+        static const StartingDeck::Generator erratic(StartingDeck::Type::ERRATIC);
+        StartingDeck::Deck deck;
+        erratic.generate(seed, deck);
+
+        // Suit scaler for a suit holding 18+ of the 52 cards (13 on average)
+        using StartingDeck::Suit;
+        const Suit top = deck.topSuit();
+        if (deck.count(top) >= 18) {
+            const bool scales = (top == Suit::DIAMONDS && (has(Items::Joker::GREEDY_JOKER) || has(Items::Joker::ROUGH_GEM)))
+                             || (top == Suit::HEARTS && (has(Items::Joker::LUSTY_JOKER) || has(Items::Joker::BLOODSTONE)))
+                             || (top == Suit::SPADES && (has(Items::Joker::WRATHFUL_JOKER) || has(Items::Joker::ARROWHEAD)))
+                             || (top == Suit::CLUBS && (has(Items::Joker::GLUTTONOUS_JOKER) || has(Items::Joker::ONYX_AGATE)));
+            if (scales) return 13;
+        }
+        if (face_support && deck.faces() >= 16) return 14; // 12 on average
+        if (hack && deck.countRanks(StartingDeck::Rank::TWO, StartingDeck::Rank::FIVE) >= 20) return 15; // 16 on average
+
         return 0; // No synergy found
     };
 
@@ -105,7 +128,10 @@ std::unique_ptr<SearchFilter> createFilter() {
             "Arrowhead + The World",
             "Bloodstone + The Sun",
             "Rough Gem + The Star",
-            "Superposition + Straight enabler"
+            "Superposition + Straight enabler",
+            "Suit scaler + 18-card suit",
+            "Face payoff + 16 faces",
+            "Hack + 20 low cards"
         },
         "Erratic Synergy Filter"
     );
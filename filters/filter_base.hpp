@@ -27,6 +27,33 @@ struct FilterResult {
     }
 };
 
+// Non-owning view over a contiguous range (std::span needs C++20)
+template<typename T>
+class Span {
+public:
+    Span() : ptr(nullptr), len(0) {}
+    Span(T* p, size_t n) : ptr(p), len(n) {}
+
+    T* data() const { return ptr; }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    T& operator[](size_t i) const { return ptr[i]; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + len; }
+    Span subspan(size_t offset, size_t count) const { return Span(ptr + offset, count); }
+
+private:
+    T* ptr;
+    size_t len;
+};
+
+// Numeric ranking of one seed, used by --top-k instead of logging every hit
+struct FilterScore {
+    double value = 0;      // Higher ranks first
+    uint16_t level = 0;    // apply()'s level for the seed; 0 means it is not a candidate
+    uint64_t payload = 0;  // Filter-defined compact detail (e.g. one bit per matched rule)
+};
+
 // Abstract base class for search filters
 class SearchFilter {
 public:
@@ -40,6 +67,27 @@ public:
         (void)seed; // unused in default
         return std::string();
     }
+    // Optional: evaluate several independent seeds in one call, writing apply()'s
+    // result for seeds[i] to levels[i]. Filters override this to interleave the
+    // seeds through their generator steps; results must match apply() exactly.
+    virtual void applyBatch(Span<const std::string> seeds, Span<uint16_t> levels) {
+        for (size_t i = 0; i < seeds.size(); i++) {
+            levels[i] = static_cast<uint16_t>(apply(seeds[i]));
+        }
+    }
+    // Optional: score a seed for --top-k. The default gives every match the
+    // same score, so the kept seeds are simply the lowest-numbered matches.
+    virtual FilterScore score(const std::string& seed) {
+        FilterScore s;
+        s.level = static_cast<uint16_t>(apply(seed));
+        s.value = s.level > 0 ? 1 : 0;
+        return s;
+    }
+    // Optional: readable form of a score payload for the top-K file
+    virtual std::string describePayload(uint64_t payload) const {
+        (void)payload;
+        return std::string();
+    }
 };
 
 // Generic function pointer filter for custom filters
@@ -48,6 +96,8 @@ private:
     std::function<int(const std::string&, std::ostream&)> filterFunc;
     std::vector<std::string> resultNames;
     std::string filterName;
+    std::function<FilterScore(const std::string&)> scoreFunc;
+    std::function<std::string(uint64_t)> payloadFunc;
 
 public:
     CustomFilter(std::function<int(const std::string&, std::ostream&)> func,
@@ -66,6 +116,21 @@ public:
     std::string getName() const override {
         return filterName;
     }
+
+    // Optional scorer for --top-k; without one the base class default applies
+    void setScoring(std::function<FilterScore(const std::string&)> score,
+                    std::function<std::string(uint64_t)> describe = nullptr) {
+        scoreFunc = std::move(score);
+        payloadFunc = std::move(describe);
+    }
+
+    FilterScore score(const std::string& seed) override {
+        return scoreFunc ? scoreFunc(seed) : SearchFilter::score(seed);
+    }
+
+    std::string describePayload(uint64_t payload) const override {
+        return payloadFunc ? payloadFunc(payload) : std::string();
+    }
 };
 
 // Utility function to create a custom filter with lambda
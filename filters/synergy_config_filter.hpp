@@ -325,9 +325,14 @@ std::unique_ptr<SearchFilter> createFilter() {
     std::vector<std::string> names;
     for (const auto& r : m.rules) names.push_back(r.name);
 
-    auto filterFunc = [m = std::move(m)](const std::string& seed, std::ostream& debugOut) -> int {
-        return m.matchFirst(seed, debugOut);
+    // Shared by apply() and the --top-k scorer, which counts every matching rule
+    auto matcher = std::make_shared<Matcher>(std::move(m));
+    auto filterFunc = [matcher](const std::string& seed, std::ostream& debugOut) -> int {
+        return matcher->matchFirst(seed, debugOut);
     };
 
-    return createCustomFilter(filterFunc, names, "Synergy Config Filter");
+    auto filter = std::make_unique<CustomFilter>(filterFunc, names, "Synergy Config Filter");
+    filter->setScoring([matcher](const std::string& seed) { return matcher->score(seed); },
+                       [matcher](uint64_t payload) { return matcher->describe(payload); });
+    return filter;
 }
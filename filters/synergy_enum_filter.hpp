@@ -166,7 +166,7 @@ static int detect_synergy(const std::string& seed) {
     }
 }
 
-class SynergyEnumFilter : public SearchFilter {
+class SynergyEnumFilter final : public SearchFilter {
 public:
     int apply(const std::string& seed, std::ostream& debugOut = std::cout) override {
         return detect_synergy(seed);
@@ -278,6 +278,8 @@ public:
     }
 };
 
+#define SELECTED_FILTER_TYPE SynergyEnumFilter
+
 std::unique_ptr<SearchFilter> createFilter() {
     return std::make_unique<SynergyEnumFilter>();
 }
@@ -50,6 +50,47 @@ public:
 
     // Evaluate rules for a seed. Returns index+1 of first matching rule, or 0
     int matchFirst(const std::string& seed, std::ostream& debugOut = std::cout) const {
+        (void)debugOut;
+        int first = 0;
+        evaluate(seed, [&](size_t ri) {
+            first = static_cast<int>(ri) + 1;
+            return false;
+        });
+        return first;
+    }
+
+    // Evaluates every rule for --top-k. The score is the number of matched
+    // rules, the level is the first match (as matchFirst), and bit i of the
+    // payload is set when rule i matched (rules past 64 only score).
+    FilterScore score(const std::string& seed) const {
+        FilterScore s;
+        evaluate(seed, [&](size_t ri) {
+            if (!s.level) s.level = static_cast<uint16_t>(ri + 1);
+            s.value += 1;
+            if (ri < 64) s.payload |= uint64_t(1) << ri;
+            return true;
+        });
+        return s;
+    }
+
+    // Names of the rules set in a score payload, separated by "; "
+    std::string describe(uint64_t payload) const {
+        std::string out;
+        for (size_t ri = 0; ri < rules.size() && ri < 64; ++ri) {
+            if (!(payload >> ri & 1)) continue;
+            if (!out.empty()) out += "; ";
+            out += rules[ri].name;
+        }
+        return out;
+    }
+
+    std::vector<Rule> rules;
+    int scanCount{28};
+
+private:
+    // Calls onMatch(ruleIndex) for each matching rule in order until it returns false
+    template<typename OnMatch>
+    void evaluate(const std::string& seed, OnMatch onMatch) const {
         Instance::Instance inst(seed);
         // Apply global env like the other filters do
         {
@@ -97,7 +138,7 @@ public:
     voucherOpt = (static_cast<int>(anteVoucher) == static_cast<int>(Items::Voucher::INVALID)) ? -1 : static_cast<int>(anteVoucher);
     tagOpt = (static_cast<int>(anteTag) == static_cast<int>(Items::Tag::INVALID)) ? -1 : static_cast<int>(anteTag);
 
-        // Evaluate rules in order; first match wins. Rules may use predicate for advanced checks.
+        // Evaluate rules in order. Rules may use predicate for advanced checks.
         for (size_t ri = 0; ri < rules.size(); ++ri) {
             const Rule& r = rules[ri];
 
@@ -154,14 +195,9 @@ public:
             }
 
             // matched
-            return static_cast<int>(ri) + 1;
+            if (!onMatch(ri)) return;
         }
-
-        return 0;
     }
-
-    std::vector<Rule> rules;
-    int scanCount{28};
 };
 
 } // namespace Synergy
@@ -74,6 +74,57 @@ class ProcessRunner:
         return ''.join(lines)
 
 
+class ServeClient:
+    # One long-lived `immolate_<filter> --serve` process answering JSON-line
+    # requests, so describes and evaluations skip process startup. Restarted
+    # when the binary is rebuilt; gives up on binaries without --serve.
+    def __init__(self, exe):
+        self.exe = exe
+        self.proc = None
+        self.mtime = None
+        self.unsupported = False
+        self.next_id = 0
+        self.lock = threading.Lock()
+
+    def request(self, cmd, **fields):
+        # Returns the result, or None if the request failed or the server is unavailable
+        with self.lock:
+            if self.unsupported or not os.path.exists(self.exe):
+                return None
+            mtime = os.path.getmtime(self.exe)
+            if self.proc is not None and (self.proc.poll() is not None or mtime != self.mtime):
+                self.close()
+            started = self.proc is None
+            if started:
+                self.proc = subprocess.Popen([self.exe, '--serve'], cwd=REPO_ROOT, stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                             stderr=subprocess.DEVNULL, text=True, bufsize=1)
+                self.mtime = mtime
+            self.next_id += 1
+            fields.update(id=self.next_id, cmd=cmd)
+            try:
+                self.proc.stdin.write(json.dumps(fields) + '\n')
+                self.proc.stdin.flush()
+                line = self.proc.stdout.readline()
+                resp = json.loads(line) if line else None
+            except (OSError, ValueError):
+                resp = None
+            if resp is None:
+                # A fresh process that cannot answer predates --serve
+                self.unsupported = started
+                self.close()
+                return None
+            return resp.get('result') if resp.get('ok') else None
+
+    def close(self):
+        if self.proc is not None:
+            try:
+                self.proc.stdin.close()
+                self.proc.wait(timeout=3)
+            except Exception:
+                self.proc.kill()
+        self.proc = None
+
+
 class App:
     def __init__(self, root: Tk):
         self.root = root
@@ -274,6 +325,9 @@ class App:
         row += 1
         self.run_output = scrolledtext.ScrolledText(frm, height=18, wrap='word')
         self.run_output.grid(column=0, row=row, columnspan=5, sticky='nsew')
+        # Live status from the --metrics-fd JSON stream
+        self.metrics_var = StringVar(value='')
+        ttk.Label(frm, textvariable=self.metrics_var, anchor='w').grid(column=0, row=row + 1, columnspan=5, sticky='w', pady=(4,0))
 
         frm.columnconfigure(1, weight=1)
         frm.rowconfigure(row, weight=1)
@@ -366,10 +420,45 @@ class App:
             # swallow UI errors during background polling
             pass
 
+    def _format_metrics(self, m):
+        """One status line from a {"type": "metrics"} record."""
+        eta = m.get('eta_s', -1)
+        if m.get('done'):
+            eta_text = 'done'
+        elif eta is None or eta < 0:
+            eta_text = 'ETA calculating...'
+        else:
+            eta = int(eta)
+            eta_text = f'ETA {eta // 86400}d {eta % 86400 // 3600}h {eta % 3600 // 60}m'
+        matches = ', '.join(f"{lv.get('name')}: {lv.get('count')}" for lv in m.get('levels', []))
+        return (f"{int(m.get('seeds', 0)):,} seeds | {m.get('rate_smoothed', 0):,.0f} seeds/s | "
+                f"{100.0 * m.get('progress', 0):.6f}% | {eta_text} | {matches}")
+
+    def _take_metrics_lines(self, out):
+        """Removes metrics records from process output and shows the latest one in the status line."""
+        rest = []
+        latest = None
+        for line in out.splitlines(keepends=True):
+            if line.startswith('{"type": "metrics"'):
+                try:
+                    latest = json.loads(line)
+                    continue
+                except Exception:
+                    pass
+            rest.append(line)
+        if latest is not None:
+            try:
+                self.metrics_var.set(self._format_metrics(latest))
+            except Exception:
+                pass
+        return ''.join(rest)
+
     def poll_outputs(self):
         # Update UI with any process output
         if self.process_runner:
             out = self.process_runner.read_available()
+            if out:
+                out = self._take_metrics_lines(out)
             if out:
                 self.append_run(out)
                 # Detect match name printed by debug mode: 'Match Name: <name>\n'
@@ -485,6 +574,11 @@ class App:
                 pass
         if threads > 0 and not debug:
             args += ['--threads', str(threads)]
+        if not debug:
+            # Structured progress instead of the redrawn statistics screen
+            args += ['--quiet', '--metrics-fd', '1']
+            # Describe matches during the run so picking one needs no extra process
+            args += ['--describe']
         # If requested, find latest env file for this filter and pass --env
         if self.use_latest_env_var.get():
             import glob
@@ -529,6 +623,7 @@ class App:
             args += ['--debug']
 
         self.run_output.delete('1.0', 'end')
+        self.metrics_var.set('')
         try:
             self.process_runner.start(args, cwd=REPO_ROOT)
             self.append_run('Process started...\n')
@@ -1583,11 +1678,9 @@ class App:
 
                         def fetch_and_show(seeds_list, filt_name):
                             results = []
+                            described = self._describe_seeds(seeds_list, filt_name)
                             for s in seeds_list:
-                                try:
-                                    j = self._describe_match_for_seed(s, filt_name)
-                                except Exception:
-                                    j = None
+                                j = described.get(s)
                                 # keep the parsed JSON so the details UI can inspect structured fields
                                 results.append((s, j))
 
@@ -1940,7 +2033,109 @@ class App:
             except Exception:
                 pass
 
+    def _filter_name(self, filt):
+        # The filter name the binary writes into describe records; None if it cannot be asked
+        names = self.__dict__.setdefault('_filter_names', {})
+        if filt not in names:
+            status = self._serve_client(filt).request('status')
+            name = status.get('filter') if isinstance(status, dict) else None
+            if name is None:
+                return None  # Asked again next time, e.g. once the binary is built
+            names[filt] = name
+        return names[filt]
+
+    def _cached_describe(self, seed, filt):
+        # Look the seed up in the dist/*.describe.jsonl files written by --describe runs,
+        # using only records of this filter. Each file is parsed once and reparsed only
+        # when its mtime changes.
+        import glob
+        name = self._filter_name(filt)
+        if name is None:
+            return None
+        cache = self.__dict__.setdefault('_describe_cache', {})
+        files = glob.glob(os.path.join(DIST_DIR, '*.describe.jsonl'))
+        for path in sorted(files, key=os.path.getmtime, reverse=True):
+            try:
+                mtime = os.path.getmtime(path)
+                entry = cache.get(path)
+                if entry is None or entry[0] != mtime:
+                    by_filter = {}
+                    with open(path, 'r', encoding='utf-8', errors='replace') as f:
+                        for line in f:
+                            try:
+                                rec = json.loads(line)
+                            except ValueError:
+                                continue  # A line still being written
+                            # Records from before the "filter" field cannot be attributed
+                            if isinstance(rec.get('describe'), dict) and 'filter' in rec:
+                                by_filter.setdefault(rec['filter'], {})[rec.get('seed', '')] = rec['describe']
+                    entry = (mtime, by_filter)
+                    cache[path] = entry
+                found = entry[1].get(name, {}).get(seed)
+                if found is not None:
+                    return found
+            except OSError:
+                continue
+        return None
+
+    def _describe_seeds(self, seeds, filt):
+        # Describe several seeds at once: cached --describe output first, then one
+        # --describe-batch process for the rest. Returns {seed: describe JSON or None}.
+        out = {}
+        missing = []
+        for s in seeds:
+            cached = self._cached_describe(s, filt)
+            if cached is not None:
+                out[s] = cached
+            else:
+                missing.append(s)
+        if missing:
+            records = self._serve_client(filt).request('describe', seeds=missing)
+            for rec in records or []:
+                d = rec.get('describe')
+                if d is None:
+                    d = {'index': rec.get('level', 0), 'name': rec.get('name', '')}
+                out[rec.get('seed', '')] = d
+            missing = [s for s in missing if s not in out]
+        exe = os.path.join(DIST_DIR, f'immolate_{filt}.exe' if os.name == 'nt' else f'immolate_{filt}')
+        if missing and os.path.exists(exe):
+            try:
+                res = subprocess.run([exe, '--describe-batch', '-', '--quiet'], cwd=REPO_ROOT, input='\n'.join(missing) + '\n',
+                                     capture_output=True, text=True, timeout=30 + len(missing) // 100)
+                for line in res.stdout.splitlines():
+                    try:
+                        rec = json.loads(line)
+                    except ValueError:
+                        continue
+                    d = rec.get('describe')
+                    if d is None:
+                        # Same fallback object --describe-match prints
+                        d = {'index': rec.get('level', 0), 'name': rec.get('name', '')}
+                    out[rec.get('seed', '')] = d
+            except Exception:
+                pass
+        for s in seeds:
+            if s not in out:
+                try:
+                    out[s] = self._describe_match_for_seed(s, filt)
+                except Exception:
+                    out[s] = None
+        return out
+
+    def _serve_client(self, filt):
+        # The warm --serve process for a filter, started on first use
+        clients = self.__dict__.setdefault('_serve_clients', {})
+        if filt not in clients:
+            clients[filt] = ServeClient(os.path.join(DIST_DIR, f'immolate_{filt}.exe' if os.name == 'nt' else f'immolate_{filt}'))
+        return clients[filt]
+
     def _describe_match_for_seed(self, seed, filt):
+        cached = self._cached_describe(seed, filt)
+        if cached is not None:
+            return cached
+        served = self._serve_client(filt).request('describe', seed=seed)
+        if served is not None:
+            return served
         # Run the compiled exe with --describe-match --seed <seed> and parse JSON
         exe = os.path.join(DIST_DIR, f'immolate_{filt}.exe' if os.name == 'nt' else os.path.join(DIST_DIR, f'immolate_{filt}'))
         if not os.path.exists(exe):
@@ -0,0 +1,286 @@
+#pragma once
+
+// Hot-path instrumentation, compiled out unless ENABLE_HOT_COUNTERS is
+// defined (HOT_COUNTERS=1 sh tools/build.sh <filter>). Every macro below
+// expands to nothing in a normal build.
+//
+//   HOT_COUNT(HotCounters::GET_NODE)      bump an event counter
+//   HOT_COUNT_N(HotCounters::SEEDS, n)    add n to it
+//   HOT_STAGES(timer)                     start cycle timing of filter stages
+//   HOT_STAGE_NEXT(timer, "arcana")       close the previous stage, open the next
+//   HOT_SEED_BEGIN() / HOT_SEED_END(seed) bracket one seed for outlier tracking
+//
+// Counters are per thread. A thread bumps its own counters with plain
+// relaxed loads and stores, so there is no locked instruction on the hot
+// path. report() sums every live thread plus the threads that already
+// exited. Stage timings are rdtsc reference cycles. A seed whose resample
+// count reaches PATHOLOGICAL_RESAMPLES, or that hits the 1000-resample cap,
+// is kept in a small per-thread list of outliers.
+
+#ifdef ENABLE_HOT_COUNTERS
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace HotCounters {
+
+    enum Counter : int {
+        GET_NODE,          // Instance::get_node calls
+        NODE_MISS,         // ... that hashed a new key into the node cache
+        RESAMPLE,          // Resample draws in enum_randchoice / pack choice
+        RESAMPLE_CAP,      // Resample loops that gave up at 1000
+        LUA_RANDOM,        // LuaRandom constructions (full 10-step warm-up)
+        GEN_TAROT,
+        GEN_PLANET,
+        GEN_SPECTRAL,
+        GEN_JOKER,
+        GEN_TAG,
+        GEN_VOUCHER,
+        GEN_BOSS,
+        GEN_SHOP_ITEM,
+        GEN_PACK,
+        GEN_STANDARD_CARD,
+        GEN_ARCANA_PACK,
+        GEN_CELESTIAL_PACK,
+        GEN_SPECTRAL_PACK,
+        GEN_BUFFOON_PACK,
+        GEN_STANDARD_PACK,
+        SEEDS,             // Seeds bracketed by HOT_SEED_BEGIN/END
+        COUNTER_COUNT
+    };
+
+    inline const char* counterName(int c) {
+        static const char* const names[COUNTER_COUNT] = {
+            "get_node", "get_node_miss", "resample", "resample_cap_hit", "lua_random_construct",
+            "nextTarot", "nextPlanet", "nextSpectral", "nextJoker", "nextTag", "nextVoucher", "nextBoss",
+            "nextShopItem", "nextPack", "nextStandardCard", "nextArcanaPack", "nextCelestialPack",
+            "nextSpectralPack", "nextBuffoonPack", "nextStandardPack", "seeds"};
+        return names[c];
+    }
+
+    constexpr int MAX_STAGES = 32;
+    constexpr uint64_t PATHOLOGICAL_RESAMPLES = 64;
+    constexpr size_t MAX_OUTLIERS = 16;
+
+    inline uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    struct Outlier {
+        std::string seed;
+        uint64_t resamples;
+        bool capHit;
+    };
+
+    // One thread's counters; only the owning thread writes them
+    struct ThreadCounters {
+        std::atomic<uint64_t> counts[COUNTER_COUNT];
+        std::atomic<uint64_t> stageCycles[MAX_STAGES];
+        std::atomic<uint64_t> stageCalls[MAX_STAGES];
+        uint64_t seedResampleStart = 0;
+        uint64_t seedCapStart = 0;
+        std::mutex outlierMutex;  // Taken only when a seed is flagged, and by report()
+        std::vector<Outlier> outliers;
+
+        ThreadCounters() {
+            for (auto& c : counts) c.store(0, std::memory_order_relaxed);
+            for (auto& c : stageCycles) c.store(0, std::memory_order_relaxed);
+            for (auto& c : stageCalls) c.store(0, std::memory_order_relaxed);
+        }
+
+        void add(std::atomic<uint64_t>& c, uint64_t n) {
+            c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    };
+
+    // Keeps the `MAX_OUTLIERS` seeds with the most resamples
+    inline void keepOutlier(std::vector<Outlier>& list, const Outlier& o) {
+        list.push_back(o);
+        std::sort(list.begin(), list.end(), [](const Outlier& a, const Outlier& b) { return a.resamples > b.resamples; });
+        if (list.size() > MAX_OUTLIERS) list.resize(MAX_OUTLIERS);
+    }
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadCounters*> live;
+        ThreadCounters retired;  // Totals of threads that have exited
+        std::vector<std::string> stageNames;
+    };
+
+    inline Registry& registry() {
+        static Registry* r = new Registry();  // Never destroyed: threads may exit after main returns
+        return *r;
+    }
+
+    // Registers the calling thread on first use and folds it into `retired` on exit
+    class ThreadSlot {
+    public:
+        ThreadSlot() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lk(r.mutex);
+            r.live.push_back(&counters);
+        }
+        ~ThreadSlot() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lk(r.mutex);
+            for (int i = 0; i < COUNTER_COUNT; i++) r.retired.add(r.retired.counts[i], counters.counts[i].load());
+            for (int i = 0; i < MAX_STAGES; i++) {
+                r.retired.add(r.retired.stageCycles[i], counters.stageCycles[i].load());
+                r.retired.add(r.retired.stageCalls[i], counters.stageCalls[i].load());
+            }
+            for (const auto& o : counters.outliers) keepOutlier(r.retired.outliers, o);
+            r.live.erase(std::remove(r.live.begin(), r.live.end(), &counters), r.live.end());
+        }
+        ThreadCounters counters;
+    };
+
+    inline ThreadCounters& local() {
+        thread_local ThreadSlot slot;
+        return slot.counters;
+    }
+
+    inline void count(Counter c, uint64_t n = 1) {
+        ThreadCounters& t = local();
+        t.add(t.counts[c], n);
+    }
+
+    // Index of a named stage; stages past MAX_STAGES share the last slot
+    inline int stageId(const char* name) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.mutex);
+        for (size_t i = 0; i < r.stageNames.size(); i++) {
+            if (r.stageNames[i] == name) return static_cast<int>(i);
+        }
+        if (r.stageNames.size() == MAX_STAGES - 1) r.stageNames.push_back("(other)");
+        if (r.stageNames.size() >= MAX_STAGES) return MAX_STAGES - 1;
+        r.stageNames.push_back(name);
+        return static_cast<int>(r.stageNames.size() - 1);
+    }
+
+    // Times consecutive stages of one filter call; the open stage closes on destruction
+    class StageTimer {
+    public:
+        StageTimer() : t(local()) {}
+        ~StageTimer() { close(); }
+        void next(int id) {
+            close();
+            stage = id;
+            start = readTsc();
+        }
+
+    private:
+        void close() {
+            if (stage < 0) return;
+            t.add(t.stageCycles[stage], readTsc() - start);
+            t.add(t.stageCalls[stage], 1);
+            stage = -1;
+        }
+        ThreadCounters& t;
+        int stage = -1;
+        uint64_t start = 0;
+    };
+
+    inline void seedBegin() {
+        ThreadCounters& t = local();
+        t.seedResampleStart = t.counts[RESAMPLE].load(std::memory_order_relaxed);
+        t.seedCapStart = t.counts[RESAMPLE_CAP].load(std::memory_order_relaxed);
+    }
+
+    inline void seedEnd(const std::string& seed) {
+        ThreadCounters& t = local();
+        t.add(t.counts[SEEDS], 1);
+        const uint64_t resamples = t.counts[RESAMPLE].load(std::memory_order_relaxed) - t.seedResampleStart;
+        const bool capHit = t.counts[RESAMPLE_CAP].load(std::memory_order_relaxed) != t.seedCapStart;
+        if (resamples >= PATHOLOGICAL_RESAMPLES || capHit) {
+            std::lock_guard<std::mutex> lk(t.outlierMutex);
+            keepOutlier(t.outliers, {seed, resamples, capHit});
+        }
+    }
+
+    // Totals over all threads, live and exited
+    inline void report(std::ostream& out) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.mutex);
+        std::vector<uint64_t> counts(COUNTER_COUNT), cycles(MAX_STAGES), calls(MAX_STAGES);
+        std::vector<Outlier> outliers = r.retired.outliers;
+        std::vector<ThreadCounters*> all = r.live;
+        all.push_back(&r.retired);
+        for (ThreadCounters* t : all) {
+            for (int i = 0; i < COUNTER_COUNT; i++) counts[i] += t->counts[i].load(std::memory_order_relaxed);
+            for (int i = 0; i < MAX_STAGES; i++) {
+                cycles[i] += t->stageCycles[i].load(std::memory_order_relaxed);
+                calls[i] += t->stageCalls[i].load(std::memory_order_relaxed);
+            }
+            if (t != &r.retired) {
+                std::lock_guard<std::mutex> olk(t->outlierMutex);
+                for (const auto& o : t->outliers) keepOutlier(outliers, o);
+            }
+        }
+
+        const double seeds = counts[SEEDS] ? static_cast<double>(counts[SEEDS]) : 0;
+        out << "=== Hot-path counters (" << r.live.size() << " live threads) ===" << std::endl;
+        out << std::fixed << std::setprecision(3);
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+            if (!counts[i] || i == SEEDS) continue;
+            out << "  " << std::left << std::setw(22) << counterName(i) << std::right << std::setw(16) << counts[i];
+            if (seeds > 0) out << std::setw(14) << counts[i] / seeds << " /seed";
+            out << std::endl;
+        }
+        out << "  " << std::left << std::setw(22) << "seeds" << std::right << std::setw(16) << counts[SEEDS] << std::endl;
+        if (counts[GET_NODE]) {
+            out << "  node cache miss rate   " << std::setprecision(2)
+                << 100.0 * counts[NODE_MISS] / counts[GET_NODE] << "%" << std::endl;
+        }
+        bool header = false;
+        for (size_t i = 0; i < r.stageNames.size(); i++) {
+            if (!calls[i]) continue;
+            if (!header) out << "  stage                           calls    tsc/call     tsc/seed" << std::endl;
+            header = true;
+            out << "  " << std::left << std::setw(24) << r.stageNames[i] << std::right << std::setw(14) << calls[i]
+                << std::setprecision(1) << std::setw(12) << static_cast<double>(cycles[i]) / calls[i] << std::setw(13)
+                << (seeds > 0 ? cycles[i] / seeds : 0.0) << std::endl;
+        }
+        if (!outliers.empty()) {
+            out << "  pathological seeds (>= " << PATHOLOGICAL_RESAMPLES << " resamples or cap hit):" << std::endl;
+            for (const auto& o : outliers) {
+                out << "    " << o.seed << "  " << o.resamples << " resamples" << (o.capHit ? "  (cap hit)" : "") << std::endl;
+            }
+        }
+    }
+}
+
+#define HOT_COUNT(counter) HotCounters::count(counter)
+#define HOT_COUNT_N(counter, n) HotCounters::count(counter, n)
+#define HOT_STAGES(timer) HotCounters::StageTimer timer
+#define HOT_STAGE_NEXT(timer, name)                                    \
+    do {                                                               \
+        static const int hotStageId_ = HotCounters::stageId(name);     \
+        (timer).next(hotStageId_);                                     \
+    } while (0)
+#define HOT_SEED_BEGIN() HotCounters::seedBegin()
+#define HOT_SEED_END(seed) HotCounters::seedEnd(seed)
+
+#else
+
+#define HOT_COUNT(counter) ((void)0)
+#define HOT_COUNT_N(counter, n) ((void)0)
+#define HOT_STAGES(timer) ((void)0)
+#define HOT_STAGE_NEXT(timer, name) ((void)0)
+#define HOT_SEED_BEGIN() ((void)0)
+#define HOT_SEED_END(seed) ((void)0)
+
+#endif
@@ -16,9 +16,15 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <condition_variable>
 #include "rand_util.hpp"
 #include "debug.hpp"
 #include "logger.hpp"
+#include "seed_util.hpp"
 
 #include "filters/filter_base.hpp"
 // Conditional filter inclusion based on preprocessor definition
@@ -26,13 +32,56 @@
 #include SELECTED_FILTER
 #else
 #endif
+#include "search_driver.hpp"
+#include "atomic_file.hpp"
+#include "progress_journal.hpp"
+#include "hot_counters.hpp"
+#include "perf_counters.hpp"
+#include "live_metrics.hpp"
+#include "seed_permutation.hpp"
+#include "top_k.hpp"
+#include "seed_input.hpp"
+#include "describe_pool.hpp"
+#include "query_server.hpp"
 
 #define INLINE_FORCE __attribute__((always_inline)) inline
 
+#ifdef ENABLE_HOT_COUNTERS
+// Set by SIGUSR1; the stats thread prints the counters and clears it
+static volatile std::sig_atomic_t hotReportRequested = 0;
+#endif
+
+// Set by the first Ctrl+C. Workers stop at their next chunk or input batch,
+// and the run still writes out everything found before it.
+static volatile std::sig_atomic_t interruptRequested = 0;
+
+// Installed before any worker starts; a second Ctrl+C exits at once
+void installInterruptHandler() {
+    std::signal(SIGINT, [](int) {
+        if (interruptRequested) std::_Exit(1);
+        interruptRequested = 1;
+    });
+}
+
 struct SearchStats {
     std::atomic<uint64_t> totalSeeds{0};
     std::atomic<uint64_t> currentSeedNumber{0};
     std::vector<FilterResult> results;
+    // Half-open range of seed numbers being searched; the whole seed space
+    // unless --end/--count was given
+    uint64_t rangeStart = 0;
+    uint64_t rangeEnd = SEED_COUNT;
+    bool bounded = false;
+    // --sample: the range holds positions in this permutation of the whole
+    // seed space instead of seed numbers
+    const SeedPermutation* sample = nullptr;
+
+    uint64_t seedNumberAt(uint64_t position) const { return sample ? sample->at(position) : position; }
+
+    // --top-k: matches are scored and only the best K are kept, instead of
+    // one CSV row per match
+    TopK::Collector* topK = nullptr;
+    size_t topKSize = 0;
     
     void initializeResults(const std::vector<std::string>& resultNames) {
         results.clear();
@@ -46,6 +95,30 @@ struct SearchStats {
             results[resultIndex - 1].count.fetch_add(1);
         }
     }
+
+    // Seeds searched by each worker thread, one cache line per counter
+    struct ThreadSeeds {
+        std::atomic<uint64_t> seeds{0};
+        char pad[64 - sizeof(std::atomic<uint64_t>)];
+    };
+    std::unique_ptr<ThreadSeeds[]> threadSeeds;
+    unsigned int threadCount = 0;
+
+    // --perf-counters: hardware event totals per search phase, summed over
+    // the threads whose counters opened. The filter phase is the chunk loop
+    // less match recording. Match recording covers recordMatch() and handing
+    // the chunk back to the tracker. Checkpoint covers the CSV append, fsync
+    // and journal write.
+    enum PerfPhase { PHASE_FILTER, PHASE_MATCH, PHASE_CHECKPOINT, PHASE_COUNT };
+    bool perfEnabled = false;
+    bool perfHas[PerfEventSet::EVENT_COUNT] = {};
+    std::string perfUnavailable;  // Set when --perf-counters was given but nothing could be opened
+    std::atomic<uint64_t> perfSeeds{0};  // Seeds covered by the filter-phase totals
+    std::atomic<uint64_t> perfTotals[PHASE_COUNT][PerfEventSet::EVENT_COUNT] {};
+
+    void addPerf(int phase, const PerfEventSet::Snapshot& delta) {
+        for (int e = 0; e < PerfEventSet::EVENT_COUNT; e++) perfTotals[phase][e] += delta.value[e];
+    }
 };
 
 
@@ -62,7 +135,33 @@ void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [OPTIONS]\n";
     std::cout << "Options:\n";
     std::cout << "  -s, --seed SEED      Start from specific 8-character seed (A-Z, 1-9)\n";
+    std::cout << "      --start N        Start from seed number N (0-based, alternative to --seed)\n";
+    std::cout << "      --end N          Stop before seed number N; the run exits once [start, N) is searched\n";
+    std::cout << "      --count N        Search exactly N seeds from the start (alternative to --end)\n";
     std::cout << "  -t, --threads NUM    Number of threads to use (default: auto-detect)\n";
+    std::cout << "  -r, --resume         Continue from dist/journal_<filter>.txt (exact; falls back to the progress file)\n";
+    std::cout << "      --chunk-size N   Seeds handed to a thread at a time and journaled as a unit (default 65536)\n";
+    std::cout << "      --journal-interval MS  Time between journal checkpoints (default 5000)\n";
+    std::cout << "      --sample N       Search N seeds drawn uniformly from the whole space and estimate match rates\n";
+    std::cout << "      --sample-key K   Permutation key for --sample; the same key gives the same seeds (default 1)\n";
+    std::cout << "      --top-k K        Keep only the K best-scoring seeds (dist/topk_<filter>.csv) instead of every match\n";
+    std::cout << "      --input PATH     Search the seeds listed in PATH (match CSV, text, or binary; - = stdin)\n";
+    std::cout << "      --input-format F auto (binary for .bin files), text or binary\n";
+    std::cout << "      --output PATH    Where --input writes its matches (default dist/refined_<time>.csv; - = stdout),\n";
+    std::cout << "                       or --describe-batch its JSON lines (default stdout)\n";
+    std::cout << "      --ordered        Write --input matches in input order\n";
+    std::cout << "      --describe-batch PATH  Print --describe-match JSON lines for every seed in PATH, in order (- = stdin)\n";
+    std::cout << "      --serve          Answer JSON-lines requests on stdin/stdout (describe, evaluate, simulate, scans)\n";
+    std::cout << "      --serve-socket PATH  Answer the same requests on a Unix socket\n";
+    std::cout << "      --describe       Also write describeMatch() JSON for each match to <csv>.describe.jsonl\n";
+    std::cout << "      --describe-threads N  Low-priority threads for --describe (default 1)\n";
+    std::cout << "      --describe-queue N    Matches waiting for --describe before new ones are marked dropped (default 65536)\n";
+    std::cout << "      --interleave N   Evaluate N seeds per thread together (1-8, default 1)\n";
+    std::cout << "      --perf-counters  Report hardware counters per seed and search phase (Linux perf_event_open)\n";
+    std::cout << "      --metrics-fd FD  Write live metrics as JSON lines to file descriptor FD (1 = stdout)\n";
+    std::cout << "      --metrics-prom PATH  Keep a Prometheus text-format metrics file at PATH\n";
+    std::cout << "      --metrics-interval MS  Time between metrics snapshots (default 1000)\n";
+    std::cout << "  -q, --quiet          Do not redraw the statistics screen\n";
     std::cout << "  -d, --debug          Enable debug mode (requires --seed)\n";
     std::cout << "  -l, --log-level LVL  Set log level (error,warn,info,debug)\n";
     std::cout << "  -v, --verbose        Shortcut for --log-level info\n";
@@ -70,46 +169,116 @@ void printUsage(const char* programName) {
     std::cout << "\nExample:\n";
     std::cout << "  " << programName << " --seed AAAAAAAA --threads 8\n";
     std::cout << "  " << programName << " -s AAAAAAAA -d\n";
+    std::cout << "  " << programName << " --start 1000000000 --count 50000000\n";
+    std::cout << "  " << programName << " --sample 10000000 --threads 8\n";
+    std::cout << "  " << programName << " --input dist/matches_legendary.csv --ordered --output dist/refined.csv\n";
 }
 
 int applyCurrentFilter(const std::string& seed, std::ostream& debugOut) {
     return getCurrentFilter()->apply(seed, debugOut);
 }
 
-uint64_t seedToNumber(const std::string& seed) {
-    const std::string chars = "ABCDEFGHIJKLMNPQRSTUVWXYZ123456789";
-    uint64_t result = 0;
-    uint64_t base = chars.length();
-    
-    for (char c : seed) {
-        size_t pos = chars.find(c);
-        if (pos == std::string::npos) return 0; // Invalid character
-        result = result * base + pos;
+// 95% Wilson score interval for a match rate of `hits` in `n` seeds; it stays
+// meaningful for the very small rates and zero counts rare filters produce
+static void wilsonInterval(uint64_t hits, uint64_t n, double& low, double& high) {
+    const double z = 1.959963984540054;
+    if (n == 0) {
+        low = 0;
+        high = 1;
+        return;
     }
-    return result;
+    const double p = static_cast<double>(hits) / n;
+    const double z2n = z * z / n;
+    const double center = (p + z2n / 2) / (1 + z2n);
+    const double spread = z * std::sqrt(p * (1 - p) / n + z2n / (4.0 * n)) / (1 + z2n);
+    low = hits == 0 ? 0 : std::max(0.0, center - spread);
+    high = hits == n ? 1 : std::min(1.0, center + spread);
 }
 
-std::string numberToSeed(uint64_t number) {
-    const std::string chars = "ABCDEFGHIJKLMNPQRSTUVWXYZ123456789";
-    uint64_t base = chars.length();
-    
-    if (number == 0) return "AAAAAAAA";
-    
-    std::string result;
-    uint64_t temp = number;
-    
-    // Convert to base-33 representation
-    while (temp > 0) {
-        result = chars[temp % base] + result;
-        temp /= base;
+static std::string oneIn(double rate) {
+    if (rate <= 0) return "never";
+    std::ostringstream o;
+    o << "1 in " << std::fixed << std::setprecision(0) << 1 / rate;
+    return o.str();
+}
+
+static std::string formatDuration(double seconds) {
+    const uint64_t s = static_cast<uint64_t>(seconds);
+    std::ostringstream o;
+    o << s / 86400 << "d " << s % 86400 / 3600 << "h " << s % 3600 / 60 << "m";
+    return o.str();
+}
+
+// --sample: each level's match rate over the seeds sampled so far, with its
+// 95% interval and what it projects to over the whole seed space. The
+// sampled positions are a prefix of a random permutation, so the estimate
+// is unbiased however far the run got.
+void printSampleEstimates(const SearchStats& stats, const std::vector<std::string>& resultNames, double seedsPerSecond) {
+    const uint64_t n = stats.totalSeeds.load();
+    if (n == 0) return;
+    std::cout << "Estimated rates (95% interval, " << n << " seeds sampled):" << std::endl;
+    for (size_t i = 0; i < stats.results.size() && i < resultNames.size(); i++) {
+        const uint64_t hits = stats.results[i].count.load();
+        double low, high;
+        wilsonInterval(hits, n, low, high);
+        std::cout << "  " << std::left << std::setw(25) << (resultNames[i] + ":") << std::right << std::setw(14)
+                  << oneIn(static_cast<double>(hits) / n) << "  [" << oneIn(high) << " .. " << oneIn(low) << "]"
+                  << std::fixed << std::setprecision(0) << "  ~" << static_cast<double>(hits) / n * SEED_COUNT
+                  << " in all seeds (" << low * SEED_COUNT << " .. " << high * SEED_COUNT << ")" << std::endl;
     }
-    
-    // Pad to 8 characters
-    while (result.length() < 8) {
-        result = chars[0] + result;
+    if (seedsPerSecond > 0) {
+        std::cout << "Full scan of " << SEED_COUNT << " seeds at this rate: " << formatDuration(SEED_COUNT / seedsPerSecond) << std::endl;
+    }
+}
+
+// Summary printed when a --sample run has evaluated all of its seeds
+void printSampleSummary(const SearchStats& stats, uint64_t expected, uint64_t key, const std::vector<std::string>& resultNames, std::chrono::steady_clock::time_point startTime) {
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const uint64_t total = stats.totalSeeds.load();
+    std::cout << "\n*** SAMPLE COMPLETE ***" << std::endl;
+    std::cout << "Sample:         positions [" << stats.rangeStart << ", " << stats.rangeEnd << ") of the permutation with key " << key << std::endl;
+    std::cout << "Seeds searched: " << total << (total == expected ? "" : " (expected " + std::to_string(expected) + ")") << std::endl;
+    std::cout << "Time:           " << std::fixed << std::setprecision(2) << secs << "s" << std::endl;
+    std::cout << "Rate:           " << std::fixed << std::setprecision(0) << (secs > 0 ? total / secs : 0) << " seeds/s" << std::endl;
+    std::cout << "Matches:" << std::endl;
+    for (size_t i = 0; i < stats.results.size() && i < resultNames.size(); i++) {
+        std::cout << "  " << std::left << std::setw(25) << (resultNames[i] + ":") << stats.results[i].count.load() << std::endl;
+    }
+    printSampleEstimates(stats, resultNames, secs > 0 ? total / secs : 0);
+}
+
+// Per-seed hardware counter averages for each search phase (--perf-counters)
+void displayPerf(const SearchStats& stats) {
+    if (!stats.perfUnavailable.empty()) {
+        std::cout << std::endl << "Perf counters:  unavailable, " << stats.perfUnavailable << std::endl;
+        return;
+    }
+    const uint64_t seeds = stats.perfSeeds.load();
+    if (!stats.perfEnabled || seeds == 0) return;
+    static const char* const phaseNames[SearchStats::PHASE_COUNT] = {"filter", "match recording", "checkpoint"};
+    std::cout << std::endl << "Perf counters per seed:" << std::endl << "  " << std::left << std::setw(17) << "phase" << std::right;
+    for (int e = 0; e < PerfEventSet::EVENT_COUNT; e++) {
+        std::cout << std::setw(14) << PerfEventSet::eventName(e);
+        if (e == PerfEventSet::INSTRUCTIONS) std::cout << std::setw(7) << "IPC";
+    }
+    std::cout << std::endl;
+    for (int p = 0; p < SearchStats::PHASE_COUNT; p++) {
+        std::cout << "  " << std::left << std::setw(17) << phaseNames[p] << std::right;
+        for (int e = 0; e < PerfEventSet::EVENT_COUNT; e++) {
+            std::cout << std::setw(14);
+            if (stats.perfHas[e]) std::cout << std::fixed << std::setprecision(e <= PerfEventSet::INSTRUCTIONS ? 1 : 3)
+                                            << static_cast<double>(stats.perfTotals[p][e].load()) / seeds;
+            else std::cout << "n/a";
+            if (e == PerfEventSet::INSTRUCTIONS) {
+                const uint64_t cycles = stats.perfTotals[p][PerfEventSet::CYCLES].load();
+                std::cout << std::setw(7);
+                if (stats.perfHas[PerfEventSet::CYCLES] && stats.perfHas[e] && cycles)
+                    std::cout << std::setprecision(2) << static_cast<double>(stats.perfTotals[p][e].load()) / cycles;
+                else std::cout << "n/a";
+            }
+        }
+        std::cout << std::endl;
     }
-    
-    return result;
 }
 
 void displayStats(const SearchStats& stats, std::chrono::steady_clock::time_point startTime) {
@@ -122,14 +291,14 @@ void displayStats(const SearchStats& stats, std::chrono::steady_clock::time_poin
     
     double rate = (elapsedMin > 0) ? total / elapsedMin : 0;
     
-    // Total possible seeds in Balatro
-    const uint64_t TOTAL_SEEDS = 2821109907456ULL;
-    
-    // Calculate progress percentage
-    double progressPercent = (double)currentSeed / TOTAL_SEEDS * 100.0;
+    // Progress through the searched range; in a bounded run every seed in
+    // it is visited exactly once, so the seed count is exact
+    const uint64_t rangeSize = stats.rangeEnd - stats.rangeStart;
+    const uint64_t done = stats.bounded ? std::min(total, rangeSize) : std::min(currentSeed, SEED_COUNT);
+    double progressPercent = rangeSize ? (double)done / (stats.bounded ? rangeSize : SEED_COUNT) * 100.0 : 100.0;
     
     // Calculate ETA
-    uint64_t remainingSeeds = TOTAL_SEEDS - currentSeed;
+    uint64_t remainingSeeds = (stats.bounded ? rangeSize : SEED_COUNT) - done;
     double etaMinutes = (rate > 0) ? remainingSeeds / rate : 0;
     uint64_t etaDays = (uint64_t)(etaMinutes / (60 * 24));
     uint64_t etaHours = (uint64_t)((etaMinutes - etaDays * 60 * 24) / 60);
@@ -176,9 +345,114 @@ void displayStats(const SearchStats& stats, std::chrono::steady_clock::time_poin
         }
     }
     
+    if (stats.sample) {
+        std::cout << std::endl;
+        printSampleEstimates(stats, resultNames, rate / 60);
+    }
+    displayPerf(stats);
     std::cout << std::flush;
 }
 
+// Builds LiveMetrics snapshots from the search state; rates cover the time
+// since the previous snapshot
+class MetricsCollector {
+public:
+    MetricsCollector(const SearchStats& s, const ProgressJournal::Tracker& t, std::string filterName,
+                     std::vector<std::string> levelNames, uint64_t planned, std::chrono::steady_clock::time_point start)
+        : stats(s), tracker(t), filter(std::move(filterName)), names(std::move(levelNames)), plannedSeeds(planned),
+          startTime(start), lastTime(start), lastThreadSeeds(s.threadCount, 0) {}
+
+    LiveMetrics::Snapshot take(bool done) {
+        const auto now = std::chrono::steady_clock::now();
+        const double dt = std::chrono::duration<double>(now - lastTime).count();
+        LiveMetrics::Snapshot m;
+        m.filter = filter;
+        m.elapsedSeconds = std::chrono::duration<double>(now - startTime).count();
+        m.seeds = stats.totalSeeds.load();
+        m.rate = dt > 0 ? (m.seeds - lastSeeds) / dt : 0;
+        // Exponential smoothing with a 10 s time constant
+        const double alpha = haveRate ? 1 - std::exp(-dt / 10.0) : 1.0;
+        smoothed += alpha * (m.rate - smoothed);
+        haveRate = haveRate || dt > 0;
+        m.rateSmoothed = smoothed;
+        for (unsigned int i = 0; i < stats.threadCount; i++) {
+            const uint64_t seeds = stats.threadSeeds[i].seeds.load(std::memory_order_relaxed);
+            m.threadRates.push_back(dt > 0 ? (seeds - lastThreadSeeds[i]) / dt : 0);
+            lastThreadSeeds[i] = seeds;
+        }
+        for (size_t i = 0; i < stats.results.size() && i < names.size(); i++) m.levels.push_back({names[i], stats.results[i].count.load()});
+        m.rangeStart = stats.rangeStart;
+        m.rangeEnd = stats.rangeEnd;
+        m.watermark = tracker.watermark();
+        // Seeds done before this run (resume) count towards progress
+        const uint64_t rangeSize = stats.rangeEnd - stats.rangeStart;
+        const uint64_t doneSeeds = rangeSize - plannedSeeds + std::min(m.seeds, plannedSeeds);
+        m.progress = rangeSize ? static_cast<double>(doneSeeds) / rangeSize : 1.0;
+        m.etaSeconds = done ? 0 : (smoothed > 0 ? (plannedSeeds - std::min(m.seeds, plannedSeeds)) / smoothed : -1);
+        m.pendingMatches = tracker.pendingMatches();
+        m.chunksInFlight = tracker.chunksInFlight();
+        m.done = done;
+        lastTime = now;
+        lastSeeds = m.seeds;
+        return m;
+    }
+
+private:
+    const SearchStats& stats;
+    const ProgressJournal::Tracker& tracker;
+    const std::string filter;
+    const std::vector<std::string> names;
+    const uint64_t plannedSeeds;
+    const std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point lastTime;
+    uint64_t lastSeeds = 0;
+    std::vector<uint64_t> lastThreadSeeds;
+    double smoothed = 0;
+    bool haveRate = false;
+};
+
+// Summary printed when a bounded run (--end/--count) has searched its whole range
+void printRangeSummary(const SearchStats& stats, uint64_t expected, const std::vector<std::string>& resultNames, std::chrono::steady_clock::time_point startTime) {
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const uint64_t total = stats.totalSeeds.load();
+    std::cout << "\n*** RANGE COMPLETE ***" << std::endl;
+    std::cout << "Range:          [" << stats.rangeStart << ", " << stats.rangeEnd << ")";
+    if (expected > 0) std::cout << " " << numberToSeed(stats.rangeStart) << " .. " << numberToSeed(stats.rangeEnd - 1);
+    else std::cout << " (already complete)";
+    std::cout << std::endl;
+    std::cout << "Seeds searched: " << total << (total == expected ? "" : " (expected " + std::to_string(expected) + ")") << std::endl;
+    std::cout << "Time:           " << std::fixed << std::setprecision(2) << secs << "s" << std::endl;
+    std::cout << "Rate:           " << std::fixed << std::setprecision(0) << (secs > 0 ? total / secs : 0) << " seeds/s" << std::endl;
+    std::cout << "Matches:" << std::endl;
+    for (size_t i = 0; i < stats.results.size() && i < resultNames.size(); i++) {
+        std::cout << "  " << std::left << std::setw(25) << (resultNames[i] + ":") << stats.results[i].count.load() << std::endl;
+    }
+}
+
+// The best few seeds of a --top-k run
+void printTopK(const TopK::Collector& topK, const std::string& path, const std::vector<std::string>& resultNames) {
+    const std::vector<TopK::Entry> best = topK.snapshot();
+    std::cout << "\nTop " << best.size() << " scored seed(s) written to: " << path << std::endl;
+    for (size_t i = 0; i < best.size() && i < 10; i++) {
+        const TopK::Entry& e = best[i];
+        std::cout << "  " << std::setw(3) << i + 1 << ". " << numberToSeed(e.number) << "  score " << std::defaultfloat
+                  << e.score << "  " << (e.level <= resultNames.size() ? resultNames[e.level - 1] : "") << std::endl;
+        const std::string detail = getCurrentFilter()->describePayload(e.payload);
+        if (!detail.empty()) std::cout << "       " << detail << std::endl;
+    }
+}
+
+// Parses a decimal seed number below SEED_COUNT (up to SEED_COUNT inclusive when `allowEnd`)
+static bool parseSeedNumber(const char* text, uint64_t& out, bool allowEnd = false) {
+    if (!text || !*text) return false;
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long v = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || text[0] == '-') return false;
+    out = v;
+    return allowEnd ? out <= SEED_COUNT : out < SEED_COUNT;
+}
+
 // Escape CSV field (very small helper)
 static std::string csvEscape(const std::string& s) {
     std::string out;
@@ -202,49 +476,516 @@ void logMatch(const std::string& seed, int matchLevel, const std::string& matchN
 
 void writeProgressFile(const std::string& filterKey, uint64_t currentNumber) {
     try {
-        std::string progDir = "dist";
-        std::string progFile = progDir + "/progress_" + filterKey + ".txt";
-        std::string tmpFile = progFile + ".tmp";
+        // Best-effort: the journal is what --resume relies on
+        std::string error;
+        AtomicFile::write("dist/progress_" + filterKey + ".txt", std::to_string(currentNumber) + "\n", error);
+    } catch (...) {
+        // best-effort only
+    }
+}
 
-        // Write to temporary file then atomically replace (best-effort)
-        std::ofstream pf(tmpFile, std::ios::trunc);
-        if (pf.is_open()) {
-            pf << currentNumber << std::endl;
-            pf.flush();
-            pf.close();
+void recordMatch(SearchStats& stats, uint64_t number, int matchLevel, std::vector<ProgressJournal::Match>& matches) {
+    // Update configurable results; the CSV row is written at the next journal checkpoint
+    stats.updateResult(matchLevel);
+    matches.push_back({number, static_cast<uint16_t>(matchLevel)});
+}
 
-            // Remove existing file then rename
-            std::remove(progFile.c_str());
-            std::rename(tmpFile.c_str(), progFile.c_str());
+template<typename Filter>
+void searchWorker(SearchDriver<Filter>& driver, std::atomic<bool>& found, SearchStats& stats, ProgressJournal::Tracker& tracker, std::ostream& debugOut, unsigned int interleave, unsigned int threadIndex) {
+    // Threads take whole chunks from the tracker, so together they cover the
+    // range exactly once and a chunk is either fully searched or redone on resume.
+    // Under --sample the chunks hold permutation positions; matches still
+    // record the real seed number.
+    std::vector<std::string> seeds(interleave);
+    std::vector<uint16_t> levels(interleave);
+    std::vector<uint64_t> numbers(interleave);
+    // --top-k: this thread's best seeds since its last merge, and the score
+    // the shared list currently needs
+    std::unique_ptr<TopK::Heap> topLocal(stats.topK ? new TopK::Heap(stats.topKSize) : nullptr);
+    double topCutoff = stats.topK ? stats.topK->cutoff() : 0;
+    std::vector<ProgressJournal::Match> matches;
+    // Only this thread writes its counter, so a relaxed load and store is enough
+    std::atomic<uint64_t>& threadSeeds = stats.threadSeeds[threadIndex].seeds;
+    // --perf-counters: counters for this thread, read once per chunk and around each match
+    std::unique_ptr<PerfEventSet> perf(stats.perfEnabled ? new PerfEventSet() : nullptr);
+    if (perf && !perf->available()) perf.reset();
+    PerfEventSet::Snapshot chunkStart, chunkMatch;
+    auto record = [&](uint64_t number, int level) {
+        if (!perf) {
+            recordMatch(stats, number, level, matches);
+            return;
         }
-    } catch (...) {
-        // best-effort only
+        const PerfEventSet::Snapshot before = perf->read();
+        recordMatch(stats, number, level, matches);
+        chunkMatch += perf->read() - before;
+    };
+    uint64_t begin, end;
+    while (!found.load() && tracker.next(begin, end)) {
+        matches.clear();
+        if (perf) {
+            chunkMatch = PerfEventSet::Snapshot();
+            chunkStart = perf->read();
+        }
+        if (interleave > 1) {
+            // Hand the filter `interleave` consecutive seeds at a time so it can
+            // overlap their dependency chains; results match the one-seed loop.
+            for (uint64_t number = begin; number < end;) {
+                unsigned int n = 0;
+                // The last batch of a chunk may be short
+                while (n < interleave && number < end) {
+                    numbers[n] = stats.seedNumberAt(number++);
+                    seeds[n] = numberToSeed(numbers[n]);
+                    n++;
+                }
+                {
+                    HOT_STAGES(hotStage);
+                    HOT_STAGE_NEXT(hotStage, "filter.applyBatch");
+                    driver.applyBatch(Span<const std::string>(seeds.data(), n), Span<uint16_t>(levels.data(), n));
+                }
+                HOT_COUNT_N(HotCounters::SEEDS, n);
+                stats.currentSeedNumber.store(numbers[n - 1]);
+                stats.totalSeeds += n;
+                threadSeeds.store(threadSeeds.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+                for (unsigned int i = 0; i < n; i++) {
+                    if (levels[i] > 0) record(numbers[i], levels[i]);
+                }
+            }
+        } else {
+            for (uint64_t position = begin; position < end; position++) {
+                const uint64_t number = stats.seedNumberAt(position);
+                std::string seed = numberToSeed(number);
+                stats.currentSeedNumber.store(number);
+
+                stats.totalSeeds++;
+                threadSeeds.store(threadSeeds.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                int matchLevel;
+                HOT_SEED_BEGIN();
+                if (topLocal) {
+                    HOT_STAGES(hotStage);
+                    HOT_STAGE_NEXT(hotStage, "filter.score");
+                    const FilterScore score = driver.score(seed);
+                    matchLevel = score.level;
+                    if (matchLevel > 0 && score.value >= topCutoff) topLocal->push({score.value, number, score.level, score.payload});
+                } else {
+                    HOT_STAGES(hotStage);
+                    HOT_STAGE_NEXT(hotStage, "filter.apply");
+                    matchLevel = driver.apply(seed, debugOut);
+                }
+                HOT_SEED_END(seed);
+
+                if (matchLevel > 0) {
+                    // Top-K runs only count matches; the kept seeds are written at checkpoints
+                    if (topLocal) stats.updateResult(matchLevel);
+                    else record(number, matchLevel);
+                }
+            }
+        }
+        // The chunk's seeds reach the shared top-K before the tracker counts it done
+        if (topLocal) topCutoff = stats.topK->merge(*topLocal);
+        if (!perf) {
+            tracker.complete(begin, matches);
+            continue;
+        }
+        // Everything in the chunk loop except match recording is filter time
+        const PerfEventSet::Snapshot loopEnd = perf->read();
+        tracker.complete(begin, matches);
+        chunkMatch += perf->read() - loopEnd;
+        stats.addPerf(SearchStats::PHASE_FILTER, loopEnd - chunkStart - chunkMatch);
+        stats.addPerf(SearchStats::PHASE_MATCH, chunkMatch);
+        stats.perfSeeds += end - begin;
     }
 }
 
-void searchWorker(std::atomic<bool>& found, std::string& result, std::mutex& resultMutex, SearchStats& stats, uint64_t startSeed, int threadId, std::ostream& csvFile, std::mutex& csvMutex, std::ostream& debugOut) {
-    const unsigned int numThreads = std::thread::hardware_concurrency();
-    uint64_t currentNumber = startSeed + threadId;
-    
-    while (!found.load()) {
-        std::string seed = numberToSeed(currentNumber);
-        stats.currentSeedNumber.store(currentNumber);
-        
-        stats.totalSeeds++;
-        int matchLevel = applyCurrentFilter(seed, debugOut);
-        
-        if (matchLevel > 0) {
-            // Update configurable results
-            stats.updateResult(matchLevel);
-            std::string matchName = "";
-            auto names = getCurrentFilter()->getResultNames();
-            if (matchLevel > 0 && matchLevel <= static_cast<int>(names.size())) matchName = names[matchLevel - 1];
-            logMatch(seed, matchLevel, matchName, csvFile, csvMutex);
+// JSON-lines file that --describe writes beside a match CSV
+std::string describePathFor(const std::string& csvPath) {
+    const size_t n = csvPath.size();
+    return (n > 4 && csvPath.compare(n - 4, 4, ".csv") == 0 ? csvPath.substr(0, n - 4) : csvPath) + ".describe.jsonl";
+}
+
+// Pool running the current filter's describeMatch(), with its level names copied once
+std::unique_ptr<DescribePool> makeDescribePool(size_t queueCapacity) {
+    const std::vector<std::string> names = getCurrentFilter()->getResultNames();
+    return std::unique_ptr<DescribePool>(new DescribePool(
+        getCurrentFilter()->getName(),
+        [](const std::string& seed) { return getCurrentFilter()->describeMatch(seed); },
+        [names](int level) { return level > 0 && level <= static_cast<int>(names.size()) ? names[level - 1] : std::string(); },
+        queueCapacity));
+}
+
+void printDescribeSummary(const DescribePool& describer, std::ostream& out) {
+    out << "Described:      " << describer.described() << " match(es)";
+    if (describer.dropped()) out << ", " << describer.dropped() << " dropped with a full queue (\"dropped\": true)";
+    out << std::endl;
+}
+
+// --input: writes each batch's matches as CSV rows. With `ordered`, a batch
+// that finishes early is held until every batch before it is written, so the
+// output follows the input order.
+class RefineWriter {
+public:
+    RefineWriter(std::ostream& o, const std::vector<std::string>& resultNames, bool inOrder, DescribePool* describePool)
+        : out(o), names(resultNames), ordered(inOrder), describer(describePool) {}
+
+    // Every batch must be submitted, even one without matches
+    void submit(uint64_t sequence, std::vector<ProgressJournal::Match>& matches) {
+        std::lock_guard<std::mutex> lk(mutex);
+        if (ordered && sequence != nextSequence) {
+            held[sequence].swap(matches);
+            return;
         }
-        
-        // Each thread takes every Nth seed where N is number of threads
-        currentNumber += numThreads;
+        write(matches);
+        if (!ordered) return;
+        nextSequence++;
+        for (auto it = held.find(nextSequence); it != held.end(); it = held.find(++nextSequence)) {
+            write(it->second);
+            held.erase(it);
+        }
+    }
+
+    uint64_t rows() const {
+        std::lock_guard<std::mutex> lk(mutex);
+        return written;
+    }
+
+private:
+    void write(const std::vector<ProgressJournal::Match>& matches) {
+        for (const auto& m : matches) {
+            out << numberToSeed(m.number) << "," << m.level;
+            if (m.level <= names.size()) out << ",\"" << csvEscape(names[m.level - 1]) << "\"";
+            out << "\n";
+            if (describer) describer->submit(m.number, m.level);
+        }
+        written += matches.size();
+        if (!matches.empty()) out.flush();
+    }
+
+    std::ostream& out;
+    const std::vector<std::string>& names;
+    const bool ordered;
+    DescribePool* describer;
+    mutable std::mutex mutex;
+    uint64_t nextSequence = 0;
+    std::map<uint64_t, std::vector<ProgressJournal::Match>> held;
+    uint64_t written = 0;
+};
+
+// Seeds per batch taken from the input by a worker thread
+constexpr size_t REFINE_BATCH = 4096;
+
+template<typename Filter>
+void refineWorker(SearchDriver<Filter>& driver, SeedInput::Reader& reader, RefineWriter& writer, SearchStats& stats, std::ostream& debugOut, unsigned int interleave, unsigned int threadIndex) {
+    SeedInput::Batch batch;
+    std::vector<std::string> seeds(interleave);
+    std::vector<uint16_t> levels(interleave);
+    std::vector<ProgressJournal::Match> matches;
+    std::atomic<uint64_t>& threadSeeds = stats.threadSeeds[threadIndex].seeds;
+    while (!interruptRequested && reader.next(batch, REFINE_BATCH)) {
+        matches.clear();
+        const size_t count = batch.numbers.size();
+        for (size_t i = 0; i < count;) {
+            const size_t n = std::min<size_t>(interleave, count - i);
+            for (size_t j = 0; j < n; j++) seeds[j] = numberToSeed(batch.numbers[i + j]);
+            if (interleave > 1) driver.applyBatch(Span<const std::string>(seeds.data(), n), Span<uint16_t>(levels.data(), n));
+            else levels[0] = static_cast<uint16_t>(driver.apply(seeds[0], debugOut));
+            for (size_t j = 0; j < n; j++) {
+                if (levels[j] == 0) continue;
+                stats.updateResult(levels[j]);
+                matches.push_back({batch.numbers[i + j], levels[j]});
+            }
+            i += n;
+        }
+        HOT_COUNT_N(HotCounters::SEEDS, count);
+        stats.currentSeedNumber.store(batch.numbers.back());
+        stats.totalSeeds += count;
+        threadSeeds.store(threadSeeds.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        writer.submit(batch.sequence, matches);
+    }
+}
+
+// --input: runs the filter over a seed list instead of a range and writes
+// the matches to `outputPath` ("-" for stdout). Messages go to stderr so the
+// output can feed the next stage's --input -.
+int runRefinement(const std::string& inputPath, SeedInput::Format format, const std::string& outputPath, bool ordered,
+                  unsigned int numThreads, unsigned int interleave, bool quiet, DescribePool* describer) {
+    SeedInput::Reader reader;
+    std::string error;
+    if (!reader.open(inputPath, format, error)) {
+        log_error("--input: ", error);
+        return 1;
+    }
+    std::ofstream file;
+    if (outputPath != "-") {
+        file.open(outputPath, std::ios::trunc);
+        if (!file.is_open()) {
+            log_error("Could not create output file: ", outputPath);
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath == "-" ? std::cout : file;
+
+    SearchStats stats;
+    SearchDriver<SelectedFilterType> driver = makeSelectedDriver(*getCurrentFilter());
+    stats.initializeResults(driver.resultNames());
+    stats.threadCount = numThreads;
+    stats.threadSeeds.reset(new SearchStats::ThreadSeeds[numThreads]);
+    RefineWriter writer(out, driver.resultNames(), ordered, describer);
+    // No rdbuf: filter debug output is discarded
+    std::ostream discard(nullptr);
+
+    out << "seed,match_level\n";
+    std::cerr << "Refining " << (inputPath == "-" ? std::string("stdin") : inputPath) << " ("
+              << (format == SeedInput::Format::BINARY ? "binary" : "text") << ") with " << numThreads << " threads"
+              << (ordered ? ", output in input order" : "") << " -> " << (outputPath == "-" ? std::string("stdout") : outputPath) << std::endl;
+    installInterruptHandler();
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < numThreads; i++) {
+        threads.emplace_back(refineWorker<SelectedFilterType>, std::ref(driver), std::ref(reader), std::ref(writer), std::ref(stats), std::ref(discard), interleave, i);
+    }
+
+    std::atomic<bool> done(false);
+    std::thread progress([&]() {
+        const uint64_t expected = reader.sizeHint();
+        int ticks = 0;
+        while (!done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (quiet || done.load() || ++ticks % 10) continue;
+            const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            const uint64_t total = stats.totalSeeds.load();
+            std::cerr << "\rRefined " << total;
+            if (expected) std::cerr << " / " << expected;
+            std::cerr << " seeds, " << std::fixed << std::setprecision(0) << total / secs << " seeds/s, " << writer.rows()
+                      << " matches   " << std::flush;
+        }
+    });
+    for (auto& t : threads) t.join();
+    done.store(true);
+    progress.join();
+    out.flush();
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const uint64_t total = stats.totalSeeds.load();
+    if (!quiet) std::cerr << std::endl;
+    if (describer) {
+        if (describer->queued()) std::cerr << "Describing " << describer->queued() << " queued match(es)..." << std::endl;
+        describer->finish();
+    }
+    if (interruptRequested) {
+        std::cerr << "Interrupted by user after " << total << " seeds; matches so far logged to: "
+                  << (outputPath == "-" ? std::string("stdout") : outputPath) << std::endl;
+        return 1;
+    }
+    std::cerr << "*** REFINEMENT COMPLETE ***" << std::endl;
+    std::cerr << "Seeds searched: " << total;
+    if (reader.skipped()) std::cerr << " (" << reader.skipped() << " input lines or records skipped)";
+    std::cerr << std::endl;
+    std::cerr << "Time:           " << std::fixed << std::setprecision(2) << secs << "s" << std::endl;
+    std::cerr << "Rate:           " << std::fixed << std::setprecision(0) << (secs > 0 ? total / secs : 0) << " seeds/s" << std::endl;
+    std::cerr << "Matches:" << std::endl;
+    for (size_t i = 0; i < stats.results.size(); i++) {
+        std::cerr << "  " << std::left << std::setw(25) << (driver.resultNames()[i] + ":") << stats.results[i].count.load() << std::endl;
+    }
+    if (outputPath != "-") std::cerr << "Matches logged to: " << outputPath << std::endl;
+    if (describer) printDescribeSummary(*describer, std::cerr);
+    return 0;
+}
+
+// --describe-batch: writes each batch's JSON lines once every batch before it
+// has been written. A thread more than `window` batches ahead of the oldest
+// unwritten one waits, so however slow one batch is, only a few batches of
+// lines are ever held.
+class DescribeBatchWriter {
+public:
+    DescribeBatchWriter(std::ostream& o, uint64_t window) : out(o), ahead(window) {}
+
+    void submit(uint64_t sequence, std::string& lines) {
+        std::unique_lock<std::mutex> lk(mutex);
+        room.wait(lk, [&] { return sequence < nextSequence + ahead; });
+        if (sequence != nextSequence) {
+            held[sequence].swap(lines);
+            return;
+        }
+        out << lines;
+        for (auto it = held.find(++nextSequence); it != held.end(); it = held.find(++nextSequence)) {
+            out << it->second;
+            held.erase(it);
+        }
+        out.flush();
+        room.notify_all();
+    }
+
+private:
+    std::ostream& out;
+    const uint64_t ahead;
+    std::mutex mutex;
+    std::condition_variable room;
+    uint64_t nextSequence = 0;
+    std::map<uint64_t, std::string> held;
+};
+
+// Seeds per --describe-batch batch; describing costs far more than apply()
+constexpr size_t DESCRIBE_BATCH = 64;
+
+template<typename Filter>
+void describeBatchWorker(SearchDriver<Filter>& driver, SeedInput::Reader& reader, DescribeBatchWriter& writer, SearchStats& stats, std::ostream& debugOut, unsigned int threadIndex) {
+    SeedInput::Batch batch;
+    std::string lines;
+    std::atomic<uint64_t>& threadSeeds = stats.threadSeeds[threadIndex].seeds;
+    while (!interruptRequested && reader.next(batch, DESCRIBE_BATCH)) {
+        lines.clear();
+        for (uint64_t number : batch.numbers) {
+            const std::string seed = numberToSeed(number);
+            const int level = driver.apply(seed, debugOut);
+            if (level > 0) stats.updateResult(level);
+            std::string json;
+            try {
+                json = getCurrentFilter()->describeMatch(seed);
+            } catch (...) {
+                json.clear();
+            }
+            lines += DescribePool::formatLine(getCurrentFilter()->getName(), seed, level, driver.resultName(level), json);
+        }
+        const size_t count = batch.numbers.size();
+        stats.totalSeeds += count;
+        threadSeeds.store(threadSeeds.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        writer.submit(batch.sequence, lines);
+    }
+}
+
+// --describe-batch: --describe-match for every seed of a list, across all
+// threads and with the environment prepared once. Writes one JSON line per
+// input seed, in input order, in the --describe file format.
+int runDescribeBatch(const std::string& inputPath, SeedInput::Format format, const std::string& outputPath,
+                     unsigned int numThreads, bool quiet) {
+    SeedInput::Reader reader;
+    std::string error;
+    if (!reader.open(inputPath, format, error)) {
+        log_error("--describe-batch: ", error);
+        return 1;
+    }
+    std::ofstream file;
+    if (outputPath != "-") {
+        file.open(outputPath, std::ios::trunc);
+        if (!file.is_open()) {
+            log_error("Could not create output file: ", outputPath);
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath == "-" ? std::cout : file;
+
+    SearchStats stats;
+    SearchDriver<SelectedFilterType> driver = makeSelectedDriver(*getCurrentFilter());
+    stats.initializeResults(driver.resultNames());
+    stats.threadCount = numThreads;
+    stats.threadSeeds.reset(new SearchStats::ThreadSeeds[numThreads]);
+    DescribeBatchWriter writer(out, 4 * static_cast<uint64_t>(numThreads));
+    // No rdbuf: filter debug output is discarded
+    std::ostream discard(nullptr);
+
+    std::cerr << "Describing " << (inputPath == "-" ? std::string("stdin") : inputPath) << " with " << numThreads << " threads -> "
+              << (outputPath == "-" ? std::string("stdout") : outputPath) << std::endl;
+    installInterruptHandler();
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < numThreads; i++) {
+        threads.emplace_back(describeBatchWorker<SelectedFilterType>, std::ref(driver), std::ref(reader), std::ref(writer), std::ref(stats), std::ref(discard), i);
     }
+
+    std::atomic<bool> done(false);
+    std::thread progress([&]() {
+        const uint64_t expected = reader.sizeHint();
+        int ticks = 0;
+        while (!done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (quiet || done.load() || ++ticks % 10) continue;
+            const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            const uint64_t total = stats.totalSeeds.load();
+            std::cerr << "\rDescribed " << total;
+            if (expected) std::cerr << " / " << expected;
+            std::cerr << " seeds, " << std::fixed << std::setprecision(0) << total / secs << " seeds/s   " << std::flush;
+        }
+    });
+    for (auto& t : threads) t.join();
+    done.store(true);
+    progress.join();
+    out.flush();
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const uint64_t total = stats.totalSeeds.load();
+    if (!quiet) std::cerr << std::endl;
+    if (interruptRequested) {
+        std::cerr << "Interrupted by user after " << total << " seeds; descriptions so far written to: "
+                  << (outputPath == "-" ? std::string("stdout") : outputPath) << std::endl;
+        return 1;
+    }
+    std::cerr << "*** DESCRIBE BATCH COMPLETE ***" << std::endl;
+    std::cerr << "Seeds described: " << total;
+    if (reader.skipped()) std::cerr << " (" << reader.skipped() << " input lines or records skipped)";
+    std::cerr << std::endl;
+    std::cerr << "Time:            " << std::fixed << std::setprecision(2) << secs << "s" << std::endl;
+    std::cerr << "Rate:            " << std::fixed << std::setprecision(0) << (secs > 0 ? total / secs : 0) << " seeds/s" << std::endl;
+    std::cerr << "Matches:" << std::endl;
+    for (size_t i = 0; i < stats.results.size(); i++) {
+        std::cerr << "  " << std::left << std::setw(25) << (driver.resultNames()[i] + ":") << stats.results[i].count.load() << std::endl;
+    }
+    if (outputPath != "-") std::cerr << "Descriptions written to: " << outputPath << std::endl;
+    return 0;
+}
+
+// The env fields --describe-match reads (the unlocked joker and tag lists),
+// applied once for --describe-match and --describe-batch
+void applyDescribeEnv(const std::string& envFilePath) {
+    try {
+        std::ifstream ef(envFilePath);
+        if (ef.is_open()) {
+            std::stringstream ssin; ssin << ef.rdbuf();
+            std::string txt = ssin.str();
+            EnvConfig e;
+            // lightweight parse for unlockedJokers
+            auto posUJ = txt.find("\"unlockedJokers\"");
+            if (posUJ != std::string::npos) {
+                auto bracket = txt.find('[', posUJ);
+                if (bracket != std::string::npos) {
+                    auto endb = txt.find(']', bracket);
+                    if (endb != std::string::npos && endb > bracket) {
+                        std::string body = txt.substr(bracket+1, endb - bracket - 1);
+                        size_t p = 0;
+                        while (p < body.size()) {
+                            auto q1 = body.find('"', p);
+                            if (q1 == std::string::npos) break;
+                            auto q2 = body.find('"', q1+1);
+                            if (q2 == std::string::npos) break;
+                            std::string jname = body.substr(q1+1, q2 - q1 - 1);
+                            if (!jname.empty()) e.unlockedJokers.push_back(jname);
+                            p = q2 + 1;
+                        }
+                    }
+                }
+            }
+            // also parse unlockedTags for parity
+            auto posUT = txt.find("\"unlockedTags\"");
+            if (posUT != std::string::npos) {
+                auto bracket = txt.find('[', posUT);
+                if (bracket != std::string::npos) {
+                    auto endb = txt.find(']', bracket);
+                    if (endb != std::string::npos && endb > bracket) {
+                        std::string body = txt.substr(bracket+1, endb - bracket - 1);
+                        size_t p = 0;
+                        while (p < body.size()) {
+                            auto q1 = body.find('"', p);
+                            if (q1 == std::string::npos) break;
+                            auto q2 = body.find('"', q1+1);
+                            if (q2 == std::string::npos) break;
+                            std::string tname = body.substr(q1+1, q2 - q1 - 1);
+                            if (!tname.empty()) e.unlockedTags.push_back(tname);
+                            p = q2 + 1;
+                        }
+                    }
+                }
+            }
+            setGlobalEnv(e);
+        }
+    } catch(...) {}
 }
 
 int main(int argc, char* argv[]) {
@@ -265,9 +1006,52 @@ int main(int argc, char* argv[]) {
     std::string envFilePath;
     bool listResults = false;
     bool describeMatch = false;
+    unsigned int interleave = 1;
+    bool perfCounters = false;
+    int metricsFd = -1;
+    std::string metricsPromPath;
+    uint64_t metricsIntervalMs = 1000;
+    bool quiet = false;
+    uint64_t endSeedNumber = 0;
+    uint64_t seedCount = 0;
+    bool haveEnd = false;
+    bool haveCount = false;
+    uint64_t chunkSize = 65536;
+    uint64_t journalIntervalMs = 5000;
+    uint64_t sampleSize = 0;
+    uint64_t sampleKey = 1;
+    uint64_t topKSize = 0;
+    std::string inputPath;
+    std::string inputFormat = "auto";
+    std::string outputPath;
+    bool ordered = false;
+    bool describeMatches = false;
+    std::string describeBatchPath;
+    bool serve = false;
+    std::string serveSocketPath;
+    unsigned int describeThreads = 1;
+    uint64_t describeQueue = 65536;
     
     static struct option long_options[] = {
         {"seed", required_argument, 0, 's'},
+        {"start", required_argument, 0, 'S'},
+        {"end", required_argument, 0, 'E'},
+        {"count", required_argument, 0, 'C'},
+        {"chunk-size", required_argument, 0, 'K'},
+        {"journal-interval", required_argument, 0, 'J'},
+        {"sample", required_argument, 0, 'N'},
+        {"sample-key", required_argument, 0, 'Y'},
+        {"top-k", required_argument, 0, 'T'},
+        {"input", required_argument, 0, 'x'},
+        {"input-format", required_argument, 0, 'X'},
+        {"output", required_argument, 0, 'w'},
+        {"ordered", no_argument, 0, 'O'},
+        {"describe", no_argument, 0, 'V'},
+        {"describe-batch", required_argument, 0, 'B'},
+        {"serve", no_argument, 0, 'Z'},
+        {"serve-socket", required_argument, 0, 'U'},
+        {"describe-threads", required_argument, 0, 'W'},
+        {"describe-queue", required_argument, 0, 'Q'},
     {"env", required_argument, 0, 'e'},
     {"list-results", no_argument, 0, 'L'},
     {"describe-match", no_argument, 0, 'D'},
@@ -277,6 +1061,12 @@ int main(int argc, char* argv[]) {
         {"resume-offset", required_argument, 0, 'o'},
     {"resume-margin", required_argument, 0, 'm'},
         {"threads", required_argument, 0, 't'},
+        {"interleave", required_argument, 0, 'I'},
+        {"perf-counters", no_argument, 0, 'P'},
+        {"metrics-fd", required_argument, 0, 'F'},
+        {"metrics-prom", required_argument, 0, 'M'},
+        {"metrics-interval", required_argument, 0, 'i'},
+        {"quiet", no_argument, 0, 'q'},
         {"debug", no_argument, 0, 'd'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}
@@ -285,7 +1075,7 @@ int main(int argc, char* argv[]) {
     int option_index = 0;
     int c;
     
-    while ((c = getopt_long(argc, argv, "s:t:dh", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "s:t:dhq", long_options, &option_index)) != -1) {
         switch (c) {
             case 's':
                 if (strlen(optarg) == 8) {
@@ -296,6 +1086,98 @@ int main(int argc, char* argv[]) {
                     return 1;
                 }
                 break;
+            case 'S':
+                if (!parseSeedNumber(optarg, startSeedNumber)) {
+                    log_error("--start expects a seed number below ", SEED_COUNT, ".");
+                    return 1;
+                }
+                break;
+            case 'E':
+                if (!parseSeedNumber(optarg, endSeedNumber, true)) {
+                    log_error("--end expects a seed number up to ", SEED_COUNT, ".");
+                    return 1;
+                }
+                haveEnd = true;
+                break;
+            case 'C':
+                if (!parseSeedNumber(optarg, seedCount, true) || seedCount == 0) {
+                    log_error("--count expects a positive number of seeds.");
+                    return 1;
+                }
+                haveCount = true;
+                break;
+            case 'K':
+                if (!parseSeedNumber(optarg, chunkSize) || chunkSize == 0) {
+                    log_error("--chunk-size expects a positive number of seeds.");
+                    return 1;
+                }
+                break;
+            case 'J':
+                journalIntervalMs = std::stoull(optarg);
+                if (journalIntervalMs < 100) {
+                    log_error("--journal-interval must be at least 100 ms.");
+                    return 1;
+                }
+                break;
+            case 'N':
+                if (!parseSeedNumber(optarg, sampleSize, true) || sampleSize == 0) {
+                    log_error("--sample expects a positive number of seeds (at most ", SEED_COUNT, ").");
+                    return 1;
+                }
+                break;
+            case 'Y':
+                sampleKey = std::stoull(optarg);
+                break;
+            case 'T':
+                topKSize = std::stoull(optarg);
+                if (topKSize == 0 || topKSize > 10000000) {
+                    log_error("--top-k must be between 1 and 10000000.");
+                    return 1;
+                }
+                break;
+            case 'x':
+                inputPath = optarg;
+                break;
+            case 'X':
+                inputFormat = optarg;
+                if (inputFormat != "auto" && inputFormat != "text" && inputFormat != "binary") {
+                    log_error("--input-format must be auto, text or binary.");
+                    return 1;
+                }
+                break;
+            case 'w':
+                outputPath = optarg;
+                break;
+            case 'O':
+                ordered = true;
+                break;
+            case 'V':
+                describeMatches = true;
+                break;
+            case 'B':
+                describeBatchPath = optarg;
+                break;
+            case 'Z':
+                serve = true;
+                break;
+            case 'U':
+                serve = true;
+                serveSocketPath = optarg;
+                break;
+            case 'W':
+                describeThreads = std::stoul(optarg);
+                if (describeThreads == 0 || describeThreads > 64) {
+                    log_error("--describe-threads must be between 1 and 64.");
+                    return 1;
+                }
+                break;
+            case 'Q':
+                describeQueue = std::stoull(optarg);
+                if (describeQueue == 0) {
+                    log_error("--describe-queue must be at least 1.");
+                    return 1;
+                }
+                break;
             case 'e':
                 envFilePath = optarg;
                 break;
@@ -321,6 +1203,36 @@ int main(int argc, char* argv[]) {
                     return 1;
                 }
                 break;
+            case 'I':
+                interleave = std::stoul(optarg);
+                if (interleave == 0 || interleave > 8) {
+                    log_error("--interleave must be between 1 and 8.");
+                    return 1;
+                }
+                break;
+            case 'P':
+                perfCounters = true;
+                break;
+            case 'F':
+                metricsFd = std::atoi(optarg);
+                if (metricsFd < 1) {
+                    log_error("--metrics-fd must be a file descriptor number (1 for stdout).");
+                    return 1;
+                }
+                break;
+            case 'M':
+                metricsPromPath = optarg;
+                break;
+            case 'i':
+                metricsIntervalMs = std::stoull(optarg);
+                if (metricsIntervalMs < 100) {
+                    log_error("--metrics-interval must be at least 100 ms.");
+                    return 1;
+                }
+                break;
+            case 'q':
+                quiet = true;
+                break;
             case 'l': {
                 std::string lvl = optarg;
                 for (auto &ch : lvl) ch = (char)std::tolower((unsigned char)ch);
@@ -356,6 +1268,59 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (haveEnd && haveCount) {
+        log_error("Use either --end or --count, not both.");
+        return 1;
+    }
+    if (!inputPath.empty() && (sampleSize > 0 || topKSize > 0 || haveEnd || haveCount || resumeMode || debugMode || startSeedNumber != 0)) {
+        log_error("--input searches a seed list; it cannot be combined with --sample, --top-k, --seed, --start, --end, --count, --resume or --debug.");
+        return 1;
+    }
+    if (serve && (!describeBatchPath.empty() || !inputPath.empty() || describeMatch || describeMatches || sampleSize > 0 ||
+                  topKSize > 0 || haveEnd || haveCount || resumeMode || debugMode || startSeedNumber != 0)) {
+        log_error("--serve takes its work from requests; it cannot be combined with search, refinement or describe options.");
+        return 1;
+    }
+    if (!describeBatchPath.empty() && (!inputPath.empty() || describeMatch || describeMatches || sampleSize > 0 || topKSize > 0 ||
+                                       haveEnd || haveCount || resumeMode || debugMode || startSeedNumber != 0 || ordered)) {
+        log_error("--describe-batch describes a seed list; it cannot be combined with --input, --describe-match, --describe, --sample, --top-k, --seed, --start, --end, --count, --resume, --debug or --ordered.");
+        return 1;
+    }
+    if (inputPath.empty() && (ordered || ((!outputPath.empty() || inputFormat != "auto") && describeBatchPath.empty()))) {
+        log_error("--ordered, --output and --input-format only apply to --input (and --output, --input-format to --describe-batch).");
+        return 1;
+    }
+    if (describeMatches && topKSize > 0) {
+        log_error("--describe needs the per-match CSV; use --describe-match on the top-K seeds instead.");
+        return 1;
+    }
+    if (topKSize > 0 && interleave > 1) {
+        log_warn("--interleave has no batched scorer to use with --top-k; evaluating one seed at a time.");
+        interleave = 1;
+    }
+    if (sampleSize > 0) {
+        if (haveEnd || haveCount || startSeedNumber != 0) {
+            log_error("--sample draws from the whole seed space; it cannot be combined with --seed, --start, --end or --count.");
+            return 1;
+        }
+        // The range becomes positions [0, N) of the permutation
+        haveCount = true;
+        seedCount = sampleSize;
+    }
+    // The range is fixed from the requested start, so a resumed run (--resume)
+    // still stops at the same end and work units stay reproducible
+    stats.rangeStart = startSeedNumber;
+    stats.bounded = haveEnd || haveCount;
+    if (haveCount) {
+        stats.rangeEnd = seedCount > SEED_COUNT - startSeedNumber ? SEED_COUNT : startSeedNumber + seedCount;
+    } else if (haveEnd) {
+        stats.rangeEnd = endSeedNumber;
+    }
+    if (stats.rangeEnd <= stats.rangeStart) {
+        log_error("The seed range is empty: --end must be greater than the start.");
+        return 1;
+    }
+
     // If user provided a start seed on the command line, print it for interactive runs
     // but suppress this when we're running describe-match which expects only JSON.
     if (!describeMatch && !debugMode && !debugSeed.empty()) {
@@ -378,7 +1343,9 @@ int main(int argc, char* argv[]) {
         std::cout << "Debug output will be written to: " << debugFilename << std::endl;
         
         // Run filter on the single seed (filter will write debug info to debugFile)
+        HOT_SEED_BEGIN();
         int matchLevel = applyCurrentFilter(debugSeed, debugFile);
+        HOT_SEED_END(debugSeed);
         
         debugFile.close();
         
@@ -394,6 +1361,9 @@ int main(int argc, char* argv[]) {
             }
         }
         std::cout << "Debug output written to: " << debugFilename << std::endl;
+        #ifdef ENABLE_HOT_COUNTERS
+        HotCounters::report(std::cout);
+        #endif
         
         return 0;
     }
@@ -421,6 +1391,47 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    // Query server: answer JSON-lines requests on stdin/stdout, or on a Unix socket with --serve-socket
+    if (serve) {
+        if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+        SearchDriver<SelectedFilterType> driver = makeSelectedDriver(*getCurrentFilter());
+        QueryServer::Server<SelectedFilterType> server(driver, *getCurrentFilter(), numThreads);
+        std::string error;
+        if (!envFilePath.empty() && !server.setEnv(envFilePath, error)) {
+            log_error("--env: ", error);
+            return 1;
+        }
+        #ifdef SIGPIPE
+        // A client that goes away must not kill the server
+        std::signal(SIGPIPE, SIG_IGN);
+        #endif
+        if (serveSocketPath.empty()) {
+            server.serveStream(std::cin, std::cout);
+            return 0;
+        }
+        #ifndef _WIN32
+        std::cerr << "Serving " << getCurrentFilter()->getName() << " on " << serveSocketPath << " with " << numThreads << " threads" << std::endl;
+        if (!server.serveSocket(serveSocketPath, error)) {
+            log_error("--serve-socket: ", error);
+            return 1;
+        }
+        return 0;
+        #else
+        log_error("--serve-socket needs Unix sockets; use --serve over stdin/stdout on Windows.");
+        return 1;
+        #endif
+    }
+
+    if (!describeBatchPath.empty()) {
+        if (!envFilePath.empty()) applyDescribeEnv(envFilePath);
+        if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+        const bool binary = inputFormat == "binary" ||
+                            (inputFormat == "auto" && describeBatchPath.size() > 4 &&
+                             describeBatchPath.compare(describeBatchPath.size() - 4, 4, ".bin") == 0);
+        return runDescribeBatch(describeBatchPath, binary ? SeedInput::Format::BINARY : SeedInput::Format::TEXT,
+                                outputPath.empty() ? "-" : outputPath, numThreads, quiet);
+    }
+
     // Describe-match: for a given --seed print a small JSON object with matched index and name
     if (describeMatch) {
         if (debugSeed.empty()) {
@@ -428,59 +1439,7 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         // If an env file was provided with --env, parse minimal fields now so describe-match respects them
-        if (!envFilePath.empty()) {
-            try {
-                std::ifstream ef(envFilePath);
-                if (ef.is_open()) {
-                    std::stringstream ssin; ssin << ef.rdbuf();
-                    std::string txt = ssin.str();
-                    EnvConfig e;
-                    // lightweight parse for unlockedJokers
-                    auto posUJ = txt.find("\"unlockedJokers\"");
-                    if (posUJ != std::string::npos) {
-                        auto bracket = txt.find('[', posUJ);
-                        if (bracket != std::string::npos) {
-                            auto endb = txt.find(']', bracket);
-                            if (endb != std::string::npos && endb > bracket) {
-                                std::string body = txt.substr(bracket+1, endb - bracket - 1);
-                                size_t p = 0;
-                                while (p < body.size()) {
-                                    auto q1 = body.find('"', p);
-                                    if (q1 == std::string::npos) break;
-                                    auto q2 = body.find('"', q1+1);
-                                    if (q2 == std::string::npos) break;
-                                    std::string jname = body.substr(q1+1, q2 - q1 - 1);
-                                    if (!jname.empty()) e.unlockedJokers.push_back(jname);
-                                    p = q2 + 1;
-                                }
-                            }
-                        }
-                    }
-                    // also parse unlockedTags for parity
-                    auto posUT = txt.find("\"unlockedTags\"");
-                    if (posUT != std::string::npos) {
-                        auto bracket = txt.find('[', posUT);
-                        if (bracket != std::string::npos) {
-                            auto endb = txt.find(']', bracket);
-                            if (endb != std::string::npos && endb > bracket) {
-                                std::string body = txt.substr(bracket+1, endb - bracket - 1);
-                                size_t p = 0;
-                                while (p < body.size()) {
-                                    auto q1 = body.find('"', p);
-                                    if (q1 == std::string::npos) break;
-                                    auto q2 = body.find('"', q1+1);
-                                    if (q2 == std::string::npos) break;
-                                    std::string tname = body.substr(q1+1, q2 - q1 - 1);
-                                    if (!tname.empty()) e.unlockedTags.push_back(tname);
-                                    p = q2 + 1;
-                                }
-                            }
-                        }
-                    }
-                    setGlobalEnv(e);
-                }
-            } catch(...) {}
-        }
+        if (!envFilePath.empty()) applyDescribeEnv(envFilePath);
         int matchLevel = applyCurrentFilter(debugSeed, std::cout);
         int idx = matchLevel;
         std::string name = "";
@@ -519,35 +1478,6 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
-    // Create CSV file with timestamp
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S");
-
-    std::string csvFilename = "dist/matches_" + ss.str() + ".csv";
-    
-    #ifdef ENABLE_LOGS
-
-    std::ofstream csvFile(csvFilename);
-    if (!csvFile.is_open()) {
-    log_error("Could not create CSV file: ", csvFilename);
-        return 1;
-    }
-
-    #else
-
-    std::streambuf * buf;
-    buf = std::cout.rdbuf();
-    std::ostream csvFile(buf);
-
-    #endif
-
-     
-    // Write CSV header
-    csvFile << "seed,match_level" << std::endl;
-    std::cout << "Logging matches to: " << csvFilename << std::endl;
-    
     stats.currentSeedNumber.store(startSeedNumber);
 
     // If env file provided, read it and apply global env
@@ -614,139 +1544,9 @@ int main(int argc, char* argv[]) {
 #endif
 
     try {
-            std::ifstream ef(envFilePath);
-            if (ef.is_open()) {
+            EnvConfig e;
+            if (loadEnvFile(envFilePath, e)) {
         log_warn("Using lightweight env parser (nlohmann::json not available or failed). Consider compiling with USE_NLOHMANN_JSON for robust parsing.");
-                std::stringstream ssin;
-                ssin << ef.rdbuf();
-                std::string txt = ssin.str();
-                EnvConfig e;
-                // lightweight parsing: look for keys and extract simple values (robust to spacing)
-                auto find_str = [&](const std::string& key) -> std::string {
-                    auto pos = txt.find('"' + key + '"');
-                    if (pos == std::string::npos) return std::string();
-                    auto colon = txt.find(':', pos);
-                    if (colon == std::string::npos) return std::string();
-                    auto start = txt.find_first_not_of(" \t\n\r", colon+1);
-                    if (start == std::string::npos) return std::string();
-                    if (txt[start] == '"') {
-                        auto end = txt.find('"', start+1);
-                        if (end == std::string::npos) return std::string();
-                        return txt.substr(start+1, end-start-1);
-                    } else {
-                        // read until comma or brace
-                        auto end = txt.find_first_of(",}\n\r", start);
-                        if (end == std::string::npos) end = txt.size();
-                        return txt.substr(start, end-start);
-                    }
-                };
-
-                std::string v;
-                v = find_str("deck"); if (!v.empty()) e.deck = v;
-                v = find_str("stake"); if (!v.empty()) e.stake = v;
-                v = find_str("tag"); if (!v.empty()) e.tag = v;
-                // Lightweight parse for unlockedTags: look for "unlockedTags" and extract a simple array of strings
-                auto posUT = txt.find("\"unlockedTags\"");
-                if (posUT != std::string::npos) {
-                    auto bracket = txt.find('[', posUT);
-                    if (bracket != std::string::npos) {
-                        auto endb = txt.find(']', bracket);
-                        if (endb != std::string::npos && endb > bracket) {
-                            std::string body = txt.substr(bracket+1, endb - bracket - 1);
-                            size_t p = 0;
-                            while (p < body.size()) {
-                                // find next quote
-                                auto q1 = body.find('"', p);
-                                if (q1 == std::string::npos) break;
-                                auto q2 = body.find('"', q1+1);
-                                if (q2 == std::string::npos) break;
-                                std::string tagname = body.substr(q1+1, q2 - q1 - 1);
-                                if (!tagname.empty()) e.unlockedTags.push_back(tagname);
-                                p = q2 + 1;
-                            }
-                        }
-                    }
-                }
-                // Lightweight parse for unlockedJokers (fallback)
-                auto posUJ = txt.find("\"unlockedJokers\"");
-                if (posUJ != std::string::npos) {
-                    auto bracket = txt.find('[', posUJ);
-                    if (bracket != std::string::npos) {
-                        auto endb = txt.find(']', bracket);
-                        if (endb != std::string::npos && endb > bracket) {
-                            std::string body = txt.substr(bracket+1, endb - bracket - 1);
-                            size_t p = 0;
-                            while (p < body.size()) {
-                                auto q1 = body.find('"', p);
-                                if (q1 == std::string::npos) break;
-                                auto q2 = body.find('"', q1+1);
-                                if (q2 == std::string::npos) break;
-                                std::string jname = body.substr(q1+1, q2 - q1 - 1);
-                                if (!jname.empty()) e.unlockedJokers.push_back(jname);
-                                p = q2 + 1;
-                            }
-                        }
-                    }
-                }
-                v = find_str("showman"); if (!v.empty()) e.showman = (v.find("true") != std::string::npos);
-                v = find_str("sixesFactor"); if (!v.empty()) e.sixesFactor = std::stoi(v);
-                v = find_str("version"); if (!v.empty()) e.version = std::stol(v);
-                v = find_str("forceAllContent"); if (!v.empty()) e.forceAllContent = (v.find("true") != std::string::npos);
-                v = find_str("freshProfile"); if (!v.empty()) e.freshProfile = (v.find("true") != std::string::npos);
-                v = find_str("freshRun"); if (!v.empty()) e.freshRun = (v.find("true") != std::string::npos);
-
-                // Lightweight attempt to parse selectedOptions: look for "selectedOptions" and extract a simple array
-                auto posSo = txt.find("\"selectedOptions\"");
-                if (posSo != std::string::npos) {
-                    auto bracket = txt.find('[', posSo);
-                    if (bracket != std::string::npos) {
-                        auto endb = txt.find(']', bracket);
-                        if (endb != std::string::npos && endb > bracket) {
-                            std::string body = txt.substr(bracket+1, endb - bracket - 1);
-                            // Split by commas and trim
-                            std::vector<std::string> parts;
-                            size_t p = 0;
-                            while (p < body.size()) {
-                                auto comma = body.find(',', p);
-                                if (comma == std::string::npos) comma = body.size();
-                                std::string token = body.substr(p, comma - p);
-                                // trim
-                                auto l = token.find_first_not_of(" \t\n\r");
-                                auto r = token.find_last_not_of(" \t\n\r");
-                                if (l != std::string::npos && r != std::string::npos) token = token.substr(l, r - l + 1);
-                                else token = "";
-                                if (!token.empty()) parts.push_back(token);
-                                p = comma + 1;
-                            }
-                            // Determine if parts are booleans or indices
-                            bool allBool = true; bool allInt = true;
-                            for (auto &tkn : parts) {
-                                std::string tl = tkn;
-                                for (auto &c : tl) c = (char)std::tolower(c);
-                                if (!(tl == "true" || tl == "false")) allBool = false;
-                                try { std::size_t idx; std::stoul(tkn); } catch(...) { allInt = false; }
-                            }
-                            if (allBool && parts.size() == 61) {
-                                e.selectedOptions.clear(); e.selectedOptions.resize(61);
-                                for (size_t i = 0; i < 61 && i < parts.size(); ++i) {
-                                    auto tl = parts[i]; for (auto &c : tl) c = (char)std::tolower(c);
-                                    e.selectedOptions[i] = (tl == "true");
-                                }
-                                e.selectedOptionsSet = true;
-                            } else if (allInt) {
-                                e.selectedOptions = std::vector<bool>(61, false);
-                                for (auto &tkn : parts) {
-                                    try {
-                                        int idx = std::stoi(tkn);
-                                        if (idx >= 0 && idx < 61) e.selectedOptions[idx] = true;
-                                    } catch (...) { }
-                                }
-                                e.selectedOptionsSet = true;
-                            }
-                        }
-                    }
-                }
-
                 setGlobalEnv(e);
                 std::cout << "Applied env: deck=" << e.deck << ", stake=" << e.stake << ", tag=" << e.tag << ", showman=" << (e.showman?"true":"false")
                           << ", unlockedTags=" << e.unlockedTags.size() << ", unlockedJokers=" << e.unlockedJokers.size() << std::endl;
@@ -756,6 +1556,31 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Refinement: a seed list instead of a range, with no journal
+    if (!inputPath.empty()) {
+        if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+        const bool binary = inputFormat == "binary" ||
+                            (inputFormat == "auto" && inputPath.size() > 4 && inputPath.compare(inputPath.size() - 4, 4, ".bin") == 0);
+        if (outputPath.empty()) {
+            const auto t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            std::stringstream name;
+            name << "dist/refined_" << std::put_time(std::localtime(&t), "%Y%m%d_%H%M%S") << ".csv";
+            outputPath = name.str();
+        }
+        std::unique_ptr<DescribePool> describer;
+        if (describeMatches) {
+            const std::string describePath = outputPath == "-" ? "dist/refined_stdout.describe.jsonl" : describePathFor(outputPath);
+            describer = makeDescribePool(describeQueue);
+            if (!describer->start(describePath, describeThreads)) {
+                log_error("Could not create describe file: ", describePath);
+                return 1;
+            }
+            std::cerr << "Describing matches to: " << describePath << std::endl;
+        }
+        return runRefinement(inputPath, binary ? SeedInput::Format::BINARY : SeedInput::Format::TEXT, outputPath, ordered,
+                             numThreads, interleave, quiet, describer.get());
+    }
+
     // If resume mode requested, try to read existing progress file for this filter
     // Determine filter key (use simplified filter name from getCurrentFilter()->getName())
     std::string filterKeyRaw = getCurrentFilter()->getName();
@@ -766,37 +1591,96 @@ int main(int argc, char* argv[]) {
         else if (std::isspace((unsigned char)ch)) filterKey.push_back('_');
     }
     if (filterKey.empty()) filterKey = "filter";
+    // Bounded runs keep their own progress file so work units don't overwrite each other
+    if (sampleSize > 0) filterKey += "_sample" + std::to_string(sampleKey) + "_" + std::to_string(sampleSize);
+    else if (stats.bounded) filterKey += "_" + std::to_string(stats.rangeStart) + "_" + std::to_string(stats.rangeEnd);
+    // A top-K run journals separately: its chunks' matches live in the top-K file, not the CSV
+    if (topKSize > 0) filterKey += "_top" + std::to_string(topKSize);
 
+    // The journal (progress_journal.hpp) records exactly which chunks are done
+    // and how much of the CSV they account for, so --resume redoes only
+    // unfinished chunks and never logs a match twice
+    const std::string journalPath = "dist/journal_" + filterKey + ".txt";
+    ProgressJournal::State journal;
+    bool haveJournal = false;
     if (resumeMode) {
-        try {
-            std::string progFile = std::string("dist/progress_") + filterKey + ".txt";
-            std::ifstream pf(progFile);
-            if (pf.is_open()) {
-                uint64_t stored = 0;
-                pf >> stored;
-                if (stored > 0) {
-                    std::cout << "Resuming from stored seed number: " << stored << " -> " << numberToSeed(stored) << std::endl;
-                    // Apply margin (subtract) then offset (add)
-                    uint64_t applied = stored;
-                    if (resumeMargin > 0) {
-                        if (applied > resumeMargin) applied = applied - resumeMargin;
-                        else applied = 0;
+        std::string journalError;
+        if (ProgressJournal::load(journalPath, journal, journalError)) {
+            haveJournal = true;
+            startSeedNumber = journal.rangeStart;
+            chunkSize = journal.chunkSize;
+            std::cout << "Resuming from journal " << journalPath << ": every " << (sampleSize > 0 ? "sample position" : "seed")
+                      << " below " << journal.watermark;
+            if (sampleSize == 0) std::cout << " (" << numberToSeed(std::min(journal.watermark, SEED_COUNT - 1)) << ")";
+            std::cout << " is done, plus " << journal.done.size() << " completed range(s) above it" << std::endl;
+            if (resumeMargin > 0 || resumeOffset > 0) log_warn("--resume-margin and --resume-offset are ignored when a journal exists.");
+        } else {
+            // No journal yet: fall back to the older progress file and its guessed margin
+            try {
+                std::string progFile = std::string("dist/progress_") + filterKey + ".txt";
+                std::ifstream pf(progFile);
+                if (pf.is_open()) {
+                    uint64_t stored = 0;
+                    pf >> stored;
+                    if (stored > 0) {
+                        std::cout << "Resuming from stored seed number: " << stored << " -> " << numberToSeed(stored) << std::endl;
+                        // Apply margin (subtract) then offset (add)
+                        uint64_t applied = stored;
+                        if (resumeMargin > 0) {
+                            if (applied > resumeMargin) applied = applied - resumeMargin;
+                            else applied = 0;
+                        }
+                        if (resumeOffset > 0) applied = applied + resumeOffset;
+                        std::cout << "Applied resume margin: " << resumeMargin << ", offset: " << resumeOffset << " -> starting at: " << applied << " (" << numberToSeed(applied) << ")" << std::endl;
+                        if (stats.bounded && applied < stats.rangeStart) applied = stats.rangeStart;
+                        stats.currentSeedNumber.store(applied);
+                        startSeedNumber = applied; // threads will start from this base
                     }
-                    if (resumeOffset > 0) applied = applied + resumeOffset;
-                    std::cout << "Applied resume margin: " << resumeMargin << ", offset: " << resumeOffset << " -> starting at: " << applied << " (" << numberToSeed(applied) << ")" << std::endl;
-                    stats.currentSeedNumber.store(applied);
-                    startSeedNumber = applied; // threads will start from this base
+                    pf.close();
                 }
-                pf.close();
+            } catch (...) {
+                // ignore
             }
-        } catch (...) {
-            // ignore
         }
     }
-    
+    stats.rangeStart = startSeedNumber;
+    std::unique_ptr<SeedPermutation> samplePermutation;
+    if (sampleSize > 0) {
+        samplePermutation.reset(new SeedPermutation(sampleKey));
+        stats.sample = samplePermutation.get();
+    }
+    const std::string topKPath = "dist/topk_" + filterKey + ".csv";
+    std::unique_ptr<TopK::Collector> topK;
+    if (topKSize > 0) {
+        topK.reset(new TopK::Collector(topKSize));
+        stats.topK = topK.get();
+        stats.topKSize = topKSize;
+        // The saved list covers at least the journal's done chunks; chunks
+        // redone after a crash find their seeds already there and add nothing
+        std::vector<TopK::Entry> kept;
+        if (haveJournal && TopK::load(topKPath, kept)) {
+            for (const auto& e : kept) topK->add(e);
+            std::cout << "Resuming with " << kept.size() << " kept seed(s) from " << topKPath << std::endl;
+        }
+    }
+
     // Initialize configurable results with default filter
-    SearchFilter* currentFilter = getCurrentFilter();
-    stats.initializeResults(currentFilter->getResultNames());
+    // The worker loop runs through the concrete filter type when the filter
+    // file names one (SELECTED_FILTER_TYPE), so apply() can inline
+    SearchDriver<SelectedFilterType> driver = makeSelectedDriver(*getCurrentFilter());
+    stats.initializeResults(driver.resultNames());
+
+    if (perfCounters) {
+        // Probe on this thread; each worker then opens its own set
+        PerfEventSet probe;
+        if (probe.available()) {
+            stats.perfEnabled = true;
+            for (int e = 0; e < PerfEventSet::EVENT_COUNT; e++) stats.perfHas[e] = probe.has(e);
+        } else {
+            stats.perfUnavailable = probe.unavailableReason();
+            log_warn("--perf-counters: ", stats.perfUnavailable, "; continuing without them");
+        }
+    }
     
     // Create null stream for filter debug output (since debug mode is disabled in normal search)
     // cross-platform null stream
@@ -813,46 +1697,195 @@ int main(int argc, char* argv[]) {
         numThreads = std::thread::hardware_concurrency();
         if (numThreads == 0) numThreads = 4; // Fallback if auto-detection fails
     }
-    // Progress write throttle (ms)
-    const uint64_t PROGRESS_THROTTLE_MS = 5000;
+    const uint64_t endSeed = stats.rangeEnd;
+    if (startSeedNumber > endSeed) startSeedNumber = stats.rangeStart = endSeed;
+    ProgressJournal::Tracker tracker(startSeedNumber, endSeed, chunkSize);
+    if (haveJournal) {
+        std::string journalError;
+        if (!tracker.restore(journal, journalError)) {
+            log_error(journalPath, ": ", journalError);
+            return 1;
+        }
+    }
+    // Seeds this run will search; less than the range when resuming
+    const uint64_t plannedSeeds = tracker.remaining();
+
+    // Create CSV file with timestamp
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::stringstream ss;
+    ss << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S");
+
+    std::string csvFilename = "dist/matches_" + ss.str() + ".csv";
+    // A resumed run appends to the journal's CSV, cut back to its last checkpoint
+    bool appendCsv = false;
     
-    auto startTime = std::chrono::steady_clock::now();
+    #ifdef ENABLE_LOGS
+
+    if (haveJournal && !journal.csvPath.empty() && ProgressJournal::truncateTo(journal.csvPath, journal.csvBytes)) {
+        appendCsv = true;
+        csvFilename = journal.csvPath;
+    }
+    std::ofstream csvFile(csvFilename, appendCsv ? std::ios::app : std::ios::trunc);
+    if (!csvFile.is_open()) {
+    log_error("Could not create CSV file: ", csvFilename);
+        return 1;
+    }
+
+    #else
+
+    std::streambuf * buf;
+    buf = std::cout.rdbuf();
+    std::ostream csvFile(buf);
+
+    #endif
+
+     
+    // Write CSV header
+    if (!appendCsv) csvFile << "seed,match_level" << std::endl;
+    if (topK) std::cout << "Keeping the " << topKSize << " best-scoring seeds in: " << topKPath << std::endl;
+    else std::cout << "Logging matches to: " << csvFilename << std::endl;
+    // Matches reach the pool with their CSV rows, so it only sees checkpointed seeds
+    std::unique_ptr<DescribePool> describer;
+    if (describeMatches) {
+        const std::string describePath = describePathFor(csvFilename);
+        describer = makeDescribePool(describeQueue);
+        if (!describer->start(describePath, describeThreads)) {
+            log_error("Could not create describe file: ", describePath);
+            return 1;
+        }
+        std::cout << "Describing matches to: " << describePath << std::endl;
+    }
+    
+    // Writes the matches of chunks completed since the last checkpoint, fsyncs
+    // the CSV, then atomically replaces the journal with the state they complete
+    std::mutex checkpointMutex;
+    auto checkpoint = [&]() {
+        std::lock_guard<std::mutex> lock(checkpointMutex);
+        ProgressJournal::State state;
+        std::vector<ProgressJournal::Match> matches;
+        tracker.checkpoint(state, matches);
+        for (const auto& m : matches) logMatch(numberToSeed(m.number), m.level, driver.resultName(m.level), csvFile, csvMutex);
+        csvFile.flush();
+        if (describer) {
+            for (const auto& m : matches) describer->submit(m.number, m.level);
+        }
+        state.filterKey = filterKey;
+        if (topK) {
+            // Written before the journal, so the list always covers the chunks it marks done
+            const bool saved = TopK::save(topKPath, topK->snapshot(), [&](int level) { return driver.resultName(level); },
+                                          [](uint64_t payload) { return getCurrentFilter()->describePayload(payload); });
+            if (!saved) log_warn("Could not write ", topKPath);
+        }
+    #ifdef ENABLE_LOGS
+        AtomicFile::syncPath(csvFilename);
+        state.csvPath = csvFilename;
+        state.csvBytes = ProgressJournal::fileSize(csvFilename);
+    #endif
+        std::string journalError;
+        if (!ProgressJournal::save(journalPath, state, journalError)) log_warn("Journal checkpoint failed: ", journalError);
+        writeProgressFile(filterKey, state.watermark);
+    };
     
-    std::cout << "Starting search with " << numThreads << " threads..." << std::endl;
+
+    std::cout << "Starting search with " << numThreads << " threads";
+    if (interleave > 1) std::cout << ", " << interleave << " seeds interleaved per thread";
+    if (stats.sample) {
+        std::cout << ", sampling " << sampleSize << " of " << SEED_COUNT << " seeds (permutation key " << sampleKey << ", "
+                  << plannedSeeds << " left)";
+    } else if (stats.bounded) {
+        std::cout << " over seed numbers [" << startSeedNumber << ", " << endSeed << ") ("
+                  << plannedSeeds << " seeds left)";
+    }
+    std::cout << "..." << std::endl;
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    auto startTime = std::chrono::steady_clock::now();
     
+    stats.threadCount = numThreads;
+    stats.threadSeeds.reset(new SearchStats::ThreadSeeds[numThreads]);
+    LiveMetrics::Sink metrics(metricsFd, metricsPromPath);
+    MetricsCollector collector(stats, tracker, getCurrentFilter()->getName(), driver.resultNames(), plannedSeeds, startTime);
+    #ifdef SIGPIPE
+    // A metrics reader that goes away must not kill the search
+    if (metricsFd >= 0) std::signal(SIGPIPE, SIG_IGN);
+    #endif
+
+    // Ctrl+C ends the search at the next chunk boundary, so the matches held
+    // for the next checkpoint still reach the CSV
+    installInterruptHandler();
     std::vector<std::thread> threads;
     for (unsigned int i = 0; i < numThreads; i++) {
-        threads.emplace_back(searchWorker, std::ref(found), std::ref(result), std::ref(resultMutex), std::ref(stats), startSeedNumber, i, std::ref(csvFile), std::ref(csvMutex), std::ref(nullStream));
+        threads.emplace_back(searchWorker<SelectedFilterType>, std::ref(driver), std::ref(found), std::ref(stats), std::ref(tracker), std::ref(nullStream), interleave, i);
     }
     
-    // Stats display thread
+    // Checkpoint with its hardware counters added to the checkpoint phase
+    auto measuredCheckpoint = [&](PerfEventSet* perf) {
+        if (!perf) {
+            checkpoint();
+            return;
+        }
+        const PerfEventSet::Snapshot before = perf->read();
+        checkpoint();
+        stats.addPerf(SearchStats::PHASE_CHECKPOINT, perf->read() - before);
+    };
+
+    // Stats thread: screen redraw, metrics snapshots and journal checkpoints, each on its own interval
     std::thread statsThread([&]() {
-        auto lastWrite = std::chrono::steady_clock::now() - std::chrono::milliseconds(PROGRESS_THROTTLE_MS);
+        using std::chrono::milliseconds;
+        std::unique_ptr<PerfEventSet> perf(stats.perfEnabled ? new PerfEventSet() : nullptr);
+        auto lastWrite = std::chrono::steady_clock::now();
+        auto lastMetrics = lastWrite;
+        auto lastDisplay = lastWrite - milliseconds(500);
         while (!found.load()) {
-            displayStats(stats, startTime);
+            // Workers finish their current chunk and take no more
+            if (interruptRequested) found.store(true);
             auto now = std::chrono::steady_clock::now();
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastWrite).count() >= (long)PROGRESS_THROTTLE_MS) {
-                writeProgressFile(filterKey, stats.currentSeedNumber.load());
+            if (!quiet && now - lastDisplay >= milliseconds(500)) {
+                displayStats(stats, startTime);
+                lastDisplay = now;
+            }
+            #ifdef ENABLE_HOT_COUNTERS
+            if (hotReportRequested) {
+                hotReportRequested = 0;
+                HotCounters::report(std::cerr);
+            }
+            #endif
+            if (metrics.enabled() && now - lastMetrics >= milliseconds(metricsIntervalMs)) {
+                metrics.write(collector.take(false));
+                lastMetrics = now;
+            }
+            if (now - lastWrite >= milliseconds(journalIntervalMs)) {
+                measuredCheckpoint(perf.get());
                 lastWrite = now;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            std::this_thread::sleep_for(milliseconds(100));
         }
-        // Final write
-        writeProgressFile(filterKey, stats.currentSeedNumber.load());
-    });
-    
-    // Handle Ctrl+C gracefully
-    std::signal(SIGINT, [](int) {
-        std::cout << "\n\nInterrupted by user." << std::endl;
-        std::exit(1);
     });
     
+    #if defined(ENABLE_HOT_COUNTERS) && defined(SIGUSR1)
+    // kill -USR1 <pid> prints the hot-path counters gathered so far
+    std::signal(SIGUSR1, [](int) { hotReportRequested = 1; });
+    #endif
+
     for (auto& thread : threads) {
         thread.join();
     }
+    // Workers only return on their own once the range is exhausted
+    found.store(true);
     
     statsThread.join();
+    // Final checkpoint: a finished range records its end so --resume has nothing left to do
+    {
+        std::unique_ptr<PerfEventSet> perf(stats.perfEnabled ? new PerfEventSet() : nullptr);
+        measuredCheckpoint(perf.get());
+    }
+    #ifdef ENABLE_HOT_COUNTERS
+    HotCounters::report(std::cerr);
+    #endif
+    if (describer) {
+        if (describer->queued()) std::cout << "Describing " << describer->queued() << " queued match(es)..." << std::endl;
+        describer->finish();
+    }
 
     #ifdef ENABLE_LOGS
 
@@ -861,12 +1894,31 @@ int main(int argc, char* argv[]) {
     #endif
 
     
+    if (metrics.enabled()) metrics.write(collector.take(true));
+
+    if (interruptRequested) {
+        std::cout << "\n\nInterrupted by user after " << stats.totalSeeds.load() << " seeds." << std::endl;
+        if (topK) std::cout << "Best seeds so far in: " << topKPath << std::endl;
+        else std::cout << "Matches so far logged to: " << csvFilename << std::endl;
+        std::cout << "Run again with --resume to continue." << std::endl;
+        return 1;
+    }
+
     // Final stats display
-    displayStats(stats, startTime);
-    std::cout << "\n*** SEARCH COMPLETE ***" << std::endl;
-    std::cout << "Found seed: " << result << std::endl;
-    std::cout << "Last processed seed: " << numberToSeed(stats.currentSeedNumber.load()) << std::endl;
-    std::cout << "Matches logged to: " << csvFilename << std::endl;
+    if (!quiet) displayStats(stats, startTime);
+    if (stats.sample) {
+        printSampleSummary(stats, plannedSeeds, sampleKey, driver.resultNames(), startTime);
+    } else if (stats.bounded) {
+        printRangeSummary(stats, plannedSeeds, driver.resultNames(), startTime);
+    } else {
+        std::cout << "\n*** SEARCH COMPLETE ***" << std::endl;
+        std::cout << "Found seed: " << result << std::endl;
+        std::cout << "Last processed seed: " << numberToSeed(stats.currentSeedNumber.load()) << std::endl;
+    }
+    if (topK) printTopK(*topK, topKPath, driver.resultNames());
+    else std::cout << "Matches logged to: " << csvFilename << std::endl;
+    if (describer) printDescribeSummary(*describer, std::cout);
+    if (stats.bounded) return stats.totalSeeds.load() == plannedSeeds ? 0 : 1;
     
     return 0;
 }
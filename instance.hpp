@@ -8,6 +8,7 @@
 #include "rand_util.hpp"
 #include "bitmap_lock.hpp"
 #include "debug.hpp"
+#include "hot_counters.hpp"
 #include <unordered_map>
 // #include <map>
 #include <array>
@@ -41,36 +42,55 @@ namespace Instance {
         // Cache for generated first pack
         bool generatedFirstPack;
         
+        // pseudohash(ID + seed) state once the seed characters are consumed,
+        // per ID length since the positional term depends on the total length
+        static constexpr size_t MAX_PREFIX_ID_LEN = 63;
+        double seedPrefix[MAX_PREFIX_ID_LEN + 1];
+        uint64_t seedPrefixValid = 0;
+
+        // pseudohash(ID + seed) without building the string or rehashing the seed per ID
+        double hashNode(const std::string& ID) {
+            const size_t idLen = ID.size();
+            if (idLen > MAX_PREFIX_ID_LEN) return pseudohash(ID + seed);
+            const uint64_t bit = 1ull << idLen;
+            if (!(seedPrefixValid & bit)) {
+                const size_t seedLen = seed.size();
+                const size_t len = idLen + seedLen;
+                double num = 1.0;
+                for (size_t i = 0; i < seedLen; i++) {
+                    num = pseudohash_step(num, seed[seedLen-1-i], len-i);
+                }
+                seedPrefix[idLen] = num;
+                seedPrefixValid |= bit;
+            }
+            double num = seedPrefix[idLen];
+            for (size_t j = 0; j < idLen; j++) num = pseudohash_step(num, ID[idLen-1-j], idLen-j);
+            return std::isnan(num) ? std::numeric_limits<double>::quiet_NaN() : num;
+        }
+
         // Fast node computation with caching
         inline double get_node(const std::string& ID) {
             // Optimize: Use find() to avoid double lookup and pre-allocate string
+            HOT_COUNT(HotCounters::GET_NODE);
             auto it = nodeCache.find(ID);
             if (it == nodeCache.end()) {
-                // Pre-allocate string to avoid reallocations
-                std::string combined;
-                combined.reserve(ID.length() + seed.length());
-                combined = ID + seed;
-                // Insert directly with computed hash
-                it = nodeCache.emplace(ID, pseudohash(combined)).first;
+                HOT_COUNT(HotCounters::NODE_MISS);
+                it = nodeCache.emplace(ID, hashNode(ID)).first;
             }
             
             // Update the cached value in-place - optimized fmod(x, 1) = x - floor(x)
-            double temp = it->second * 1.72431234 + 2.134453429141;
-            it->second = round13(temp - std::floor(temp));
-            return (it->second + hashedSeed) / 2;
+            return pseudoseed_advance(it->second, hashedSeed);
         }
         
         // Fast random generation
-        // Use local LuaRandom instances for transient RNG usage to avoid
-        // writing to the member RNG on hot paths (reduces memory writes).
+        // Each call is a single draw from a fresh generator, so it goes through
+        // the precomputed warm-up jump instead of a LuaRandom instance.
         double random(const std::string& ID) {
-            LuaRandom local_rng(get_node(ID));
-            return local_rng.random();
+            return lua_random_once(get_node(ID));
         }
 
         int randint(const std::string& ID, int min, int max) {
-            LuaRandom local_rng(get_node(ID));
-            return local_rng.randint(min, max);
+            return lua_randint_once(get_node(ID), min, max);
         }
         
     public:
@@ -90,6 +110,7 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast tarot generation
         Items::Tarot nextTarot_enum(const std::string& source, int ante, bool soulable = false) {
+            HOT_COUNT(HotCounters::GEN_TAROT);
             std::string anteStr = std::to_string(ante);
             
             // Fast soul card check with direct enum comparison
@@ -106,6 +127,7 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast planet generation  
         Items::Planet nextPlanet_enum(const std::string& source, int ante, bool soulable = false) {
+            HOT_COUNT(HotCounters::GEN_PLANET);
             std::string anteStr = std::to_string(ante);
             
             // Fast black hole check with direct enum comparison
@@ -122,6 +144,7 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast spectral generation
         Items::Spectral nextSpectral_enum(const std::string& source, int ante, bool soulable = false) {
+            HOT_COUNT(HotCounters::GEN_SPECTRAL);
             std::string anteStr = std::to_string(ante);
             
             if (soulable) {
@@ -143,6 +166,7 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast joker generation
         Items::OptimizedJokerData nextJoker_enum(const std::string& source, int ante, bool hasStickers = false) {
+            HOT_COUNT(HotCounters::GEN_JOKER);
             std::string anteStr = std::to_string(ante);
             
             // Fast rarity determination
@@ -261,18 +285,21 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast tag generation
         Items::Tag nextTag_enum(int ante) {
+            HOT_COUNT(HotCounters::GEN_TAG);
             auto get_node_func = [this](const std::string& id) { return get_node(id); };
             return Items::TagChoice(get_node_func, enumLocks, showman, "Tag" + std::to_string(ante));
         }
         
         // CRITICAL HOT PATH: Ultra-fast voucher generation
         Items::Voucher nextVoucher_enum(int ante) {
+            HOT_COUNT(HotCounters::GEN_VOUCHER);
             auto get_node_func = [this](const std::string& id) { return get_node(id); };
             return Items::VoucherChoice(get_node_func, enumLocks, showman, "Voucher" + std::to_string(ante));
         }
         
         // CRITICAL HOT PATH: Ultra-fast boss generation
         Items::Boss nextBoss_enum(int ante) {
+            HOT_COUNT(HotCounters::GEN_BOSS);
             // Fast boss pool construction using enum arrays
             std::vector<Items::Boss> bossPool;
             bool needsTemple = (ante % 8 == 0);
@@ -309,8 +336,7 @@ namespace Instance {
             }
 
             // Fast selection from pool
-            LuaRandom rng(get_node("boss"));
-            Items::Boss chosenBoss = bossPool[rng.randint(0, bossPool.size() - 1)];
+            Items::Boss chosenBoss = bossPool[lua_randint_once(get_node("boss"), 0, bossPool.size() - 1)];
             enumLocks.lock(chosenBoss);
 
             return chosenBoss;
@@ -318,6 +344,7 @@ namespace Instance {
 
         // CRITICAL HOT PATH: Ultra-fast shop item generation
         Items::OptimizedShopItem nextShopItem_enum(int ante) {
+            HOT_COUNT(HotCounters::GEN_SHOP_ITEM);
             std::string anteStr = std::to_string(ante);
             
             // Fast shop rate calculation (simplified)
@@ -368,6 +395,7 @@ namespace Instance {
         // ========================================
         
         Items::MixedArcanaPack nextArcanaPack_enum(int size, int ante) {
+            HOT_COUNT(HotCounters::GEN_ARCANA_PACK);
             Items::MixedArcanaPack pack;
             pack.tarots.reserve(size);
             pack.spectrals.reserve(size);
@@ -404,6 +432,7 @@ namespace Instance {
         }
         
         std::vector<Items::Planet> nextCelestialPack_enum(int size, int ante) {
+            HOT_COUNT(HotCounters::GEN_CELESTIAL_PACK);
             std::vector<Items::Planet> pack;
             pack.reserve(size);
             
@@ -420,6 +449,7 @@ namespace Instance {
         }
         
         std::vector<Items::Spectral> nextSpectralPack_enum(int size, int ante) {
+            HOT_COUNT(HotCounters::GEN_SPECTRAL_PACK);
             std::vector<Items::Spectral> pack;
             pack.reserve(size);
             
@@ -436,6 +466,7 @@ namespace Instance {
         }
         
         std::vector<Items::OptimizedJokerData> nextBuffoonPack_enum(int size, int ante) {
+            HOT_COUNT(HotCounters::GEN_BUFFOON_PACK);
             std::vector<Items::OptimizedJokerData> pack;
             pack.reserve(size);
             
@@ -453,6 +484,7 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast standard card generation
         Items::CardEnum nextStandardCard_enum(int ante) {
+            HOT_COUNT(HotCounters::GEN_STANDARD_CARD);
             std::string anteStr = std::to_string(ante);
 
             // Enhancement determination - EXACT SAME LOGIC as original
@@ -492,6 +524,7 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast standard pack generation
         std::vector<Items::CardEnum> nextStandardPack_enum(int size, int ante) {
+            HOT_COUNT(HotCounters::GEN_STANDARD_PACK);
             std::vector<Items::CardEnum> pack;
             pack.reserve(size);
             
@@ -504,6 +537,7 @@ namespace Instance {
         
         // CRITICAL HOT PATH: Ultra-fast pack generation
         Items::Pack nextPack_enum(int ante) {
+            HOT_COUNT(HotCounters::GEN_PACK);
             // EXACT SAME LOGIC as original nextPack
             if (ante <= 2 && !generatedFirstPack && version > 10099) {
                 generatedFirstPack = true;
@@ -520,10 +554,12 @@ namespace Instance {
                 if (resample == 1) {
                     chosen_pack = Items::PackChoice(get_node_func, "shop_pack" + anteStr);
                 } else {
+                    HOT_COUNT(HotCounters::RESAMPLE);
                     chosen_pack = Items::PackChoice(get_node_func, "shop_pack" + anteStr + "_resample" + std::to_string(resample));
                 }
                 resample++;
             } while (chosen_pack == Items::Pack::INVALID && resample <= 1000);
+            if (chosen_pack == Items::Pack::INVALID) HOT_COUNT(HotCounters::RESAMPLE_CAP);
             
             return (chosen_pack == Items::Pack::INVALID) ? Items::Pack::ARCANA_PACK : chosen_pack;
         }
@@ -833,8 +869,17 @@ namespace Instance {
                 }
             }
         }
-        
+
+        // An owned joker leaves the pools for the rest of the run, unless Showman allows duplicates
+        void lockJoker_enum(Items::Joker joker) {
+            if (!showman) enumLocks.lock(joker);
+        }
+
         const std::string& getSeed() const { return seed; }
+        // One pseudoseed draw for `ID` (cached node update); used by the benchmark suite
+        double node(const std::string& ID) { return get_node(ID); }
+        // Lock state after initLocks(); used by generated kernels as their starting template
+        const Locks::EnumLockSystem& getLocks() const { return enumLocks; }
         bool isShowman() const { return showman; }
         long getVersion() const { return version; }
     };
@@ -0,0 +1,594 @@
+#pragma once
+
+#include "instance.hpp"
+#include "kernel_runtime.hpp"
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Structure-of-arrays counterpart of Instance::Instance for N seeds advanced
+// in lockstep. Node IDs never depend on the seed, so a node is looked up once
+// per call and its N lane states sit next to each other; lock bitsets are
+// stored per item as lane masks. Every generator takes a lane mask so filters
+// can drop lanes as they fail; lanes that need resampling are masked out of
+// the wide step and finished on a scalar path.
+
+namespace Instance {
+
+    // Per-item lane masks for one lockable enum (bit l set = locked in lane l)
+    template<typename EnumType>
+    class LaneLockTable {
+    public:
+        static constexpr size_t COUNT = static_cast<size_t>(EnumType::COUNT);
+
+        void assign(const Locks::EnumLockSystem& locks, uint64_t lanes) {
+            for (size_t i = 0; i < COUNT; i++) {
+                masks[i] = locks.isLocked(static_cast<EnumType>(i)) ? lanes : 0;
+            }
+        }
+
+        // INVALID entries are never locked
+        INLINE_FORCE uint64_t locked(EnumType e) const {
+            size_t i = static_cast<size_t>(e);
+            return i < COUNT ? masks[i] : 0;
+        }
+        INLINE_FORCE void lock(EnumType e, uint64_t lanes) {
+            size_t i = static_cast<size_t>(e);
+            if (i < COUNT) masks[i] |= lanes;
+        }
+        INLINE_FORCE void unlock(EnumType e, uint64_t lanes) {
+            size_t i = static_cast<size_t>(e);
+            if (i < COUNT) masks[i] &= ~lanes;
+        }
+
+    private:
+        std::array<uint64_t, COUNT> masks{};
+    };
+
+    template<size_t N>
+    class InstanceBatch {
+        static_assert(N >= 1 && N <= 64, "InstanceBatch lane masks are 64-bit");
+
+    public:
+        using LaneMask = uint64_t;
+        static constexpr size_t MAX_PACK_SIZE = 5;
+
+        struct ArcanaPack {
+            int size = 0;
+            Items::Tarot tarots[MAX_PACK_SIZE][N];
+            Items::Spectral spectrals[MAX_PACK_SIZE][N];
+            LaneMask isSpectral[MAX_PACK_SIZE];
+        };
+
+        static constexpr LaneMask allLanes() { return N == 64 ? ~0ull : ((1ull << N) - 1); }
+        static constexpr LaneMask laneBit(size_t lane) { return 1ull << lane; }
+
+        InstanceBatch() {
+            nodes.reserve(32);
+            baseLocks.resetAll();
+            for (size_t l = 0; l < N; l++) hashedSeed[l] = 1.0;
+        }
+
+        // ========================================
+        // SETUP
+        // ========================================
+
+        void setDeck(const std::string& d) { deck = d; }
+        void setStake(const std::string& s) { stake = s; }
+        void setShowman(bool s) { showman = s; }
+        void setVersion(long v) { version = v; }
+
+        // Same lock template as Instance::initLocks(); computed once and
+        // restored by every reset()
+        void initLocks(int ante, bool freshProfile, bool freshRun) {
+            Instance inst("");
+            inst.setDeck(deck);
+            inst.setStake(stake);
+            inst.setShowman(showman);
+            inst.setVersion(version);
+            inst.initLocks(ante, freshProfile, freshRun);
+            baseLocks = inst.getLocks();
+            baseTags.assign(baseLocks, allLanes());
+            baseTarots.assign(baseLocks, allLanes());
+            basePlanets.assign(baseLocks, allLanes());
+            baseSpectrals.assign(baseLocks, allLanes());
+            baseJokers.assign(baseLocks, allLanes());
+        }
+
+        // Loads up to N seeds into lanes 0..count-1 and returns their mask
+        LaneMask reset(const std::string* seedList, size_t count) {
+            if (count > N) count = N;
+            lanes = 0;
+            for (size_t l = 0; l < N; l++) {
+                if (l < count) {
+                    seeds[l] = seedList[l];
+                    lanes |= laneBit(l);
+                } else {
+                    seeds[l].clear();
+                }
+                hashedSeed[l] = pseudohash(seeds[l]);
+            }
+            // Node IDs do not depend on the seed, so the table is kept across
+            // batches and only the lane states are invalidated
+            for (auto& n : nodes) n.ready = 0;
+            for (auto& m : prefixReady) m = 0;
+            tagLocks = baseTags;
+            tarotLocks = baseTarots;
+            planetLocks = basePlanets;
+            spectralLocks = baseSpectrals;
+            jokerLocks = baseJokers;
+            return lanes;
+        }
+
+        LaneMask activeLanes() const { return lanes; }
+        const std::string& getSeed(size_t lane) const { return seeds[lane]; }
+        bool isShowman() const { return showman; }
+
+        // ========================================
+        // GENERATORS
+        // ========================================
+
+        void nextTag(int ante, LaneMask mask, Items::Tag* out) {
+            randchoice("Tag" + std::to_string(ante), Items::ALL_TAGS, tagLocks, mask, out);
+        }
+
+        void nextTarot(const std::string& source, int ante, bool soulable, LaneMask mask, Items::Tarot* out) {
+            std::string anteStr = std::to_string(ante);
+            LaneMask rest = mask & lanes;
+            if (soulable) {
+                LaneMask check = rest & ~(showman ? 0 : tarotLocks.locked(Items::Tarot::SPECIAL_THE_SOUL));
+                rest &= ~forced(check, "soul_Tarot" + anteStr, Items::Tarot::SPECIAL_THE_SOUL, out);
+            }
+            randchoice("Tarot" + source + anteStr, Items::ALL_TAROTS, tarotLocks, rest, out);
+        }
+
+        void nextPlanet(const std::string& source, int ante, bool soulable, LaneMask mask, Items::Planet* out) {
+            std::string anteStr = std::to_string(ante);
+            LaneMask rest = mask & lanes;
+            if (soulable) {
+                LaneMask check = rest & ~(showman ? 0 : planetLocks.locked(Items::Planet::SPECIAL_BLACK_HOLE));
+                rest &= ~forced(check, "soul_Planet" + anteStr, Items::Planet::SPECIAL_BLACK_HOLE, out);
+            }
+            randchoice("Planet" + source + anteStr, Items::ALL_PLANETS, planetLocks, rest, out);
+        }
+
+        void nextSpectral(const std::string& source, int ante, bool soulable, LaneMask mask, Items::Spectral* out) {
+            std::string anteStr = std::to_string(ante);
+            LaneMask rest = mask & lanes;
+            if (soulable) {
+                // Both polls share one node; a Black Hole hit overrides The Soul
+                std::string soulKey = "soul_Spectral" + anteStr;
+                LaneMask check = rest & ~(showman ? 0 : spectralLocks.locked(Items::Spectral::SPECTRAL_THE_SOUL));
+                LaneMask hit = forced(check, soulKey, Items::Spectral::SPECTRAL_THE_SOUL, out);
+                check = rest & ~(showman ? 0 : spectralLocks.locked(Items::Spectral::SPECTRAL_BLACK_HOLE));
+                hit |= forced(check, soulKey, Items::Spectral::SPECTRAL_BLACK_HOLE, out);
+                rest &= ~hit;
+            }
+            randchoice("Spectral" + source + anteStr, Items::ALL_SPECTRALS, spectralLocks, rest, out);
+        }
+
+        void nextJoker(const std::string& source, int ante, bool hasStickers, LaneMask mask, Items::OptimizedJokerData* out) {
+            std::string anteStr = std::to_string(ante);
+            mask &= lanes;
+            if (!mask) return;
+            double poll[N];
+
+            uint8_t rarity[N];
+            uint8_t fixedRarity = 0;
+            if (source == "sou") fixedRarity = 4;
+            else if (source == "wra") fixedRarity = 3;
+            else if (source == "rta") fixedRarity = 3;
+            else if (source == "uta") fixedRarity = 2;
+            if (fixedRarity) {
+                for (size_t l = 0; l < N; l++) rarity[l] = fixedRarity;
+            } else {
+                random("rarity" + anteStr + source, mask, poll);
+                for (size_t l = 0; l < N; l++) {
+                    rarity[l] = poll[l] > 0.95 ? 3 : poll[l] > 0.7 ? 2 : 1;
+                }
+            }
+
+            int editionRate = 1;
+            if (baseLocks.isVoucherActive(Items::Voucher::GLOW_UP)) editionRate = 4;
+            else if (baseLocks.isVoucherActive(Items::Voucher::HONE)) editionRate = 2;
+            random("edi" + source + anteStr, mask, poll);
+            Items::Edition edition[N];
+            for (size_t l = 0; l < N; l++) {
+                if (poll[l] > 0.997) edition[l] = Items::Edition::NEGATIVE;
+                else if (poll[l] > 1 - 0.006 * editionRate) edition[l] = Items::Edition::POLYCHROME;
+                else if (poll[l] > 1 - 0.02 * editionRate) edition[l] = Items::Edition::HOLOGRAPHIC;
+                else if (poll[l] > 1 - 0.04 * editionRate) edition[l] = Items::Edition::FOIL;
+                else edition[l] = Items::Edition::NO_EDITION;
+            }
+
+            Items::Joker joker[N];
+            LaneMask byRarity[5] = {0, 0, 0, 0, 0};
+            for (size_t l = 0; l < N; l++) {
+                if (mask & laneBit(l)) byRarity[rarity[l]] |= laneBit(l);
+            }
+            if (byRarity[4]) {
+                randchoice(version > 10099 ? std::string("Joker4") : "Joker4" + source + anteStr,
+                           Items::LEGENDARY_JOKERS, jokerLocks, byRarity[4], joker);
+            }
+            if (byRarity[3]) randchoice("Joker3" + source + anteStr, Items::RARE_JOKERS, jokerLocks, byRarity[3], joker);
+            if (byRarity[2]) randchoice("Joker2" + source + anteStr, Items::UNCOMMON_JOKERS, jokerLocks, byRarity[2], joker);
+            if (byRarity[1]) randchoice("Joker1" + source + anteStr, Items::COMMON_JOKERS, jokerLocks, byRarity[1], joker);
+
+            LaneMask eternal = 0, perishable = 0, rental = 0;
+            if (hasStickers) {
+                const bool eternalStake = stake == "Black Stake" || stake == "Blue Stake" || stake == "Purple Stake" ||
+                                          stake == "Orange Stake" || stake == "Gold Stake";
+                const bool perishableStake = stake == "Orange Stake" || stake == "Gold Stake";
+                const bool goldStake = stake == "Gold Stake";
+                if (version > 10103) {
+                    random(((source == "buf") ? "packetper" : "etperpoll") + anteStr, mask, poll);
+                    for (size_t l = 0; l < N; l++) {
+                        if (!(mask & laneBit(l))) continue;
+                        if (poll[l] > 0.7 && eternalStake && canBeEternal(joker[l])) eternal |= laneBit(l);
+                        if (poll[l] > 0.4 && poll[l] <= 0.7 && perishableStake && canBePerishable(joker[l])) perishable |= laneBit(l);
+                    }
+                    if (goldStake) rental = above(((source == "buf") ? "packssjr" : "ssjr") + anteStr, mask, 0.7);
+                } else {
+                    if (eternalStake) {
+                        LaneMask candidates = 0;
+                        for (size_t l = 0; l < N; l++) {
+                            if ((mask & laneBit(l)) && canBeEternal(joker[l])) candidates |= laneBit(l);
+                        }
+                        eternal = above("stake_shop_joker_eternal" + anteStr, candidates, 0.7);
+                    }
+                    if (version > 10099) {
+                        if (perishableStake) perishable = above("ssjp" + anteStr, mask & ~eternal, 0.49);
+                        if (goldStake) rental = above("ssjr" + anteStr, mask, 0.7);
+                    }
+                }
+            }
+
+            for (size_t l = 0; l < N; l++) {
+                if (!(mask & laneBit(l))) continue;
+                out[l] = Items::OptimizedJokerData(joker[l], rarity[l], edition[l],
+                                                   (eternal >> l) & 1, (perishable >> l) & 1, (rental >> l) & 1);
+            }
+        }
+
+        void nextShopItem(int ante, LaneMask mask, Items::OptimizedShopItem* out) {
+            std::string anteStr = std::to_string(ante);
+            mask &= lanes;
+            if (!mask) return;
+
+            double jokerRate = 20, tarotRate = 4, planetRate = 4;
+            double playingCardRate = 0, spectralRate = 0;
+            if (deck == "Ghost Deck") spectralRate = 2;
+            if (baseLocks.isVoucherActive(Items::Voucher::TAROT_TYCOON)) tarotRate = 32;
+            else if (baseLocks.isVoucherActive(Items::Voucher::TAROT_MERCHANT)) tarotRate = 9.6;
+            if (baseLocks.isVoucherActive(Items::Voucher::PLANET_TYCOON)) planetRate = 32;
+            else if (baseLocks.isVoucherActive(Items::Voucher::PLANET_MERCHANT)) planetRate = 9.6;
+            if (baseLocks.isVoucherActive(Items::Voucher::MAGIC_TRICK)) playingCardRate = 4;
+            double totalRate = jokerRate + tarotRate + planetRate + playingCardRate + spectralRate;
+
+            double poll[N];
+            random("cdt" + anteStr, mask, poll);
+            LaneMask jokers = 0, tarots = 0, planets = 0, spectrals = 0;
+            for (size_t l = 0; l < N; l++) {
+                if (!(mask & laneBit(l))) continue;
+                double cdtPoll = poll[l] * totalRate;
+                if (cdtPoll < jokerRate) { jokers |= laneBit(l); continue; }
+                cdtPoll -= jokerRate;
+                if (cdtPoll < tarotRate) { tarots |= laneBit(l); continue; }
+                cdtPoll -= tarotRate;
+                if (cdtPoll < planetRate) planets |= laneBit(l);
+                else spectrals |= laneBit(l);
+            }
+
+            if (jokers) {
+                Items::OptimizedJokerData data[N];
+                nextJoker("sho", ante, true, jokers, data);
+                forEachLane(jokers, [&](size_t l) { out[l] = Items::OptimizedShopItem(data[l].joker, data[l]); });
+            }
+            if (tarots) {
+                Items::Tarot t[N];
+                nextTarot("sho", ante, false, tarots, t);
+                forEachLane(tarots, [&](size_t l) { out[l] = Items::OptimizedShopItem(t[l]); });
+            }
+            if (planets) {
+                Items::Planet p[N];
+                nextPlanet("sho", ante, false, planets, p);
+                forEachLane(planets, [&](size_t l) { out[l] = Items::OptimizedShopItem(p[l]); });
+            }
+            if (spectrals) {
+                Items::Spectral s[N];
+                nextSpectral("sho", ante, false, spectrals, s);
+                forEachLane(spectrals, [&](size_t l) { out[l] = Items::OptimizedShopItem(s[l]); });
+            }
+        }
+
+        void nextArcanaPack(int size, int ante, LaneMask mask, ArcanaPack& out) {
+            mask &= lanes;
+            if (size > static_cast<int>(MAX_PACK_SIZE)) size = MAX_PACK_SIZE;
+            out.size = size;
+            const bool omenGlobe = baseLocks.isVoucherActive(Items::Voucher::OMEN_GLOBE);
+
+            for (int i = 0; i < size; i++) {
+                LaneMask spectralLanes = omenGlobe ? above("omen_globe", mask, 0.8) : 0;
+                LaneMask tarotLanes = mask & ~spectralLanes;
+                out.isSpectral[i] = spectralLanes;
+                if (spectralLanes) {
+                    nextSpectral("ar2", ante, true, spectralLanes, out.spectrals[i]);
+                    forEachLane(spectralLanes, [&](size_t l) {
+                        out.tarots[i][l] = Items::Tarot::INVALID;
+                        if (!showman) spectralLocks.lock(out.spectrals[i][l], laneBit(l));
+                    });
+                }
+                if (tarotLanes) {
+                    nextTarot("ar1", ante, true, tarotLanes, out.tarots[i]);
+                    forEachLane(tarotLanes, [&](size_t l) {
+                        out.spectrals[i][l] = Items::Spectral::INVALID;
+                        if (!showman) tarotLocks.lock(out.tarots[i][l], laneBit(l));
+                    });
+                }
+            }
+
+            for (int i = 0; i < size; i++) {
+                forEachLane(mask, [&](size_t l) {
+                    if (out.isSpectral[i] & laneBit(l)) spectralLocks.unlock(out.spectrals[i][l], laneBit(l));
+                    else tarotLocks.unlock(out.tarots[i][l], laneBit(l));
+                });
+            }
+        }
+
+    private:
+        struct Node {
+            std::array<double, N> state;
+            LaneMask ready;
+        };
+
+        std::string seeds[N];
+        double hashedSeed[N];
+        LaneMask lanes = 0;
+
+        std::vector<Node> nodes;
+        std::unordered_map<std::string, size_t> nodeIndex;
+        // Seed part of pseudohash(ID + seed) per ID length, shared by all IDs of that length
+        double prefix[Kernel::MAX_KEY_LEN + 1][N];
+        LaneMask prefixReady[Kernel::MAX_KEY_LEN + 1] = {};
+
+        std::string deck = "Red Deck";
+        std::string stake = "White Stake";
+        bool showman = false;
+        long version = 10106;
+
+        Locks::EnumLockSystem baseLocks;
+        LaneLockTable<Items::Tag> baseTags, tagLocks;
+        LaneLockTable<Items::Tarot> baseTarots, tarotLocks;
+        LaneLockTable<Items::Planet> basePlanets, planetLocks;
+        LaneLockTable<Items::Spectral> baseSpectrals, spectralLocks;
+        LaneLockTable<Items::Joker> baseJokers, jokerLocks;
+
+        template<typename Fn>
+        static INLINE_FORCE void forEachLane(LaneMask mask, Fn fn) {
+            while (mask) {
+                size_t l = static_cast<size_t>(__builtin_ctzll(mask));
+                mask &= mask - 1;
+                fn(l);
+            }
+        }
+
+        // Index of `id`, hashing it for the lanes in `mask` that have not seen it yet
+        size_t node(const std::string& id, LaneMask mask) {
+            auto it = nodeIndex.find(id);
+            size_t idx;
+            if (it == nodeIndex.end()) {
+                idx = nodes.size();
+                nodes.emplace_back();
+                nodes.back().state.fill(0);
+                nodes.back().ready = 0;
+                nodeIndex.emplace(id, idx);
+            } else {
+                idx = it->second;
+            }
+            LaneMask missing = mask & ~nodes[idx].ready;
+            if (missing) {
+                hashLanes(id, missing, nodes[idx].state.data());
+                nodes[idx].ready |= missing;
+            }
+            return idx;
+        }
+
+        // Wide loops run every lane; once most lanes have dropped out it is
+        // cheaper to visit only the survivors
+        static INLINE_FORCE bool sparse(LaneMask mask) {
+            return static_cast<size_t>(__builtin_popcountll(mask)) * 2 < N;
+        }
+
+        void hashLanes(const std::string& id, LaneMask mask, double* out) {
+            const size_t idLen = id.size();
+            if (idLen > Kernel::MAX_KEY_LEN) {
+                forEachLane(mask, [&](size_t l) { out[l] = pseudohash(id + seeds[l]); });
+                return;
+            }
+            forEachLane(mask & ~prefixReady[idLen], [&](size_t l) {
+                const std::string& s = seeds[l];
+                const size_t len = idLen + s.size();
+                double num = 1.0;
+                for (size_t i = 0; i < s.size(); i++) {
+                    num = pseudohash_step(num, s[s.size()-1-i], len-i);
+                }
+                prefix[idLen][l] = num;
+            });
+            prefixReady[idLen] |= mask;
+
+            if (sparse(mask)) {
+                forEachLane(mask, [&](size_t l) {
+                    double num = prefix[idLen][l];
+                    for (size_t j = 0; j < idLen; j++) num = pseudohash_step(num, id[idLen-1-j], idLen-j);
+                    out[l] = num;
+                });
+                return;
+            }
+            // ID characters are the same in every lane: the wide part of the hash
+            double num[N];
+            for (size_t l = 0; l < N; l++) num[l] = (prefixReady[idLen] & laneBit(l)) ? prefix[idLen][l] : 1.0;
+            for (size_t j = 0; j < idLen; j++) {
+                const char c = id[idLen-1-j];
+                const size_t k = idLen - j;
+                for (size_t l = 0; l < N; l++) num[l] = pseudohash_step(num[l], c, k);
+            }
+            forEachLane(mask, [&](size_t l) { out[l] = num[l]; });
+        }
+
+        // random(id) for every lane in `mask`; other lanes of `out` are unspecified
+        void random(const std::string& id, LaneMask mask, double* out) {
+            if (!mask) return;
+            Node& n = nodes[node(id, mask)];
+            if (sparse(mask)) {
+                forEachLane(mask, [&](size_t l) {
+                    out[l] = lua_random_once(pseudoseed_advance(n.state[l], hashedSeed[l]));
+                });
+                return;
+            }
+            for (size_t l = 0; l < N; l++) {
+                double state = n.state[l];
+                out[l] = lua_random_once(pseudoseed_advance(state, hashedSeed[l]));
+                if (mask & laneBit(l)) n.state[l] = state;
+            }
+        }
+
+        LaneMask above(const std::string& id, LaneMask mask, double threshold) {
+            double poll[N];
+            random(id, mask, poll);
+            LaneMask hit = 0;
+            forEachLane(mask, [&](size_t l) { if (poll[l] > threshold) hit |= laneBit(l); });
+            return hit;
+        }
+
+        // Soul-style poll: lanes in `mask` drawing above 0.997 get `item`
+        template<typename EnumType>
+        LaneMask forced(LaneMask mask, const std::string& id, EnumType item, EnumType* out) {
+            LaneMask hit = above(id, mask, 0.997);
+            forEachLane(hit, [&](size_t l) { out[l] = item; });
+            return hit;
+        }
+
+        // Items::enum_randchoice across lanes; locked or INVALID draws are
+        // finished per lane on the scalar resample path
+        template<typename EnumType, size_t ArraySize>
+        void randchoice(const std::string& id, const std::array<EnumType, ArraySize>& items,
+                        const LaneLockTable<EnumType>& locks, LaneMask mask, EnumType* out) {
+            mask &= lanes;
+            if (!mask) return;
+            const EnumType invalid = static_cast<EnumType>(static_cast<std::underlying_type_t<EnumType>>(EnumType::INVALID));
+            Node& n = nodes[node(id, mask)];
+            int pick[N];
+            if (sparse(mask)) {
+                forEachLane(mask, [&](size_t l) {
+                    pick[l] = lua_randint_once(pseudoseed_advance(n.state[l], hashedSeed[l]), 0, ArraySize - 1);
+                });
+            } else {
+                for (size_t l = 0; l < N; l++) {
+                    double state = n.state[l];
+                    pick[l] = lua_randint_once(pseudoseed_advance(state, hashedSeed[l]), 0, ArraySize - 1);
+                    if (mask & laneBit(l)) n.state[l] = state;
+                }
+            }
+            LaneMask retry = 0;
+            forEachLane(mask, [&](size_t l) {
+                EnumType item = items[pick[l]];
+                out[l] = item;
+                if ((!showman && (locks.locked(item) & laneBit(l))) || item == invalid) retry |= laneBit(l);
+            });
+            forEachLane(retry, [&](size_t l) { out[l] = resample(id, items, locks, l); });
+        }
+
+        template<typename EnumType, size_t ArraySize>
+        EnumType resample(const std::string& id, const std::array<EnumType, ArraySize>& items,
+                          const LaneLockTable<EnumType>& locks, size_t lane) {
+            const EnumType invalid = static_cast<EnumType>(static_cast<std::underlying_type_t<EnumType>>(EnumType::INVALID));
+            std::string resID;
+            resID.reserve(id.size() + 16);
+            int resample = 2;
+            while (true) {
+                resID = id;
+                resID += "_resample";
+                resID += std::to_string(resample);
+                HOT_COUNT(HotCounters::RESAMPLE);
+                Node& n = nodes[node(resID, laneBit(lane))];
+                LuaRandom rng(pseudoseed_advance(n.state[lane], hashedSeed[lane]));
+                EnumType item = items[rng.randint(0, ArraySize - 1)];
+                resample++;
+                if (item != invalid && !(locks.locked(item) & laneBit(lane))) return item;
+                if (resample > 1000) {
+                    HOT_COUNT(HotCounters::RESAMPLE_CAP);
+                    return item;
+                }
+            }
+        }
+
+        static bool canBeEternal(Items::Joker joker) {
+            return !(joker == Items::Joker::GROS_MICHEL || joker == Items::Joker::ICE_CREAM ||
+                     joker == Items::Joker::CAVENDISH || joker == Items::Joker::LUCHADOR ||
+                     joker == Items::Joker::TURTLE_BEAN || joker == Items::Joker::DIET_COLA ||
+                     joker == Items::Joker::POPCORN || joker == Items::Joker::RAMEN ||
+                     joker == Items::Joker::SELTZER || joker == Items::Joker::MR_BONES ||
+                     joker == Items::Joker::INVISIBLE_JOKER);
+        }
+
+        static bool canBePerishable(Items::Joker joker) {
+            return !(joker == Items::Joker::CEREMONIAL_DAGGER || joker == Items::Joker::RIDE_THE_BUS ||
+                     joker == Items::Joker::RUNNER || joker == Items::Joker::CONSTELLATION ||
+                     joker == Items::Joker::GREEN_JOKER || joker == Items::Joker::RED_CARD ||
+                     joker == Items::Joker::MADNESS || joker == Items::Joker::SQUARE_JOKER ||
+                     joker == Items::Joker::VAMPIRE || joker == Items::Joker::ROCKET ||
+                     joker == Items::Joker::OBELISK || joker == Items::Joker::LUCKY_CAT ||
+                     joker == Items::Joker::FLASH_CARD || joker == Items::Joker::SPARE_TROUSERS ||
+                     joker == Items::Joker::CASTLE || joker == Items::Joker::WEE_JOKER);
+        }
+    };
+
+    // Widest batch used for interleaving; wider groups stop paying off on scalar cores
+    constexpr size_t MAX_INTERLEAVE = 8;
+
+    // Per-thread batch configured from the global env, rebuilt after setGlobalEnv()
+    template<size_t N>
+    InstanceBatch<N>& threadBatch(int initAnte) {
+        static thread_local InstanceBatch<N> batch;
+        static thread_local uint64_t generation = ~0ull;
+        static thread_local int ante = -1;
+        const uint64_t gen = getGlobalEnvGeneration();
+        if (generation != gen || ante != initAnte) {
+            EnvConfig e = getGlobalEnv();
+            if (!e.deck.empty()) batch.setDeck(e.deck);
+            if (!e.stake.empty()) batch.setStake(e.stake);
+            batch.setShowman(e.showman);
+            batch.setVersion(e.version);
+            batch.initLocks(initAnte, e.freshProfile, e.freshRun);
+            generation = gen;
+            ante = initAnte;
+        }
+        return batch;
+    }
+
+    // Splits `count` seeds into groups of `width` lanes (clamped to 1..MAX_INTERLEAVE)
+    // and calls fn(std::integral_constant<size_t, width>, offset, groupSize) for each,
+    // so the lane count is a compile-time constant inside fn.
+    template<typename Fn>
+    void forEachLaneGroup(size_t count, size_t width, Fn&& fn) {
+        auto run = [&](auto lanes) {
+            constexpr size_t K = decltype(lanes)::value;
+            for (size_t offset = 0; offset < count; offset += K) {
+                fn(lanes, offset, count - offset < K ? count - offset : K);
+            }
+        };
+        switch (width) {
+            case 0:
+            case 1: run(std::integral_constant<size_t, 1>{}); break;
+            case 2: run(std::integral_constant<size_t, 2>{}); break;
+            case 3: run(std::integral_constant<size_t, 3>{}); break;
+            case 4: run(std::integral_constant<size_t, 4>{}); break;
+            case 5: run(std::integral_constant<size_t, 5>{}); break;
+            case 6: run(std::integral_constant<size_t, 6>{}); break;
+            case 7: run(std::integral_constant<size_t, 7>{}); break;
+            default: run(std::integral_constant<size_t, MAX_INTERLEAVE>{}); break;
+        }
+    }
+
+} // namespace Instance
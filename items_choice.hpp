@@ -2,6 +2,8 @@
 
 #include "items.hpp"
 #include "items_utils.hpp"
+#include "hot_counters.hpp"
+#include <functional>
 
 namespace Items {
 
@@ -79,11 +81,14 @@ namespace Items {
             if (!showman && locks.isLocked(item)) {
                 int resample = 2;
                 while (true) {
+                    HOT_COUNT(HotCounters::RESAMPLE);
                     LuaRandom resample_rng(rng.random()); // Use current RNG to seed new one
                     item = items[resample_rng.randint(0, ArraySize - 1)];
                     resample++;
 
-                    if (!locks.isLocked(item) || resample > 1000) {
+                    if (!locks.isLocked(item)) return item;
+                    if (resample > 1000) {
+                        HOT_COUNT(HotCounters::RESAMPLE_CAP);
                         return item;
                     }
                 }
@@ -101,8 +106,7 @@ namespace Items {
     EnumType enum_randchoice(const std::string& ID, const std::array<EnumType, ArraySize>& items,
                            const Locks::EnumLockSystem& locks, bool showman, const GetNodeFunc& get_node) {
         // EXACT SAME LOGIC as original randchoice:
-        LuaRandom rng(get_node(ID));
-        EnumType item = items[rng.randint(0, items.size()-1)];
+        EnumType item = items[lua_randint_once(get_node(ID), 0, items.size()-1)];
 
         // Check if locked or invalid (RETRY equivalent)
         bool isRetry = (item == static_cast<EnumType>(static_cast<std::underlying_type_t<EnumType>>(EnumType::INVALID)));
@@ -115,11 +119,16 @@ namespace Items {
                 resID = ID;
                 resID += "_resample";
                 resID += std::to_string(resample);
-                rng = LuaRandom(get_node(resID));
+                HOT_COUNT(HotCounters::RESAMPLE);
+                LuaRandom rng(get_node(resID));
                 item = items[rng.randint(0, items.size()-1)];
                 resample++;
                 bool isNotRetry = (item != static_cast<EnumType>(static_cast<std::underlying_type_t<EnumType>>(EnumType::INVALID)));
-                if ((isNotRetry && !locks.isLocked(item)) || resample > 1000) return item;
+                if (isNotRetry && !locks.isLocked(item)) return item;
+                if (resample > 1000) {
+                    HOT_COUNT(HotCounters::RESAMPLE_CAP);
+                    return item;
+                }
             }
         }
         return item;
@@ -166,13 +175,11 @@ namespace Items {
     }
 
     inline Enhancement EnhancementChoice(const GetNodeFunc& get_node, const std::string& ID = "enhancement") {
-        LuaRandom rng(get_node(ID));
-        return ALL_ENHANCEMENTS[rng.randint(0, ALL_ENHANCEMENTS.size() - 1)];
+        return ALL_ENHANCEMENTS[lua_randint_once(get_node(ID), 0, ALL_ENHANCEMENTS.size() - 1)];
     }
 
     inline Pack PackChoice(const GetNodeFunc& get_node, const std::string& ID = "pack") {
-        LuaRandom rng(get_node(ID));
-        double poll = rng.random() * ALL_PACKS[0].weight;
+        double poll = lua_random_once(get_node(ID)) * ALL_PACKS[0].weight;
         size_t idx = 1;
         double weight = 0;
 
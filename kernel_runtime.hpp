@@ -0,0 +1,179 @@
+#pragma once
+
+#include "instance.hpp"
+#include "rand_util.hpp"
+#include "env.hpp"
+#include <array>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Runtime support for generated filter kernels (see tools/gen_kernel.py).
+// A kernel replays a fixed sequence of draws for one seed without the node
+// map or string keys: the constant part of every key is hashed by unrolled
+// code emitted by the generator, and only the per-seed part lives here.
+
+namespace Kernel {
+
+    constexpr size_t MAX_SEED_LEN = 32;
+    constexpr size_t MAX_KEY_LEN = 48;
+    constexpr size_t MAX_RESAMPLE_NODES = 64;
+
+    class SeedState {
+    public:
+        double hashedSeed = 0;
+        // Set when a resample chain outgrew the fixed table; the caller must
+        // discard the kernel result and take the interpreted path instead.
+        bool overflow = false;
+
+        // Returns false when the seed does not fit the fixed buffers
+        bool reset(const std::string& s) {
+            if (s.size() > MAX_SEED_LEN) return false;
+            seedLen = s.size();
+            std::memcpy(seed, s.data(), seedLen);
+            double num = 1.0;
+            for (size_t i = 0; i < seedLen; i++) {
+                num = pseudohash_step(num, seed[seedLen-1-i], seedLen-i);
+            }
+            hashedSeed = num;
+            prefixValid = 0;
+            resampleCount = 0;
+            overflow = false;
+            return true;
+        }
+
+        // pseudohash state once the seed characters of `ID + seed` have been
+        // consumed. The positional term depends on the total length, so the
+        // state is cached per ID length.
+        INLINE_FORCE double seedPrefix(size_t idLen) {
+            const uint64_t bit = 1ull << idLen;
+            if (!(prefixValid & bit)) {
+                const size_t len = idLen + seedLen;
+                double num = 1.0;
+                for (size_t i = 0; i < seedLen; i++) {
+                    num = pseudohash_step(num, seed[seedLen-1-i], len-i);
+                }
+                prefix[idLen] = num;
+                prefixValid |= bit;
+            }
+            return prefix[idLen];
+        }
+
+        // Initial node value for a key only known at runtime
+        double hashKey(const char* id, size_t idLen) {
+            double num = seedPrefix(idLen);
+            for (size_t j = 0; j < idLen; j++) {
+                num = pseudohash_step(num, id[idLen-1-j], idLen-j);
+            }
+            return num;
+        }
+
+        // Node for `<key>_resample<n>`, created on first use. `keyId` is the
+        // generator-assigned index of the base key.
+        double* resampleNode(uint16_t keyId, const char* key, size_t keyLen, int n) {
+            const uint32_t tag = (static_cast<uint32_t>(keyId) << 16) | static_cast<uint32_t>(n);
+            for (size_t i = 0; i < resampleCount; i++) {
+                if (resampleTags[i] == tag) return &resampleStates[i];
+            }
+            // "_resample" plus up to four digits
+            if (resampleCount == MAX_RESAMPLE_NODES || keyLen + 13 > MAX_KEY_LEN) {
+                overflow = true;
+                return nullptr;
+            }
+            char id[MAX_KEY_LEN];
+            std::memcpy(id, key, keyLen);
+            std::memcpy(id + keyLen, "_resample", 9);
+            size_t len = keyLen + 9;
+            char digits[4];
+            int nd = 0;
+            do { digits[nd++] = static_cast<char>('0' + n % 10); n /= 10; } while (n > 0);
+            while (nd > 0) id[len++] = digits[--nd];
+
+            resampleTags[resampleCount] = tag;
+            resampleStates[resampleCount] = hashKey(id, len);
+            return &resampleStates[resampleCount++];
+        }
+
+    private:
+        char seed[MAX_SEED_LEN];
+        size_t seedLen = 0;
+        double prefix[MAX_KEY_LEN + 1];
+        uint64_t prefixValid = 0;
+        uint32_t resampleTags[MAX_RESAMPLE_NODES];
+        double resampleStates[MAX_RESAMPLE_NODES];
+        size_t resampleCount = 0;
+    };
+
+    // Lazily initialised node: `has` starts false and `init` hashes the constant key
+    template<typename InitFn>
+    INLINE_FORCE double& node(SeedState& s, double& value, bool& has, InitFn init) {
+        if (!has) {
+            value = init(s);
+            has = true;
+        }
+        return value;
+    }
+
+    INLINE_FORCE double random(SeedState& s, double& node) {
+        return lua_random_once(pseudoseed_advance(node, s.hashedSeed));
+    }
+
+    template<typename EnumType, size_t ArraySize>
+    EnumType randchoiceResample(SeedState& s, uint16_t keyId, const char* key, size_t keyLen,
+                                const std::array<EnumType, ArraySize>& items,
+                                const Locks::EnumLockSystem& locks) {
+        const EnumType invalid = static_cast<EnumType>(static_cast<std::underlying_type_t<EnumType>>(EnumType::INVALID));
+        int resample = 2;
+        while (true) {
+            double* n = s.resampleNode(keyId, key, keyLen, resample);
+            if (!n) return invalid;
+            LuaRandom rng(pseudoseed_advance(*n, s.hashedSeed));
+            EnumType item = items[rng.randint(0, ArraySize - 1)];
+            resample++;
+            if ((item != invalid && !locks.isLocked(item)) || resample > 1000) return item;
+        }
+    }
+
+    // Mirrors Items::enum_randchoice for a node held by the kernel
+    template<typename EnumType, size_t ArraySize>
+    INLINE_FORCE EnumType randchoice(SeedState& s, double& node, uint16_t keyId, const char* key, size_t keyLen,
+                                     const std::array<EnumType, ArraySize>& items,
+                                     const Locks::EnumLockSystem& locks, bool showman) {
+        const EnumType invalid = static_cast<EnumType>(static_cast<std::underlying_type_t<EnumType>>(EnumType::INVALID));
+        EnumType item = items[lua_randint_once(pseudoseed_advance(node, s.hashedSeed), 0, ArraySize - 1)];
+        if ((!showman && locks.isLocked(item)) || item == invalid) {
+            return randchoiceResample(s, keyId, key, keyLen, items, locks);
+        }
+        return item;
+    }
+
+    // Env-derived starting state shared by every seed of a run
+    struct PreparedEnv {
+        uint64_t generation = ~0ull;
+        int initAnte = 0;
+        Locks::EnumLockSystem locks;
+        bool showman = false;
+        long version = 10106;
+    };
+
+    // Per-thread copy so the hot path never touches the env mutex; rebuilt
+    // whenever setGlobalEnv() has been called since the last refresh.
+    inline const PreparedEnv& preparedEnv(int initAnte) {
+        static thread_local PreparedEnv tl;
+        const uint64_t gen = getGlobalEnvGeneration();
+        if (tl.generation != gen || tl.initAnte != initAnte) {
+            EnvConfig e = getGlobalEnv();
+            Instance::Instance inst("");
+            inst.setShowman(e.showman);
+            inst.setVersion(e.version);
+            inst.initLocks(initAnte, e.freshProfile, e.freshRun);
+            tl.locks = inst.getLocks();
+            tl.showman = e.showman;
+            tl.version = e.version;
+            tl.initAnte = initAnte;
+            tl.generation = gen;
+        }
+        return tl;
+    }
+
+} // namespace Kernel
@@ -0,0 +1,275 @@
+// libbalatro: the C ABI declared in libbalatro.h, built per filter by
+// tools/build-lib.sh (SELECTED_FILTER, as for immolate). Batch calls cut
+// the seed array into one contiguous part per thread of a shared WorkerPool.
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libbalatro.h"
+#include "env.hpp"
+#include "mini_json.hpp"
+#include "seed_util.hpp"
+#include "worker_pool.hpp"
+#include "filters/filter_base.hpp"
+#ifdef SELECTED_FILTER
+#include SELECTED_FILTER
+#endif
+#include "search_driver.hpp"
+#include "tools/feature_columns.hpp"
+
+struct balatro_env {
+    EnvConfig config;
+    uint64_t hash;
+};
+
+namespace {
+
+    constexpr size_t BATCH = 256;
+
+    thread_local std::string lastError;
+
+    int fail(int code, const std::string& message) {
+        lastError = message;
+        return code;
+    }
+
+    // Filter, driver and pool, created on first use
+    struct Library {
+        std::unique_ptr<SearchFilter> filter;
+        std::unique_ptr<SearchDriver<SelectedFilterType>> driver;
+        std::string name;
+        WorkerPool pool;
+        // Held by evaluations and feature extraction: both read the process-wide env
+        std::mutex evaluateMutex;
+
+        Library() : filter(createFilter()), name(filter->getName()), pool(std::max(1u, std::thread::hardware_concurrency())) {
+            driver.reset(new SearchDriver<SelectedFilterType>(makeSelectedDriver(*filter)));
+        }
+    };
+
+    // Never destroyed: joining pool threads while the library is unloaded
+    // can deadlock (Windows holds the loader lock)
+    Library& library() {
+        static Library* lib = new Library();
+        return *lib;
+    }
+
+    const FeatureColumns::Schema* schema(int shopSlots) {
+        static std::unique_ptr<FeatureColumns::Schema> schemas[FeatureColumns::MAX_SHOP_SLOTS + 1];
+        static std::mutex mutex;
+        if (shopSlots < 1 || shopSlots > FeatureColumns::MAX_SHOP_SLOTS) return nullptr;
+        std::lock_guard<std::mutex> lk(mutex);
+        if (!schemas[shopSlots]) schemas[shopSlots].reset(new FeatureColumns::Schema(shopSlots));
+        return schemas[shopSlots].get();
+    }
+
+    bool validSeeds(const uint64_t* seeds, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (seeds[i] >= SEED_COUNT) {
+                lastError = "seeds[" + std::to_string(i) + "] is not a seed number";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Runs fn(begin, end) over [0, count) in up to `threads` contiguous parts
+    void parallel(size_t count, int threads, const std::function<void(size_t, size_t)>& fn) {
+        WorkerPool& pool = library().pool;
+        const size_t parts = std::min<size_t>(threads > 0 ? static_cast<size_t>(threads) : pool.size(), (count + BATCH - 1) / BATCH);
+        if (parts <= 1) {
+            fn(0, count);
+            return;
+        }
+        std::vector<std::function<void()>> tasks;
+        for (size_t p = 0; p < parts; p++) {
+            const size_t begin = count * p / parts, end = count * (p + 1) / parts;
+            tasks.push_back([&fn, begin, end]() { fn(begin, end); });
+        }
+        pool.runAll(tasks);
+    }
+
+    template<typename EnumType>
+    const char* enumName(uint16_t value) {
+        return value < static_cast<uint16_t>(EnumType::COUNT) ? Items::toString(static_cast<EnumType>(value)) : nullptr;
+    }
+
+    // Feature values written straight into the caller's column arrays
+    struct ColumnWriter {
+        uint16_t* const* columns;
+        void set(size_t column, uint64_t row, uint16_t value) { columns[column][row] = value; }
+    };
+}
+
+#define BALATRO_GUARD_BEGIN try {
+#define BALATRO_GUARD_END(result)                                   \
+    } catch (const std::exception& ex) {                            \
+        lastError = ex.what();                                      \
+    } catch (...) {                                                 \
+        lastError = "unknown error";                                \
+    }                                                               \
+    return result;
+
+extern "C" {
+
+int balatro_abi_version(void) { return BALATRO_ABI_VERSION; }
+
+const char* balatro_last_error(void) { return lastError.c_str(); }
+
+const char* balatro_filter_name(void) {
+    BALATRO_GUARD_BEGIN
+    return library().name.c_str();
+    BALATRO_GUARD_END(nullptr)
+}
+
+int balatro_result_count(void) {
+    BALATRO_GUARD_BEGIN
+    return static_cast<int>(library().driver->resultNames().size());
+    BALATRO_GUARD_END(BALATRO_EINTERNAL)
+}
+
+const char* balatro_result_name(int level) {
+    BALATRO_GUARD_BEGIN
+    const auto& names = library().driver->resultNames();
+    return level >= 1 && level <= static_cast<int>(names.size()) ? names[level - 1].c_str() : nullptr;
+    BALATRO_GUARD_END(nullptr)
+}
+
+int balatro_seed_to_number(const char* seed, uint64_t* out) {
+    if (!seed || !out) return fail(BALATRO_EINVAL, "null argument");
+    if (std::strlen(seed) != 8) return fail(BALATRO_EINVAL, "a seed has 8 characters");
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        const char* at = std::strchr(SEED_CHARS, seed[i]);
+        if (!at) return fail(BALATRO_EINVAL, std::string("invalid seed character '") + seed[i] + "'");
+        v = v * SEED_BASE + static_cast<uint64_t>(at - SEED_CHARS);
+    }
+    *out = v;
+    return BALATRO_OK;
+}
+
+int balatro_number_to_seed(uint64_t number, char* out) {
+    if (!out) return fail(BALATRO_EINVAL, "null argument");
+    if (number >= SEED_COUNT) return fail(BALATRO_EINVAL, "not a seed number");
+    const std::string seed = numberToSeed(number);
+    std::memcpy(out, seed.c_str(), seed.size() + 1);
+    return BALATRO_OK;
+}
+
+balatro_env* balatro_env_create(const char* json) {
+    BALATRO_GUARD_BEGIN
+    std::unique_ptr<balatro_env> env(new balatro_env());
+    if (json && *json) {
+        // The env reader scans for keys and would take truncated text as defaults
+        MiniJson::Value v;
+        std::string error;
+        if (!MiniJson::parse(json, v, error) || !v.isObject()) {
+            lastError = error.empty() ? "env JSON is not an object" : "env JSON: " + error;
+            return nullptr;
+        }
+        if (!parseEnvJson(json, env->config)) {
+            lastError = "could not parse env JSON";
+            return nullptr;
+        }
+    }
+    env->hash = envConfigHash(env->config);
+    return env.release();
+    BALATRO_GUARD_END(nullptr)
+}
+
+void balatro_env_destroy(balatro_env* env) { delete env; }
+
+int balatro_evaluate(const balatro_env* env, const uint64_t* seeds, size_t count, uint16_t* levels, int threads) {
+    BALATRO_GUARD_BEGIN
+    if (!env || (count && (!seeds || !levels))) return fail(BALATRO_EINVAL, "null argument");
+    if (!validSeeds(seeds, count)) return BALATRO_EINVAL;
+    Library& lib = library();
+    std::lock_guard<std::mutex> lk(lib.evaluateMutex);
+    if (envConfigHash(getGlobalEnv()) != env->hash) setGlobalEnv(env->config);
+    // Blocks through applyBatch, as immolate's workers do, so batch kernels apply
+    parallel(count, threads, [&](size_t begin, size_t end) {
+        std::vector<std::string> block;
+        block.reserve(BATCH);
+        for (size_t at = begin; at < end; at += BATCH) {
+            const size_t n = std::min(BATCH, end - at);
+            block.clear();
+            for (size_t i = 0; i < n; i++) block.push_back(numberToSeed(seeds[at + i]));
+            lib.driver->applyBatch(Span<const std::string>(block.data(), n), Span<uint16_t>(levels + at, n));
+        }
+    });
+    return BALATRO_OK;
+    BALATRO_GUARD_END(BALATRO_EINTERNAL)
+}
+
+int balatro_feature_count(int shop_slots) {
+    BALATRO_GUARD_BEGIN
+    const FeatureColumns::Schema* s = schema(shop_slots);
+    return s ? static_cast<int>(s->columns().size()) : fail(BALATRO_EINVAL, "shop_slots must be 1-16");
+    BALATRO_GUARD_END(BALATRO_EINTERNAL)
+}
+
+const char* balatro_feature_name(int shop_slots, int column) {
+    BALATRO_GUARD_BEGIN
+    const FeatureColumns::Schema* s = schema(shop_slots);
+    if (!s || column < 0 || column >= static_cast<int>(s->columns().size())) return nullptr;
+    return s->columns()[column].spec.name.c_str();
+    BALATRO_GUARD_END(nullptr)
+}
+
+const char* balatro_feature_value_name(int shop_slots, int column, uint16_t value) {
+    BALATRO_GUARD_BEGIN
+    const FeatureColumns::Schema* s = schema(shop_slots);
+    if (!s || column < 0 || column >= static_cast<int>(s->columns().size())) return nullptr;
+    using Type = FeatureColumns::Type;
+    using Kind = FeatureColumns::Kind;
+    switch (s->columns()[column].type) {
+        case Type::BOSS: return enumName<Items::Boss>(value);
+        case Type::VOUCHER: return enumName<Items::Voucher>(value);
+        case Type::TAG: return enumName<Items::Tag>(value);
+        case Type::PACK: return enumName<Items::Pack>(value);
+        case Type::EDITION: return enumName<Items::Edition>(value);
+        case Type::ITEM: {
+            const uint16_t id = value & 0xFF;
+            switch (static_cast<Kind>(value >> 8)) {
+                case Kind::NONE: return value == 0 ? "" : nullptr;
+                case Kind::JOKER: return enumName<Items::Joker>(id);
+                case Kind::TAROT: return enumName<Items::Tarot>(id);
+                case Kind::PLANET: return enumName<Items::Planet>(id);
+                case Kind::SPECTRAL: return enumName<Items::Spectral>(id);
+            }
+            return nullptr;
+        }
+    }
+    return nullptr;
+    BALATRO_GUARD_END(nullptr)
+}
+
+int balatro_features(const balatro_env* env, const uint64_t* seeds, size_t count, int shop_slots,
+                     uint16_t* const* columns, int threads) {
+    BALATRO_GUARD_BEGIN
+    const FeatureColumns::Schema* s = schema(shop_slots);
+    if (!s) return fail(BALATRO_EINVAL, "shop_slots must be 1-16");
+    if (!env || (count && (!seeds || !columns))) return fail(BALATRO_EINVAL, "null argument");
+    for (size_t c = 0; count && c < s->columns().size(); c++) {
+        if (!columns[c]) return fail(BALATRO_EINVAL, "columns[" + std::to_string(c) + "] is null");
+    }
+    if (!validSeeds(seeds, count)) return BALATRO_EINVAL;
+    // Instance::initLocks reads the unlocked tags and jokers from the process-wide env
+    Library& lib = library();
+    std::lock_guard<std::mutex> lk(lib.evaluateMutex);
+    if (envConfigHash(getGlobalEnv()) != env->hash) setGlobalEnv(env->config);
+    parallel(count, threads, [&](size_t begin, size_t end) {
+        ColumnWriter w{columns};
+        for (size_t i = begin; i < end; i++) s->extract(numberToSeed(seeds[i]), env->config, w, i);
+    });
+    return BALATRO_OK;
+    BALATRO_GUARD_END(BALATRO_EINTERNAL)
+}
+
+}
@@ -0,0 +1,89 @@
+#ifndef LIBBALATRO_H
+#define LIBBALATRO_H
+
+/*
+ * libbalatro: C ABI over one compiled filter and the ante-1 feature columns,
+ * for Python (ctypes, cffi) and other callers that want bulk results without
+ * parsing subprocess output. Build with `sh tools/build-lib.sh <filter>`;
+ * tools/libbalatro.py wraps it for Python and numpy.
+ *
+ * Seeds are passed as seed numbers (0 .. 34^8 - 1, see seed_util.hpp) and
+ * results are written into caller-owned arrays, so numpy buffers can be
+ * passed without copies. Batch calls split the work across an internal
+ * thread pool; `threads` = 0 uses every pool thread.
+ *
+ * Functions returning int return BALATRO_OK or a negative error code, with
+ * a message from balatro_last_error() on the calling thread. Calls may come
+ * from several threads. Filter evaluations are serialized, because filters
+ * read the process-wide environment.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define BALATRO_API __declspec(dllexport)
+#else
+#define BALATRO_API __attribute__((visibility("default")))
+#endif
+
+/* Bumped whenever a signature or the meaning of a result changes */
+#define BALATRO_ABI_VERSION 1
+
+#define BALATRO_OK 0
+#define BALATRO_EINVAL -1   /* Bad argument: null pointer, seed number out of range, bad shop slot count */
+#define BALATRO_EINTERNAL -2
+
+typedef struct balatro_env balatro_env;
+
+BALATRO_API int balatro_abi_version(void);
+BALATRO_API const char* balatro_last_error(void);
+
+/* The compiled filter: its name and match level names (level 1 .. count) */
+BALATRO_API const char* balatro_filter_name(void);
+BALATRO_API int balatro_result_count(void);
+BALATRO_API const char* balatro_result_name(int level);
+
+/* Seed string <-> seed number; `out` of balatro_number_to_seed holds 9 bytes */
+BALATRO_API int balatro_seed_to_number(const char* seed, uint64_t* out);
+BALATRO_API int balatro_number_to_seed(uint64_t number, char* out);
+
+/*
+ * Environment from the same JSON as an --env file; NULL or "" gives the
+ * defaults. Returns NULL on a parse error. Free with balatro_env_destroy().
+ */
+BALATRO_API balatro_env* balatro_env_create(const char* json);
+BALATRO_API void balatro_env_destroy(balatro_env* env);
+
+/* levels[i] = the filter's match level for seeds[i] (0 = no match) */
+BALATRO_API int balatro_evaluate(const balatro_env* env, const uint64_t* seeds, size_t count, uint16_t* levels, int threads);
+
+/*
+ * Ante-1 feature columns (tools/feature_columns.hpp) for `shop_slots` shop
+ * items (1-16): boss, voucher, tags, packs, the first pack's cards, shop
+ * items and their editions. Columns are numbered 0 .. balatro_feature_count()-1.
+ */
+BALATRO_API int balatro_feature_count(int shop_slots);
+BALATRO_API const char* balatro_feature_name(int shop_slots, int column);
+
+/* Name of `value` in a column, e.g. "The Hook" or "Blueprint"; "" for an empty slot, NULL if unknown */
+BALATRO_API const char* balatro_feature_value_name(int shop_slots, int column, uint16_t value);
+
+/*
+ * columns[c][i] = feature column c of seeds[i]. `columns` holds
+ * balatro_feature_count(shop_slots) arrays of `count` uint16 values. Values
+ * are the enum codes feature_indexer stores; shop and pack slots are
+ * kind << 8 | item id.
+ */
+BALATRO_API int balatro_features(const balatro_env* env, const uint64_t* seeds, size_t count, int shop_slots,
+                                 uint16_t* const* columns, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
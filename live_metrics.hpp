@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "atomic_file.hpp"
+
+// Machine-readable live metrics for the search loop. The stats thread fills
+// a Snapshot at a fixed interval. The snapshot goes out as one JSON object
+// per line on a file descriptor (--metrics-fd) and/or as a Prometheus text
+// exposition file that is atomically replaced each time (--metrics-prom;
+// point node_exporter's textfile collector at it). Consumers such as the
+// GUI read the JSON lines instead of scraping the terminal screen.
+namespace LiveMetrics {
+
+    struct Level {
+        std::string name;
+        uint64_t count;
+    };
+
+    struct Snapshot {
+        std::string filter;
+        double elapsedSeconds = 0;
+        uint64_t seeds = 0;              // Searched by this process
+        double rate = 0;                 // Seeds/s over the last interval
+        double rateSmoothed = 0;         // Exponentially weighted, ~10 s time constant
+        std::vector<double> threadRates; // Seeds/s per worker over the last interval
+        std::vector<Level> levels;
+        uint64_t rangeStart = 0;
+        uint64_t rangeEnd = 0;
+        uint64_t watermark = 0;          // Every seed below it is done
+        double progress = 0;             // 0..1 through [rangeStart, rangeEnd)
+        double etaSeconds = -1;          // -1 while the rate is unknown
+        uint64_t pendingMatches = 0;     // Matches waiting for the next CSV checkpoint
+        uint64_t chunksInFlight = 0;
+        bool done = false;               // Last snapshot of the run
+    };
+
+    inline std::string jsonEscape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    // One line, no trailing newline
+    inline std::string toJsonLine(const Snapshot& s) {
+        std::ostringstream o;
+        o << std::fixed << std::setprecision(1);
+        o << "{\"type\": \"metrics\", \"filter\": \"" << jsonEscape(s.filter) << "\", \"elapsed_s\": " << s.elapsedSeconds
+          << ", \"seeds\": " << s.seeds << ", \"rate\": " << s.rate << ", \"rate_smoothed\": " << s.rateSmoothed
+          << ", \"thread_rates\": [";
+        for (size_t i = 0; i < s.threadRates.size(); i++) o << (i ? ", " : "") << s.threadRates[i];
+        o << "], \"levels\": [";
+        for (size_t i = 0; i < s.levels.size(); i++) {
+            o << (i ? ", " : "") << "{\"level\": " << i + 1 << ", \"name\": \"" << jsonEscape(s.levels[i].name)
+              << "\", \"count\": " << s.levels[i].count << "}";
+        }
+        o << "], \"range_start\": " << s.rangeStart << ", \"range_end\": " << s.rangeEnd << ", \"watermark\": " << s.watermark
+          << ", \"progress\": " << std::setprecision(9) << s.progress << std::setprecision(1) << ", \"eta_s\": " << s.etaSeconds
+          << ", \"pending_matches\": " << s.pendingMatches << ", \"chunks_in_flight\": " << s.chunksInFlight
+          << ", \"done\": " << (s.done ? "true" : "false") << "}";
+        return o.str();
+    }
+
+    inline std::string promLabel(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '\\' || c == '"') out += '\\';
+            if (c == '\n') {
+                out += "\\n";
+                continue;
+            }
+            out += c;
+        }
+        return out;
+    }
+
+    inline std::string toPrometheus(const Snapshot& s) {
+        std::ostringstream o;
+        o << std::setprecision(12);
+        const std::string f = "filter=\"" + promLabel(s.filter) + "\"";
+        auto metric = [&](const char* name, const char* type, const char* help) {
+            o << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+        };
+        metric("balatro_seeds_total", "counter", "Seeds searched by this process.");
+        o << "balatro_seeds_total{" << f << "} " << s.seeds << "\n";
+        metric("balatro_seed_rate", "gauge", "Seeds per second over the last interval.");
+        o << "balatro_seed_rate{" << f << "} " << s.rate << "\n";
+        metric("balatro_seed_rate_smoothed", "gauge", "Exponentially smoothed seeds per second.");
+        o << "balatro_seed_rate_smoothed{" << f << "} " << s.rateSmoothed << "\n";
+        metric("balatro_thread_seed_rate", "gauge", "Seeds per second of each worker thread.");
+        for (size_t i = 0; i < s.threadRates.size(); i++) {
+            o << "balatro_thread_seed_rate{" << f << ",thread=\"" << i << "\"} " << s.threadRates[i] << "\n";
+        }
+        metric("balatro_matches_total", "counter", "Matches per filter level.");
+        for (size_t i = 0; i < s.levels.size(); i++) {
+            o << "balatro_matches_total{" << f << ",level=\"" << i + 1 << "\",name=\"" << promLabel(s.levels[i].name) << "\"} "
+              << s.levels[i].count << "\n";
+        }
+        metric("balatro_watermark", "gauge", "Seed number below which every seed is done.");
+        o << "balatro_watermark{" << f << "} " << s.watermark << "\n";
+        metric("balatro_progress_ratio", "gauge", "Fraction of the searched range that is done.");
+        o << "balatro_progress_ratio{" << f << "} " << s.progress << "\n";
+        metric("balatro_eta_seconds", "gauge", "Estimated time to finish the range, -1 when unknown.");
+        o << "balatro_eta_seconds{" << f << "} " << s.etaSeconds << "\n";
+        metric("balatro_pending_matches", "gauge", "Matches waiting for the next CSV checkpoint.");
+        o << "balatro_pending_matches{" << f << "} " << s.pendingMatches << "\n";
+        metric("balatro_chunks_in_flight", "gauge", "Chunks being searched by worker threads.");
+        o << "balatro_chunks_in_flight{" << f << "} " << s.chunksInFlight << "\n";
+        return o.str();
+    }
+
+    // Writes snapshots to the configured outputs; a failed write is reported once, not retried
+    class Sink {
+    public:
+        // fd < 0 disables the JSON stream; an empty path disables the Prometheus file
+        Sink(int jsonFd, const std::string& promPath) : fd(jsonFd), prom(promPath) {}
+
+        bool enabled() const { return fd >= 0 || !prom.empty(); }
+
+        void write(const Snapshot& s) {
+            std::lock_guard<std::mutex> lk(mutex);
+            if (fd >= 0) writeLine(toJsonLine(s) + "\n");
+            if (!prom.empty()) writeProm(toPrometheus(s));
+        }
+
+    private:
+        void writeLine(const std::string& line) {
+            // stdout and stderr go through the streams so lines do not interleave with other output
+            if (fd == 1) {
+                std::cout << line << std::flush;
+                return;
+            }
+            if (fd == 2) {
+                std::cerr << line << std::flush;
+                return;
+            }
+            size_t off = 0;
+            while (off < line.size()) {
+#ifdef _WIN32
+                const int n = _write(fd, line.data() + off, static_cast<unsigned int>(line.size() - off));
+#else
+                const ssize_t n = ::write(fd, line.data() + off, line.size() - off);
+#endif
+                if (n <= 0) {
+                    if (!fdFailed) std::cerr << "metrics: write to fd " << fd << " failed" << std::endl;
+                    fdFailed = true;
+                    return;
+                }
+                off += static_cast<size_t>(n);
+            }
+        }
+
+        // Scrapers never see a half-written file
+        void writeProm(const std::string& text) {
+            std::string error;
+            const bool ok = AtomicFile::write(prom, text, error);
+            if (!ok && !promFailed) std::cerr << "metrics: could not write " << prom << std::endl;
+            promFailed = promFailed || !ok;
+        }
+
+        int fd;
+        std::string prom;
+        std::mutex mutex;
+        bool fdFailed = false;
+        bool promFailed = false;
+    };
+}
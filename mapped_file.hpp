@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file: memory-mapped where available, read into
+// memory on Windows. An empty file opens as zero bytes.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // `sequential` tells the kernel the file is read once, front to back
+    bool open(const std::string& path, std::string& error, bool sequential = false) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            if (fd >= 0) ::close(fd);
+            error = "could not open " + path;
+            return false;
+        }
+        const uint64_t length = static_cast<uint64_t>(st.st_size);
+        if (length == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            error = "could not map " + path;
+            return false;
+        }
+        if (sequential) madvise(p, length, MADV_SEQUENTIAL);
+        base = static_cast<const uint8_t*>(p);
+        bytes = length;
+        mapped = true;
+        return true;
+#else
+        (void)sequential;
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            error = "could not open " + path;
+            return false;
+        }
+        buffer.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        base = reinterpret_cast<const uint8_t*>(buffer.data());
+        bytes = buffer.size();
+        return true;
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (mapped) munmap(const_cast<uint8_t*>(base), bytes);
+#endif
+        mapped = false;
+        base = nullptr;
+        bytes = 0;
+        buffer.clear();
+    }
+
+    const uint8_t* data() const { return base; }
+    uint64_t size() const { return bytes; }
+
+private:
+    const uint8_t* base = nullptr;
+    uint64_t bytes = 0;
+    bool mapped = false;
+    std::string buffer;
+};
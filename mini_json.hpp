@@ -0,0 +1,304 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Small JSON reader and string quoting for the --serve protocol, where each
+// request is one JSON object per line. Values are a plain tree. Numbers keep
+// their source text, so seed numbers above 2^53 are read exactly.
+namespace MiniJson {
+
+    class Value {
+    public:
+        enum class Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+        Type type = Type::NUL;
+        bool boolean = false;
+        std::string text;                                    // STRING contents, or a NUMBER's literal
+        std::vector<Value> items;                            // ARRAY
+        std::vector<std::pair<std::string, Value>> members;  // OBJECT, in source order
+
+        bool isNull() const { return type == Type::NUL; }
+        bool isString() const { return type == Type::STRING; }
+        bool isNumber() const { return type == Type::NUMBER; }
+        bool isArray() const { return type == Type::ARRAY; }
+        bool isObject() const { return type == Type::OBJECT; }
+
+        // Member `key` of an object; null when absent or not an object. The
+        // last of repeated keys wins.
+        const Value* get(const std::string& key) const {
+            const Value* found = nullptr;
+            for (const auto& m : members) {
+                if (m.first == key) found = &m.second;
+            }
+            return found;
+        }
+
+        double asDouble() const { return std::strtod(text.c_str(), nullptr); }
+
+        // A non-negative integer literal (no fraction or exponent) that fits in 64 bits
+        bool asUint(uint64_t& out) const {
+            if (type != Type::NUMBER || text.empty() || text[0] == '-') return false;
+            uint64_t v = 0;
+            for (char c : text) {
+                if (c < '0' || c > '9') return false;
+                const uint64_t d = static_cast<uint64_t>(c - '0');
+                if (v > (UINT64_MAX - d) / 10) return false;
+                v = v * 10 + d;
+            }
+            out = v;
+            return true;
+        }
+    };
+
+    class Parser {
+    public:
+        explicit Parser(const std::string& s) : src(s) {}
+
+        bool parse(Value& out, std::string& error) {
+            if (!value(out, 0)) {
+                error = message + " at offset " + std::to_string(pos);
+                return false;
+            }
+            skipSpace();
+            if (pos != src.size()) {
+                error = "trailing characters at offset " + std::to_string(pos);
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr int MAX_DEPTH = 64;
+
+        bool fail(const char* what) {
+            message = what;
+            return false;
+        }
+
+        void skipSpace() {
+            while (pos < src.size() && (src[pos] == ' ' || src[pos] == '\t' || src[pos] == '\n' || src[pos] == '\r')) pos++;
+        }
+
+        bool literal(const char* word) {
+            size_t n = 0;
+            while (word[n]) n++;
+            if (src.compare(pos, n, word) != 0) return fail("invalid literal");
+            pos += n;
+            return true;
+        }
+
+        bool value(Value& out, int depth) {
+            if (depth > MAX_DEPTH) return fail("nesting too deep");
+            skipSpace();
+            if (pos >= src.size()) return fail("unexpected end of input");
+            const char c = src[pos];
+            if (c == '{') return object(out, depth);
+            if (c == '[') return array(out, depth);
+            if (c == '"') {
+                out.type = Value::Type::STRING;
+                return string(out.text);
+            }
+            if (c == 't' || c == 'f') {
+                out.type = Value::Type::BOOL;
+                out.boolean = c == 't';
+                return literal(c == 't' ? "true" : "false");
+            }
+            if (c == 'n') {
+                out.type = Value::Type::NUL;
+                return literal("null");
+            }
+            return number(out);
+        }
+
+        bool object(Value& out, int depth) {
+            out.type = Value::Type::OBJECT;
+            pos++;
+            skipSpace();
+            if (pos < src.size() && src[pos] == '}') {
+                pos++;
+                return true;
+            }
+            for (;;) {
+                skipSpace();
+                if (pos >= src.size() || src[pos] != '"') return fail("expected object key");
+                std::pair<std::string, Value> member;
+                if (!string(member.first)) return false;
+                skipSpace();
+                if (pos >= src.size() || src[pos] != ':') return fail("expected ':'");
+                pos++;
+                if (!value(member.second, depth + 1)) return false;
+                out.members.push_back(std::move(member));
+                skipSpace();
+                if (pos < src.size() && src[pos] == ',') {
+                    pos++;
+                    continue;
+                }
+                if (pos < src.size() && src[pos] == '}') {
+                    pos++;
+                    return true;
+                }
+                return fail("expected ',' or '}'");
+            }
+        }
+
+        bool array(Value& out, int depth) {
+            out.type = Value::Type::ARRAY;
+            pos++;
+            skipSpace();
+            if (pos < src.size() && src[pos] == ']') {
+                pos++;
+                return true;
+            }
+            for (;;) {
+                out.items.emplace_back();
+                if (!value(out.items.back(), depth + 1)) return false;
+                skipSpace();
+                if (pos < src.size() && src[pos] == ',') {
+                    pos++;
+                    continue;
+                }
+                if (pos < src.size() && src[pos] == ']') {
+                    pos++;
+                    return true;
+                }
+                return fail("expected ',' or ']'");
+            }
+        }
+
+        bool number(Value& out) {
+            const size_t start = pos;
+            if (pos < src.size() && src[pos] == '-') pos++;
+            const size_t intStart = pos;
+            while (pos < src.size() && src[pos] >= '0' && src[pos] <= '9') pos++;
+            if (pos == intStart) return fail("invalid value");
+            if (src[intStart] == '0' && pos - intStart > 1) return fail("leading zero");
+            if (pos < src.size() && src[pos] == '.') {
+                const size_t fracStart = ++pos;
+                while (pos < src.size() && src[pos] >= '0' && src[pos] <= '9') pos++;
+                if (pos == fracStart) return fail("invalid number");
+            }
+            if (pos < src.size() && (src[pos] == 'e' || src[pos] == 'E')) {
+                pos++;
+                if (pos < src.size() && (src[pos] == '+' || src[pos] == '-')) pos++;
+                const size_t expStart = pos;
+                while (pos < src.size() && src[pos] >= '0' && src[pos] <= '9') pos++;
+                if (pos == expStart) return fail("invalid number");
+            }
+            out.type = Value::Type::NUMBER;
+            out.text = src.substr(start, pos - start);
+            return true;
+        }
+
+        bool hex4(uint32_t& out) {
+            if (src.size() - pos < 4) return fail("truncated \\u escape");
+            out = 0;
+            for (int i = 0; i < 4; i++) {
+                const char c = src[pos++];
+                out <<= 4;
+                if (c >= '0' && c <= '9') out |= static_cast<uint32_t>(c - '0');
+                else if (c >= 'a' && c <= 'f') out |= static_cast<uint32_t>(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F') out |= static_cast<uint32_t>(c - 'A' + 10);
+                else return fail("invalid \\u escape");
+            }
+            return true;
+        }
+
+        static void utf8(uint32_t cp, std::string& out) {
+            if (cp < 0x80) {
+                out += static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                out += static_cast<char>(0xC0 | (cp >> 6));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                out += static_cast<char>(0xE0 | (cp >> 12));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (cp >> 18));
+                out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+
+        bool string(std::string& out) {
+            pos++;
+            for (;;) {
+                if (pos >= src.size()) return fail("unterminated string");
+                const char c = src[pos++];
+                if (c == '"') return true;
+                if (static_cast<unsigned char>(c) < 0x20) return fail("control character in string");
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos >= src.size()) return fail("unterminated string");
+                const char e = src[pos++];
+                switch (e) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        uint32_t cp;
+                        if (!hex4(cp)) return false;
+                        // A high surrogate followed by a low one encodes a code point above U+FFFF
+                        if (cp >= 0xD800 && cp < 0xDC00 && src.compare(pos, 2, "\\u") == 0) {
+                            const size_t save = pos;
+                            pos += 2;
+                            uint32_t low;
+                            if (!hex4(low)) return false;
+                            if (low >= 0xDC00 && low < 0xE000) cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            else pos = save;
+                        }
+                        utf8(cp, out);
+                        break;
+                    }
+                    default:
+                        return fail("invalid escape");
+                }
+            }
+        }
+
+        const std::string& src;
+        size_t pos = 0;
+        std::string message;
+    };
+
+    inline bool parse(const std::string& text, Value& out, std::string& error) {
+        out = Value();
+        return Parser(text).parse(out, error);
+    }
+
+    // `s` as a JSON string literal, quotes included
+    inline std::string quote(const std::string& s) {
+        std::string out = "\"";
+        for (char c : s) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+                        out += buf;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        return out + "\"";
+    }
+}
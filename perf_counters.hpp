@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Cycle and instruction counts for the calling thread via perf_event_open.
+// available() is false off Linux or when the kernel/sandbox refuses access
+// (perf_event_paranoid, containers); callers should then report "n/a" and
+// can fall back to readTsc() for reference-cycle timing.
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        leader = openCounter(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (leader >= 0) {
+            instructionsFd = openCounter(PERF_COUNT_HW_INSTRUCTIONS, leader);
+            if (instructionsFd < 0) {
+                close(leader);
+                leader = -1;
+            }
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        if (instructionsFd >= 0) close(instructionsFd);
+        if (leader >= 0) close(leader);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return leader >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (leader < 0) return;
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        if (leader < 0) return;
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // PERF_FORMAT_GROUP layout: nr, then one value per counter
+        uint64_t data[3] = {0, 0, 0};
+        if (read(leader, data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)) && data[0] == 2) {
+            cyclesCount = data[1];
+            instructionsCount = data[2];
+        }
+#endif
+    }
+
+    uint64_t cycles() const { return cyclesCount; }
+    uint64_t instructions() const { return instructionsCount; }
+    double ipc() const { return cyclesCount ? static_cast<double>(instructionsCount) / cyclesCount : 0.0; }
+
+    static uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+private:
+    int leader = -1;
+    int instructionsFd = -1;
+    uint64_t cyclesCount = 0;
+    uint64_t instructionsCount = 0;
+
+#if defined(__linux__)
+    static int openCounter(uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = groupFd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+#endif
+};
+
+// Per-thread counters for the search loop's --perf-counters mode: cycles,
+// instructions, L1D read misses, last-level cache misses and branch misses.
+// The events are opened independently, so an event the PMU or the kernel
+// does not offer is just left out. When the kernel multiplexes the events,
+// their values are scaled by time enabled / time running. Counting starts
+// at construction; phases are measured as differences between snapshots.
+class PerfEventSet {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+    struct Snapshot {
+        uint64_t value[EVENT_COUNT] = {};
+
+        Snapshot operator-(const Snapshot& o) const {
+            Snapshot d;
+            for (int e = 0; e < EVENT_COUNT; e++) d.value[e] = value[e] > o.value[e] ? value[e] - o.value[e] : 0;
+            return d;
+        }
+        Snapshot& operator+=(const Snapshot& o) {
+            for (int e = 0; e < EVENT_COUNT; e++) value[e] += o.value[e];
+            return *this;
+        }
+    };
+
+    static const char* eventName(int e) {
+        static const char* const names[EVENT_COUNT] = {"cycles", "instructions", "L1D misses", "LLC misses", "branch misses"};
+        return names[e];
+    }
+
+    PerfEventSet() {
+        for (int& fd : fds) fd = -1;
+#if defined(__linux__)
+        fds[CYCLES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[L1D_MISSES] = openEvent(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        fds[LLC_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    ~PerfEventSet() {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfEventSet(const PerfEventSet&) = delete;
+    PerfEventSet& operator=(const PerfEventSet&) = delete;
+
+    bool has(int e) const { return fds[e] >= 0; }
+    bool available() const {
+        for (int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    // Counts since construction; events that are not open read as 0
+    Snapshot read() const {
+        Snapshot s;
+#if defined(__linux__)
+        for (int e = 0; e < EVENT_COUNT; e++) {
+            if (fds[e] < 0) continue;
+            // PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING layout
+            uint64_t data[3] = {0, 0, 0};
+            if (::read(fds[e], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) continue;
+            s.value[e] = data[2] && data[2] < data[1]
+                ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2])
+                : data[0];
+        }
+#endif
+        return s;
+    }
+
+    // Why no event could be opened, for the one-line fallback message
+    std::string unavailableReason() const {
+#if defined(__linux__)
+        std::string reason = "perf_event_open failed";
+        if (openErrno) reason += std::string(": ") + std::strerror(openErrno);
+        std::ifstream paranoid("/proc/sys/kernel/perf_event_paranoid");
+        int level;
+        if (paranoid >> level) reason += " (perf_event_paranoid=" + std::to_string(level) + ")";
+        return reason;
+#else
+        return "perf counters are only supported on Linux";
+#endif
+    }
+
+private:
+    int fds[EVENT_COUNT];
+    int openErrno = 0;   // errno of this set's last failed perf_event_open
+
+#if defined(__linux__)
+    int openEvent(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = type;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0) openErrno = errno;
+        return fd;
+    }
+#endif
+};
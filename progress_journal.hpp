@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "atomic_file.hpp"
+
+// Crash-safe progress journal for the search driver. The searched range is
+// handed out in fixed-size chunks (Tracker). Matches are held back until a
+// checkpoint, which first appends them to the CSV and fsyncs it, then
+// atomically replaces the journal with the new state. The journal records
+// the watermark (every seed below it is done), the completed chunks above
+// it, the chunks in flight, and the CSV size after the last checkpoint.
+// A resumed run truncates the CSV back to that size and redoes only the
+// chunks that are not done, so no seed is skipped and no match is logged
+// twice.
+//
+// File format (text, one record per line):
+//   balatro-progress-journal 1
+//   filter <key>
+//   range <start> <end>
+//   chunk <size>
+//   watermark <n>
+//   seeds <completed seed count>
+//   csv <bytes> <path>
+//   done <begin> <end>        (zero or more, above the watermark)
+//   inflight <begin> <end>    (zero or more, informational)
+namespace ProgressJournal {
+
+    constexpr const char* MAGIC = "balatro-progress-journal";
+    constexpr int FORMAT_VERSION = 1;
+
+    struct Range {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    struct Match {
+        uint64_t number;
+        uint16_t level;
+    };
+
+    struct State {
+        std::string filterKey;
+        uint64_t rangeStart = 0;
+        uint64_t rangeEnd = 0;
+        uint64_t chunkSize = 0;
+        uint64_t watermark = 0;
+        uint64_t seedsDone = 0;
+        std::string csvPath;
+        uint64_t csvBytes = 0;
+        std::vector<Range> done;
+        std::vector<Range> inFlight;
+    };
+
+    // Cuts `path` back to `bytes`, dropping anything written after the last checkpoint
+    inline bool truncateTo(const std::string& path, uint64_t bytes) {
+#ifdef _WIN32
+        int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+        if (fd < 0) return false;
+        bool ok = _chsize_s(fd, static_cast<__int64>(bytes)) == 0;
+        _close(fd);
+        return ok;
+#else
+        return ::truncate(path.c_str(), static_cast<off_t>(bytes)) == 0;
+#endif
+    }
+
+    inline uint64_t fileSize(const std::string& path) {
+        std::ifstream f(path, std::ios::binary | std::ios::ate);
+        return f ? static_cast<uint64_t>(f.tellg()) : 0;
+    }
+
+    // Replaces the journal atomically (atomic_file.hpp)
+    inline bool save(const std::string& path, const State& s, std::string& error) {
+        std::ostringstream out;
+        out << MAGIC << " " << FORMAT_VERSION << "\n"
+            << "filter " << s.filterKey << "\n"
+            << "range " << s.rangeStart << " " << s.rangeEnd << "\n"
+            << "chunk " << s.chunkSize << "\n"
+            << "watermark " << s.watermark << "\n"
+            << "seeds " << s.seedsDone << "\n"
+            << "csv " << s.csvBytes << " " << s.csvPath << "\n";
+        for (const auto& r : s.done) out << "done " << r.begin << " " << r.end << "\n";
+        for (const auto& r : s.inFlight) out << "inflight " << r.begin << " " << r.end << "\n";
+        return AtomicFile::write(path, out.str(), error);
+    }
+
+    inline bool load(const std::string& path, State& s, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "could not open " + path;
+            return false;
+        }
+        std::string magic;
+        int version = 0;
+        if (!(in >> magic >> version) || magic != MAGIC || version != FORMAT_VERSION) {
+            error = path + " is not a progress journal";
+            return false;
+        }
+        s = State();
+        std::string key;
+        while (in >> key) {
+            if (key == "filter") in >> s.filterKey;
+            else if (key == "range") in >> s.rangeStart >> s.rangeEnd;
+            else if (key == "chunk") in >> s.chunkSize;
+            else if (key == "watermark") in >> s.watermark;
+            else if (key == "seeds") in >> s.seedsDone;
+            else if (key == "csv") {
+                in >> s.csvBytes;
+                std::getline(in, s.csvPath);
+                if (!s.csvPath.empty() && s.csvPath[0] == ' ') s.csvPath.erase(0, 1);
+            } else if (key == "done" || key == "inflight") {
+                Range r;
+                in >> r.begin >> r.end;
+                (key == "done" ? s.done : s.inFlight).push_back(r);
+            } else {
+                std::getline(in, key);  // Unknown record: skip the line
+            }
+            if (!in) {
+                error = path + ": malformed " + key + " record";
+                return false;
+            }
+        }
+        if (s.chunkSize == 0 || s.rangeEnd < s.rangeStart || s.watermark < s.rangeStart || s.watermark > s.rangeEnd) {
+            error = path + ": inconsistent range";
+            return false;
+        }
+        return true;
+    }
+
+    // Hands out chunks of [start, end) to worker threads and tracks which
+    // are done, in flight, and not yet checkpointed
+    class Tracker {
+    public:
+        Tracker(uint64_t rangeStart, uint64_t rangeEnd, uint64_t chunkSize)
+            : start(rangeStart), end(rangeEnd), chunk(chunkSize), chunks((rangeEnd - rangeStart + chunkSize - 1) / chunkSize) {}
+
+        // Continues from a loaded journal; its range and chunk size must match
+        bool restore(const State& s, std::string& error) {
+            if (s.rangeStart != start || s.rangeEnd != end || s.chunkSize != chunk) {
+                error = "journal range or chunk size does not match this run";
+                return false;
+            }
+            std::lock_guard<std::mutex> lk(mutex);
+            mark = s.watermark == end ? chunks : chunkOf(s.watermark);
+            nextChunk = mark;
+            seedsDone = s.seedsDone;
+            for (const auto& r : s.done) {
+                for (uint64_t c = chunkOf(r.begin); c < chunks && chunkBegin(c) < r.end; c++) done.insert(c);
+            }
+            advance();
+            return true;
+        }
+
+        // Seeds this run still has to search
+        uint64_t remaining() const {
+            std::lock_guard<std::mutex> lk(mutex);
+            uint64_t n = end - std::min(end, chunkBegin(mark));
+            for (uint64_t c : done) n -= chunkEnd(c) - chunkBegin(c);
+            return n;
+        }
+
+        bool next(uint64_t& begin, uint64_t& stop) {
+            std::lock_guard<std::mutex> lk(mutex);
+            while (nextChunk < chunks && done.count(nextChunk)) nextChunk++;
+            if (nextChunk >= chunks) return false;
+            inFlight.insert(nextChunk);
+            begin = chunkBegin(nextChunk);
+            stop = chunkEnd(nextChunk);
+            nextChunk++;
+            return true;
+        }
+
+        // Marks the chunk starting at `begin` done; its matches wait for the next checkpoint
+        void complete(uint64_t begin, const std::vector<Match>& matches) {
+            std::lock_guard<std::mutex> lk(mutex);
+            const uint64_t c = chunkOf(begin);
+            inFlight.erase(c);
+            done.insert(c);
+            seedsDone += chunkEnd(c) - chunkBegin(c);
+            pending.insert(pending.end(), matches.begin(), matches.end());
+            advance();
+        }
+
+        // Takes the matches completed since the last checkpoint (sorted by
+        // seed number) and the journal state that covers exactly them
+        void checkpoint(State& s, std::vector<Match>& matches) {
+            std::lock_guard<std::mutex> lk(mutex);
+            s.rangeStart = start;
+            s.rangeEnd = end;
+            s.chunkSize = chunk;
+            s.watermark = std::min(end, chunkBegin(mark));
+            s.seedsDone = seedsDone;
+            s.done = ranges(done);
+            s.inFlight = ranges(inFlight);
+            matches.clear();
+            matches.swap(pending);
+            std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) { return a.number < b.number; });
+        }
+
+        uint64_t watermark() const {
+            std::lock_guard<std::mutex> lk(mutex);
+            return std::min(end, chunkBegin(mark));
+        }
+
+        // Matches completed but not yet taken by a checkpoint
+        size_t pendingMatches() const {
+            std::lock_guard<std::mutex> lk(mutex);
+            return pending.size();
+        }
+
+        size_t chunksInFlight() const {
+            std::lock_guard<std::mutex> lk(mutex);
+            return inFlight.size();
+        }
+
+    private:
+        uint64_t chunkOf(uint64_t n) const { return (n - start) / chunk; }
+        uint64_t chunkBegin(uint64_t c) const { return start + c * chunk; }
+        uint64_t chunkEnd(uint64_t c) const { return std::min(end, start + (c + 1) * chunk); }
+
+        // Moves the watermark over chunks that are done, so `done` only holds chunks above it
+        void advance() {
+            while (!done.empty() && *done.begin() == mark) {
+                done.erase(done.begin());
+                mark++;
+            }
+        }
+
+        std::vector<Range> ranges(const std::set<uint64_t>& set) const {
+            std::vector<Range> out;
+            for (uint64_t c : set) {
+                if (!out.empty() && out.back().end == chunkBegin(c)) out.back().end = chunkEnd(c);
+                else out.push_back({chunkBegin(c), chunkEnd(c)});
+            }
+            return out;
+        }
+
+        const uint64_t start, end, chunk, chunks;
+        mutable std::mutex mutex;
+        uint64_t mark = 0;       // First chunk that is not done
+        uint64_t nextChunk = 0;  // Next chunk to hand out (skipping done ones)
+        uint64_t seedsDone = 0;
+        std::set<uint64_t> done;      // Done chunks above the watermark
+        std::set<uint64_t> inFlight;
+        std::vector<Match> pending;
+    };
+}
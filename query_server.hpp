@@ -0,0 +1,679 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "describe_pool.hpp"
+#include "env.hpp"
+#include "instance.hpp"
+#include "items_to_string.hpp"
+#include "logger.hpp"
+#include "mini_json.hpp"
+#include "search_driver.hpp"
+#include "seed_input.hpp"
+#include "seed_util.hpp"
+#include "worker_pool.hpp"
+
+// --serve: keeps one process, its filter, env files and worker threads warm
+// for tools (the GUI) that would otherwise launch the binary per query.
+// Requests and responses are single JSON lines, over stdin/stdout or a Unix
+// socket (--serve-socket PATH, one thread per client):
+//
+//   {"id": 7, "cmd": "describe", "seed": "ABCD1234"}
+//   {"id": 7, "ok": true, "result": {...}}
+//   {"id": 8, "ok": false, "error": "..."}
+//
+// Commands:
+//   status                      filter, level names, threads, active env, scans
+//   describe    seed | seeds[]  --describe-match output for one seed, or
+//                               --describe records for a list
+//   evaluate    seeds[]         [{"seed", "level", "name"}] in request order
+//   simulate    seed, antes, shop  bosses, vouchers, tags, shop queue and packs
+//   scan_start  start|seed, count|end  background range scan to a match CSV
+//   scan_status [scan]          progress of one scan, or of all
+//   scan_stop   scan            stop a scan after its current chunks
+//   shutdown                    stop scans and exit
+//
+// Any request may name an "env" file. Parsed files are cached by path and
+// modification time. The global env only changes when the requested one
+// differs from the active one, and not while a scan is running.
+namespace QueryServer {
+
+    // Bosses, vouchers, tags, the first `shopItems` shop items and the packs
+    // of antes 1..`antes`, in the order the game generates them
+    inline std::string simulate(const std::string& seed, int antes, int shopItems, const EnvConfig& e) {
+        Instance::Instance inst(seed);
+        if (!e.deck.empty()) inst.setDeck(e.deck);
+        if (!e.stake.empty()) inst.setStake(e.stake);
+        inst.setShowman(e.showman);
+        inst.setSixesFactor(e.sixesFactor);
+        inst.setVersion(e.version);
+        inst.setForceAllContent(e.forceAllContent);
+        inst.initLocks(1, e.freshProfile, e.freshRun);
+
+        using MiniJson::quote;
+        std::string out = "{\"seed\": " + quote(seed) + ", \"antes\": [";
+        for (int a = 1; a <= antes; a++) {
+            inst.initUnlocks(a, e.freshProfile);
+            const Items::Boss boss = inst.nextBoss_enum(a);
+            const Items::Voucher voucher = inst.nextVoucher_enum(a);
+            inst.activateVoucher_enum(voucher);
+            const Items::Tag smallTag = inst.nextTag_enum(a);
+            const Items::Tag bigTag = inst.nextTag_enum(a);
+            if (a > 1) out += ", ";
+            out += "{\"ante\": " + std::to_string(a) + ", \"boss\": " + quote(Items::toString(boss)) +
+                   ", \"voucher\": " + quote(Items::toString(voucher)) + ", \"tags\": [" + quote(Items::toString(smallTag)) + ", " +
+                   quote(Items::toString(bigTag)) + "], \"shop\": [";
+            for (int i = 0; i < shopItems; i++) {
+                const Items::OptimizedShopItem item = inst.nextShopItem_enum(a);
+                std::string name;
+                switch (item.type) {
+                    case Items::OptimizedShopItem::Type::JOKER: {
+                        const Items::OptimizedJokerData& j = item.joker_data;
+                        if (j.edition != Items::Edition::NO_EDITION) name += std::string(Items::toString(j.edition)) + " ";
+                        if (j.eternal) name += "Eternal ";
+                        if (j.perishable) name += "Perishable ";
+                        if (j.rental) name += "Rental ";
+                        name += Items::toString(item.item.joker);
+                        break;
+                    }
+                    case Items::OptimizedShopItem::Type::TAROT: name = Items::toString(item.item.tarot); break;
+                    case Items::OptimizedShopItem::Type::PLANET: name = Items::toString(item.item.planet); break;
+                    case Items::OptimizedShopItem::Type::SPECTRAL: name = Items::toString(item.item.spectral); break;
+                    default: name = "Playing Card"; break;
+                }
+                out += (i ? ", " : "") + quote(name);
+            }
+            out += "], \"packs\": [";
+            const int packs = a == 1 ? 4 : 6;
+            for (int p = 0; p < packs; p++) {
+                const Items::NextPackData pack = Items::convertPackData(inst.nextPack_enum(a));
+                std::vector<std::string> cards;
+                switch (pack.type) {
+                    case Items::Pack::ARCANA_PACK: {
+                        const Items::MixedArcanaPack arcana = inst.nextArcanaPack_enum(pack.size, a);
+                        for (size_t i = 0; i < arcana.tarots.size(); i++) {
+                            cards.push_back(arcana.isSpectral[i] ? Items::toString(arcana.spectrals[i]) : Items::toString(arcana.tarots[i]));
+                        }
+                        break;
+                    }
+                    case Items::Pack::CELESTIAL_PACK:
+                        for (Items::Planet planet : inst.nextCelestialPack_enum(pack.size, a)) cards.push_back(Items::toString(planet));
+                        break;
+                    case Items::Pack::SPECTRAL_PACK:
+                        for (Items::Spectral s : inst.nextSpectralPack_enum(pack.size, a)) cards.push_back(Items::toString(s));
+                        break;
+                    case Items::Pack::BUFFOON_PACK:
+                        for (const auto& j : inst.nextBuffoonPack_enum(pack.size, a)) {
+                            std::string name;
+                            if (j.edition != Items::Edition::NO_EDITION) name += std::string(Items::toString(j.edition)) + " ";
+                            cards.push_back(name + Items::toString(j.joker));
+                        }
+                        break;
+                    case Items::Pack::STANDARD_PACK:
+                        for (const auto& c : inst.nextStandardPack_enum(pack.size, a)) {
+                            cards.push_back(c.base + " " + Items::toString(c.enhancement) + " " + Items::toString(c.edition) + " " +
+                                            Items::toString(c.seal));
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                out += std::string(p ? ", " : "") + "{\"pack\": " + quote(Items::toString(pack.type)) + ", \"choices\": " +
+                       std::to_string(pack.choices) + ", \"cards\": [";
+                for (size_t i = 0; i < cards.size(); i++) out += (i ? ", " : "") + quote(cards[i]);
+                out += "]}";
+            }
+            out += "]}";
+        }
+        return out + "]}";
+    }
+
+    template<typename Filter>
+    class Server {
+    public:
+        // Seeds a scan task searches before it requeues itself behind interactive work
+        static constexpr uint64_t SCAN_CHUNK = 4096;
+        static constexpr int MAX_ANTES = 8;
+        static constexpr int MAX_SHOP_ITEMS = 100;
+
+        Server(SearchDriver<Filter>& searchDriver, SearchFilter& searchFilter, unsigned int threads)
+            : driver(searchDriver), filter(searchFilter), activeEnv(envConfigHash(getGlobalEnv())), pool(threads) {}
+
+        ~Server() { stopScans(); }
+
+        // Makes `path` the active env, as a request's "env" would
+        bool setEnv(const std::string& path, std::string& error) {
+            std::lock_guard<std::mutex> lk(requestMutex);
+            return useEnv(path, error);
+        }
+
+        // Serves requests from `in` until EOF or shutdown
+        void serveStream(std::istream& in, std::ostream& out) {
+            std::string line;
+            bool quit = false;
+            while (!quit && std::getline(in, line)) {
+                if (line.empty() || line == "\r") continue;
+                out << handle(line, quit) << '\n' << std::flush;
+            }
+            stopScans();
+        }
+
+#ifndef _WIN32
+        // Serves clients of a Unix socket at `path` until one sends shutdown
+        bool serveSocket(const std::string& path, std::string& error) {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(addr.sun_path)) {
+                error = "socket path too long: " + path;
+                return false;
+            }
+            std::copy(path.begin(), path.end(), addr.sun_path);
+            listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+            ::unlink(path.c_str());
+            if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listenFd, 8) != 0) {
+                error = "could not listen on " + path;
+                if (listenFd >= 0) ::close(listenFd);
+                return false;
+            }
+            std::vector<std::thread> clients;
+            for (;;) {
+                const int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) {
+                    if (errno == EINTR) continue;
+                    break;  // Listener shut down by a shutdown request
+                }
+                std::lock_guard<std::mutex> lk(clientMutex);
+                if (quitting) {
+                    ::close(fd);
+                    break;
+                }
+                clientFds.insert(fd);
+                clients.emplace_back(&Server::serveClient, this, fd);
+            }
+            for (auto& t : clients) t.join();
+            ::close(listenFd);
+            ::unlink(path.c_str());
+            stopScans();
+            return true;
+        }
+#endif
+
+        // One request line in, one response line out (without the newline)
+        std::string handle(const std::string& line, bool& quit) {
+            MiniJson::Value request;
+            std::string error;
+            if (!MiniJson::parse(line, request, error)) return failure("null", "bad JSON: " + error);
+            const MiniJson::Value* idValue = request.get("id");
+            const std::string id = !idValue ? "null" : idValue->isNumber() ? idValue->text : idValue->isString() ? MiniJson::quote(idValue->text) : "null";
+            const MiniJson::Value* cmdValue = request.get("cmd");
+            if (!request.isObject() || !cmdValue || !cmdValue->isString()) return failure(id, "request needs a \"cmd\" string");
+            const std::string& cmd = cmdValue->text;
+
+            std::lock_guard<std::mutex> lk(requestMutex);
+            const MiniJson::Value* env = request.get("env");
+            if (env && !env->isNull()) {
+                if (!env->isString()) return failure(id, "\"env\" must be a file path");
+                if (!useEnv(env->text, error)) return failure(id, error);
+            }
+            std::string result;
+            try {
+                if (cmd == "status") result = status();
+                else if (cmd == "describe") result = describe(request, error);
+                else if (cmd == "evaluate") result = evaluate(request, error);
+                else if (cmd == "simulate") result = simulateRequest(request, error);
+                else if (cmd == "scan_start") result = scanStart(request, error);
+                else if (cmd == "scan_status") result = scanStatus(request, error);
+                else if (cmd == "scan_stop") result = scanStop(request, error);
+                else if (cmd == "shutdown") {
+                    quit = true;
+                    requestShutdown();
+                    result = "true";
+                } else {
+                    error = "unknown cmd \"" + cmd + "\"";
+                }
+            } catch (const std::exception& ex) {
+                error = ex.what();
+            }
+            if (result.empty()) return failure(id, error.empty() ? "request failed" : error);
+            return "{\"id\": " + id + ", \"ok\": true, \"result\": " + result + "}";
+        }
+
+    private:
+        struct Scan {
+            uint64_t id = 0;
+            uint64_t start = 0;
+            uint64_t end = 0;
+            std::string csvPath;
+            std::ofstream csv;
+            std::mutex csvMutex;
+            std::atomic<uint64_t> next{0};
+            std::atomic<uint64_t> searched{0};
+            std::unique_ptr<std::atomic<uint64_t>[]> levels;
+            std::atomic<bool> stop{false};
+            std::atomic<unsigned int> tasks{0};
+            std::atomic<bool> finished{false};
+            std::string error;          // First filter failure; read once finished
+            std::chrono::steady_clock::time_point started;
+            std::atomic<double> seconds{0};
+        };
+
+        static std::string failure(const std::string& id, const std::string& message) {
+            return "{\"id\": " + id + ", \"ok\": false, \"error\": " + MiniJson::quote(message) + "}";
+        }
+
+        bool useEnv(const std::string& path, std::string& error) {
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0) {
+                error = "env file not found: " + path;
+                return false;
+            }
+            auto cached = envCache.find(path);
+            if (cached == envCache.end() || cached->second.first != st.st_mtime) {
+                EnvConfig e;
+                if (!loadEnvFile(path, e)) {
+                    error = "could not parse env file: " + path;
+                    return false;
+                }
+                envCache[path] = std::make_pair(st.st_mtime, e);
+                cached = envCache.find(path);
+            }
+            const uint64_t hash = envConfigHash(cached->second.second);
+            if (hash == activeEnv) {
+                activeEnvPath = path;
+                return true;
+            }
+            if (scanRunning()) {
+                error = "a scan is running with another env; stop it first";
+                return false;
+            }
+            setGlobalEnv(cached->second.second);
+            activeEnv = hash;
+            activeEnvPath = path;
+            return true;
+        }
+
+        bool parseSeedValue(const MiniJson::Value* v, uint64_t& number) const {
+            return v && v->isString() && SeedInput::parseSeed(v->text.data(), v->text.size(), number);
+        }
+
+        std::string levelName(int level) const { return driver.resultName(level); }
+
+        std::string status() {
+            std::string out = "{\"filter\": " + MiniJson::quote(filter.getName()) + ", \"results\": [";
+            const auto& names = driver.resultNames();
+            for (size_t i = 0; i < names.size(); i++) out += (i ? ", " : "") + MiniJson::quote(names[i]);
+            out += "], \"threads\": " + std::to_string(pool.size()) + ", \"env\": " +
+                   (activeEnvPath.empty() ? std::string("null") : MiniJson::quote(activeEnvPath)) + ", \"scans\": " + scanList() + "}";
+            return out;
+        }
+
+        // --describe-match's output for one seed
+        std::string describeOne(const std::string& seed, int& level) {
+            std::ostream discard(nullptr);
+            level = driver.apply(seed, discard);
+            std::string json = filter.describeMatch(seed);
+            for (char& c : json) {
+                if (c == '\n' || c == '\r') c = ' ';
+            }
+            return json;
+        }
+
+        std::string describe(const MiniJson::Value& request, std::string& error) {
+            uint64_t number;
+            if (request.get("seed")) {
+                if (!parseSeedValue(request.get("seed"), number)) {
+                    error = "\"seed\" must be an 8-character seed";
+                    return std::string();
+                }
+                const std::string seed = numberToSeed(number);
+                int level;
+                const std::string json = describeOne(seed, level);
+                if (!json.empty()) return json;
+                return "{\"index\": " + std::to_string(level) + ", \"name\": " + MiniJson::quote(levelName(level)) + "}";
+            }
+            std::vector<std::string> seeds;
+            if (!seedList(request, seeds, error)) return std::string();
+            std::vector<std::string> records(seeds.size());
+            forEachSeed(seeds, [&](size_t i) {
+                int level;
+                const std::string json = describeOne(seeds[i], level);
+                records[i] = DescribePool::formatLine(filter.getName(), seeds[i], level, levelName(level), json);
+                records[i].pop_back();  // The newline
+            });
+            return joinArray(records);
+        }
+
+        std::string evaluate(const MiniJson::Value& request, std::string& error) {
+            std::vector<std::string> seeds;
+            if (!seedList(request, seeds, error)) return std::string();
+            std::vector<std::string> records(seeds.size());
+            forEachSeed(seeds, [&](size_t i) {
+                std::ostream discard(nullptr);
+                const int level = driver.apply(seeds[i], discard);
+                records[i] = "{\"seed\": \"" + seeds[i] + "\", \"level\": " + std::to_string(level) + ", \"name\": " +
+                             MiniJson::quote(levelName(level)) + "}";
+            });
+            return joinArray(records);
+        }
+
+        std::string simulateRequest(const MiniJson::Value& request, std::string& error) {
+            uint64_t number;
+            if (!parseSeedValue(request.get("seed"), number)) {
+                error = "\"seed\" must be an 8-character seed";
+                return std::string();
+            }
+            uint64_t antes = 1, shop = 10;
+            const MiniJson::Value* a = request.get("antes");
+            const MiniJson::Value* s = request.get("shop");
+            if ((a && (!a->asUint(antes) || antes < 1 || antes > MAX_ANTES)) || (s && (!s->asUint(shop) || shop > MAX_SHOP_ITEMS))) {
+                error = "\"antes\" must be 1-" + std::to_string(MAX_ANTES) + " and \"shop\" 0-" + std::to_string(MAX_SHOP_ITEMS);
+                return std::string();
+            }
+            return simulate(numberToSeed(number), static_cast<int>(antes), static_cast<int>(shop), getGlobalEnv());
+        }
+
+        bool seedList(const MiniJson::Value& request, std::vector<std::string>& seeds, std::string& error) const {
+            const MiniJson::Value* list = request.get("seeds");
+            if (!list || !list->isArray()) {
+                error = "\"seeds\" must be an array of seeds";
+                return false;
+            }
+            for (size_t i = 0; i < list->items.size(); i++) {
+                uint64_t number;
+                if (!parseSeedValue(&list->items[i], number)) {
+                    error = "seeds[" + std::to_string(i) + "] is not an 8-character seed";
+                    return false;
+                }
+                seeds.push_back(numberToSeed(number));
+            }
+            return true;
+        }
+
+        // Runs fn(i) for every seed index, split across the pool
+        void forEachSeed(const std::vector<std::string>& seeds, const std::function<void(size_t)>& fn) {
+            const size_t parts = std::min<size_t>(pool.size(), (seeds.size() + 15) / 16);
+            if (parts <= 1) {
+                for (size_t i = 0; i < seeds.size(); i++) fn(i);
+                return;
+            }
+            std::vector<std::function<void()>> tasks;
+            for (size_t p = 0; p < parts; p++) {
+                tasks.push_back([&, p]() {
+                    for (size_t i = p; i < seeds.size(); i += parts) fn(i);
+                });
+            }
+            pool.runAll(tasks);
+        }
+
+        static std::string joinArray(const std::vector<std::string>& items) {
+            std::string out = "[";
+            for (size_t i = 0; i < items.size(); i++) out += (i ? ", " : "") + items[i];
+            return out + "]";
+        }
+
+        std::string scanStart(const MiniJson::Value& request, std::string& error) {
+            uint64_t start = 0, end = SEED_COUNT, count = 0;
+            const MiniJson::Value* s = request.get("start");
+            const MiniJson::Value* seed = request.get("seed");
+            const MiniJson::Value* e = request.get("end");
+            const MiniJson::Value* c = request.get("count");
+            if ((s && !s->asUint(start)) || (seed && !parseSeedValue(seed, start)) || (e && !e->asUint(end)) || (c && !c->asUint(count)) ||
+                (e && c) || (s && seed)) {
+                error = "scan_start takes \"start\" (number) or \"seed\", and \"end\" or \"count\"";
+                return std::string();
+            }
+            if (c) end = start + std::min(count, SEED_COUNT - std::min(start, SEED_COUNT));
+            end = std::min(end, SEED_COUNT);
+            if (start >= end) {
+                error = "empty scan range";
+                return std::string();
+            }
+            std::shared_ptr<Scan> scan = std::make_shared<Scan>();
+            scan->id = ++lastScanId;
+            scan->start = start;
+            scan->end = end;
+            scan->next = start;
+            scan->levels.reset(new std::atomic<uint64_t>[driver.resultNames().size()]);
+            for (size_t i = 0; i < driver.resultNames().size(); i++) scan->levels[i] = 0;
+            const auto t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            std::stringstream name;
+            name << "dist/serve_scan_" << std::put_time(std::localtime(&t), "%Y%m%d_%H%M%S") << "_" << scan->id << ".csv";
+            scan->csvPath = name.str();
+            scan->csv.open(scan->csvPath, std::ios::trunc);
+            if (!scan->csv.is_open()) {
+                error = "could not create " + scan->csvPath;
+                return std::string();
+            }
+            scan->csv << "seed,match_level\n";
+            scan->started = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lk(scansMutex);
+                scans[scan->id] = scan;
+            }
+            scan->tasks = pool.size();
+            for (unsigned int i = 0; i < pool.size(); i++) {
+                pool.submit([this, scan]() { scanChunk(scan); }, false);
+            }
+            return describeScan(*scan);
+        }
+
+        // One chunk of a scan, then the next one queued behind other work. A
+        // filter that throws stops the scan, which then reports "failed".
+        void scanChunk(const std::shared_ptr<Scan>& scan) {
+            const uint64_t from = scan->next.fetch_add(SCAN_CHUNK);
+            if (!scan->stop.load() && from < scan->end) {
+                std::string failure;
+                try {
+                    searchChunk(*scan, from);
+                    pool.submit([this, scan]() { scanChunk(scan); }, false);
+                    return;
+                } catch (const std::exception& ex) {
+                    failure = ex.what();
+                } catch (...) {
+                    failure = "unknown error";
+                }
+                std::lock_guard<std::mutex> lk(scan->csvMutex);
+                if (scan->error.empty()) scan->error = failure.empty() ? "scan failed" : failure;
+                scan->stop = true;
+            }
+            // Every task ends here exactly once; the last one closes the scan
+            if (--scan->tasks == 0) {
+                std::lock_guard<std::mutex> lk(scan->csvMutex);
+                scan->csv.close();
+                scan->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - scan->started).count();
+                scan->finished = true;
+            }
+        }
+
+        void searchChunk(Scan& scan, uint64_t from) {
+            const uint64_t to = std::min(from + SCAN_CHUNK, scan.end);
+            std::ostream discard(nullptr);
+            std::string rows;
+            // Counted once the chunk is through, so a failed chunk adds nothing
+            std::vector<uint64_t> levels(driver.resultNames().size(), 0);
+            for (uint64_t n = from; n < to; n++) {
+                const std::string seed = numberToSeed(n);
+                const int level = driver.apply(seed, discard);
+                if (level <= 0) continue;
+                levels[level - 1]++;
+                // Same rows as a search's match CSV
+                const std::string& name = driver.resultName(level);
+                rows += seed + "," + std::to_string(level);
+                if (!name.empty()) {
+                    rows += ",\"";
+                    for (char ch : name) rows += ch == '"' ? std::string("\"\"") : std::string(1, ch);
+                    rows += "\"";
+                }
+                rows += "\n";
+            }
+            for (size_t i = 0; i < levels.size(); i++) {
+                if (levels[i]) scan.levels[i] += levels[i];
+            }
+            scan.searched += to - from;
+            if (!rows.empty()) {
+                std::lock_guard<std::mutex> lk(scan.csvMutex);
+                scan.csv << rows << std::flush;
+            }
+        }
+
+        std::string describeScan(const Scan& scan) const {
+            const double secs = scan.finished ? scan.seconds.load()
+                                              : std::chrono::duration<double>(std::chrono::steady_clock::now() - scan.started).count();
+            const uint64_t searched = scan.searched.load();
+            const bool failed = scan.finished && !scan.error.empty();
+            const char* state = failed ? "failed"
+                              : scan.finished ? (searched == scan.end - scan.start ? "done" : "stopped")
+                              : scan.stop ? "stopping" : "running";
+            std::string out = "{\"scan\": " + std::to_string(scan.id) + ", \"state\": \"" + state + "\", \"start\": " +
+                              std::to_string(scan.start) + ", \"end\": " + std::to_string(scan.end) + ", \"searched\": " +
+                              std::to_string(searched) + ", \"seeds_per_second\": " +
+                              std::to_string(secs > 0 ? static_cast<uint64_t>(searched / secs) : 0) + ", \"matches\": [";
+            for (size_t i = 0; i < driver.resultNames().size(); i++) out += (i ? ", " : "") + std::to_string(scan.levels[i].load());
+            out += "], \"csv\": " + MiniJson::quote(scan.csvPath);
+            if (failed) out += ", \"error\": " + MiniJson::quote(scan.error);
+            return out + "}";
+        }
+
+        std::shared_ptr<Scan> findScan(const MiniJson::Value& request, std::string& error) {
+            uint64_t id;
+            const MiniJson::Value* v = request.get("scan");
+            std::lock_guard<std::mutex> lk(scansMutex);
+            auto it = v && v->asUint(id) ? scans.find(id) : scans.end();
+            if (it == scans.end()) {
+                error = "unknown \"scan\" id";
+                return nullptr;
+            }
+            return it->second;
+        }
+
+        std::string scanStatus(const MiniJson::Value& request, std::string& error) {
+            if (!request.get("scan")) return scanList();
+            std::shared_ptr<Scan> scan = findScan(request, error);
+            return scan ? describeScan(*scan) : std::string();
+        }
+
+        std::string scanStop(const MiniJson::Value& request, std::string& error) {
+            std::shared_ptr<Scan> scan = findScan(request, error);
+            if (!scan) return std::string();
+            scan->stop = true;
+            return describeScan(*scan);
+        }
+
+        std::string scanList() {
+            std::vector<std::string> items;
+            std::lock_guard<std::mutex> lk(scansMutex);
+            for (const auto& s : scans) items.push_back(describeScan(*s.second));
+            return joinArray(items);
+        }
+
+        bool scanRunning() {
+            std::lock_guard<std::mutex> lk(scansMutex);
+            for (const auto& s : scans) {
+                if (!s.second->finished) return true;
+            }
+            return false;
+        }
+
+        // Stops every scan and waits until their CSVs are closed
+        void stopScans() {
+            std::vector<std::shared_ptr<Scan>> all;
+            {
+                std::lock_guard<std::mutex> lk(scansMutex);
+                for (const auto& s : scans) all.push_back(s.second);
+            }
+            for (const auto& s : all) s->stop = true;
+            for (const auto& s : all) {
+                while (!s->finished) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        void requestShutdown() {
+#ifndef _WIN32
+            std::lock_guard<std::mutex> lk(clientMutex);
+            quitting = true;
+            if (listenFd >= 0) ::shutdown(listenFd, SHUT_RDWR);
+            // Readers blocked on other clients return with EOF
+            for (int fd : clientFds) ::shutdown(fd, SHUT_RD);
+#endif
+        }
+
+#ifndef _WIN32
+        void serveClient(int fd) {
+            std::string buffer;
+            char chunk[4096];
+            bool quit = false;
+            while (!quit) {
+                const ssize_t n = ::read(fd, chunk, sizeof(chunk));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+                buffer.append(chunk, static_cast<size_t>(n));
+                size_t nl;
+                while (!quit && (nl = buffer.find('\n')) != std::string::npos) {
+                    std::string line = buffer.substr(0, nl);
+                    buffer.erase(0, nl + 1);
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    if (line.empty()) continue;
+                    const std::string reply = handle(line, quit) + "\n";
+                    if (!writeAll(fd, reply)) quit = true;
+                }
+            }
+            std::lock_guard<std::mutex> lk(clientMutex);
+            clientFds.erase(fd);
+            ::close(fd);
+        }
+
+        static bool writeAll(int fd, const std::string& data) {
+            size_t done = 0;
+            while (done < data.size()) {
+                const ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                done += static_cast<size_t>(n);
+            }
+            return true;
+        }
+#endif
+
+        SearchDriver<Filter>& driver;
+        SearchFilter& filter;
+        // Requests run one at a time; scans and multi-seed requests use the pool
+        std::mutex requestMutex;
+        std::map<std::string, std::pair<time_t, EnvConfig>> envCache;
+        uint64_t activeEnv;
+        std::string activeEnvPath;
+        std::mutex scansMutex;
+        std::map<uint64_t, std::shared_ptr<Scan>> scans;
+        uint64_t lastScanId = 0;
+        std::mutex clientMutex;
+        std::set<int> clientFds;
+        int listenFd = -1;
+        bool quitting = false;
+        // Last member: its threads are joined before the rest is destroyed
+        WorkerPool pool;
+    };
+}
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include "hot_counters.hpp"
 
 #define INLINE_FORCE __attribute__((always_inline)) inline
 
@@ -21,6 +22,16 @@ typedef union DoubleLong {
 struct LuaRandom {
     uint64_t state[4];
     LuaRandom(double seed) {
+        HOT_COUNT(HotCounters::LUA_RANDOM);
+        seedState(seed, state);
+        for (int i = 0; i < 10; i++) {
+            _randint();
+        }
+    }
+    LuaRandom() : LuaRandom(0) {}
+
+    // State words before the warm-up steps
+    INLINE_FORCE static void seedState(double seed, uint64_t out[4]) {
         double d = seed;
         uint64_t r = 0x11090601;
         for (int i = 0; i < 4; i++) {
@@ -30,13 +41,9 @@ struct LuaRandom {
             dbllong u;
             u.dbl = d;
             if (u.ulong < m) u.ulong += m;
-            state[i] = u.ulong;
-        }
-        for (int i = 0; i < 10; i++) {
-            _randint();
+            out[i] = u.ulong;
         }
     }
-    LuaRandom() : LuaRandom(0) {}
 
     INLINE_FORCE uint64_t _randint() {
         uint64_t z = 0;
@@ -60,14 +67,18 @@ struct LuaRandom {
         return r;
     }
 
+    INLINE_FORCE static double toDouble(uint64_t bits) {
+        dbllong u;
+        u.ulong = (bits & 4503599627370495ull) | 4607182418800017408ull;
+        return u.dbl - 1.0;
+    }
+
     INLINE_FORCE uint64_t randdblmem() {        
         return (_randint() & 4503599627370495ull) | 4607182418800017408ull;
     }
 
     INLINE_FORCE double random() {
-        dbllong u;
-        u.ulong = randdblmem();
-        return u.dbl - 1.0;
+        return toDouble(_randint());
     }
 
     INLINE_FORCE int randint(int min, int max) {
@@ -75,18 +86,104 @@ struct LuaRandom {
     }
 };
 
-INLINE_FORCE double pseudohash(const std::string& s) {
+// Single-draw fast path. Most call sites seed a fresh LuaRandom, run the ten
+// warm-up steps and read one value. Every word update is linear over GF(2),
+// so that first output is a fixed linear map of the four seeded words: the
+// map is tabulated at compile time as eight byte-indexed tables per word
+// (64 KB), which replaces 44 shift/xor rounds with 32 loads and XORs.
+// Draws that continue on the same generator must still use LuaRandom.
+namespace LuaRandomJump {
+    constexpr int STEPS = 11;
+    constexpr int SHIFT_LEFT[4] = {31, 19, 24, 21};
+    constexpr int SHIFT_RIGHT[4] = {45, 30, 48, 39};
+    constexpr int MASK_SHIFT[4] = {1, 6, 9, 17};
+    constexpr int SHIFT_MASKED[4] = {18, 28, 7, 8};
+
+    // Same update as LuaRandom::_randint for word `w`
+    constexpr uint64_t step(uint64_t z, int w) {
+        return (((z << SHIFT_LEFT[w]) ^ z) >> SHIFT_RIGHT[w]) ^ ((z & (MAX_UINT64 << MASK_SHIFT[w])) << SHIFT_MASKED[w]);
+    }
+
+    // Word `w` after STEPS updates, starting from state z
+    constexpr uint64_t advance(uint64_t z, int w) {
+        for (int i = 0; i < STEPS; i++) z = step(z, w);
+        return z;
+    }
+
+    struct Table {
+        uint64_t byWord[4][8][256];
+    };
+
+    constexpr Table build() {
+        Table t{};
+        for (int w = 0; w < 4; w++) {
+            for (int b = 0; b < 8; b++) {
+                uint64_t column[8] = {};
+                for (int bit = 0; bit < 8; bit++) column[bit] = advance(1ull << (b * 8 + bit), w);
+                for (int v = 0; v < 256; v++) {
+                    uint64_t x = 0;
+                    for (int bit = 0; bit < 8; bit++) {
+                        if (v & (1 << bit)) x ^= column[bit];
+                    }
+                    t.byWord[w][b][v] = x;
+                }
+            }
+        }
+        return t;
+    }
+
+    // Class template so every translation unit shares one copy
+    template<typename = void>
+    struct Tables {
+        static constexpr Table value = build();
+    };
+    template<typename T>
+    constexpr Table Tables<T>::value;
+
+    // Spelled out so the lookups stay independent at -O2 as well
+    INLINE_FORCE uint64_t applyWord(const uint64_t (&t)[8][256], uint64_t z) {
+        return t[0][z & 255] ^ t[1][(z >> 8) & 255] ^ t[2][(z >> 16) & 255] ^ t[3][(z >> 24) & 255] ^
+               t[4][(z >> 32) & 255] ^ t[5][(z >> 40) & 255] ^ t[6][(z >> 48) & 255] ^ t[7][z >> 56];
+    }
+
+    // Bits of the first output of LuaRandom(seed)
+    INLINE_FORCE uint64_t firstOutput(double seed) {
+        const Table& t = Tables<>::value;
+        uint64_t state[4];
+        LuaRandom::seedState(seed, state);
+        return applyWord(t.byWord[0], state[0]) ^ applyWord(t.byWord[1], state[1]) ^
+               applyWord(t.byWord[2], state[2]) ^ applyWord(t.byWord[3], state[3]);
+    }
+}
+
+// LuaRandom(seed).random()
+INLINE_FORCE double lua_random_once(double seed) {
+    return LuaRandom::toDouble(LuaRandomJump::firstOutput(seed));
+}
+
+// LuaRandom(seed).randint(min, max)
+INLINE_FORCE int lua_randint_once(double seed, int min, int max) {
+    return (int)(lua_random_once(seed)*(max-min+1))+min;
+}
+
+// One step of the pseudohash recurrence. `k` is the position of `c` counted
+// from the end of the full string (1-based), so callers that split a key
+// into constant and per-seed parts can reproduce the exact same sequence.
+INLINE_FORCE double pseudohash_step(double num, char c, size_t k) {
     static constexpr double MAGIC1 = 1.1239285023;
     static constexpr double PI = 3.141592653589793116;
-    
+
+    double temp = MAGIC1 / num * c * PI + PI * k;
+    return temp - std::floor(temp);
+}
+
+INLINE_FORCE double pseudohash(const std::string& s) {
     double num = 1.0;
     const size_t len = s.length();
     const char* data = s.data(); // Avoid bounds checking in loop
     
     for (size_t i = 0; i < len; i++) {
-        // Inline division (still exact)
-        double temp = MAGIC1 / num * data[len-1-i] * PI + PI * (len-i);
-        num = temp - std::floor(temp);
+        num = pseudohash_step(num, data[len-1-i], len-i);
     }
     
     return std::isnan(num) ? std::numeric_limits<double>::quiet_NaN() : num;
@@ -106,4 +203,12 @@ INLINE_FORCE double round13(double x) {
         return (std::floor(x * inv_prec) + 1) / inv_prec;
     }
     return tentative;
-}
\ No newline at end of file
+}
+
+// Advance a cached node value in place and return the value fed to LuaRandom.
+// This is the per-draw update performed by Instance::get_node.
+INLINE_FORCE double pseudoseed_advance(double& node, double hashedSeed) {
+    double temp = node * 1.72431234 + 2.134453429141;
+    node = round13(temp - std::floor(temp));
+    return (node + hashedSeed) / 2;
+}
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "env.hpp"
+#include "instance.hpp"
+#include "shop_stream.hpp"
+
+// Deterministic multi-ante run engine on top of Instance. Each ante draws its
+// boss, voucher and the two blind tags, then plays the small, big and boss
+// blinds in order: a skipped blind grants its tag (pack tags open their pack
+// right away), a cleared blind leads to a shop with the ante's shop items,
+// rerolls and booster packs. A policy decides what is skipped, bought, opened
+// and taken, and may stop the run at any hook; everything else follows the
+// generator streams, so one seed, env and policy always give the same run.
+//
+// Not modelled: money, hands and scoring, selling, voucher effects on shop
+// rates and prices (only Overstock's shop slots are applied), and tags other
+// than the pack tags. A bought voucher does unlock its upgrade for later
+// antes. Consumables that create jokers (The Soul, Judgement, Wraith) are
+// used as soon as they are taken.
+namespace RunEngine {
+
+    enum class Blind : uint8_t { SMALL = 0, BIG = 1, BOSS = 2 };
+
+    // Where an owned joker came from
+    enum class Source : uint8_t { SHOP, PACK, SOUL, JUDGEMENT, WRAITH };
+
+    // Shop items and pack cards share one representation
+    using Card = Items::OptimizedShopItem;
+
+    constexpr int MAX_PACK_SIZE = 5;
+
+    struct Ante {
+        int ante;
+        Items::Boss boss;
+        Items::Voucher voucher;
+        Items::Tag tags[2];  // Small and big blind
+    };
+
+    struct Pack {
+        Items::Pack offer = Items::Pack::INVALID;  // As generated, e.g. MEGA_ARCANA_PACK
+        Items::Pack type = Items::Pack::INVALID;   // Base type, e.g. ARCANA_PACK
+        int size = 0;
+        int choices = 0;
+        bool fromTag = false;
+        Card cards[MAX_PACK_SIZE];                 // Every pack type but Standard
+        std::vector<Items::CardEnum> playingCards; // Standard packs
+    };
+
+    struct Config {
+        int antes = 8;
+        // Shop items per visit and per reroll before Overstock. 0 skips the shop
+        // queue: its draws are its own, so a policy that never buys from it
+        // loses nothing.
+        int shopSlots = ShopStream::BASE_SLOTS;
+        int packsPerShop = 2;
+        int maxRerolls = 50;   // Per shop; bounds a policy that always rerolls
+    };
+
+    // What the policy sees of the run, and its way to end it early
+    struct State {
+        int ante = 0;
+        Blind blind = Blind::SMALL;
+        std::vector<Items::OptimizedJokerData> jokers;  // Owned, in the order gained
+        std::vector<Items::Voucher> vouchers;            // Bought, in order
+        uint64_t shopItems = 0;                          // Shop items generated
+        uint64_t packsOpened = 0;
+        bool stopped = false;
+
+        void stop() { stopped = true; }
+    };
+
+    // Default policy: clear every blind, buy each ante's voucher, open every
+    // shop pack, and buy or take nothing. Policies derive from it and hide the
+    // hooks they change; Engine calls them statically, so the defaults cost
+    // nothing. Any hook may call State::stop().
+    struct Policy {
+        void ante(State&, const Ante&) {}
+        bool skip(State&, Blind, Items::Tag) { return false; }
+        bool buyVoucher(State&, Items::Voucher) { return true; }
+        bool buy(State&, const Card&) { return false; }
+        bool reroll(State&) { return false; }
+        bool open(State&, Items::Pack) { return true; }
+        // Bitmask of the cards to take; set bits past the pack's choices are ignored
+        uint32_t pick(State&, const Pack&) { return 0; }
+        void gained(State&, const Items::OptimizedJokerData&, Source) {}
+    };
+
+    // Pack a skipped blind's tag opens, or INVALID for the other tags
+    inline Items::Pack tagPack(Items::Tag tag) {
+        switch (tag) {
+            case Items::Tag::CHARM_TAG: return Items::Pack::MEGA_ARCANA_PACK;
+            case Items::Tag::METEOR_TAG: return Items::Pack::MEGA_CELESTIAL_PACK;
+            case Items::Tag::BUFFOON_TAG: return Items::Pack::MEGA_BUFFOON_PACK;
+            case Items::Tag::ETHEREAL_TAG: return Items::Pack::SPECTRAL_PACK;
+            case Items::Tag::STANDARD_TAG: return Items::Pack::MEGA_STANDARD_PACK;
+            default: return Items::Pack::INVALID;
+        }
+    }
+
+    // One engine per thread; it keeps its buffers between runs
+    template<typename P>
+    class Engine {
+    public:
+        explicit Engine(P& p, const Config& c = Config()) : policy(p), config(c) {}
+
+        // Simulates `seed` until the last ante or until the policy stops.
+        // Returns the number of antes started.
+        int run(const std::string& seed, const EnvConfig& e) {
+            Instance::Instance instance(seed);
+            if (!e.deck.empty()) instance.setDeck(e.deck);
+            if (!e.stake.empty()) instance.setStake(e.stake);
+            instance.setShowman(e.showman);
+            instance.setSixesFactor(e.sixesFactor);
+            instance.setVersion(e.version);
+            instance.setForceAllContent(e.forceAllContent);
+            instance.initLocks(1, e.freshProfile, e.freshRun);
+            inst = &instance;
+
+            s.ante = 0;
+            s.blind = Blind::SMALL;
+            s.jokers.clear();
+            s.vouchers.clear();
+            s.shopItems = s.packsOpened = 0;
+            s.stopped = false;
+            slots = config.shopSlots;
+
+            for (int a = 1; a <= config.antes; a++) {
+                s.ante = a;
+                if (!playAnte(a, e.freshProfile)) return a;
+            }
+            return config.antes;
+        }
+
+        const State& state() const { return s; }
+
+    private:
+        P& policy;
+        Config config;
+        State s;
+        Pack pack;
+        Instance::Instance* inst = nullptr;
+        int slots = 0;   // Current shop slots
+
+        bool playAnte(int a, bool freshProfile) {
+            inst->initUnlocks(a, freshProfile);
+            Ante info;
+            info.ante = a;
+            info.boss = inst->nextBoss_enum(a);
+            info.voucher = inst->nextVoucher_enum(a);
+            info.tags[0] = inst->nextTag_enum(a);
+            info.tags[1] = inst->nextTag_enum(a);
+            s.blind = Blind::SMALL;
+            policy.ante(s, info);
+            if (s.stopped) return false;
+
+            bool voucherBought = false;
+            for (int b = 0; b < 3; b++) {
+                s.blind = static_cast<Blind>(b);
+                if (b < 2 && policy.skip(s, s.blind, info.tags[b])) {
+                    if (s.stopped) return false;
+                    const Items::Pack offer = tagPack(info.tags[b]);
+                    if (offer != Items::Pack::INVALID && !openPack(offer, true)) return false;
+                    continue;
+                }
+                if (s.stopped || !shop(info, voucherBought)) return false;
+            }
+            return true;
+        }
+
+        bool shop(const Ante& info, bool& voucherBought) {
+            // The voucher stays on offer in every shop of the ante until bought
+            if (!voucherBought && policy.buyVoucher(s, info.voucher)) {
+                inst->activateVoucher_enum(info.voucher);
+                s.vouchers.push_back(info.voucher);
+                voucherBought = true;
+                if (slots > 0) slots += ShopStream::slotsAdded(info.voucher);
+            }
+            if (s.stopped) return false;
+
+            for (int roll = 0; slots > 0; roll++) {
+                for (int i = 0; i < slots; i++) {
+                    const Card item = inst->nextShopItem_enum(info.ante);
+                    s.shopItems++;
+                    if (policy.buy(s, item) && !s.stopped) take(item, Source::SHOP);
+                    if (s.stopped) return false;
+                }
+                if (roll >= config.maxRerolls) break;
+                const bool again = policy.reroll(s);
+                if (s.stopped) return false;
+                if (!again) break;
+            }
+
+            // Packs the policy passes on are never generated, as in the game
+            for (int p = 0; p < config.packsPerShop; p++) {
+                const Items::Pack offer = inst->nextPack_enum(info.ante);
+                const bool wanted = policy.open(s, offer);
+                if (s.stopped || (wanted && !openPack(offer, false))) return false;
+            }
+            return true;
+        }
+
+        bool openPack(Items::Pack offer, bool fromTag) {
+            const Items::NextPackData data = Items::convertPackData(offer);
+            const int a = s.ante;
+            pack.offer = offer;
+            pack.type = data.type;
+            pack.size = data.size;
+            pack.choices = data.choices;
+            pack.fromTag = fromTag;
+            switch (data.type) {
+                case Items::Pack::ARCANA_PACK: {
+                    const Items::MixedArcanaPack arcana = inst->nextArcanaPack_enum(data.size, a);
+                    for (int i = 0; i < data.size; i++) {
+                        pack.cards[i] = arcana.isSpectral[i] ? Card(arcana.spectrals[i]) : Card(arcana.tarots[i]);
+                    }
+                    break;
+                }
+                case Items::Pack::CELESTIAL_PACK: {
+                    const std::vector<Items::Planet> planets = inst->nextCelestialPack_enum(data.size, a);
+                    for (int i = 0; i < data.size; i++) pack.cards[i] = Card(planets[i]);
+                    break;
+                }
+                case Items::Pack::SPECTRAL_PACK: {
+                    const std::vector<Items::Spectral> spectrals = inst->nextSpectralPack_enum(data.size, a);
+                    for (int i = 0; i < data.size; i++) pack.cards[i] = Card(spectrals[i]);
+                    break;
+                }
+                case Items::Pack::BUFFOON_PACK: {
+                    const std::vector<Items::OptimizedJokerData> jokers = inst->nextBuffoonPack_enum(data.size, a);
+                    for (int i = 0; i < data.size; i++) pack.cards[i] = Card(jokers[i].joker, jokers[i]);
+                    break;
+                }
+                default:
+                    pack.playingCards = inst->nextStandardPack_enum(data.size, a);
+                    break;
+            }
+            s.packsOpened++;
+
+            const uint32_t mask = policy.pick(s, pack);
+            if (s.stopped) return false;
+            if (pack.type == Items::Pack::STANDARD_PACK) return true;  // Playing cards only join the deck
+            int taken = 0;
+            for (int i = 0; i < pack.size && taken < pack.choices; i++) {
+                if (!(mask & (1u << i))) continue;
+                taken++;
+                take(pack.cards[i], Source::PACK);
+                if (s.stopped) return false;
+            }
+            return true;
+        }
+
+        void take(const Card& card, Source source) {
+            switch (card.type) {
+                case Card::Type::JOKER:
+                    gain(card.joker_data, source);
+                    break;
+                case Card::Type::TAROT:
+                    if (card.item.tarot == Items::Tarot::SPECIAL_THE_SOUL) gain(inst->nextJoker_enum("sou", s.ante), Source::SOUL);
+                    else if (card.item.tarot == Items::Tarot::JUDGEMENT) gain(inst->nextJoker_enum("jud", s.ante), Source::JUDGEMENT);
+                    break;
+                case Card::Type::SPECTRAL:
+                    if (card.item.spectral == Items::Spectral::SPECTRAL_THE_SOUL) gain(inst->nextJoker_enum("sou", s.ante), Source::SOUL);
+                    else if (card.item.spectral == Items::Spectral::WRAITH) gain(inst->nextJoker_enum("wra", s.ante), Source::WRAITH);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void gain(const Items::OptimizedJokerData& joker, Source source) {
+            s.jokers.push_back(joker);
+            inst->lockJoker_enum(joker.joker);
+            policy.gained(s, joker, source);
+        }
+    };
+
+} // namespace RunEngine
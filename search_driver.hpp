@@ -0,0 +1,58 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "filters/filter_base.hpp"
+
+// Static front end for the search loop. Filter files name their concrete
+// class with `#define SELECTED_FILTER_TYPE ClassName` next to createFilter();
+// when that class is declared `final`, apply() and applyBatch() resolve at
+// compile time and inline into the worker loop. SearchDriver<SearchFilter>
+// keeps the virtual path for filters that only exist behind the base class
+// (CustomFilter, dynamically chosen filters).
+template<typename Filter>
+class SearchDriver {
+public:
+    explicit SearchDriver(Filter& f) : filter(f), names(f.getResultNames()) {}
+
+    INLINE_FORCE int apply(const std::string& seed, std::ostream& debugOut) {
+        return filter.apply(seed, debugOut);
+    }
+
+    // Levels for a block of seeds; filters that do not override applyBatch()
+    // get the base class loop over apply()
+    INLINE_FORCE void applyBatch(Span<const std::string> seeds, Span<uint16_t> levels) {
+        filter.applyBatch(seeds, levels);
+    }
+
+    // Score and level for --top-k
+    INLINE_FORCE FilterScore score(const std::string& seed) {
+        return filter.score(seed);
+    }
+
+    // Name of a match level, cached at construction; empty when out of range
+    const std::string& resultName(int level) const {
+        static const std::string none;
+        return (level > 0 && level <= static_cast<int>(names.size())) ? names[level - 1] : none;
+    }
+
+    const std::vector<std::string>& resultNames() const { return names; }
+    Filter& get() const { return filter; }
+
+private:
+    Filter& filter;
+    std::vector<std::string> names;
+};
+
+#ifdef SELECTED_FILTER_TYPE
+using SelectedFilterType = SELECTED_FILTER_TYPE;
+#else
+using SelectedFilterType = SearchFilter;
+#endif
+
+// Driver for the filter returned by createFilter(); throws std::bad_cast if a
+// filter file's SELECTED_FILTER_TYPE does not match what it creates
+inline SearchDriver<SelectedFilterType> makeSelectedDriver(SearchFilter& filter) {
+    return SearchDriver<SelectedFilterType>(dynamic_cast<SelectedFilterType&>(filter));
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <dirent.h>
+
+#include "atomic_file.hpp"
+
+// On-disk seed index written by tools/seed_indexer.cpp. The seed space is
+// swept once and every seed that hits one of the indexed events is stored,
+// so a query becomes a lookup instead of a full scan.
+//
+// One shard file covers the seed numbers [rangeStart, rangeEnd) and holds one
+// ascending list per event. All integers are little-endian:
+//   "BSIX" magic, u32 format version
+//   u64 envConfigHash, i64 game version, u64 rangeStart, u64 rangeEnd
+//   u32 event count, then per event: u16 name length, name, u64 seed count,
+//   u64 payload bytes
+//   payloads in the same order: LEB128 varint gaps between consecutive seed
+//   numbers, the first one relative to rangeStart
+namespace SeedIndex {
+
+    constexpr uint32_t FORMAT_VERSION = 1;
+    constexpr const char* SHARD_SUFFIX = ".bsix";
+
+    struct ShardHeader {
+        uint64_t envHash = 0;
+        int64_t gameVersion = 0;
+        uint64_t rangeStart = 0;
+        uint64_t rangeEnd = 0;
+    };
+
+    struct EventList {
+        std::string name;
+        std::vector<uint64_t> seeds;  // Seed numbers, ascending
+    };
+
+    inline void putVarint(std::string& out, uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    inline bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            const unsigned char b = *p++;
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    inline std::string encodeGaps(const std::vector<uint64_t>& seeds, uint64_t base) {
+        std::string out;
+        out.reserve(seeds.size() * 3);
+        uint64_t prev = base;
+        for (uint64_t s : seeds) {
+            putVarint(out, s - prev);
+            prev = s;
+        }
+        return out;
+    }
+
+    inline bool decodeGaps(const std::string& bytes, uint64_t base, uint64_t count, std::vector<uint64_t>& out) {
+        out.clear();
+        out.reserve(static_cast<size_t>(count));
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes.data());
+        const unsigned char* end = p + bytes.size();
+        uint64_t prev = base;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t gap;
+            if (!getVarint(p, end, gap)) return false;
+            prev += gap;
+            out.push_back(prev);
+        }
+        return p == end;
+    }
+
+    namespace detail {
+        inline void put(std::string& out, uint64_t v, int bytes) {
+            for (int i = 0; i < bytes; i++) out.push_back(static_cast<char>(v >> (i * 8)));
+        }
+
+        inline bool get(std::istream& in, uint64_t& v, int bytes) {
+            unsigned char buf[8];
+            if (!in.read(reinterpret_cast<char*>(buf), bytes)) return false;
+            v = 0;
+            for (int i = 0; i < bytes; i++) v |= static_cast<uint64_t>(buf[i]) << (i * 8);
+            return true;
+        }
+    }
+
+    // Shard names sort by range start
+    inline std::string shardFileName(uint64_t rangeStart, uint64_t rangeEnd) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "shard_%013llu_%013llu%s",
+                      static_cast<unsigned long long>(rangeStart), static_cast<unsigned long long>(rangeEnd), SHARD_SUFFIX);
+        return buf;
+    }
+
+    // Writes `path`.tmp and renames it, so an interrupted build never leaves a
+    // partial shard behind
+    inline bool writeShard(const std::string& path, const ShardHeader& h, const std::vector<EventList>& events, std::string& error) {
+        std::vector<std::string> payloads;
+        payloads.reserve(events.size());
+        for (const auto& ev : events) payloads.push_back(encodeGaps(ev.seeds, h.rangeStart));
+
+        std::string out("BSIX", 4);
+        detail::put(out, FORMAT_VERSION, 4);
+        detail::put(out, h.envHash, 8);
+        detail::put(out, static_cast<uint64_t>(h.gameVersion), 8);
+        detail::put(out, h.rangeStart, 8);
+        detail::put(out, h.rangeEnd, 8);
+        detail::put(out, events.size(), 4);
+        for (size_t i = 0; i < events.size(); i++) {
+            detail::put(out, events[i].name.size(), 2);
+            out += events[i].name;
+            detail::put(out, events[i].seeds.size(), 8);
+            detail::put(out, payloads[i].size(), 8);
+        }
+        for (const auto& p : payloads) out += p;
+
+        return AtomicFile::write(path, out, error);
+    }
+
+    class ShardReader {
+    public:
+        // Reads the header and event table; payloads are read on demand
+        bool open(const std::string& path, std::string& error) {
+            file.close();
+            file.clear();
+            entries.clear();
+            file.open(path, std::ios::binary);
+            if (!file) {
+                error = "could not open " + path;
+                return false;
+            }
+            char magic[4];
+            uint64_t version, gameVersion, eventCount;
+            if (!file.read(magic, 4) || std::string(magic, 4) != "BSIX" || !detail::get(file, version, 4)) {
+                error = path + " is not a seed index shard";
+                return false;
+            }
+            if (version != FORMAT_VERSION) {
+                error = path + " has unsupported format version " + std::to_string(version);
+                return false;
+            }
+            if (!detail::get(file, hdr.envHash, 8) || !detail::get(file, gameVersion, 8) ||
+                !detail::get(file, hdr.rangeStart, 8) || !detail::get(file, hdr.rangeEnd, 8) ||
+                !detail::get(file, eventCount, 4)) {
+                error = path + ": truncated header";
+                return false;
+            }
+            hdr.gameVersion = static_cast<int64_t>(gameVersion);
+            uint64_t offset = 0;
+            for (uint64_t i = 0; i < eventCount; i++) {
+                Entry e;
+                uint64_t nameLen;
+                if (!detail::get(file, nameLen, 2)) break;
+                e.name.resize(static_cast<size_t>(nameLen));
+                if (!file.read(&e.name[0], nameLen) || !detail::get(file, e.count, 8) || !detail::get(file, e.bytes, 8)) break;
+                e.offset = offset;
+                offset += e.bytes;
+                entries.push_back(e);
+            }
+            if (entries.size() != eventCount) {
+                error = path + ": truncated event table";
+                entries.clear();
+                return false;
+            }
+            payloadStart = file.tellg();
+            name = path;
+            return true;
+        }
+
+        const ShardHeader& header() const { return hdr; }
+
+        std::vector<std::string> eventNames() const {
+            std::vector<std::string> names;
+            for (const auto& e : entries) names.push_back(e.name);
+            return names;
+        }
+
+        bool hasEvent(const std::string& event) const { return find(event) != nullptr; }
+
+        uint64_t count(const std::string& event) const {
+            const Entry* e = find(event);
+            return e ? e->count : 0;
+        }
+
+        bool read(const std::string& event, std::vector<uint64_t>& out, std::string& error) {
+            const Entry* e = find(event);
+            if (!e) {
+                error = name + " has no event '" + event + "'";
+                return false;
+            }
+            std::string bytes(static_cast<size_t>(e->bytes), '\0');
+            file.clear();
+            file.seekg(payloadStart + static_cast<std::streamoff>(e->offset));
+            if (!file.read(&bytes[0], e->bytes) || !decodeGaps(bytes, hdr.rangeStart, e->count, out)) {
+                error = name + ": corrupt payload for '" + event + "'";
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        struct Entry {
+            std::string name;
+            uint64_t count = 0;
+            uint64_t bytes = 0;
+            uint64_t offset = 0;
+        };
+
+        const Entry* find(const std::string& event) const {
+            for (const auto& e : entries) {
+                if (e.name == event) return &e;
+            }
+            return nullptr;
+        }
+
+        std::ifstream file;
+        std::string name;
+        ShardHeader hdr;
+        std::vector<Entry> entries;
+        std::streampos payloadStart = 0;
+    };
+
+    inline std::vector<uint64_t> intersect(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+        std::vector<uint64_t> out;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+        return out;
+    }
+
+    // Shard files in `dir`, in range order
+    inline std::vector<std::string> listShards(const std::string& dir) {
+        std::vector<std::string> files;
+        DIR* d = opendir(dir.c_str());
+        if (!d) return files;
+        const std::string suffix = SHARD_SUFFIX;
+        while (dirent* ent = readdir(d)) {
+            std::string n = ent->d_name;
+            if (n.size() > suffix.size() && n.compare(0, 6, "shard_") == 0 &&
+                n.compare(n.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                files.push_back(dir + "/" + n);
+            }
+        }
+        closedir(d);
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+}
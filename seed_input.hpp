@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "seed_util.hpp"
+
+// Seed lists for refinement runs (--input): a second filter over seeds that
+// an earlier run already matched. A file is memory-mapped and "-" streams
+// from stdin. Worker threads take numbered batches from one Reader. The
+// batch number is the batch's position in the input, which --ordered uses
+// to write results back in input order.
+//
+// Formats:
+//   text    one seed per line; the first comma-separated field is used, so
+//           match CSVs (seed,level,name) and the top-K files work as they
+//           are. Quotes and surrounding blanks are ignored. Lines that are
+//           not an 8-character seed (headers, blanks) are skipped and counted.
+//   binary  little-endian uint64 seed numbers, 8 bytes each
+namespace SeedInput {
+
+    enum class Format { TEXT, BINARY };
+
+    // Seed number of an 8-character seed in [p, p + n); false if it is not one
+    inline bool parseSeed(const char* p, size_t n, uint64_t& out) {
+        while (n && (std::isspace(static_cast<unsigned char>(*p)) || *p == '"')) p++, n--;
+        while (n && (std::isspace(static_cast<unsigned char>(p[n - 1])) || p[n - 1] == '"')) n--;
+        if (n != 8) return false;
+        uint64_t v = 0;
+        for (size_t i = 0; i < n; i++) {
+            const char c = static_cast<char>(std::toupper(static_cast<unsigned char>(p[i])));
+            const char* at = std::strchr(SEED_CHARS, c);
+            if (!c || !at) return false;
+            v = v * SEED_BASE + static_cast<uint64_t>(at - SEED_CHARS);
+        }
+        out = v;
+        return true;
+    }
+
+    struct Batch {
+        uint64_t sequence = 0;           // Position of the batch in the input
+        std::vector<uint64_t> numbers;
+    };
+
+    class Reader {
+    public:
+        Reader() = default;
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        // "-" reads stdin; anything else is mapped read-only
+        bool open(const std::string& path, Format f, std::string& error) {
+            format = f;
+            if (path == "-") {
+                stream = true;
+                return true;
+            }
+            // The file is read once, front to back
+            return file.open(path, error, true);
+        }
+
+        // Fills `batch` with up to `max` seeds; false once the input is exhausted
+        bool next(Batch& batch, size_t max) {
+            std::lock_guard<std::mutex> lk(mutex);
+            batch.numbers.clear();
+            batch.sequence = sequence;
+            if (format == Format::BINARY) readBinary(batch.numbers, max);
+            else readText(batch.numbers, max);
+            if (batch.numbers.empty()) return false;
+            sequence++;
+            delivered += batch.numbers.size();
+            return true;
+        }
+
+        // Seeds in a binary file; 0 when unknown (text or stdin)
+        uint64_t sizeHint() const { return !stream && format == Format::BINARY ? file.size() / 8 : 0; }
+        uint64_t seedsRead() const {
+            std::lock_guard<std::mutex> lk(mutex);
+            return delivered;
+        }
+        // Lines (or trailing bytes) that held no valid seed, headers excluded
+        uint64_t skipped() const {
+            std::lock_guard<std::mutex> lk(mutex);
+            return invalid;
+        }
+
+    private:
+        // Handles one text line; a first line that is not a seed is taken as a header
+        void takeLine(const char* p, size_t n, std::vector<uint64_t>& out) {
+            const char* comma = static_cast<const char*>(std::memchr(p, ',', n));
+            uint64_t v;
+            if (parseSeed(p, comma ? static_cast<size_t>(comma - p) : n, v)) out.push_back(v);
+            else if (lines > 0 && n > 0 && !(n == 1 && p[0] == '\r')) invalid++;
+            lines++;
+        }
+
+        void readText(std::vector<uint64_t>& out, size_t max) {
+            if (stream) {
+                std::string line;
+                while (out.size() < max && std::getline(std::cin, line)) takeLine(line.data(), line.size(), out);
+                return;
+            }
+            const char* text = reinterpret_cast<const char*>(file.data());
+            const uint64_t size = file.size();
+            while (out.size() < max && pos < size) {
+                const char* nl = static_cast<const char*>(std::memchr(text + pos, '\n', static_cast<size_t>(size - pos)));
+                const uint64_t end = nl ? static_cast<uint64_t>(nl - text) : size;
+                takeLine(text + pos, static_cast<size_t>(end - pos), out);
+                pos = end + 1;
+            }
+        }
+
+        void readBinary(std::vector<uint64_t>& out, size_t max) {
+            uint8_t buf[8];
+            while (out.size() < max) {
+                if (stream) {
+                    const size_t got = std::fread(buf, 1, 8, stdin);
+                    if (got != 8) {
+                        if (got) invalid++;
+                        return;
+                    }
+                    push(buf, out);
+                } else {
+                    const uint64_t size = file.size();
+                    if (size - pos < 8) {
+                        if (size > pos) invalid++;
+                        pos = size;
+                        return;
+                    }
+                    push(file.data() + pos, out);
+                    pos += 8;
+                }
+            }
+        }
+
+        void push(const uint8_t* p, std::vector<uint64_t>& out) {
+            uint64_t v = 0;
+            for (int i = 7; i >= 0; i--) v = v << 8 | p[i];
+            if (v < SEED_COUNT) out.push_back(v);
+            else invalid++;
+        }
+
+        Format format = Format::TEXT;
+        bool stream = false;
+        MappedFile file;
+        uint64_t pos = 0;
+        mutable std::mutex mutex;
+        uint64_t sequence = 0;
+        uint64_t delivered = 0;
+        uint64_t lines = 0;
+        uint64_t invalid = 0;
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Seed <-> seed number conversion shared by the search driver and the tools.
+// Seeds are 8 characters over a 34-symbol alphabet (no 'O', no '0').
+
+constexpr const char* SEED_CHARS = "ABCDEFGHIJKLMNPQRSTUVWXYZ123456789";
+constexpr uint64_t SEED_BASE = 34;
+constexpr uint64_t SEED_COUNT = 1785793904896ull; // SEED_BASE^8
+
+inline uint64_t seedToNumber(const std::string& seed) {
+    const std::string chars = SEED_CHARS;
+    uint64_t result = 0;
+    uint64_t base = chars.length();
+
+    for (char c : seed) {
+        size_t pos = chars.find(c);
+        if (pos == std::string::npos) return 0; // Invalid character
+        result = result * base + pos;
+    }
+    return result;
+}
+
+inline std::string numberToSeed(uint64_t number) {
+    const std::string chars = SEED_CHARS;
+    uint64_t base = chars.length();
+
+    if (number == 0) return "AAAAAAAA";
+
+    std::string result;
+    uint64_t temp = number;
+
+    // Convert to base-33 representation
+    while (temp > 0) {
+        result = chars[temp % base] + result;
+        temp /= base;
+    }
+
+    // Pad to 8 characters
+    while (result.length() < 8) {
+        result = chars[0] + result;
+    }
+
+    return result;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "env.hpp"
+#include "instance.hpp"
+
+// Shop lookahead over the per-ante shop queue. nextShopItem_enum(ante) is one
+// stream per ante: the first shop of the ante shows its first cards, every
+// reroll shows the next ones, and the next shop continues where the last one
+// stopped. A card is addressed as (ante, visit, reroll, index); where that
+// lands in the stream depends on the ante's slot count (2, plus one each for
+// Overstock and Overstock Plus) and on the rerolls spent in earlier visits.
+//
+// Cards are drawn only when a query reaches them, so a seed costs as many
+// draws as the furthest card inspected in each ante. No shop card is bought:
+// buying a joker would take it out of the later draws.
+namespace ShopStream {
+
+    using Item = Items::OptimizedShopItem;
+
+    constexpr int BASE_SLOTS = 2;
+    constexpr int MAX_ANTE = 8;
+
+    // Extra shop slots a voucher gives from the shop it is bought in
+    inline int slotsAdded(Items::Voucher v) {
+        return (v == Items::Voucher::OVERSTOCK || v == Items::Voucher::OVERSTOCK_PLUS) ? 1 : 0;
+    }
+
+    // Which of each ante's vouchers the modelled run buys. Bought vouchers
+    // unlock their upgrade for later antes, so this also shapes later offers.
+    enum class Vouchers : uint8_t { NONE, OVERSTOCK, ALL };
+
+    struct Options {
+        int visits = 3;                       // Shops per ante: one per blind not skipped
+        Vouchers vouchers = Vouchers::ALL;    // ALL matches --serve simulate
+    };
+
+    struct Slot {
+        int ante = 0;
+        int visit = 0;    // Shop of the ante, 0-based
+        int reroll = 0;   // Rerolls done in that visit before the card shows
+        int index = 0;    // Card within the shop
+    };
+
+    struct Hit {
+        Slot slot;
+        int rerolls = 0;  // Rerolls the ante needs to show the card
+        Item item;
+    };
+
+    class Lookahead {
+    public:
+        Lookahead(const std::string& seed, const EnvConfig& e, const Options& o = Options())
+            : inst(seed), options(o) {
+            if (!e.deck.empty()) inst.setDeck(e.deck);
+            if (!e.stake.empty()) inst.setStake(e.stake);
+            inst.setShowman(e.showman);
+            inst.setSixesFactor(e.sixesFactor);
+            inst.setVersion(e.version);
+            inst.setForceAllContent(e.forceAllContent);
+            inst.initLocks(1, e.freshProfile, e.freshRun);
+        }
+
+        // Cards per shop in `ante`. Vouchers are drawn in ante order up to it.
+        int slots(int ante) {
+            while (vouchersDrawn < ante) {
+                const int a = ++vouchersDrawn;
+                const Items::Voucher v = inst.nextVoucher_enum(a);
+                offered[a] = v;
+                const bool buy = options.vouchers == Vouchers::ALL ||
+                                 (options.vouchers == Vouchers::OVERSTOCK && slotsAdded(v));
+                if (buy) inst.activateVoucher_enum(v);
+                anteSlots[a] = (a > 1 ? anteSlots[a - 1] : BASE_SLOTS) + (buy ? slotsAdded(v) : 0);
+            }
+            return anteSlots[ante];
+        }
+
+        // Voucher offered in `ante`
+        Items::Voucher voucher(int ante) {
+            slots(ante);
+            return offered[ante];
+        }
+
+        // Stream position of `slot`, given the rerolls spent in earlier visits of its ante
+        int position(const Slot& slot, int rerollsBefore = 0) {
+            return (slot.visit + rerollsBefore + slot.reroll) * slots(slot.ante) + slot.index;
+        }
+
+        // Card `n` (0-based) of `ante`'s stream, drawing up to it if needed
+        const Item& at(int ante, int n) {
+            std::vector<Item>& drawn = items[ante];
+            while (static_cast<int>(drawn.size()) <= n) drawn.push_back(inst.nextShopItem_enum(ante));
+            return drawn[n];
+        }
+
+        const Item& at(const Slot& slot, int rerollsBefore = 0) {
+            return at(slot.ante, position(slot, rerollsBefore));
+        }
+
+        // Cards drawn so far in `ante`
+        int drawn(int ante) const { return static_cast<int>(items[ante].size()); }
+
+        // Earliest card of antes [fromAnte, toAnte] matching `pred` that shows
+        // within `maxRerolls` rerolls of its ante. The slot it reports uses
+        // the free visits first and rerolls in the last one, so hit.rerolls
+        // is the fewest the ante needs. Each ante's stream is read only up to
+        // the match or the end of its budget.
+        template<typename Pred>
+        bool find(int fromAnte, int toAnte, int maxRerolls, Pred pred, Hit* hit = nullptr) {
+            for (int a = fromAnte; a <= toAnte && a <= MAX_ANTE; a++) {
+                const int perShop = slots(a);
+                const int reach = (options.visits + maxRerolls) * perShop;
+                for (int n = 0; n < reach; n++) {
+                    const Item& item = at(a, n);
+                    if (!pred(item)) continue;
+                    if (hit) {
+                        const int shop = n / perShop;
+                        hit->rerolls = shop < options.visits ? 0 : shop - (options.visits - 1);
+                        hit->slot.ante = a;
+                        hit->slot.visit = shop < options.visits ? shop : options.visits - 1;
+                        hit->slot.reroll = hit->rerolls;
+                        hit->slot.index = n % perShop;
+                        hit->item = item;
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // find() for one joker
+        bool findJoker(Items::Joker joker, int fromAnte, int toAnte, int maxRerolls, Hit* hit = nullptr) {
+            return find(fromAnte, toAnte, maxRerolls, [joker](const Item& item) {
+                return item.type == Item::Type::JOKER && item.item.joker == joker;
+            }, hit);
+        }
+
+    private:
+        Instance::Instance inst;
+        Options options;
+        int vouchersDrawn = 0;
+        Items::Voucher offered[MAX_ANTE + 1] = {};
+        int anteSlots[MAX_ANTE + 1] = {};
+        std::vector<Item> items[MAX_ANTE + 1];
+    };
+
+} // namespace ShopStream
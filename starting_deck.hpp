@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "rand_util.hpp"
+
+// Starting deck of a seed as packed rank/suit counts. Only Erratic Deck
+// depends on the seed: the game builds it from 52 draws of the "erratic"
+// stream, each picking one of Items::CARDS. Abandoned Deck drops the face
+// cards, Checkered Deck turns Clubs into Spades and Diamonds into Hearts,
+// and every other deck starts with the standard 52. Challenge decks are not
+// modelled.
+//
+// Generation allocates nothing: the "erratic" node is hashed from the seed
+// in place, so a filter can require deck properties for the cost of 52 draws.
+// Those draws are bound by the serial node updates (round13), so building
+// several decks with interleaved lanes is no faster than a loop over generate().
+namespace StartingDeck {
+
+    // Items::CARDS order
+    enum class Suit : uint8_t { CLUBS = 0, DIAMONDS = 1, HEARTS = 2, SPADES = 3 };
+
+    // Natural order, so rank ranges are index ranges
+    enum class Rank : uint8_t {
+        TWO = 0, THREE, FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, TEN,
+        JACK, QUEEN, KING, ACE
+    };
+
+    enum class Type : uint8_t { STANDARD, ERRATIC, ABANDONED, CHECKERED };
+
+    constexpr int SUITS = 4;
+    constexpr int RANKS = 13;
+    constexpr int CARDS = SUITS * RANKS;
+
+    // Rank of Items::CARDS[suit * 13 + i]; the game sorts card keys, so ranks read 2-9, A, J, K, Q, T
+    constexpr Rank CARD_RANK[RANKS] = {
+        Rank::TWO, Rank::THREE, Rank::FOUR, Rank::FIVE, Rank::SIX, Rank::SEVEN, Rank::EIGHT,
+        Rank::NINE, Rank::ACE, Rank::JACK, Rank::KING, Rank::QUEEN, Rank::TEN
+    };
+
+    inline Type typeOf(const std::string& deck) {
+        if (deck == "Erratic Deck") return Type::ERRATIC;
+        if (deck == "Abandoned Deck") return Type::ABANDONED;
+        if (deck == "Checkered Deck") return Type::CHECKERED;
+        return Type::STANDARD;
+    }
+
+    inline bool isFace(Rank r) {
+        return r == Rank::JACK || r == Rank::QUEEN || r == Rank::KING;
+    }
+
+    struct Deck {
+        uint8_t cards[CARDS];   // Copies of each card, suit * 13 + rank
+        uint8_t suits[SUITS];   // Suit histogram
+        uint8_t ranks[RANKS];   // Rank histogram
+        uint8_t size;
+
+        void clear() { std::memset(this, 0, sizeof(Deck)); }
+
+        void add(Suit s, Rank r) {
+            cards[static_cast<int>(s) * RANKS + static_cast<int>(r)]++;
+            suits[static_cast<int>(s)]++;
+            ranks[static_cast<int>(r)]++;
+            size++;
+        }
+
+        int count(Suit s, Rank r) const { return cards[static_cast<int>(s) * RANKS + static_cast<int>(r)]; }
+        int count(Suit s) const { return suits[static_cast<int>(s)]; }
+        int count(Rank r) const { return ranks[static_cast<int>(r)]; }
+
+        // Cards with a rank in [lo, hi]
+        int countRanks(Rank lo, Rank hi) const {
+            int n = 0;
+            for (int r = static_cast<int>(lo); r <= static_cast<int>(hi); r++) n += ranks[r];
+            return n;
+        }
+
+        // Jacks, Queens and Kings
+        int faces() const { return countRanks(Rank::JACK, Rank::KING); }
+
+        Suit topSuit() const {
+            int best = 0;
+            for (int s = 1; s < SUITS; s++) if (suits[s] > suits[best]) best = s;
+            return static_cast<Suit>(best);
+        }
+
+        Rank topRank() const {
+            int best = 0;
+            for (int r = 1; r < RANKS; r++) if (ranks[r] > ranks[best]) best = r;
+            return static_cast<Rank>(best);
+        }
+
+        // Distinct (suit, rank) pairs present
+        int distinct() const {
+            int n = 0;
+            for (int i = 0; i < CARDS; i++) n += cards[i] != 0;
+            return n;
+        }
+    };
+
+    // Deck for a seed-independent type
+    inline Deck fixedDeck(Type type) {
+        Deck d;
+        d.clear();
+        for (int s = 0; s < SUITS; s++) {
+            for (int r = 0; r < RANKS; r++) {
+                if (type == Type::ABANDONED && isFace(static_cast<Rank>(r))) continue;
+                int suit = s;
+                if (type == Type::CHECKERED) {
+                    if (s == static_cast<int>(Suit::CLUBS)) suit = static_cast<int>(Suit::SPADES);
+                    if (s == static_cast<int>(Suit::DIAMONDS)) suit = static_cast<int>(Suit::HEARTS);
+                }
+                d.add(static_cast<Suit>(suit), static_cast<Rank>(r));
+            }
+        }
+        return d;
+    }
+
+    // pseudohash("erratic" + seed) without building the string
+    inline double erraticNode(const std::string& seed) {
+        static constexpr char KEY[] = "erratic";
+        static constexpr size_t KEY_LEN = sizeof(KEY) - 1;
+        const size_t seedLen = seed.size();
+        const size_t len = KEY_LEN + seedLen;
+        double num = 1.0;
+        for (size_t i = 0; i < seedLen; i++) num = pseudohash_step(num, seed[seedLen-1-i], len-i);
+        for (size_t j = 0; j < KEY_LEN; j++) num = pseudohash_step(num, KEY[KEY_LEN-1-j], KEY_LEN-j);
+        return std::isnan(num) ? std::numeric_limits<double>::quiet_NaN() : num;
+    }
+
+    inline void addCard(Deck& d, int card) {
+        d.add(static_cast<Suit>(card / RANKS), CARD_RANK[card % RANKS]);
+    }
+
+    // Builds starting decks of one type. Cheap to copy; one per thread is fine.
+    class Generator {
+    public:
+        explicit Generator(Type t = Type::STANDARD) : type(t), fixed(fixedDeck(t)) {}
+        explicit Generator(const std::string& deck) : Generator(typeOf(deck)) {}
+
+        Type deckType() const { return type; }
+        bool seeded() const { return type == Type::ERRATIC; }
+
+        void generate(const std::string& seed, Deck& out) const {
+            if (!seeded()) {
+                out = fixed;
+                return;
+            }
+            double node = erraticNode(seed);
+            const double hashed = pseudohash(seed);
+            out.clear();
+            for (int i = 0; i < CARDS; i++) {
+                addCard(out, lua_randint_once(pseudoseed_advance(node, hashed), 0, CARDS - 1));
+            }
+        }
+
+        Deck generate(const std::string& seed) const {
+            Deck d;
+            generate(seed, d);
+            return d;
+        }
+
+    private:
+        Type type;
+        Deck fixed;
+    };
+
+} // namespace StartingDeck
@@ -0,0 +1,97 @@
+// Compares the one-seed-at-a-time loop with interleaved applyBatch() for the
+// selected filter: seeds/sec, IPC (when perf counters are available) and TSC
+// cycles per seed, and checks that every width returns the same levels.
+// Build from the repo root:
+//   g++ -std=c++14 -O3 -ffp-contract=off -I. -DSELECTED_FILTER="\"filters/enum_perkeo_filter.hpp\"" \
+//       -o dist/bench_interleave tools/bench_interleave.cpp env.cpp
+// Usage: dist/bench_interleave [seed_count]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "perf_counters.hpp"
+#include "seed_util.hpp"
+#include "filters/filter_base.hpp"
+
+#ifndef SELECTED_FILTER
+#error "Define SELECTED_FILTER to the filter header to benchmark"
+#endif
+#include SELECTED_FILTER
+
+using namespace std::chrono;
+
+struct RunStats {
+    double seconds = 0;
+    uint64_t tsc = 0;
+    bool hasIpc = false;
+    double ipc = 0;
+};
+
+template<typename Fn>
+static RunStats measure(Fn fn) {
+    PerfCounters counters;
+    RunStats r;
+    auto t0 = steady_clock::now();
+    uint64_t c0 = PerfCounters::readTsc();
+    counters.start();
+    fn();
+    counters.stop();
+    r.tsc = PerfCounters::readTsc() - c0;
+    r.seconds = duration<double>(steady_clock::now() - t0).count();
+    r.hasIpc = counters.available();
+    r.ipc = counters.ipc();
+    return r;
+}
+
+static void report(const std::string& label, const RunStats& r, size_t seeds, double baselineRate) {
+    double rate = seeds / r.seconds;
+    std::cout << std::left << std::setw(14) << label << std::right
+              << std::setw(12) << std::fixed << std::setprecision(0) << rate << " seeds/s"
+              << std::setw(8) << std::setprecision(2) << (baselineRate > 0 ? rate / baselineRate : 1.0) << "x"
+              << std::setw(10) << std::setprecision(0) << static_cast<double>(r.tsc) / seeds << " tsc/seed"
+              << "   IPC " << (r.hasIpc ? std::to_string(r.ipc).substr(0, 4) : std::string("n/a")) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::unique_ptr<SearchFilter> filter = createFilter();
+
+    std::vector<std::string> seeds;
+    seeds.reserve(count);
+    for (size_t i = 0; i < count; i++) seeds.push_back(numberToSeed(i * 7919ull * 104729ull % 1785793904896ull));
+
+    std::vector<uint16_t> expected(count), levels(count);
+
+    // Warm up caches and thread-local state
+    for (size_t i = 0; i < count && i < 2000; i++) filter->apply(seeds[i]);
+
+    std::cout << filter->getName() << ", " << count << " seeds" << std::endl;
+    RunStats scalar = measure([&]() {
+        for (size_t i = 0; i < count; i++) expected[i] = static_cast<uint16_t>(filter->apply(seeds[i]));
+    });
+    double baselineRate = count / scalar.seconds;
+    report("one-at-a-time", scalar, count, baselineRate);
+
+    int failures = 0;
+    for (size_t width : {2, 4, 6, 8}) {
+        RunStats r = measure([&]() {
+            for (size_t i = 0; i < count; i += width) {
+                size_t n = count - i < width ? count - i : width;
+                filter->applyBatch(Span<const std::string>(seeds.data() + i, n), Span<uint16_t>(levels.data() + i, n));
+            }
+        });
+        report("interleave " + std::to_string(width), r, count, baselineRate);
+        for (size_t i = 0; i < count; i++) {
+            if (levels[i] != expected[i]) {
+                std::cerr << "MISMATCH width " << width << " seed " << seeds[i] << ": " << levels[i]
+                          << " vs " << expected[i] << std::endl;
+                failures++;
+                break;
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,453 @@
+// Micro and macro benchmark suite: the RNG primitives (pseudohash, round13,
+// LuaRandom), Instance::get_node hits and misses, initLocks, every next*_enum
+// generator, and end-to-end seeds/sec for each hand-written filter.
+// Each benchmark is calibrated until one repetition takes --min-rep-ms,
+// warmed up for --warmup-ms, then timed for --reps repetitions; the report
+// gives median and p99 time per operation (operation = one call, or one seed
+// for the filter benchmarks) and TSC cycles per operation, plus core cycles
+// and IPC when perf counters are available.
+// Build from the repo root (or use tools/build-bench.sh):
+//   g++ -std=c++14 -O3 -ffp-contract=off -I. -o dist/bench_suite tools/bench_suite.cpp env.cpp
+// Usage: dist/bench_suite [--json FILE] [--baseline FILE] [--threshold PCT]
+//                         [--reps N] [--warmup-ms MS] [--min-rep-ms MS] [--only SUBSTR] [--list]
+// With --baseline, every benchmark whose median is more than --threshold
+// percent (default 10) slower than the baseline's is reported as a
+// regression and the exit status is 2. Baselines are files written by --json.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "perf_counters.hpp"
+#include "search_driver.hpp"
+#include "seed_util.hpp"
+#include "filters/filter_base.hpp"
+
+// The filter headers each define createFilter(); rename it per header so
+// every filter can be linked into this one binary
+#define createFilter createEnumPerkeoFilter
+#include "filters/enum_perkeo_filter.hpp"
+#undef createFilter
+using EnumPerkeoType = SELECTED_FILTER_TYPE;
+#undef SELECTED_FILTER_TYPE
+
+#define createFilter createAnyLegendaryFilter
+#include "filters/any_legendary_enum_filter.hpp"
+#undef createFilter
+using AnyLegendaryType = SELECTED_FILTER_TYPE;
+#undef SELECTED_FILTER_TYPE
+
+#define createFilter createSynergyEnumFilter
+#include "filters/synergy_enum_filter.hpp"
+#undef createFilter
+using SynergyEnumType = SELECTED_FILTER_TYPE;
+#undef SELECTED_FILTER_TYPE
+
+#define createFilter createSynergyConfigFilter
+#include "filters/synergy_config_filter.hpp"
+#undef createFilter
+
+#define createFilter createErraticFilter
+#include "filters/erratic_enum_filter.hpp"
+#undef createFilter
+
+using namespace std::chrono;
+
+// Results are folded into this so the timed loops cannot be optimized away
+static volatile double sink;
+
+struct Benchmark {
+    std::string name;
+    std::string unit;                   // "op" or "seed"
+    std::function<void(size_t)> setup;  // Untimed, runs before every repetition
+    std::function<void(size_t)> run;    // Performs `ops` operations
+};
+
+struct Sample {
+    double ns = 0;     // Per operation
+    double tsc = 0;    // Per operation
+    double cycles = 0; // Per operation, 0 when perf counters are unavailable
+    double ipc = 0;
+};
+
+struct Result {
+    std::string name;
+    std::string unit;
+    size_t ops = 0;
+    int reps = 0;
+    double medianNs = 0, p99Ns = 0, minNs = 0;
+    double medianTsc = 0;
+    double medianCycles = 0;
+    double ipc = 0;
+};
+
+struct Options {
+    std::string jsonPath;
+    std::string baselinePath;
+    std::string only;
+    double threshold = 10;
+    int reps = 21;
+    double warmupMs = 100;
+    double minRepMs = 5;
+    bool list = false;
+};
+
+static Sample timeOnce(const Benchmark& b, size_t ops, PerfCounters& counters) {
+    if (b.setup) b.setup(ops);
+    auto t0 = steady_clock::now();
+    uint64_t c0 = PerfCounters::readTsc();
+    counters.start();
+    b.run(ops);
+    counters.stop();
+    uint64_t c1 = PerfCounters::readTsc();
+    double seconds = duration<double>(steady_clock::now() - t0).count();
+    Sample s;
+    s.ns = seconds * 1e9 / ops;
+    s.tsc = static_cast<double>(c1 - c0) / ops;
+    if (counters.available()) {
+        s.cycles = static_cast<double>(counters.cycles()) / ops;
+        s.ipc = counters.ipc();
+    }
+    return s;
+}
+
+// Value at quantile q of a sorted sample (nearest rank)
+static double quantile(const std::vector<double>& sorted, double q) {
+    size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank ? rank - 1 : 0)];
+}
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+// `fixedOps` (from the baseline) skips calibration so both runs time the same work
+static Result measure(const Benchmark& b, const Options& opt, size_t fixedOps) {
+    PerfCounters counters;
+    // Calibrate: grow the operation count until one repetition is long enough
+    size_t ops = fixedOps ? fixedOps : 1;
+    while (!fixedOps) {
+        Sample s = timeOnce(b, ops, counters);
+        if (s.ns * ops >= opt.minRepMs * 1e6 || ops >= (size_t(1) << 26)) break;
+        double scale = s.ns * ops > 0 ? opt.minRepMs * 1e6 / (s.ns * ops) : 16;
+        ops = static_cast<size_t>(ops * std::min(16.0, std::max(2.0, scale * 1.2)));
+    }
+    // Warm up caches, branch predictors and clocks
+    auto warmEnd = steady_clock::now() + microseconds(static_cast<long long>(opt.warmupMs * 1000));
+    while (steady_clock::now() < warmEnd) timeOnce(b, ops, counters);
+
+    std::vector<double> ns, tsc, cycles, ipc;
+    for (int r = 0; r < opt.reps; r++) {
+        Sample s = timeOnce(b, ops, counters);
+        ns.push_back(s.ns);
+        tsc.push_back(s.tsc);
+        cycles.push_back(s.cycles);
+        ipc.push_back(s.ipc);
+    }
+    Result res;
+    res.name = b.name;
+    res.unit = b.unit;
+    res.ops = ops;
+    res.reps = opt.reps;
+    res.medianTsc = median(tsc);
+    res.medianCycles = median(cycles);
+    res.ipc = median(ipc);
+    std::sort(ns.begin(), ns.end());
+    res.medianNs = median(ns);
+    res.p99Ns = quantile(ns, 0.99);
+    res.minNs = ns.front();
+    return res;
+}
+
+// Seeds spread over the whole seed space, shared by the generator and filter benchmarks
+static const std::vector<std::string>& benchSeeds() {
+    static const std::vector<std::string> seeds = [] {
+        std::vector<std::string> v;
+        for (uint64_t i = 0; i < 4096; i++) v.push_back(numberToSeed(i * 7919ull * 104729ull % SEED_COUNT));
+        return v;
+    }();
+    return seeds;
+}
+
+// Repeated calls to one generator on an instance that is reset for every repetition
+static Benchmark generator(const std::string& name, std::function<double(Instance::Instance&)> call) {
+    auto inst = std::make_shared<std::unique_ptr<Instance::Instance>>();
+    Benchmark b;
+    b.name = name;
+    b.unit = "op";
+    b.setup = [inst](size_t) {
+        inst->reset(new Instance::Instance("ABCDEFGH"));
+        (*inst)->initLocks(1, false, false);
+    };
+    b.run = [inst, call](size_t ops) {
+        double sum = 0;
+        for (size_t i = 0; i < ops; i++) sum += call(**inst);
+        sink = sink + sum;
+    };
+    return b;
+}
+
+// End-to-end filter throughput, through SearchDriver like the search loop
+template<typename Filter>
+static Benchmark filterBench(const std::string& name, std::unique_ptr<SearchFilter> (*create)()) {
+    std::shared_ptr<SearchFilter> filter(create().release());
+    auto driver = std::make_shared<SearchDriver<Filter>>(static_cast<Filter&>(*filter));
+    Benchmark b;
+    b.name = "filter_" + name;
+    b.unit = "seed";
+    b.run = [filter, driver](size_t ops) {
+        static std::ostream nullOut(nullptr);
+        const auto& seeds = benchSeeds();
+        long sum = 0;
+        for (size_t i = 0; i < ops; i++) sum += driver->apply(seeds[i & 4095], nullOut);
+        sink = sink + sum;
+    };
+    return b;
+}
+
+static std::vector<Benchmark> allBenchmarks() {
+    std::vector<Benchmark> list;
+    auto keys = std::make_shared<std::vector<std::string>>();
+    auto values = std::make_shared<std::vector<double>>();
+    for (const auto& seed : benchSeeds()) {
+        keys->push_back("Joker1sho1" + seed);
+        values->push_back(pseudohash(seed));
+    }
+
+    list.push_back({"pseudohash", "op", nullptr, [keys](size_t ops) {
+        double sum = 0;
+        for (size_t i = 0; i < ops; i++) sum += pseudohash((*keys)[i & 4095]);
+        sink = sink + sum;
+    }});
+    list.push_back({"round13", "op", nullptr, [values](size_t ops) {
+        double sum = 0;
+        for (size_t i = 0; i < ops; i++) sum += round13((*values)[i & 4095] * 3.7);
+        sink = sink + sum;
+    }});
+    list.push_back({"pseudoseed_advance", "op", nullptr, [](size_t ops) {
+        double node = 0.123456789, sum = 0;
+        for (size_t i = 0; i < ops; i++) sum += pseudoseed_advance(node, 0.5);
+        sink = sink + sum;
+    }});
+    list.push_back({"LuaRandom_seed", "op", nullptr, [values](size_t ops) {
+        double sum = 0;
+        for (size_t i = 0; i < ops; i++) {
+            LuaRandom r((*values)[i & 4095]);
+            sum += r.random();
+        }
+        sink = sink + sum;
+    }});
+    list.push_back({"lua_random_once", "op", nullptr, [values](size_t ops) {
+        double sum = 0;
+        for (size_t i = 0; i < ops; i++) sum += lua_random_once((*values)[i & 4095]);
+        sink = sink + sum;
+    }});
+    list.push_back({"LuaRandom_next", "op", nullptr, [](size_t ops) {
+        LuaRandom r(0.5);
+        double sum = 0;
+        for (size_t i = 0; i < ops; i++) sum += r.random();
+        sink = sink + sum;
+    }});
+
+    // get_node: a hit updates a cached node, a miss hashes the key and inserts it
+    auto inst = std::make_shared<std::unique_ptr<Instance::Instance>>();
+    list.push_back({"get_node_hit", "op",
+                    [inst](size_t) { inst->reset(new Instance::Instance("ABCDEFGH")); },
+                    [inst, keys](size_t ops) {
+                        double sum = 0;
+                        for (size_t i = 0; i < ops; i++) sum += (*inst)->node((*keys)[i & 15]);
+                        sink = sink + sum;
+                    }});
+    auto missKeys = std::make_shared<std::vector<std::string>>();
+    list.push_back({"get_node_miss", "op",
+                    [inst, missKeys](size_t ops) {
+                        inst->reset(new Instance::Instance("ABCDEFGH"));
+                        while (missKeys->size() < ops) missKeys->push_back("bench_node" + std::to_string(missKeys->size()));
+                    },
+                    [inst, missKeys](size_t ops) {
+                        double sum = 0;
+                        for (size_t i = 0; i < ops; i++) sum += (*inst)->node((*missKeys)[i]);
+                        sink = sink + sum;
+                    }});
+
+    auto instances = std::make_shared<std::vector<Instance::Instance>>();
+    list.push_back({"initLocks", "op",
+                    [instances](size_t ops) {
+                        instances->clear();
+                        const auto& seeds = benchSeeds();
+                        for (size_t i = 0; i < ops; i++) instances->emplace_back(seeds[i & 4095]);
+                    },
+                    [instances](size_t ops) {
+                        for (size_t i = 0; i < ops; i++) (*instances)[i].initLocks(1, false, false);
+                        sink = sink + instances->size();
+                    }});
+
+    using I = Instance::Instance;
+    list.push_back(generator("nextTarot_enum", [](I& i) { return double(i.nextTarot_enum("ar1", 1, true)); }));
+    list.push_back(generator("nextPlanet_enum", [](I& i) { return double(i.nextPlanet_enum("pl1", 1, true)); }));
+    list.push_back(generator("nextSpectral_enum", [](I& i) { return double(i.nextSpectral_enum("spe", 1, true)); }));
+    list.push_back(generator("nextJoker_enum", [](I& i) { return double(i.nextJoker_enum("sho", 1, true).joker); }));
+    list.push_back(generator("nextTag_enum", [](I& i) { return double(i.nextTag_enum(1)); }));
+    list.push_back(generator("nextVoucher_enum", [](I& i) { return double(i.nextVoucher_enum(1)); }));
+    list.push_back(generator("nextBoss_enum", [](I& i) { return double(i.nextBoss_enum(1)); }));
+    list.push_back(generator("nextShopItem_enum", [](I& i) { return double(i.nextShopItem_enum(1).type); }));
+    list.push_back(generator("nextPack_enum", [](I& i) { return double(i.nextPack_enum(1)); }));
+    list.push_back(generator("nextStandardCard_enum", [](I& i) { return double(i.nextStandardCard_enum(1).base.size()); }));
+    list.push_back(generator("nextArcanaPack_enum", [](I& i) { return double(i.nextArcanaPack_enum(5, 1).isSpectral.size()); }));
+    list.push_back(generator("nextCelestialPack_enum", [](I& i) { return double(i.nextCelestialPack_enum(5, 1).size()); }));
+    list.push_back(generator("nextSpectralPack_enum", [](I& i) { return double(i.nextSpectralPack_enum(2, 1).size()); }));
+    list.push_back(generator("nextBuffoonPack_enum", [](I& i) { return double(i.nextBuffoonPack_enum(2, 1).size()); }));
+    list.push_back(generator("nextStandardPack_enum", [](I& i) { return double(i.nextStandardPack_enum(3, 1).size()); }));
+
+    list.push_back(filterBench<EnumPerkeoType>("enum_perkeo", createEnumPerkeoFilter));
+    list.push_back(filterBench<AnyLegendaryType>("any_legendary_enum", createAnyLegendaryFilter));
+    list.push_back(filterBench<SynergyEnumType>("synergy_enum", createSynergyEnumFilter));
+    list.push_back(filterBench<SearchFilter>("synergy_config", createSynergyConfigFilter));
+    list.push_back(filterBench<SearchFilter>("erratic_enum", createErraticFilter));
+    return list;
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// One result per line, so loadBaseline() can read the file back without a JSON library
+static bool writeJson(const std::string& path, const std::vector<Result>& results, const Options& opt) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << std::setprecision(6);
+    out << "{\n  \"format\": \"balatro-bench 1\",\n"
+        << "  \"reps\": " << opt.reps << ",\n"
+        << "  \"perf_counters\": " << (PerfCounters().available() ? "true" : "false") << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"unit\": \"" << r.unit << "\", \"ops_per_rep\": " << r.ops
+            << ", \"median_ns\": " << r.medianNs << ", \"p99_ns\": " << r.p99Ns << ", \"min_ns\": " << r.minNs
+            << ", \"tsc_per_op\": " << r.medianTsc << ", \"cycles_per_op\": " << r.medianCycles << ", \"ipc\": " << r.ipc
+            << ", \"per_sec\": " << (r.medianNs > 0 ? 1e9 / r.medianNs : 0) << "}" << (i + 1 < results.size() ? "," : "")
+            << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+struct BaselineEntry {
+    double medianNs = 0;
+    size_t ops = 0;
+};
+
+// Benchmark name -> median and operation count from a file written by writeJson()
+static bool loadBaseline(const std::string& path, std::map<std::string, BaselineEntry>& entries) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        auto n = line.find("\"name\": \"");
+        auto m = line.find("\"median_ns\": ");
+        if (n == std::string::npos || m == std::string::npos) continue;
+        n += 9;
+        auto end = line.find('"', n);
+        if (end == std::string::npos) continue;
+        BaselineEntry& e = entries[line.substr(n, end - n)];
+        e.medianNs = std::strtod(line.c_str() + m + 13, nullptr);
+        auto o = line.find("\"ops_per_rep\": ");
+        if (o != std::string::npos) e.ops = std::strtoull(line.c_str() + o + 15, nullptr, 10);
+    }
+    return true;
+}
+
+static bool parseArgs(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json" && hasValue) opt.jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) opt.baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) opt.threshold = std::atof(argv[++i]);
+        else if (arg == "--reps" && hasValue) opt.reps = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--warmup-ms" && hasValue) opt.warmupMs = std::atof(argv[++i]);
+        else if (arg == "--min-rep-ms" && hasValue) opt.minRepMs = std::max(0.01, std::atof(argv[++i]));
+        else if (arg == "--only" && hasValue) opt.only = argv[++i];
+        else if (arg == "--list") opt.list = true;
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 1;
+    std::map<std::string, BaselineEntry> baseline;
+    if (!opt.baselinePath.empty() && !loadBaseline(opt.baselinePath, baseline)) {
+        std::cerr << "Could not read baseline " << opt.baselinePath << std::endl;
+        return 1;
+    }
+
+    std::vector<Benchmark> benchmarks = allBenchmarks();
+    if (opt.list) {
+        for (const auto& b : benchmarks) std::cout << b.name << std::endl;
+        return 0;
+    }
+
+    std::cout << std::left << std::setw(26) << "benchmark" << std::right << std::setw(10) << "ops/rep" << std::setw(12)
+              << "median ns" << std::setw(12) << "p99 ns" << std::setw(10) << "tsc/op" << std::setw(10) << "cyc/op"
+              << std::setw(14) << "per sec";
+    if (!baseline.empty()) std::cout << std::setw(12) << "vs base";
+    std::cout << std::endl;
+
+    std::vector<Result> results;
+    int regressions = 0;
+    for (const auto& b : benchmarks) {
+        if (!opt.only.empty() && b.name.find(opt.only) == std::string::npos) continue;
+        auto base = baseline.find(b.name);
+        Result r = measure(b, opt, base != baseline.end() ? base->second.ops : 0);
+        results.push_back(r);
+        std::cout << std::left << std::setw(26) << r.name << std::right << std::fixed << std::setw(10) << r.ops
+                  << std::setprecision(1) << std::setw(12) << r.medianNs << std::setw(12) << r.p99Ns << std::setw(10)
+                  << r.medianTsc << std::setw(10);
+        if (r.medianCycles > 0) std::cout << r.medianCycles;
+        else std::cout << "n/a";
+        std::cout << std::setprecision(0) << std::setw(14) << 1e9 / r.medianNs << (r.unit == "seed" ? " seeds" : "");
+        if (base != baseline.end() && base->second.medianNs > 0) {
+            double delta = (r.medianNs / base->second.medianNs - 1) * 100;
+            bool regressed = delta > opt.threshold;
+            regressions += regressed;
+            std::cout << std::setprecision(1) << std::setw(10) << std::showpos << delta << "%" << std::noshowpos
+                      << (regressed ? "  REGRESSION" : "");
+        } else if (!baseline.empty()) {
+            std::cout << std::setw(12) << "new";
+        }
+        std::cout << std::endl;
+    }
+
+    if (!opt.jsonPath.empty()) {
+        if (!writeJson(opt.jsonPath, results, opt)) {
+            std::cerr << "Could not write " << opt.jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << opt.jsonPath << std::endl;
+    }
+    if (!baseline.empty()) {
+        std::cout << regressions << " regression(s) over " << opt.threshold << "% against " << opt.baselinePath << std::endl;
+    }
+    return regressions ? 2 : 0;
+}
@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# Build the benchmark suite (tools/bench_suite.cpp) and run it against a
+# stored baseline. The first run on a machine (or any run with --update)
+# records the baseline; later runs fail when a benchmark's median is more
+# than THRESHOLD percent slower than the baseline's.
+# Usage: tools/build-bench.sh [--update] [threshold_pct]
+# BENCH_BASELINE overrides the baseline path (default dist/bench_baseline.json).
+
+UPDATE=0
+if [ "$1" = "--update" ]; then
+    UPDATE=1
+    shift
+fi
+THRESHOLD=${1:-10}
+BASELINE=${BENCH_BASELINE:-dist/bench_baseline.json}
+
+# GCC only accepts -fexcess-precision=standard for C++ from version 13
+EXCESS_PRECISION=""
+if echo "int main(){}" | g++ -x c++ -fexcess-precision=standard -fsyntax-only - 2>/dev/null; then
+    EXCESS_PRECISION="-fexcess-precision=standard"
+fi
+
+mkdir -p dist
+g++ -std=c++14 -O3 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/bench_suite tools/bench_suite.cpp env.cpp || { echo "Build failed!"; exit 1; }
+
+if [ $UPDATE -eq 1 ] || [ ! -f "$BASELINE" ]; then
+    ./dist/bench_suite --json "$BASELINE" || exit 1
+    echo "Baseline recorded in $BASELINE"
+    exit 0
+fi
+
+./dist/bench_suite --baseline "$BASELINE" --threshold "$THRESHOLD" --json dist/bench_latest.json
+STATUS=$?
+if [ $STATUS -eq 2 ]; then
+    echo "Benchmark regression against $BASELINE (threshold ${THRESHOLD}%)."
+fi
+exit $STATUS
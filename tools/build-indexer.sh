@@ -0,0 +1,41 @@
+#!/bin/bash
+
+# Build the seed and feature index tools (tools/seed_indexer.cpp,
+# tools/feature_indexer.cpp), the co-occurrence counter
+# (tools/cooccurrence.cpp) and run their tests.
+
+# GCC only accepts -fexcess-precision=standard for C++ from version 13
+EXCESS_PRECISION=""
+if echo "int main(){}" | g++ -x c++ -fexcess-precision=standard -fsyntax-only - 2>/dev/null; then
+    EXCESS_PRECISION="-fexcess-precision=standard"
+fi
+
+mkdir -p dist
+g++ -std=c++14 -O3 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/seed_indexer tools/seed_indexer.cpp env.cpp -lpthread || { echo "Build failed!"; exit 1; }
+g++ -std=c++14 -O3 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/feature_indexer tools/feature_indexer.cpp env.cpp -lpthread || { echo "Build failed!"; exit 1; }
+g++ -std=c++14 -O3 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/cooccurrence tools/cooccurrence.cpp env.cpp -lpthread || { echo "Build failed!"; exit 1; }
+
+g++ -std=c++14 -O2 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/seed_index_test tools/seed_index_test.cpp env.cpp || { echo "Build failed!"; exit 1; }
+g++ -std=c++14 -O2 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/feature_index_test tools/feature_index_test.cpp env.cpp -lpthread || { echo "Build failed!"; exit 1; }
+g++ -std=c++14 -O2 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/cooccurrence_test tools/cooccurrence_test.cpp env.cpp -lpthread || { echo "Build failed!"; exit 1; }
+
+if ! ./dist/seed_index_test "${1:-50000}"; then
+    echo "Seed index tests failed."
+    exit 1
+fi
+if ! ./dist/feature_index_test "${1:-50000}"; then
+    echo "Feature index tests failed."
+    exit 1
+fi
+if ! ./dist/cooccurrence_test "${1:-50000}"; then
+    echo "Co-occurrence tests failed."
+    exit 1
+fi
+
+echo "Build successful! Executables: dist/seed_indexer, dist/feature_indexer, dist/cooccurrence"
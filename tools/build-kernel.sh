@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# Generate a straight-line kernel filter from filters/kernels/<name>.json,
+# build immolate with it and run the kernel equivalence harness.
+
+if [ $# -eq 0 ]; then
+    echo "Usage: $0 <kernel_name> [equivalence_seed_count]"
+    echo "Available kernel specs:"
+    for spec in filters/kernels/*.json; do
+        if [ -f "$spec" ]; then
+            echo "  $(basename "$spec" .json)"
+        fi
+    done
+    exit 1
+fi
+
+KERNEL_NAME=$1
+SEED_COUNT=${2:-200000}
+SPEC_FILE="filters/kernels/${KERNEL_NAME}.json"
+OUT_FILE="filters/generated/${KERNEL_NAME}_kernel_filter.hpp"
+
+if [ ! -f "$SPEC_FILE" ]; then
+    echo "Error: Kernel spec $SPEC_FILE not found!"
+    exit 1
+fi
+
+python3 tools/gen_kernel.py "$SPEC_FILE" -o "$OUT_FILE" || { echo "Kernel generation failed!"; exit 1; }
+
+# GCC only accepts -fexcess-precision=standard for C++ from version 13
+EXCESS_PRECISION=""
+if echo "int main(){}" | g++ -x c++ -fexcess-precision=standard -fsyntax-only - 2>/dev/null; then
+    EXCESS_PRECISION="-fexcess-precision=standard"
+fi
+
+mkdir -p dist
+g++ -std=c++14 -g -DENABLE_LOGS -O3 "-DSELECTED_FILTER=\"${OUT_FILE}\"" -ffp-contract=off $EXCESS_PRECISION \
+    -o "dist/immolate_${KERNEL_NAME}_kernel" immolate.cpp env.cpp || { echo "Build failed!"; exit 1; }
+
+g++ -std=c++14 -O3 -I. "-DKERNEL_HEADER=\"${OUT_FILE}\"" -ffp-contract=off $EXCESS_PRECISION \
+    -o "dist/kernel_equivalence_${KERNEL_NAME}" tools/kernel_equivalence_test.cpp env.cpp || { echo "Build failed!"; exit 1; }
+
+if ! "./dist/kernel_equivalence_${KERNEL_NAME}" "$SEED_COUNT"; then
+    echo "Kernel does not match the reference filter; not using it."
+    exit 1
+fi
+
+echo "Build successful! Executable: dist/immolate_${KERNEL_NAME}_kernel"
@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Build libbalatro (libbalatro.h) for one filter as a shared library,
+# dist/libbalatro_<filter>.so (.dll on Windows, .dylib on macOS), then run
+# its tests against it. Usage: sh tools/build-lib.sh <filter_name>
+
+if [ $# -eq 0 ]; then
+    echo "Usage: $0 <filter_name>"
+    echo "Example: $0 enum_perkeo"
+    exit 1
+fi
+
+FILTER_NAME=$1
+FILTER_FILE="filters/${FILTER_NAME}_filter.hpp"
+if [ ! -f "$FILTER_FILE" ]; then
+    echo "Error: Filter file $FILTER_FILE not found!"
+    exit 1
+fi
+
+# GCC only accepts -fexcess-precision=standard for C++ from version 13
+EXCESS_PRECISION=""
+if echo "int main(){}" | g++ -x c++ -fexcess-precision=standard -fsyntax-only - 2>/dev/null; then
+    EXCESS_PRECISION="-fexcess-precision=standard"
+fi
+
+case "$(uname -s)" in
+    MINGW*|MSYS*|CYGWIN*) EXT=dll ;;
+    Darwin) EXT=dylib ;;
+    *) EXT=so ;;
+esac
+LIB="dist/libbalatro_${FILTER_NAME}.${EXT}"
+
+mkdir -p dist
+g++ -std=c++14 -O3 -shared -fPIC -fvisibility=hidden -ffp-contract=off $EXCESS_PRECISION \
+    -DSELECTED_FILTER="\"$FILTER_FILE\"" -o "$LIB" libbalatro.cpp env.cpp -lpthread || { echo "Build failed!"; exit 1; }
+
+# The test loads the library at run time, as ctypes does
+g++ -std=c++14 -O2 -I. -ffp-contract=off $EXCESS_PRECISION -DSELECTED_FILTER="\"$FILTER_FILE\"" \
+    -o dist/libbalatro_test tools/libbalatro_test.cpp env.cpp -ldl -lpthread || { echo "Build failed!"; exit 1; }
+if ! ./dist/libbalatro_test "$LIB"; then
+    echo "libbalatro tests failed."
+    exit 1
+fi
+
+echo "Build successful! Library: $LIB (Python: tools/libbalatro.py)"
@@ -1,8 +1,14 @@
 #!/bin/bash
 
 # Simple build script for simulate
+# -fexcess-precision=standard only where the compiler has it for C++ (GCC 13+)
+EXCESS_PRECISION=""
+if echo "int main(){}" | g++ -x c++ -fexcess-precision=standard -fsyntax-only - 2>/dev/null; then
+    EXCESS_PRECISION="-fexcess-precision=standard"
+fi
+
 # Compile directly with g++, defining the filter to include
-g++ -std=c++14 -g -DENABLE_LOGS -O3 -g -ffp-contract=off -fexcess-precision=standard -o "dist/simulate_enum" simulate_enum.cpp
+g++ -std=c++14 -g -DENABLE_LOGS -O3 -g -ffp-contract=off $EXCESS_PRECISION -o "dist/simulate_enum" simulate_enum.cpp env.cpp
 
 # Check if compilation was successful
 if [ $? -eq 0 ]; then
@@ -10,4 +16,26 @@ if [ $? -eq 0 ]; then
 else
     echo "Build failed!"
     exit 1
-fi
\ No newline at end of file
+fi
+
+# Run engine (run_engine.hpp), shop lookahead (shop_stream.hpp) and
+# starting deck (starting_deck.hpp) tests, checked against
+# QueryServer::simulate and direct draws
+g++ -std=c++14 -O2 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/run_engine_test tools/run_engine_test.cpp env.cpp -lpthread || { echo "Build failed!"; exit 1; }
+g++ -std=c++14 -O2 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/shop_stream_test tools/shop_stream_test.cpp env.cpp || { echo "Build failed!"; exit 1; }
+g++ -std=c++14 -O2 -I. -ffp-contract=off $EXCESS_PRECISION \
+    -o dist/starting_deck_test tools/starting_deck_test.cpp env.cpp || { echo "Build failed!"; exit 1; }
+if ! ./dist/run_engine_test; then
+    echo "Run engine tests failed."
+    exit 1
+fi
+if ! ./dist/shop_stream_test; then
+    echo "Shop lookahead tests failed."
+    exit 1
+fi
+if ! ./dist/starting_deck_test; then
+    echo "Starting deck tests failed."
+    exit 1
+fi
@@ -36,8 +36,21 @@ echo "Building immolate with filter: $FILTER_NAME"
 # Create a preprocessor definition for the filter
 FILTER_DEF="-DSELECTED_FILTER=\"filters/${FILTER_NAME}_filter.hpp\""
 
+# HOT_COUNTERS=1 compiles in the hot-path counters and stage timing (hot_counters.hpp)
+EXTRA_DEFS=""
+if [ "${HOT_COUNTERS:-0}" != "0" ]; then
+    EXTRA_DEFS="-DENABLE_HOT_COUNTERS"
+    echo "Hot-path counters enabled"
+fi
+
+# GCC only accepts -fexcess-precision=standard for C++ from version 13
+EXCESS_PRECISION=""
+if echo "int main(){}" | g++ -x c++ -fexcess-precision=standard -fsyntax-only - 2>/dev/null; then
+    EXCESS_PRECISION="-fexcess-precision=standard"
+fi
+
 # Compile directly with g++, defining the filter to include
-g++ -std=c++14 -g -DENABLE_LOGS -O3 "$FILTER_DEF" -ffp-contract=off -fexcess-precision=standard -o "dist/immolate_${FILTER_NAME}" immolate.cpp env.cpp
+g++ -std=c++14 -g -DENABLE_LOGS -O3 "$FILTER_DEF" $EXTRA_DEFS -ffp-contract=off $EXCESS_PRECISION -o "dist/immolate_${FILTER_NAME}" immolate.cpp env.cpp
 
 # Check if compilation was successful
 if [ $? -eq 0 ]; then
@@ -0,0 +1,214 @@
+// Co-occurrence analytics over ante-1 outputs. `scan` runs a seed range (or
+// a uniform sample of the whole space) through the generator and counts, for
+// each pair of axes, the seeds in which two items appear together, e.g.
+// jokers x jokers in the first shop slots, jokers x tarots, tags x vouchers
+// (cooccurrence.hpp). Tables are written as CSV, or as binary that `merge`
+// can sum, e.g. across machines that scanned different ranges.
+// Build with tools/build-indexer.sh, or from the repo root:
+//   g++ -std=c++14 -O3 -ffp-contract=off -I. -o dist/cooccurrence tools/cooccurrence.cpp env.cpp -lpthread
+// Usage:
+//   cooccurrence scan --out FILE [--format csv|bin] [--env FILE] [--start SEED | --start-number N] [--count N]
+//                     [--sample N] [--sample-key K] [--shop-slots N] [--threads N] [--pair ROW:COL]...
+//   cooccurrence merge --out FILE [--format csv|bin] TABLE.bin...
+// Axes: boss, voucher, tag, pack, joker, tarot, planet, spectral; item axes
+// cover the shop slots and the opened first pack, or one of them as
+// shop_<item> / pack_<item>. Default pairs: shop_joker:shop_joker,
+// joker:tarot, tag:voucher.
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cooccurrence.hpp"
+#include "env.hpp"
+#include "seed_permutation.hpp"
+#include "seed_util.hpp"
+
+using namespace std::chrono;
+
+struct Options {
+    std::string command;
+    std::string out;
+    std::string format;
+    std::string envFile;
+    uint64_t start = 0;
+    uint64_t count = 10000000;
+    uint64_t sample = 0;
+    uint64_t sampleKey = 1;
+    int shopSlots = 4;
+    unsigned int threads = 0;
+    std::vector<std::string> pairs;
+    std::vector<std::string> inputs;
+};
+
+static void usage(const char* prog) {
+    std::cerr << "Usage:\n"
+              << "  " << prog << " scan --out FILE [--format csv|bin] [--env FILE] [--start SEED | --start-number N] [--count N]\n"
+              << "        [--sample N] [--sample-key K] [--shop-slots N] [--threads N] [--pair ROW:COL]...\n"
+              << "  " << prog << " merge --out FILE [--format csv|bin] TABLE.bin...\n"
+              << "Axes: " << Cooccurrence::axisHelp() << "\n"
+              << "Default pairs: shop_joker:shop_joker joker:tarot tag:voucher\n";
+}
+
+static bool parseNumber(const std::string& s, uint64_t& out) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    out = std::strtoull(s.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+static bool parseOptions(int argc, char* argv[], Options& o) {
+    if (argc < 2) return false;
+    o.command = argv[1];
+    for (int i = 2; i < argc; i++) {
+        std::string a = argv[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        std::string v;
+        uint64_t n;
+        if (a == "--out") {
+            if (!value(o.out)) return false;
+        } else if (a == "--format") {
+            if (!value(o.format) || (o.format != "csv" && o.format != "bin")) return false;
+        } else if (a == "--env") {
+            if (!value(o.envFile)) return false;
+        } else if (a == "--start") {
+            if (!value(v)) return false;
+            o.start = seedToNumber(v);
+        } else if (a == "--start-number") {
+            if (!value(v) || !parseNumber(v, o.start)) return false;
+        } else if (a == "--count") {
+            if (!value(v) || !parseNumber(v, o.count)) return false;
+        } else if (a == "--sample") {
+            if (!value(v) || !parseNumber(v, o.sample) || o.sample == 0 || o.sample > SEED_COUNT) return false;
+        } else if (a == "--sample-key") {
+            if (!value(v) || !parseNumber(v, o.sampleKey)) return false;
+        } else if (a == "--shop-slots") {
+            if (!value(v) || !parseNumber(v, n) || n < 1 || n > FeatureColumns::MAX_SHOP_SLOTS) return false;
+            o.shopSlots = static_cast<int>(n);
+        } else if (a == "--threads") {
+            if (!value(v) || !parseNumber(v, n)) return false;
+            o.threads = static_cast<unsigned int>(n);
+        } else if (a == "--pair") {
+            if (!value(v)) return false;
+            o.pairs.push_back(v);
+        } else if (!a.empty() && a[0] != '-') {
+            o.inputs.push_back(a);
+        } else {
+            std::cerr << "Unknown option " << a << std::endl;
+            return false;
+        }
+    }
+    // The format follows the file name unless given
+    if (o.format.empty()) o.format = o.out.size() > 4 && o.out.compare(o.out.size() - 4, 4, ".bin") == 0 ? "bin" : "csv";
+    return !o.out.empty();
+}
+
+static bool save(const Options& o, const Cooccurrence::Table& table) {
+    std::string error;
+    if (o.format == "bin") {
+        if (!table.write(o.out, error)) {
+            std::cerr << error << std::endl;
+            return false;
+        }
+    } else {
+        std::ofstream f(o.out, std::ios::trunc);
+        table.writeCsv(f);
+        if (!f) {
+            std::cerr << "could not write " << o.out << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Wrote " << o.out << " (" << table.matrices.size() << " pairs, " << table.seeds << " seeds)" << std::endl;
+    return true;
+}
+
+static int scan(const Options& o) {
+    EnvConfig env;
+    if (!o.envFile.empty() && !loadEnvFile(o.envFile, env)) {
+        std::cerr << "Could not read env file " << o.envFile << std::endl;
+        return 1;
+    }
+    setGlobalEnv(env);
+
+    Cooccurrence::Table shape;
+    std::string error;
+    const std::vector<std::string> defaults = {"shop_joker:shop_joker", "joker:tarot", "tag:voucher"};
+    if (!shape.init(o.pairs.empty() ? defaults : o.pairs, o.shopSlots, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    // --sample counts positions 0 .. N of a permutation of the whole space
+    std::unique_ptr<SeedPermutation> sample;
+    uint64_t start = o.start, count = o.count;
+    if (o.sample) {
+        sample.reset(new SeedPermutation(o.sampleKey));
+        start = 0;
+        count = o.sample;
+    } else {
+        if (start >= SEED_COUNT) {
+            std::cerr << "--start is past the last seed" << std::endl;
+            return 1;
+        }
+        count = std::min(count, SEED_COUNT - start);
+    }
+    if (count == 0) {
+        std::cerr << "Nothing to count" << std::endl;
+        return 1;
+    }
+    unsigned int threads = o.threads ? o.threads : std::thread::hardware_concurrency();
+    if (!threads) threads = 4;
+
+    std::cout << "Counting " << shape.matrices.size() << " pairs over "
+              << (sample ? std::to_string(count) + " sampled seeds" : numberToSeed(start) + " .. " + numberToSeed(start + count - 1))
+              << " (" << o.shopSlots << " shop slots, " << threads << " threads)" << std::endl;
+    const auto t0 = steady_clock::now();
+    auto lastReport = t0;
+    const Cooccurrence::Table table = Cooccurrence::scan(shape, env, start, count, sample.get(), threads, [&](uint64_t done) {
+        const auto now = steady_clock::now();
+        if (now - lastReport < seconds(5) && done < count) return;
+        lastReport = now;
+        const double secs = duration<double>(now - t0).count();
+        std::cout << "  " << done << " / " << count << " seeds, " << static_cast<uint64_t>(done / secs) << " seeds/s" << std::endl;
+    });
+    return save(o, table) ? 0 : 1;
+}
+
+static int merge(const Options& o) {
+    if (o.inputs.empty()) {
+        std::cerr << "merge needs at least one table" << std::endl;
+        return 1;
+    }
+    Cooccurrence::Table total;
+    for (size_t i = 0; i < o.inputs.size(); i++) {
+        Cooccurrence::Table t;
+        std::string error;
+        if (!t.read(o.inputs[i], error) || (i > 0 && !total.sameShape(t, error))) {
+            std::cerr << o.inputs[i] << ": " << error << std::endl;
+            return 1;
+        }
+        if (i == 0) total = t;
+        else total.merge(t);
+    }
+    return save(o, total) ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (o.command == "scan") return scan(o);
+    if (o.command == "merge") return merge(o);
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,187 @@
+// Tests for the co-occurrence tables: counts against a direct recount of
+// the feature rows, thread-count invariance, skipped packs, binary round
+// trips and merges.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/cooccurrence_test tools/cooccurrence_test.cpp env.cpp -lpthread
+// Usage: dist/cooccurrence_test [seed_count]
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "cooccurrence.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+using Names = std::set<std::string>;
+
+// Item names of one seed's row for the default pairs, read column by column
+struct Direct {
+    Names shopJokers, jokers, tarots, tags, vouchers;
+};
+
+static Direct direct(const FeatureColumns::Schema& schema, uint64_t n, const EnvConfig& env) {
+    Cooccurrence::Row row;
+    schema.extract(numberToSeed(n), env, row, 0);
+    Direct d;
+    d.vouchers.insert(Items::toString(static_cast<Items::Voucher>(row.values[1])));
+    for (size_t c = 2; c < 4; c++) d.tags.insert(Items::toString(static_cast<Items::Tag>(row.values[c])));
+    for (size_t c = 6; c < 11 + static_cast<size_t>(schema.shopSlots()); c++) {
+        const uint16_t code = row.values[c];
+        const auto kind = static_cast<FeatureColumns::Kind>(code >> 8);
+        if (kind == FeatureColumns::Kind::JOKER) {
+            const std::string name = Items::toString(static_cast<Items::Joker>(code & 0xFF));
+            d.jokers.insert(name);
+            if (c >= 11) d.shopJokers.insert(name);
+        } else if (kind == FeatureColumns::Kind::TAROT) {
+            d.tarots.insert(Items::toString(static_cast<Items::Tarot>(code & 0xFF)));
+        }
+    }
+    return d;
+}
+
+using Cells = std::map<std::pair<std::string, std::string>, uint64_t>;
+
+static void count(Cells& cells, const Names& rows, const Names& cols) {
+    for (const auto& a : rows) {
+        for (const auto& b : cols) cells[{a, b}]++;
+    }
+}
+
+// Non-zero cells of matrix `m`, by item names
+static Cells cellsOf(const Cooccurrence::Table& t, size_t m) {
+    Cells out;
+    const auto& matrix = t.matrices[m];
+    const auto& ra = t.axes[matrix.rowAxis];
+    const auto& ca = t.axes[matrix.colAxis];
+    for (size_t i = 0; i < ra.size(); i++) {
+        for (size_t j = 0; j < ca.size(); j++) {
+            const uint64_t v = matrix.counts[i * ca.size() + j];
+            if (v) out[{ra.label(i), ca.label(j)}] = v;
+        }
+    }
+    return out;
+}
+
+static bool sameCounts(const Cooccurrence::Table& a, const Cooccurrence::Table& b) {
+    if (a.seeds != b.seeds || a.marginals != b.marginals || a.matrices.size() != b.matrices.size()) return false;
+    for (size_t m = 0; m < a.matrices.size(); m++) {
+        if (a.matrices[m].counts != b.matrices[m].counts) return false;
+    }
+    return true;
+}
+
+static void testAxes() {
+    Cooccurrence::Axis a;
+    expect(Cooccurrence::parseAxis("shop_joker", a) && a.shop && !a.pack && a.size() == 150, "shop_joker");
+    expect(Cooccurrence::parseAxis("tarot", a) && a.shop && a.pack, "tarot covers shop and pack");
+    expect(Cooccurrence::parseAxis("tag", a) && !a.shop && !a.pack, "tag");
+    expect(!Cooccurrence::parseAxis("shop_tag", a), "tags have no origin prefix");
+    expect(!Cooccurrence::parseAxis("jokers", a), "unknown axis");
+    Cooccurrence::Table t;
+    std::string error;
+    expect(!t.init({"joker"}, 4, error) && !error.empty(), "pair needs a colon");
+}
+
+static void testCounts(uint64_t seeds) {
+    const EnvConfig env;
+    const FeatureColumns::Schema schema(4);
+    Cells shopJokers, jokerTarot, tagVoucher;
+    for (uint64_t n = 0; n < seeds; n++) {
+        const Direct d = direct(schema, n, env);
+        count(shopJokers, d.shopJokers, d.shopJokers);
+        count(jokerTarot, d.jokers, d.tarots);
+        count(tagVoucher, d.tags, d.vouchers);
+    }
+
+    Cooccurrence::Table shape;
+    std::string error;
+    expect(shape.init({"shop_joker:shop_joker", "joker:tarot", "tag:voucher"}, 4, error), "init: " + error);
+    expect(shape.axes.size() == 5, "axes are shared between pairs");
+    const Cooccurrence::Table one = Cooccurrence::scan(shape, env, 0, seeds, nullptr, 1);
+    expect(one.seeds == seeds, "seed count");
+    expect(cellsOf(one, 0) == shopJokers, "shop joker x shop joker");
+    expect(cellsOf(one, 1) == jokerTarot, "joker x tarot");
+    expect(cellsOf(one, 2) == tagVoucher, "tag x voucher");
+    uint64_t tagTotal = 0;
+    for (uint64_t v : one.marginals[one.matrices[2].rowAxis]) tagTotal += v;
+    expect(tagTotal >= seeds && tagTotal <= 2 * seeds, "tag marginals count each seed's distinct tags");
+
+    const Cooccurrence::Table three = Cooccurrence::scan(shape, env, 0, seeds, nullptr, 3);
+    expect(sameCounts(one, three), "3 threads count the same as 1");
+
+    // Without pack axes the packs are skipped; shop counts must not change
+    Cooccurrence::Table shopOnly;
+    expect(shopOnly.init({"shop_joker:shop_joker"}, 4, error) && !shopOnly.needsPacks() && shape.needsPacks(), "needsPacks");
+    const Cooccurrence::Table skipped = Cooccurrence::scan(shopOnly, env, 0, seeds, nullptr, 2);
+    expect(skipped.matrices[0].counts == one.matrices[0].counts, "skipping packs leaves shop counts unchanged");
+
+    // CSV: one line per non-zero cell, the upper triangle for a self pair
+    std::ostringstream csv;
+    one.writeCsv(csv);
+    size_t lines = 0;
+    for (char c : csv.str()) lines += c == '\n';
+    size_t upper = 0;
+    const auto& self = one.matrices[0];
+    for (size_t i = 0; i < 150; i++) {
+        for (size_t j = i; j < 150; j++) upper += self.counts[i * 150 + j] ? 1 : 0;
+    }
+    expect(lines == 1 + upper + jokerTarot.size() + tagVoucher.size(), "CSV line count");
+}
+
+static void testFiles(uint64_t seeds) {
+    const EnvConfig env;
+    Cooccurrence::Table shape;
+    std::string error;
+    shape.init({"joker:joker", "tag:voucher", "boss:pack"}, 2, error);
+    const Cooccurrence::Table whole = Cooccurrence::scan(shape, env, 100, seeds, nullptr, 2);
+    const Cooccurrence::Table first = Cooccurrence::scan(shape, env, 100, seeds / 3, nullptr, 1);
+    const Cooccurrence::Table rest = Cooccurrence::scan(shape, env, 100 + seeds / 3, seeds - seeds / 3, nullptr, 1);
+
+    const std::string a = "cooccurrence_test_a.bin", b = "cooccurrence_test_b.bin";
+    expect(first.write(a, error) && rest.write(b, error), "write: " + error);
+    Cooccurrence::Table ra, rb;
+    expect(ra.read(a, error) && rb.read(b, error), "read: " + error);
+    expect(sameCounts(ra, first) && ra.shopSlots == 2 && ra.envHash == envConfigHash(env), "binary round trip");
+    expect(ra.sameShape(rb, error), "halves have the same shape");
+    ra.merge(rb);
+    expect(sameCounts(ra, whole), "merged halves equal one scan");
+
+    Cooccurrence::Table other;
+    other.init({"joker:joker"}, 2, error);
+    other.envHash = ra.envHash;
+    other.gameVersion = ra.gameVersion;
+    expect(!ra.sameShape(other, error), "different pairs are not merged");
+
+    // A truncated file is rejected
+    {
+        std::ifstream in(a, std::ios::binary);
+        const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(a, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+    }
+    expect(!ra.read(a, error), "truncated table rejected");
+    std::remove(a.c_str());
+    std::remove(b.c_str());
+}
+
+int main(int argc, char** argv) {
+    const uint64_t seeds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    testAxes();
+    testCounts(seeds);
+    testFiles(seeds);
+    std::cout << "cooccurrence: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
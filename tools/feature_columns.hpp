@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../feature_index.hpp"
+#include "../instance.hpp"
+#include "item_lookup.hpp"
+#include "../items_to_string.hpp"
+
+// Ante-1 feature columns written by tools/feature_indexer.cpp, and the
+// name -> value mapping its queries use. Each seed runs through Instance in
+// the order simulate_enum.cpp uses: boss, voucher (not bought), both blind
+// tags, the first `shopSlots` shop items, then the two shop packs with the
+// first one opened.
+namespace FeatureColumns {
+
+    constexpr int PACK_CARDS = 5;   // Largest pack size
+    constexpr int MAX_SHOP_SLOTS = 16;
+
+    // Shop and pack slots hold kind << 8 | item id; 0 is an empty slot
+    enum class Kind : uint16_t { NONE = 0, JOKER = 1, TAROT = 2, PLANET = 3, SPECTRAL = 4 };
+
+    inline uint16_t itemCode(Kind kind, unsigned int id) { return static_cast<uint16_t>(static_cast<uint16_t>(kind) << 8 | id); }
+
+    // Column kinds, which decide how query values are resolved
+    enum class Type { BOSS, VOUCHER, TAG, PACK, ITEM, EDITION };
+
+    struct Column {
+        FeatureIndex::ColumnSpec spec;
+        Type type;
+    };
+
+    using ItemLookup::normalize;
+    using ItemLookup::lookup;
+
+    class Schema {
+    public:
+        explicit Schema(int shopSlots = 4) : slots(shopSlots) {
+            add("boss", 1, Type::BOSS);
+            add("voucher", 1, Type::VOUCHER);
+            add("tag1", 1, Type::TAG);
+            add("tag2", 1, Type::TAG);
+            add("pack1", 1, Type::PACK);
+            add("pack2", 1, Type::PACK);
+            for (int i = 1; i <= PACK_CARDS; i++) add("pack1_card" + std::to_string(i), 2, Type::ITEM);
+            for (int i = 1; i <= slots; i++) add("shop" + std::to_string(i), 2, Type::ITEM);
+            for (int i = 1; i <= slots; i++) add("shop" + std::to_string(i) + "_edition", 1, Type::EDITION);
+        }
+
+        int shopSlots() const { return slots; }
+        const std::vector<Column>& columns() const { return cols; }
+
+        std::vector<FeatureIndex::ColumnSpec> specs() const {
+            std::vector<FeatureIndex::ColumnSpec> out;
+            for (const auto& c : cols) out.push_back(c.spec);
+            return out;
+        }
+
+        // Writes row `row` of `w` for `seed`. `w` is a FeatureIndex::ShardWriter,
+        // or anything else with set(column, row, value) (libbalatro's caller arrays).
+        // Without `packs` the pack columns are left INVALID/empty and the packs,
+        // generated last, are skipped (cooccurrence.hpp when no axis reads them).
+        template<typename Writer>
+        void extract(const std::string& seed, const EnvConfig& e, Writer& w, uint64_t row, bool packs = true) const {
+            Instance::Instance inst(seed);
+            if (!e.deck.empty()) inst.setDeck(e.deck);
+            if (!e.stake.empty()) inst.setStake(e.stake);
+            inst.setShowman(e.showman);
+            inst.setSixesFactor(e.sixesFactor);
+            inst.setVersion(e.version);
+            inst.setForceAllContent(e.forceAllContent);
+            inst.initLocks(1, e.freshProfile, e.freshRun);
+
+            size_t c = 0;
+            w.set(c++, row, static_cast<uint16_t>(inst.nextBoss_enum(1)));
+            w.set(c++, row, static_cast<uint16_t>(inst.nextVoucher_enum(1)));
+            w.set(c++, row, static_cast<uint16_t>(inst.nextTag_enum(1)));
+            w.set(c++, row, static_cast<uint16_t>(inst.nextTag_enum(1)));
+
+            // Shop items come before the packs in the game's generation order
+            std::vector<Items::OptimizedShopItem> shop;
+            for (int i = 0; i < slots; i++) shop.push_back(inst.nextShopItem_enum(1));
+
+            Items::Pack pack1 = Items::Pack::INVALID, pack2 = Items::Pack::INVALID;
+            uint16_t cards[PACK_CARDS] = {};
+            if (packs) {
+                pack1 = inst.nextPack_enum(1);
+                openPack(inst, pack1, cards);
+                pack2 = inst.nextPack_enum(1);
+            }
+            w.set(c++, row, static_cast<uint16_t>(pack1));
+            w.set(c++, row, static_cast<uint16_t>(pack2));
+            for (int i = 0; i < PACK_CARDS; i++) w.set(c++, row, cards[i]);
+
+            for (int i = 0; i < slots; i++) w.set(c++, row, shopCode(shop[i]));
+            for (int i = 0; i < slots; i++) {
+                const bool joker = shop[i].type == Items::OptimizedShopItem::Type::JOKER;
+                w.set(c++, row, static_cast<uint16_t>(joker ? shop[i].joker_data.edition : Items::Edition::NO_EDITION));
+            }
+        }
+
+        // Column names a query term refers to: a column, or a group
+        // ("tag", "shop", "shop_edition", "pack1_card") meaning any of its members
+        std::vector<const Column*> resolveColumns(const std::string& name) const {
+            std::vector<const Column*> out;
+            for (const auto& c : cols) {
+                const std::string& n = c.spec.name;
+                if (n == name) return {&c};
+                const bool member =
+                    (name == "tag" && c.type == Type::TAG) ||
+                    (name == "shop" && n.compare(0, 4, "shop") == 0 && c.type == Type::ITEM) ||
+                    (name == "shop_edition" && c.type == Type::EDITION) ||
+                    (name == "pack1_card" && n.compare(0, 10, "pack1_card") == 0);
+                if (member) out.push_back(&c);
+            }
+            return out;
+        }
+
+        // Value stored for `name` in a column of type `t`
+        static bool resolveValue(Type t, const std::string& name, uint16_t& out) {
+            switch (t) {
+                case Type::BOSS: return lookupCode<Items::Boss>(name, out);
+                case Type::VOUCHER: return lookupCode<Items::Voucher>(name, out);
+                case Type::TAG: return lookupCode<Items::Tag>(name, out);
+                case Type::PACK: return lookupCode<Items::Pack>(name, out);
+                case Type::EDITION: return lookupCode<Items::Edition>(name, out);
+                case Type::ITEM: {
+                    Items::Joker j; Items::Tarot t2; Items::Planet p; Items::Spectral s;
+                    if (normalize(name) == "empty") { out = 0; return true; }
+                    if (lookup(name, j)) { out = itemCode(Kind::JOKER, static_cast<unsigned>(j)); return true; }
+                    if (lookup(name, t2)) { out = itemCode(Kind::TAROT, static_cast<unsigned>(t2)); return true; }
+                    if (lookup(name, p)) { out = itemCode(Kind::PLANET, static_cast<unsigned>(p)); return true; }
+                    if (lookup(name, s)) { out = itemCode(Kind::SPECTRAL, static_cast<unsigned>(s)); return true; }
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        // Parses "column=Value|Value" or "column!=Value" into a predicate
+        bool parsePredicate(const std::string& text, FeatureIndex::Predicate& p, std::string& error) const {
+            auto eq = text.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                error = "expected COLUMN=VALUE, got '" + text + "'";
+                return false;
+            }
+            p = FeatureIndex::Predicate();
+            p.text = text;
+            p.negate = text[eq - 1] == '!';
+            const std::string column = text.substr(0, p.negate ? eq - 1 : eq);
+            std::vector<const Column*> members = resolveColumns(column);
+            if (members.empty()) {
+                error = "unknown column '" + column + "'";
+                return false;
+            }
+            for (const Column* c : members) p.columns.push_back(c->spec.name);
+            std::string values = text.substr(eq + 1);
+            size_t start = 0;
+            while (start <= values.size()) {
+                size_t bar = values.find('|', start);
+                if (bar == std::string::npos) bar = values.size();
+                const std::string v = values.substr(start, bar - start);
+                uint16_t code;
+                if (!resolveValue(members[0]->type, v, code)) {
+                    error = "unknown value '" + v + "' for " + column;
+                    return false;
+                }
+                p.accept->set(code);
+                start = bar + 1;
+            }
+            return true;
+        }
+
+    private:
+        void add(const std::string& name, uint8_t width, Type t) { cols.push_back({{name, width}, t}); }
+
+        template<typename EnumType>
+        static bool lookupCode(const std::string& name, uint16_t& out) {
+            EnumType v;
+            if (!lookup(name, v)) return false;
+            out = static_cast<uint16_t>(v);
+            return true;
+        }
+
+        static uint16_t shopCode(const Items::OptimizedShopItem& item) {
+            switch (item.type) {
+                case Items::OptimizedShopItem::Type::JOKER: return itemCode(Kind::JOKER, static_cast<unsigned>(item.item.joker));
+                case Items::OptimizedShopItem::Type::TAROT: return itemCode(Kind::TAROT, static_cast<unsigned>(item.item.tarot));
+                case Items::OptimizedShopItem::Type::PLANET: return itemCode(Kind::PLANET, static_cast<unsigned>(item.item.planet));
+                case Items::OptimizedShopItem::Type::SPECTRAL: return itemCode(Kind::SPECTRAL, static_cast<unsigned>(item.item.spectral));
+                default: return 0;
+            }
+        }
+
+        // Opens `pack` as the game would and records its cards; standard
+        // packs are opened but their playing cards are not stored
+        static void openPack(Instance::Instance& inst, Items::Pack pack, uint16_t (&cards)[PACK_CARDS]) {
+            if (pack == Items::Pack::INVALID) return;
+            const Items::NextPackData info = Items::convertPackData(pack);
+            const int n = std::min(info.size, PACK_CARDS);
+            switch (info.type) {
+                case Items::Pack::ARCANA_PACK: {
+                    auto p = inst.nextArcanaPack_enum(info.size, 1);
+                    for (int i = 0; i < n; i++) {
+                        cards[i] = p.isSpectral[i] ? itemCode(Kind::SPECTRAL, static_cast<unsigned>(p.spectrals[i]))
+                                                   : itemCode(Kind::TAROT, static_cast<unsigned>(p.tarots[i]));
+                    }
+                    break;
+                }
+                case Items::Pack::CELESTIAL_PACK: {
+                    auto p = inst.nextCelestialPack_enum(info.size, 1);
+                    for (int i = 0; i < n; i++) cards[i] = itemCode(Kind::PLANET, static_cast<unsigned>(p[i]));
+                    break;
+                }
+                case Items::Pack::SPECTRAL_PACK: {
+                    auto p = inst.nextSpectralPack_enum(info.size, 1);
+                    for (int i = 0; i < n; i++) cards[i] = itemCode(Kind::SPECTRAL, static_cast<unsigned>(p[i]));
+                    break;
+                }
+                case Items::Pack::BUFFOON_PACK: {
+                    auto p = inst.nextBuffoonPack_enum(info.size, 1);
+                    for (int i = 0; i < n; i++) cards[i] = itemCode(Kind::JOKER, static_cast<unsigned>(p[i].joker));
+                    break;
+                }
+                case Items::Pack::STANDARD_PACK:
+                    inst.nextStandardPack_enum(info.size, 1);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        int slots;
+        std::vector<Column> cols;
+    };
+}
@@ -0,0 +1,175 @@
+// Tests for the feature index: shard round trips and query results against
+// a direct scan of the generator.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/feature_index_test tools/feature_index_test.cpp env.cpp -lpthread
+// Usage: dist/feature_index_test [seed_count]
+// Indexes `seed_count` seeds into a temporary directory as two shards, then
+// checks every query below against what Instance generates for each seed.
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "feature_index.hpp"
+#include "seed_util.hpp"
+#include "tools/feature_columns.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+// What the generator produced for one seed, taken straight from Instance
+struct Direct {
+    Items::Voucher voucher;
+    Items::Tag tags[2];
+    Items::Pack pack1, pack2;
+    bool pack1Blueprint = false;
+    std::vector<Items::OptimizedShopItem> shop;
+};
+
+static Direct generate(const std::string& seed, int shopSlots) {
+    Instance::Instance inst(seed);
+    inst.initLocks(1, false, false);
+    Direct d;
+    inst.nextBoss_enum(1);
+    d.voucher = inst.nextVoucher_enum(1);
+    d.tags[0] = inst.nextTag_enum(1);
+    d.tags[1] = inst.nextTag_enum(1);
+    for (int i = 0; i < shopSlots; i++) d.shop.push_back(inst.nextShopItem_enum(1));
+    d.pack1 = inst.nextPack_enum(1);
+    // The first pack is a Buffoon Pack in current versions; open it before drawing the second
+    const Items::NextPackData info = Items::convertPackData(d.pack1);
+    if (info.type == Items::Pack::BUFFOON_PACK) {
+        for (const auto& j : inst.nextBuffoonPack_enum(info.size, 1)) d.pack1Blueprint |= j.joker == Items::Joker::BLUEPRINT;
+    }
+    d.pack2 = inst.nextPack_enum(1);
+    return d;
+}
+
+static bool shopHasJoker(const Direct& d, Items::Joker j) {
+    for (const auto& item : d.shop) {
+        if (item.type == Items::OptimizedShopItem::Type::JOKER && item.item.joker == j) return true;
+    }
+    return false;
+}
+
+static void testChunkSet() {
+    using FeatureIndex::ChunkSet;
+    const uint32_t n = static_cast<uint32_t>(FeatureIndex::CHUNK_ROWS);
+    ChunkSet dense = ChunkSet::scan(n, [](uint32_t r) { return r % 3 != 0; });
+    ChunkSet sparse = ChunkSet::scan(n, [](uint32_t r) { return r % 100 == 1; });
+    expect(dense.isDense() && !sparse.isDense(), "containers pick dense/sparse form");
+    expect(dense.cardinality() == n - (n + 2) / 3, "dense cardinality");
+    ChunkSet both = dense;
+    both.intersectWith(sparse);
+    uint32_t expected = 0;
+    for (uint32_t r = 0; r < n; r++) expected += r % 3 != 0 && r % 100 == 1;
+    expect(both.cardinality() == expected, "dense & sparse intersection");
+    dense.filter(n, [](uint32_t r) { return r % 7 == 0; });
+    expect(!dense.isDense() || dense.cardinality() > FeatureIndex::ARRAY_MAX, "filtered set compacts");
+    bool ok = true;
+    dense.forEach([&](uint32_t r) { ok = ok && r % 3 != 0 && r % 7 == 0; });
+    expect(ok && dense.cardinality() == [&] { uint32_t c = 0; for (uint32_t r = 0; r < n; r++) c += r % 3 != 0 && r % 7 == 0; return c; }(),
+           "dense filter");
+}
+
+int main(int argc, char* argv[]) {
+    const uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    char tmpl[] = "/tmp/feature_index_test_XXXXXX";
+    const char* dir = mkdtemp(tmpl);
+    if (!dir) {
+        std::cerr << "could not create a temporary directory" << std::endl;
+        return 1;
+    }
+    testChunkSet();
+    std::cout << "chunk sets: " << (failures ? "FAILED" : "ok") << std::endl;
+
+    const EnvConfig env;
+    setGlobalEnv(env);
+    const FeatureColumns::Schema schema(4);
+    const uint64_t start = 123456789;
+    const uint64_t split = start + count / 2 + 17;  // Unaligned shard boundary, partial last chunk
+    std::vector<std::string> paths;
+    for (int s = 0; s < 2; s++) {
+        FeatureIndex::ShardHeader h;
+        h.envHash = envConfigHash(env);
+        h.gameVersion = env.version;
+        h.rangeStart = s ? split : start;
+        h.rangeEnd = s ? start + count : split;
+        FeatureIndex::ShardWriter w(h, schema.specs());
+        for (uint64_t n = h.rangeStart; n < h.rangeEnd; n++) schema.extract(numberToSeed(n), env, w, n - h.rangeStart);
+        paths.push_back(std::string(dir) + "/" + FeatureIndex::shardFileName(h.rangeStart, h.rangeEnd));
+        std::string error;
+        expect(w.write(paths.back(), error), "write: " + error);
+    }
+    expect(FeatureIndex::listShards(dir) == paths, "listShards finds both shards in order");
+
+    std::vector<std::unique_ptr<FeatureIndex::MappedShard>> shards;
+    std::vector<const FeatureIndex::MappedShard*> views;
+    for (const auto& p : paths) {
+        std::unique_ptr<FeatureIndex::MappedShard> m(new FeatureIndex::MappedShard());
+        std::string error;
+        expect(m->open(p, error), "open: " + error);
+        views.push_back(m.get());
+        shards.push_back(std::move(m));
+    }
+    if (failures) return 1;
+    expect(shards[0]->columnCount() == schema.columns().size() && shards[0]->header().rangeStart == start, "header round trip");
+
+    std::vector<Direct> direct;
+    for (uint64_t n = start; n < start + count; n++) direct.push_back(generate(numberToSeed(n), 4));
+
+    struct Case {
+        std::vector<std::string> predicates;
+        std::function<bool(const Direct&)> expected;
+    };
+    const std::vector<Case> cases = {
+        {{"tag=Charm Tag"}, [](const Direct& d) { return d.tags[0] == Items::Tag::CHARM_TAG || d.tags[1] == Items::Tag::CHARM_TAG; }},
+        {{"tag1=Charm Tag", "voucher=Telescope"},
+         [](const Direct& d) { return d.tags[0] == Items::Tag::CHARM_TAG && d.voucher == Items::Voucher::TELESCOPE; }},
+        {{"voucher!=Telescope"}, [](const Direct& d) { return d.voucher != Items::Voucher::TELESCOPE; }},
+        {{"shop=Blueprint|Brainstorm"},
+         [](const Direct& d) { return shopHasJoker(d, Items::Joker::BLUEPRINT) || shopHasJoker(d, Items::Joker::BRAINSTORM); }},
+        {{"pack2=Mega Arcana Pack|Jumbo Arcana Pack", "tag!=Charm Tag"},
+         [](const Direct& d) {
+             return (d.pack2 == Items::Pack::MEGA_ARCANA_PACK || d.pack2 == Items::Pack::JUMBO_ARCANA_PACK) &&
+                    d.tags[0] != Items::Tag::CHARM_TAG && d.tags[1] != Items::Tag::CHARM_TAG;
+         }},
+        {{"pack1_card=Blueprint"}, [](const Direct& d) { return d.pack1Blueprint; }},
+    };
+    for (const auto& c : cases) {
+        std::vector<FeatureIndex::Predicate> predicates;
+        std::string label;
+        for (const auto& text : c.predicates) {
+            FeatureIndex::Predicate p;
+            std::string error;
+            expect(schema.parsePredicate(text, p, error), "parse " + text + ": " + error);
+            predicates.push_back(p);
+            label += text + " ";
+        }
+        std::vector<uint64_t> got, want;
+        std::string error;
+        expect(FeatureIndex::runQuery(views, predicates, 3, got, error), "runQuery: " + error);
+        for (uint64_t i = 0; i < count; i++) {
+            if (c.expected(direct[i])) want.push_back(start + i);
+        }
+        expect(got == want, "query " + label + "(" + std::to_string(got.size()) + " vs " + std::to_string(want.size()) + ")");
+        std::cout << label << ": " << got.size() << " matches" << std::endl;
+    }
+
+    FeatureIndex::Predicate p;
+    std::string error;
+    expect(!schema.parsePredicate("nope=Charm Tag", p, error), "unknown column is rejected");
+    expect(!schema.parsePredicate("tag=Blueprint", p, error), "value of the wrong type is rejected");
+
+    shards.clear();
+    for (const auto& path : paths) std::remove(path.c_str());
+    std::remove(dir);
+    std::cout << "feature index: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,313 @@
+// Columnar ante-1 feature index. `build` runs every seed of a range through
+// the generator once and writes its outputs as column shards
+// (feature_index.hpp, columns in tools/feature_columns.hpp); `query` then
+// answers ad-hoc predicates over those columns with chunked bitmap
+// intersections, without re-simulating.
+// Build with tools/build-indexer.sh, or from the repo root:
+//   g++ -std=c++14 -O3 -ffp-contract=off -I. -o dist/feature_indexer tools/feature_indexer.cpp env.cpp -lpthread
+// Usage:
+//   feature_indexer build --out DIR [--env FILE] [--start SEED | --start-number N] [--count N]
+//                         [--shard-size N] [--shop-slots N] [--threads N]
+//   feature_indexer query --index DIR [--env FILE] [--threads N] [--limit N] [--count-only] PREDICATE...
+//   feature_indexer columns --index DIR
+// A predicate is COLUMN=VALUE[|VALUE...] or COLUMN!=VALUE; all predicates
+// must hold. Group names match any member column: tag (tag1, tag2), shop
+// (shop1..N), shop_edition, pack1_card. Values are item names, matched
+// case- and punctuation-insensitively, e.g.
+//   feature_indexer query --index feat "tag=Charm Tag" "voucher=Telescope" "shop=Blueprint"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+#include "env.hpp"
+#include "feature_index.hpp"
+#include "seed_util.hpp"
+#include "tools/feature_columns.hpp"
+
+using namespace std::chrono;
+
+struct Options {
+    std::string command;
+    std::string dir;
+    std::string envFile;
+    uint64_t start = 0;
+    uint64_t count = 10000000;
+    uint64_t shardSize = 4 * FeatureIndex::CHUNK_ROWS * 4;
+    int shopSlots = 4;
+    unsigned int threads = 0;
+    uint64_t limit = 0;
+    bool countOnly = false;
+    std::vector<std::string> predicates;
+};
+
+static void usage(const char* prog) {
+    std::cerr << "Usage:\n"
+              << "  " << prog << " build --out DIR [--env FILE] [--start SEED | --start-number N] [--count N]\n"
+              << "        [--shard-size N] [--shop-slots N] [--threads N]\n"
+              << "  " << prog << " query --index DIR [--env FILE] [--threads N] [--limit N] [--count-only] PREDICATE...\n"
+              << "  " << prog << " columns --index DIR\n"
+              << "Predicates: COLUMN=VALUE[|VALUE...] or COLUMN!=VALUE, e.g. \"tag=Charm Tag\" \"shop=Blueprint\"\n";
+}
+
+static bool parseNumber(const std::string& s, uint64_t& out) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    out = std::strtoull(s.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+static bool parseOptions(int argc, char* argv[], Options& o) {
+    if (argc < 2) return false;
+    o.command = argv[1];
+    for (int i = 2; i < argc; i++) {
+        std::string a = argv[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        std::string v;
+        uint64_t n;
+        if (a == "--out" || a == "--index") {
+            if (!value(o.dir)) return false;
+        } else if (a == "--env") {
+            if (!value(o.envFile)) return false;
+        } else if (a == "--start") {
+            if (!value(v)) return false;
+            o.start = seedToNumber(v);
+        } else if (a == "--start-number") {
+            if (!value(v) || !parseNumber(v, o.start)) return false;
+        } else if (a == "--count") {
+            if (!value(v) || !parseNumber(v, o.count)) return false;
+        } else if (a == "--shard-size") {
+            if (!value(v) || !parseNumber(v, o.shardSize) || o.shardSize == 0) return false;
+        } else if (a == "--shop-slots") {
+            if (!value(v) || !parseNumber(v, n) || n < 1 || n > FeatureColumns::MAX_SHOP_SLOTS) return false;
+            o.shopSlots = static_cast<int>(n);
+        } else if (a == "--threads") {
+            if (!value(v) || !parseNumber(v, n)) return false;
+            o.threads = static_cast<unsigned int>(n);
+        } else if (a == "--limit") {
+            if (!value(v) || !parseNumber(v, o.limit)) return false;
+        } else if (a == "--count-only") {
+            o.countOnly = true;
+        } else if (!a.empty() && a[0] != '-') {
+            o.predicates.push_back(a);
+        } else {
+            std::cerr << "Unknown option " << a << std::endl;
+            return false;
+        }
+    }
+    return !o.dir.empty();
+}
+
+static bool loadEnv(const Options& o, EnvConfig& env) {
+    if (!o.envFile.empty() && !loadEnvFile(o.envFile, env)) {
+        std::cerr << "Could not read env file " << o.envFile << std::endl;
+        return false;
+    }
+    setGlobalEnv(env);
+    return true;
+}
+
+static unsigned int threadCount(const Options& o) {
+    unsigned int threads = o.threads ? o.threads : std::thread::hardware_concurrency();
+    return threads ? threads : 4;
+}
+
+static void makeDir(const std::string& dir) {
+#ifdef _WIN32
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+}
+
+// An existing shard is reused only if it was built with the same env and columns
+static bool shardIsComplete(const std::string& path, const FeatureIndex::ShardHeader& want,
+                            const std::vector<FeatureIndex::ColumnSpec>& specs) {
+    FeatureIndex::MappedShard shard;
+    std::string error;
+    if (!shard.open(path, error) || shard.header().envHash != want.envHash ||
+        shard.header().gameVersion != want.gameVersion || shard.columnCount() != specs.size()) return false;
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (shard.columnName(i) != specs[i].name) return false;
+    }
+    return true;
+}
+
+static int build(const Options& o) {
+    EnvConfig env;
+    if (!loadEnv(o, env)) return 1;
+    if (o.start >= SEED_COUNT) {
+        std::cerr << "--start is past the last seed" << std::endl;
+        return 1;
+    }
+    makeDir(o.dir);
+
+    const FeatureColumns::Schema schema(o.shopSlots);
+    const std::vector<FeatureIndex::ColumnSpec> specs = schema.specs();
+    const uint64_t end = std::min(SEED_COUNT, o.start + o.count);
+    const uint64_t shardCount = (end - o.start + o.shardSize - 1) / o.shardSize;
+    const unsigned int threads = threadCount(o);
+
+    FeatureIndex::ShardHeader base;
+    base.envHash = envConfigHash(env);
+    base.gameVersion = env.version;
+
+    size_t rowBytes = 0;
+    for (const auto& s : specs) rowBytes += s.width;
+    std::cout << "Indexing features of " << numberToSeed(o.start) << " .. " << numberToSeed(end - 1) << " ("
+              << (end - o.start) << " seeds, " << specs.size() << " columns, " << rowBytes << " bytes/seed, "
+              << shardCount << " shards, " << threads << " threads) into " << o.dir << std::endl;
+
+    std::atomic<uint64_t> nextShard{0};
+    std::atomic<uint64_t> seedsDone{0};
+    std::atomic<bool> failed{false};
+    std::mutex outMutex;
+    auto t0 = steady_clock::now();
+
+    auto worker = [&]() {
+        for (uint64_t s = nextShard++; s < shardCount && !failed.load(); s = nextShard++) {
+            FeatureIndex::ShardHeader h = base;
+            h.rangeStart = o.start + s * o.shardSize;
+            h.rangeEnd = std::min(end, h.rangeStart + o.shardSize);
+            const std::string path = o.dir + "/" + FeatureIndex::shardFileName(h.rangeStart, h.rangeEnd);
+            if (shardIsComplete(path, h, specs)) continue;
+
+            FeatureIndex::ShardWriter w(h, specs);
+            for (uint64_t n = h.rangeStart; n < h.rangeEnd; n++) schema.extract(numberToSeed(n), env, w, n - h.rangeStart);
+            std::string error;
+            if (!w.write(path, error)) {
+                std::lock_guard<std::mutex> lk(outMutex);
+                std::cerr << error << std::endl;
+                failed = true;
+                return;
+            }
+            uint64_t done = seedsDone += h.rows();
+            double secs = duration<double>(steady_clock::now() - t0).count();
+            std::lock_guard<std::mutex> lk(outMutex);
+            std::cout << "  " << FeatureIndex::shardFileName(h.rangeStart, h.rangeEnd) << "  "
+                      << static_cast<uint64_t>(done / secs) << " seeds/s" << std::endl;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 0; i < threads; i++) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+    return failed ? 1 : 0;
+}
+
+// Opens every shard in the index; fails on a shard built for another env
+static bool openShards(const Options& o, const EnvConfig* env, std::vector<std::unique_ptr<FeatureIndex::MappedShard>>& shards) {
+    const auto files = FeatureIndex::listShards(o.dir);
+    if (files.empty()) {
+        std::cerr << "No feature shards in " << o.dir << std::endl;
+        return false;
+    }
+    for (const auto& f : files) {
+        std::unique_ptr<FeatureIndex::MappedShard> shard(new FeatureIndex::MappedShard());
+        std::string error;
+        if (!shard->open(f, error)) {
+            std::cerr << error << std::endl;
+            return false;
+        }
+        if (env && (shard->header().envHash != envConfigHash(*env) || shard->header().gameVersion != env->version)) {
+            std::cerr << f << " was built for a different env (hash/version mismatch); rebuild or pass the matching --env" << std::endl;
+            return false;
+        }
+        shards.push_back(std::move(shard));
+    }
+    return true;
+}
+
+static int shopSlotsOf(const FeatureIndex::MappedShard& shard) {
+    int slots = 0;
+    while (shard.findColumn("shop" + std::to_string(slots + 1)) >= 0) slots++;
+    return slots;
+}
+
+static int query(const Options& o) {
+    EnvConfig env;
+    if (!loadEnv(o, env)) return 1;
+    if (o.predicates.empty()) {
+        std::cerr << "query needs at least one predicate" << std::endl;
+        return 1;
+    }
+    std::vector<std::unique_ptr<FeatureIndex::MappedShard>> shards;
+    if (!openShards(o, &env, shards)) return 1;
+
+    const FeatureColumns::Schema schema(shopSlotsOf(*shards[0]));
+    std::vector<FeatureIndex::Predicate> predicates;
+    for (const auto& text : o.predicates) {
+        FeatureIndex::Predicate p;
+        std::string error;
+        if (!schema.parsePredicate(text, p, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        predicates.push_back(p);
+    }
+
+    std::vector<const FeatureIndex::MappedShard*> views;
+    uint64_t rows = 0;
+    for (const auto& s : shards) {
+        views.push_back(s.get());
+        rows += s->rows();
+    }
+    auto t0 = steady_clock::now();
+    std::vector<uint64_t> seeds;
+    std::string error;
+    if (!FeatureIndex::runQuery(views, predicates, threadCount(o), seeds, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    const double secs = duration<double>(steady_clock::now() - t0).count();
+
+    if (!o.countOnly) {
+        uint64_t printed = 0;
+        for (uint64_t n : seeds) {
+            if (o.limit && printed++ >= o.limit) break;
+            std::cout << numberToSeed(n) << "\n";
+        }
+    }
+    std::cerr << seeds.size() << " of " << rows << " seeds match (" << shards.size() << " shards, "
+              << static_cast<uint64_t>(secs * 1000) << " ms)" << std::endl;
+    if (o.countOnly) std::cout << seeds.size() << std::endl;
+    return 0;
+}
+
+static int columns(const Options& o) {
+    std::vector<std::unique_ptr<FeatureIndex::MappedShard>> shards;
+    if (!openShards(o, nullptr, shards)) return 1;
+    uint64_t rows = 0;
+    for (const auto& s : shards) rows += s->rows();
+    std::cout << shards.size() << " shards, " << rows << " seeds, env hash " << std::hex << shards[0]->header().envHash
+              << std::dec << ", version " << shards[0]->header().gameVersion << std::endl;
+    for (size_t i = 0; i < shards[0]->columnCount(); i++) std::cout << "  " << shards[0]->columnName(i) << std::endl;
+    std::cout << "Groups: tag, shop, shop_edition, pack1_card" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (o.command == "build") return build(o);
+    if (o.command == "query") return query(o);
+    if (o.command == "columns") return columns(o);
+    usage(argv[0]);
+    return 1;
+}
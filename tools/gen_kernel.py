@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+"""Generate a straight-line filter kernel from a JSON spec.
+
+The spec lists the draws a filter makes (tag, arcana pack, soul joker) and
+what it expects from each. The generated header contains a SearchFilter
+whose apply() replays only those draws with prehashed constant keys and no
+node map, strings or virtual calls on the hot path, plus applyReference()
+which runs the same steps through Instance for equivalence testing.
+
+Usage: python3 tools/gen_kernel.py filters/kernels/perkeo.json [-o OUT]
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+MAX_KEY_LEN = 48  # Kernel::MAX_KEY_LEN, resample suffix included
+
+
+class SpecError(Exception):
+    pass
+
+
+def camel(name):
+    return ''.join(p[:1].upper() + p[1:] for p in re.split(r'[^A-Za-z0-9]+', name) if p)
+
+
+def c_string(s):
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+class Keys:
+    """Constant RNG keys used by a kernel, each with a stable id."""
+
+    def __init__(self):
+        self.ids = {}
+
+    def add(self, key):
+        if len(key) + 13 > MAX_KEY_LEN:
+            raise SpecError('key too long: ' + key)
+        if key not in self.ids:
+            self.ids[key] = len(self.ids)
+        return self.ident(key)
+
+    @staticmethod
+    def ident(key):
+        return re.sub(r'[^A-Za-z0-9_]', '_', key)
+
+    def emit_functions(self):
+        out = []
+        for key in self.ids:
+            ident = self.ident(key)
+            out.append('    // "%s"' % key)
+            out.append('    static INLINE_FORCE double key_%s(Kernel::SeedState& s) {' % ident)
+            out.append('        double n = s.seedPrefix(%d);' % len(key))
+            for j in range(len(key)):
+                c = key[len(key) - 1 - j]
+                ch = "'\\''" if c == "'" else "'%s'" % c
+                out.append('        n = pseudohash_step(n, %s, %d);' % (ch, len(key) - j))
+            out.append('        return n;')
+            out.append('    }')
+            out.append('')
+        return out
+
+    def emit_decls(self):
+        out = []
+        for key in self.ids:
+            ident = self.ident(key)
+            out.append('        double n_%s; bool h_%s = false;' % (ident, ident))
+        return out
+
+    def node(self, key):
+        ident = self.ident(key)
+        return 'Kernel::node(s, n_%s, h_%s, key_%s)' % (ident, ident, ident)
+
+
+def expected_values(step, enum):
+    """Returns (values, results) where results is a list of (value, name)."""
+    if 'results' in step:
+        res = [(r['value'], r['name']) for r in step['results']]
+        if not res:
+            raise SpecError('empty results list')
+        return [v for v, _ in res], res
+    eq = step.get('equals')
+    if eq is None:
+        return None, None
+    if isinstance(eq, str):
+        eq = [eq]
+    return eq, None
+
+
+def check_values(values, enum):
+    for v in values:
+        if not re.match(r'^[A-Z0-9_]+$', v):
+            raise SpecError('bad %s value: %s' % (enum, v))
+
+
+def emit_match(var, enum, values, results, indent):
+    """Kernel and reference share this so both return identical levels."""
+    out = []
+    if results is not None:
+        for i, (v, _) in enumerate(results):
+            out.append('%sif (%s == Items::%s::%s) return %d;' % (indent, var, enum, v, i + 1))
+        out.append('%sreturn 0;' % indent)
+    elif values is not None:
+        cond = ' && '.join('%s != Items::%s::%s' % (var, enum, v) for v in values)
+        out.append('%sif (%s) return 0;' % (indent, cond))
+    return out
+
+
+def generate(spec, spec_path):
+    name = spec.get('name')
+    if not name or not re.match(r'^[a-z0-9_]+$', name):
+        raise SpecError('"name" must be lower_snake_case')
+    display = spec.get('display_name', camel(name) + ' Kernel Filter')
+    init_ante = int(spec.get('init_ante', 1))
+    steps = spec.get('steps', [])
+    if not steps:
+        raise SpecError('no steps')
+
+    cls = camel(name) + 'KernelFilter'
+    keys = Keys()
+    kernel = []
+    reference = []
+    result_names = None
+    mutable_locks = False
+
+    for idx, step in enumerate(steps):
+        op = step.get('op')
+        ante = int(step.get('ante', init_ante))
+        later = steps[idx + 1:]
+        last = idx == len(steps) - 1
+        results = None
+
+        if op == 'tag':
+            values, results = expected_values(step, 'Tag')
+            if values: check_values(values, 'Tag')
+            key = 'Tag%d' % ante
+            keys.add(key)
+            var = 'tag_%d' % idx
+            kernel.append('        // step %d: tag (ante %d)' % (idx, ante))
+            kernel.append('        Items::Tag %s = Kernel::randchoice(s, %s, %d, %s, %d, Items::ALL_TAGS, locks, showman);'
+                          % (var, keys.node(key), keys.ids[key], c_string(key), len(key)))
+            kernel.append('        if (s.overflow) return applyReference(seed);')
+            kernel.extend(emit_match(var, 'Tag', values, results, '        '))
+            reference.append('        Items::Tag %s = inst.nextTag_enum(%d);' % (var, ante))
+            reference.extend(emit_match(var, 'Tag', values, results, '        '))
+
+        elif op == 'arcana_pack':
+            size = int(step.get('size', 3))
+            require = step.get('require')
+            if require not in (None, 'soul'):
+                raise SpecError('arcana_pack only supports "require": "soul"')
+            if 'results' in step:
+                raise SpecError('arcana_pack cannot define results')
+            soul_key = 'soul_Tarot%d' % ante
+            tarot_key = 'Tarotar1%d' % ante
+            var = 'soul_%d' % idx
+            # Later packs read the tarot streams and the lock state this pack
+            # leaves behind; without one, only the soul draws are observable.
+            full = any(s.get('op') == 'arcana_pack' for s in later)
+            kernel.append('        // step %d: arcana pack (%d cards, ante %d)' % (idx, size, ante))
+            kernel.append('        if (locks.isVoucherActive(Items::Voucher::OMEN_GLOBE)) return applyReference(seed);')
+            kernel.append('        bool %s = false;' % var)
+            if full:
+                mutable_locks = True
+                keys.add(soul_key)
+                keys.add(tarot_key)
+                kernel.append('        {')
+                kernel.append('            Items::Tarot cards[%d];' % size)
+                kernel.append('            for (int i = 0; i < %d; i++) {' % size)
+                kernel.append('                Items::Tarot t;')
+                kernel.append('                if ((showman || !locks.isLocked(Items::Tarot::SPECIAL_THE_SOUL)) && Kernel::random(s, %s) > 0.997) {'
+                              % keys.node(soul_key))
+                kernel.append('                    t = Items::Tarot::SPECIAL_THE_SOUL;')
+                kernel.append('                } else {')
+                kernel.append('                    t = Kernel::randchoice(s, %s, %d, %s, %d, Items::ALL_TAROTS, locks, showman);'
+                              % (keys.node(tarot_key), keys.ids[tarot_key], c_string(tarot_key), len(tarot_key)))
+                kernel.append('                    if (s.overflow) return applyReference(seed);')
+                kernel.append('                }')
+                kernel.append('                if (t == Items::Tarot::SPECIAL_THE_SOUL) %s = true;' % var)
+                kernel.append('                if (!showman) locks.lock(t);')
+                kernel.append('                cards[i] = t;')
+                kernel.append('            }')
+                kernel.append('            for (int i = 0; i < %d; i++) locks.unlock(cards[i]);' % size)
+                kernel.append('        }')
+            elif require == 'soul':
+                keys.add(soul_key)
+                kernel.append('        if (showman || !locks.isLocked(Items::Tarot::SPECIAL_THE_SOUL)) {')
+                kernel.append('            for (int i = 0; i < %d; i++) {' % size)
+                kernel.append('                if (Kernel::random(s, %s) > 0.997) { %s = true; break; }'
+                              % (keys.node(soul_key), var))
+                kernel.append('            }')
+                kernel.append('        }')
+            if require == 'soul':
+                kernel.append('        if (!%s) return 0;' % var)
+            reference.append('        {')
+            reference.append('            auto pack = inst.nextArcanaPack_enum(%d, %d);' % (size, ante))
+            reference.append('            bool %s = false;' % var)
+            reference.append('            for (size_t i = 0; i < pack.tarots.size(); i++) {')
+            reference.append('                if (pack.isSpectral[i] ? pack.spectrals[i] == Items::Spectral::SPECTRAL_THE_SOUL')
+            reference.append('                                       : pack.tarots[i] == Items::Tarot::SPECIAL_THE_SOUL) %s = true;' % var)
+            reference.append('            }')
+            if require == 'soul':
+                reference.append('            if (!%s) return 0;' % var)
+            reference.append('        }')
+
+        elif op == 'soul_joker':
+            values, results = expected_values(step, 'Joker')
+            if values: check_values(values, 'Joker')
+            edi_key = 'edisou%d' % ante
+            var = 'joker_%d' % idx
+            kernel.append('        // step %d: soul joker (ante %d)' % (idx, ante))
+            # The edition poll only matters if a later soul joker shares its stream
+            if any(s.get('op') == 'soul_joker' and int(s.get('ante', init_ante)) == ante for s in later):
+                keys.add(edi_key)
+                kernel.append('        Kernel::random(s, %s);' % keys.node(edi_key))
+            new_key = 'Joker4'
+            old_key = 'Joker4sou%d' % ante
+            keys.add(new_key)
+            keys.add(old_key)
+            kernel.append('        Items::Joker %s = env.version > 10099' % var)
+            for k, sep in ((new_key, '?'), (old_key, ':')):
+                kernel.append('            %s Kernel::randchoice(s, %s, %d, %s, %d, Items::LEGENDARY_JOKERS, locks, showman)'
+                              % (sep, keys.node(k), keys.ids[k], c_string(k), len(k)))
+            kernel[-1] += ';'
+            kernel.append('        if (s.overflow) return applyReference(seed);')
+            kernel.extend(emit_match(var, 'Joker', values, results, '        '))
+            reference.append('        Items::Joker %s = inst.nextJoker_enum("sou", %d, false).joker;' % (var, ante))
+            reference.extend(emit_match(var, 'Joker', values, results, '        '))
+
+        else:
+            raise SpecError('unknown op: %r' % op)
+
+        if results is not None:
+            if not last:
+                raise SpecError('only the last step may define results')
+            result_names = [n for _, n in results]
+        kernel.append('')
+        reference.append('')
+
+    if result_names is None:
+        result_names = [display]
+        kernel.append('        return 1;')
+        reference.append('        return 1;')
+    else:
+        # emit_match already returned on every path
+        kernel.pop()
+        reference.pop()
+
+    locks_decl = ('        Locks::EnumLockSystem locks = env.locks;' if mutable_locks
+                  else '        const Locks::EnumLockSystem& locks = env.locks;')
+
+    out = []
+    out.append('#pragma once')
+    out.append('')
+    out.append('// Generated by tools/gen_kernel.py from %s. Do not edit.' % spec_path.replace('\\', '/'))
+    out.append('')
+    out.append('#include "../filter_base.hpp"')
+    out.append('#include "../../kernel_runtime.hpp"')
+    out.append('')
+    out.append('class %s final : public SearchFilter {' % cls)
+    out.append('public:')
+    out.append('    int apply(const std::string& seed, std::ostream& debugOut = std::cout) override {')
+    out.append('        const Kernel::PreparedEnv& env = Kernel::preparedEnv(%d);' % init_ante)
+    out.append('        Kernel::SeedState s;')
+    out.append('        if (!s.reset(seed)) return applyReference(seed);')
+    out.append(locks_decl)
+    out.append('        const bool showman = env.showman;')
+    out.extend(keys.emit_decls())
+    out.append('')
+    out.extend(kernel)
+    out.append('    }')
+    out.append('')
+    out.append('    // Same steps through Instance; used when the kernel bails out and by')
+    out.append('    // tools/kernel_equivalence_test.cpp')
+    out.append('    int applyReference(const std::string& seed) const {')
+    out.append('        Instance::Instance inst(seed);')
+    out.append('        EnvConfig e = getGlobalEnv();')
+    out.append('        if (!e.deck.empty()) inst.setDeck(e.deck);')
+    out.append('        if (!e.stake.empty()) inst.setStake(e.stake);')
+    out.append('        inst.setShowman(e.showman);')
+    out.append('        inst.setSixesFactor(e.sixesFactor);')
+    out.append('        inst.setVersion(e.version);')
+    out.append('        inst.setForceAllContent(e.forceAllContent);')
+    out.append('        inst.initLocks(%d, e.freshProfile, e.freshRun);' % init_ante)
+    out.append('')
+    out.extend(reference)
+    out.append('    }')
+    out.append('')
+    out.append('    std::vector<std::string> getResultNames() const override {')
+    out.append('        return {%s};' % ', '.join(c_string(n) for n in result_names))
+    out.append('    }')
+    out.append('')
+    out.append('    std::string getName() const override {')
+    out.append('        return %s;' % c_string(display))
+    out.append('    }')
+    out.append('')
+    out.append('private:')
+    out.extend(keys.emit_functions())
+    if out[-1] == '':
+        out.pop()
+    out.append('};')
+    out.append('')
+    out.append('using GeneratedKernelFilter = %s;' % cls)
+    out.append('#define SELECTED_FILTER_TYPE %s' % cls)
+    out.append('')
+    out.append('std::unique_ptr<SearchFilter> createFilter() {')
+    out.append('    return std::make_unique<%s>();' % cls)
+    out.append('}')
+    out.append('')
+    return '\n'.join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Generate a straight-line filter kernel from a JSON spec')
+    ap.add_argument('spec')
+    ap.add_argument('-o', '--output', help='output header (default: filters/generated/<name>_kernel_filter.hpp)')
+    args = ap.parse_args()
+
+    with open(args.spec) as f:
+        spec = json.load(f)
+    try:
+        text = generate(spec, os.path.relpath(args.spec))
+    except SpecError as e:
+        print('%s: %s' % (args.spec, e), file=sys.stderr)
+        return 1
+
+    out = args.output or os.path.join('filters', 'generated', '%s_kernel_filter.hpp' % spec['name'])
+    os.makedirs(os.path.dirname(out) or '.', exist_ok=True)
+    with open(out, 'w') as f:
+        f.write(text)
+    print(out)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,159 @@
+// Parity test for Instance::InstanceBatch against Instance::Instance.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/instance_batch_test tools/instance_batch_test.cpp env.cpp
+// Each lane runs the same scenario as a scalar Instance: tag, arcana pack,
+// soul joker, a run of shop items, then a second ante where some lanes are
+// masked out. Exits non-zero on the first mismatch.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "instance_batch.hpp"
+#include "seed_util.hpp"
+
+constexpr size_t LANES = 8;
+constexpr int SHOP_ITEMS = 6;
+
+struct Scenario {
+    std::string name;
+    EnvConfig env;
+};
+
+struct LaneResult {
+    std::vector<int> values;
+};
+
+static int shopValue(const Items::OptimizedShopItem& item) {
+    int v = static_cast<int>(item.type) * 1000 + item.item.raw_value;
+    if (item.type == Items::OptimizedShopItem::Type::JOKER) {
+        const auto& d = item.joker_data;
+        v = v * 100 + static_cast<int>(d.edition) * 8 + d.eternal * 4 + d.perishable * 2 + d.rental;
+    }
+    return v;
+}
+
+static int jokerValue(const Items::OptimizedJokerData& d) {
+    return static_cast<int>(d.joker) * 100 + static_cast<int>(d.edition);
+}
+
+// Lanes drop out of the second ante when their first tag is odd
+static bool keepsSecondAnte(Items::Tag tag) { return static_cast<int>(tag) % 2 == 0; }
+
+static LaneResult runScalar(const std::string& seed, const EnvConfig& e) {
+    Instance::Instance inst(seed);
+    inst.setDeck(e.deck);
+    inst.setStake(e.stake);
+    inst.setShowman(e.showman);
+    inst.setVersion(e.version);
+    inst.initLocks(1, e.freshProfile, e.freshRun);
+
+    LaneResult r;
+    Items::Tag tag = inst.nextTag_enum(1);
+    r.values.push_back(static_cast<int>(tag));
+    auto pack = inst.nextArcanaPack_enum(5, 1);
+    for (size_t i = 0; i < pack.tarots.size(); i++) {
+        r.values.push_back(pack.isSpectral[i] ? 1000 + static_cast<int>(pack.spectrals[i]) : static_cast<int>(pack.tarots[i]));
+    }
+    r.values.push_back(jokerValue(inst.nextJoker_enum("sou", 1, false)));
+    for (int i = 0; i < SHOP_ITEMS; i++) r.values.push_back(shopValue(inst.nextShopItem_enum(1)));
+    if (keepsSecondAnte(tag)) {
+        r.values.push_back(static_cast<int>(inst.nextTag_enum(2)));
+        auto pack2 = inst.nextArcanaPack_enum(3, 2);
+        for (size_t i = 0; i < pack2.tarots.size(); i++) r.values.push_back(static_cast<int>(pack2.tarots[i]));
+        r.values.push_back(jokerValue(inst.nextJoker_enum("buf", 2, true)));
+        for (int i = 0; i < SHOP_ITEMS; i++) r.values.push_back(shopValue(inst.nextShopItem_enum(2)));
+    }
+    return r;
+}
+
+static std::vector<LaneResult> runBatch(Instance::InstanceBatch<LANES>& batch, const std::vector<std::string>& seeds) {
+    using Batch = Instance::InstanceBatch<LANES>;
+    std::vector<LaneResult> r(LANES);
+    Batch::LaneMask lanes = batch.reset(seeds.data(), seeds.size());
+    auto each = [&](Batch::LaneMask m, auto fn) {
+        for (size_t l = 0; l < LANES; l++) if (m & Batch::laneBit(l)) fn(l);
+    };
+
+    Items::Tag tags[LANES];
+    batch.nextTag(1, lanes, tags);
+    each(lanes, [&](size_t l) { r[l].values.push_back(static_cast<int>(tags[l])); });
+    Batch::ArcanaPack pack;
+    batch.nextArcanaPack(5, 1, lanes, pack);
+    for (int i = 0; i < pack.size; i++) {
+        each(lanes, [&](size_t l) {
+            bool spectral = pack.isSpectral[i] & Batch::laneBit(l);
+            r[l].values.push_back(spectral ? 1000 + static_cast<int>(pack.spectrals[i][l]) : static_cast<int>(pack.tarots[i][l]));
+        });
+    }
+    Items::OptimizedJokerData jokers[LANES];
+    batch.nextJoker("sou", 1, false, lanes, jokers);
+    each(lanes, [&](size_t l) { r[l].values.push_back(jokerValue(jokers[l])); });
+    Items::OptimizedShopItem shop[LANES];
+    for (int i = 0; i < SHOP_ITEMS; i++) {
+        batch.nextShopItem(1, lanes, shop);
+        each(lanes, [&](size_t l) { r[l].values.push_back(shopValue(shop[l])); });
+    }
+
+    Batch::LaneMask second = 0;
+    each(lanes, [&](size_t l) { if (keepsSecondAnte(tags[l])) second |= Batch::laneBit(l); });
+    batch.nextTag(2, second, tags);
+    each(second, [&](size_t l) { r[l].values.push_back(static_cast<int>(tags[l])); });
+    batch.nextArcanaPack(3, 2, second, pack);
+    for (int i = 0; i < pack.size; i++) {
+        each(second, [&](size_t l) { r[l].values.push_back(static_cast<int>(pack.tarots[i][l])); });
+    }
+    batch.nextJoker("buf", 2, true, second, jokers);
+    each(second, [&](size_t l) { r[l].values.push_back(jokerValue(jokers[l])); });
+    for (int i = 0; i < SHOP_ITEMS; i++) {
+        batch.nextShopItem(2, second, shop);
+        each(second, [&](size_t l) { r[l].values.push_back(shopValue(shop[l])); });
+    }
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+
+    std::vector<Scenario> scenarios;
+    scenarios.push_back({"default", EnvConfig()});
+    EnvConfig showman; showman.showman = true;
+    scenarios.push_back({"showman", showman});
+    EnvConfig fresh; fresh.freshProfile = true; fresh.freshRun = true;
+    scenarios.push_back({"fresh profile+run", fresh});
+    EnvConfig gold; gold.stake = "Gold Stake"; gold.deck = "Ghost Deck";
+    scenarios.push_back({"gold stake, ghost deck", gold});
+    EnvConfig legacy; legacy.stake = "Gold Stake"; legacy.version = 10103;
+    scenarios.push_back({"gold stake, version 10103", legacy});
+    EnvConfig old; old.stake = "Orange Stake"; old.version = 10099;
+    scenarios.push_back({"orange stake, version 10099", old});
+
+    int failures = 0;
+    for (const auto& sc : scenarios) {
+        setGlobalEnv(sc.env);
+        Instance::InstanceBatch<LANES> batch;
+        batch.setDeck(sc.env.deck);
+        batch.setStake(sc.env.stake);
+        batch.setShowman(sc.env.showman);
+        batch.setVersion(sc.env.version);
+        batch.initLocks(1, sc.env.freshProfile, sc.env.freshRun);
+
+        for (uint64_t base = 0; base < count && failures == 0; base += LANES) {
+            std::vector<std::string> seeds;
+            // The final batch is partial to exercise inactive lanes
+            size_t n = (base + LANES > count) ? static_cast<size_t>(count - base) : LANES;
+            for (size_t l = 0; l < n; l++) seeds.push_back(numberToSeed((base + l) * 7919ull * 104729ull % 1785793904896ull));
+            auto got = runBatch(batch, seeds);
+            for (size_t l = 0; l < n; l++) {
+                auto want = runScalar(seeds[l], sc.env);
+                if (want.values != got[l].values) {
+                    std::cerr << "MISMATCH [" << sc.name << "] seed " << seeds[l] << " lane " << l << std::endl;
+                    failures++;
+                }
+            }
+        }
+        std::cout << sc.name << ": " << count << " seeds " << (failures ? "FAILED" : "ok") << std::endl;
+        if (failures) break;
+    }
+    return failures ? 1 : 0;
+}
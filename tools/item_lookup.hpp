@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include "../items_to_string.hpp"
+
+// Item names as typed on the command line, matched against Items::toString()
+// ignoring case, spaces and punctuation ("the soul" finds The Soul).
+namespace ItemLookup {
+
+    inline std::string normalize(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (std::isalnum(static_cast<unsigned char>(c))) out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        }
+        return out;
+    }
+
+    template<typename EnumType>
+    bool lookup(const std::string& name, EnumType& out) {
+        const std::string n = normalize(name);
+        for (size_t i = 0; i < static_cast<size_t>(EnumType::COUNT); i++) {
+            if (normalize(Items::toString(static_cast<EnumType>(i))) == n) {
+                out = static_cast<EnumType>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace ItemLookup
@@ -0,0 +1,95 @@
+// Equivalence harness for generated filter kernels.
+// Build with tools/build-kernel.sh, or by hand:
+//   g++ -std=c++14 -O3 -ffp-contract=off -I. \
+//       -DKERNEL_HEADER="\"filters/generated/perkeo_kernel_filter.hpp\"" \
+//       -o dist/kernel_equivalence_perkeo tools/kernel_equivalence_test.cpp env.cpp
+// Runs the kernel and its Instance reference path over the same seeds under
+// several env configurations and exits non-zero on the first mismatch.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "seed_util.hpp"
+
+#ifndef KERNEL_HEADER
+#error "Define KERNEL_HEADER to the generated filter header"
+#endif
+#include KERNEL_HEADER
+
+struct NamedEnv {
+    std::string name;
+    EnvConfig env;
+};
+
+static std::vector<NamedEnv> envConfigs() {
+    std::vector<NamedEnv> out;
+    out.push_back({"default", EnvConfig()});
+
+    EnvConfig showman;
+    showman.showman = true;
+    out.push_back({"showman", showman});
+
+    EnvConfig fresh;
+    fresh.freshProfile = true;
+    fresh.freshRun = true;
+    out.push_back({"fresh profile+run", fresh});
+
+    EnvConfig legacy;
+    legacy.version = 10099;
+    out.push_back({"version 10099", legacy});
+
+    EnvConfig tags;
+    tags.freshProfile = true;
+    tags.unlockedTags = {"Negative Tag", "Foil Tag"};
+    out.push_back({"fresh profile, unlocked tags", tags});
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    GeneratedKernelFilter filter;
+    std::vector<std::string> extraSeeds = {"", "A", "7LB2WV", "ABCDEFGHIJK", "PERKEOPERKEO123"};
+    int failures = 0;
+
+    for (const auto& cfg : envConfigs()) {
+        setGlobalEnv(cfg.env);
+        uint64_t matches = 0;
+        double kernelSec = 0, referenceSec = 0;
+
+        auto check = [&](const std::string& seed) {
+            auto t0 = std::chrono::steady_clock::now();
+            int k = filter.apply(seed);
+            auto t1 = std::chrono::steady_clock::now();
+            int r = filter.applyReference(seed);
+            auto t2 = std::chrono::steady_clock::now();
+            kernelSec += std::chrono::duration<double>(t1 - t0).count();
+            referenceSec += std::chrono::duration<double>(t2 - t1).count();
+            if (k != r) {
+                std::cerr << "MISMATCH [" << cfg.name << "] seed '" << seed
+                          << "': kernel=" << k << " reference=" << r << std::endl;
+                failures++;
+            }
+            if (r > 0) matches++;
+        };
+
+        // A contiguous block (low characters vary) and a prime stride (all vary)
+        for (uint64_t i = 0; i < count / 2; i++) check(numberToSeed(i));
+        for (uint64_t i = 0; i < count - count / 2; i++) check(numberToSeed(i * 7919ull * 104729ull % 1785793904896ull));
+        for (const auto& seed : extraSeeds) check(seed);
+
+        std::cout << cfg.name << ": " << count + extraSeeds.size() << " seeds, " << matches
+                  << " matches, kernel " << (kernelSec > 0 ? count / kernelSec : 0) << " seeds/s, reference "
+                  << (referenceSec > 0 ? count / referenceSec : 0) << " seeds/s" << std::endl;
+        if (failures > 0) break;
+    }
+
+    if (failures > 0) {
+        std::cerr << filter.getName() << ": " << failures << " mismatches" << std::endl;
+        return 1;
+    }
+    std::cout << filter.getName() << ": kernel matches reference" << std::endl;
+    return 0;
+}
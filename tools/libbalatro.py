@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""ctypes wrapper for libbalatro (libbalatro.h), built by tools/build-lib.sh.
+
+Seeds go in and results come out as flat arrays that the library reads and
+writes in place: numpy arrays when numpy is installed, array.array otherwise.
+A uint64 numpy array (or array.array('Q')) of seed numbers is passed without
+a copy; anything else (seed strings, lists of ints) is converted first.
+
+    lib = Library('dist/libbalatro_enum_perkeo.so')
+    with lib.env({'deck': 'Ghost Deck'}) as env:
+        levels = lib.evaluate(env, numpy.arange(0, 10**6, dtype=numpy.uint64))
+        cols = lib.features(env, ['AAAAAAAA', 'BBBBBBBB'], shop_slots=4)
+        cols['shop1']        # uint16 codes; lib.feature_value_name(4, 'shop1', code)
+
+Usage: python3 tools/libbalatro.py LIB SEED...   # prints each seed's level and name
+"""
+
+import array
+import ctypes
+import json
+import sys
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+ABI_VERSION = 1  # libbalatro.h BALATRO_ABI_VERSION
+
+_u64_p = ctypes.POINTER(ctypes.c_uint64)
+
+
+class LibbalatroError(Exception):
+    pass
+
+
+def _new_u16(count):
+    if numpy is not None:
+        return numpy.zeros(count, dtype=numpy.uint16)
+    return array.array('H', bytes(2 * count))
+
+
+def _address(buf):
+    if numpy is not None and isinstance(buf, numpy.ndarray):
+        return buf.ctypes.data
+    return buf.buffer_info()[0] if len(buf) else 0
+
+
+def _check_u16(out, count):
+    """`out` as a writable uint16 buffer of `count` values, or an error."""
+    if numpy is not None and isinstance(out, numpy.ndarray):
+        ok = out.dtype == numpy.uint16 and out.flags.c_contiguous and out.flags.writeable
+    else:
+        ok = isinstance(out, array.array) and out.typecode == 'H'
+    if not ok or len(out) != count:
+        raise LibbalatroError('output arrays must be %d contiguous writable uint16 values' % count)
+    return out
+
+
+class Env:
+    """An environment handle; close() it, or use it as a context manager."""
+
+    def __init__(self, lib, handle):
+        self._lib = lib
+        self.handle = handle
+
+    def close(self):
+        if self.handle:
+            self._lib.balatro_env_destroy(self.handle)
+            self.handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+
+class Library:
+    def __init__(self, path):
+        self._lib = lib = ctypes.CDLL(path)
+        lib.balatro_abi_version.restype = ctypes.c_int
+        lib.balatro_last_error.restype = ctypes.c_char_p
+        lib.balatro_filter_name.restype = ctypes.c_char_p
+        lib.balatro_result_count.restype = ctypes.c_int
+        lib.balatro_result_name.argtypes = [ctypes.c_int]
+        lib.balatro_result_name.restype = ctypes.c_char_p
+        lib.balatro_seed_to_number.argtypes = [ctypes.c_char_p, _u64_p]
+        lib.balatro_number_to_seed.argtypes = [ctypes.c_uint64, ctypes.c_char_p]
+        lib.balatro_env_create.argtypes = [ctypes.c_char_p]
+        lib.balatro_env_create.restype = ctypes.c_void_p
+        lib.balatro_env_destroy.argtypes = [ctypes.c_void_p]
+        lib.balatro_env_destroy.restype = None
+        lib.balatro_evaluate.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p, ctypes.c_int]
+        lib.balatro_feature_count.argtypes = [ctypes.c_int]
+        lib.balatro_feature_name.argtypes = [ctypes.c_int, ctypes.c_int]
+        lib.balatro_feature_name.restype = ctypes.c_char_p
+        lib.balatro_feature_value_name.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_uint16]
+        lib.balatro_feature_value_name.restype = ctypes.c_char_p
+        lib.balatro_features.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t, ctypes.c_int,
+                                         ctypes.POINTER(ctypes.c_void_p), ctypes.c_int]
+        if lib.balatro_abi_version() != ABI_VERSION:
+            raise LibbalatroError('%s has ABI version %d, this wrapper expects %d'
+                                  % (path, lib.balatro_abi_version(), ABI_VERSION))
+        self.filter_name = lib.balatro_filter_name().decode()
+        self.result_names = [lib.balatro_result_name(level).decode()
+                             for level in range(1, lib.balatro_result_count() + 1)]
+
+    def _check(self, code):
+        if code != 0:
+            raise LibbalatroError(self._lib.balatro_last_error().decode())
+
+    def result_name(self, level):
+        """Name of a match level; '' for 0 (no match)."""
+        return self.result_names[level - 1] if 0 < level <= len(self.result_names) else ''
+
+    def seed_to_number(self, seed):
+        out = ctypes.c_uint64()
+        self._check(self._lib.balatro_seed_to_number(seed.encode(), ctypes.byref(out)))
+        return out.value
+
+    def number_to_seed(self, number):
+        out = ctypes.create_string_buffer(9)
+        self._check(self._lib.balatro_number_to_seed(number, out))
+        return out.value.decode()
+
+    def env(self, config=None):
+        """Env from a dict (as in an --env file), a JSON string, or None for the defaults."""
+        text = config if isinstance(config, str) or config is None else json.dumps(config)
+        handle = self._lib.balatro_env_create(text.encode() if text is not None else None)
+        if not handle:
+            raise LibbalatroError(self._lib.balatro_last_error().decode())
+        return Env(self._lib, handle)
+
+    def _seeds(self, seeds):
+        """Seed numbers as a contiguous uint64 buffer, copying only when needed."""
+        if numpy is not None and isinstance(seeds, numpy.ndarray) and seeds.dtype == numpy.uint64:
+            return numpy.ascontiguousarray(seeds)
+        if isinstance(seeds, array.array) and seeds.typecode == 'Q':
+            return seeds
+        numbers = [self.seed_to_number(s) if isinstance(s, str) else int(s) for s in seeds]
+        if numpy is not None:
+            return numpy.array(numbers, dtype=numpy.uint64)
+        return array.array('Q', numbers)
+
+    def evaluate(self, env, seeds, threads=0, out=None):
+        """Match level of each seed (0 = no match), as a uint16 array."""
+        buf = self._seeds(seeds)
+        levels = _check_u16(out, len(buf)) if out is not None else _new_u16(len(buf))
+        self._check(self._lib.balatro_evaluate(env.handle, _address(buf), len(buf), _address(levels), threads))
+        return levels
+
+    def feature_names(self, shop_slots=4):
+        count = self._lib.balatro_feature_count(shop_slots)
+        self._check(min(count, 0))
+        return [self._lib.balatro_feature_name(shop_slots, c).decode() for c in range(count)]
+
+    def feature_value_name(self, shop_slots, column, value):
+        """Name of a feature code, e.g. 'Blueprint'; '' for an empty slot. `column` is a name or index."""
+        if isinstance(column, str):
+            column = self.feature_names(shop_slots).index(column)
+        name = self._lib.balatro_feature_value_name(shop_slots, column, value)
+        return name.decode() if name is not None else None
+
+    def features(self, env, seeds, shop_slots=4, threads=0, out=None):
+        """Ante-1 feature columns as {name: uint16 array}. `out` may supply the arrays, by name."""
+        buf = self._seeds(seeds)
+        names = self.feature_names(shop_slots)
+        if out is not None:
+            columns = {name: _check_u16(out[name], len(buf)) for name in names}
+        elif numpy is not None:
+            # One block, so each column is a contiguous row of it
+            block = numpy.zeros((len(names), len(buf)), dtype=numpy.uint16)
+            columns = {name: block[c] for c, name in enumerate(names)}
+        else:
+            columns = {name: _new_u16(len(buf)) for name in names}
+        pointers = (ctypes.c_void_p * len(names))(*[_address(columns[name]) for name in names])
+        self._check(self._lib.balatro_features(env.handle, _address(buf), len(buf), shop_slots, pointers, threads))
+        return columns
+
+
+def main(argv):
+    if len(argv) < 3:
+        print(__doc__.strip().splitlines()[-1], file=sys.stderr)
+        return 2
+    lib = Library(argv[1])
+    with lib.env() as env:
+        levels = lib.evaluate(env, argv[2:])
+    for seed, level in zip(argv[2:], levels):
+        print('%s,%d,%s' % (seed, level, lib.result_name(level)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
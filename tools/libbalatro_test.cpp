@@ -0,0 +1,218 @@
+// Tests for libbalatro: loads the built library the way ctypes does and checks
+// its levels and feature columns against the filter and schema run in this
+// process, for two environments and several thread counts.
+// Build from the repo root (tools/build-lib.sh does both steps):
+//   g++ -std=c++14 -O2 -I. -ffp-contract=off -DSELECTED_FILTER="\"filters/<f>_filter.hpp\"" \
+//       -o dist/libbalatro_test tools/libbalatro_test.cpp env.cpp -ldl -lpthread
+// Usage: dist/libbalatro_test dist/libbalatro_<f>.so [seed_count]
+// The library must be built from the same filter as this test.
+
+#include <dlfcn.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "libbalatro.h"
+#include "env.hpp"
+#include "seed_util.hpp"
+#include "filters/filter_base.hpp"
+#include SELECTED_FILTER
+#include "search_driver.hpp"
+#include "tools/feature_columns.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+// The library's entry points, resolved with dlsym
+struct Api {
+    decltype(&balatro_abi_version) abiVersion;
+    decltype(&balatro_last_error) lastError;
+    decltype(&balatro_filter_name) filterName;
+    decltype(&balatro_result_count) resultCount;
+    decltype(&balatro_result_name) resultName;
+    decltype(&balatro_seed_to_number) seedToNumber;
+    decltype(&balatro_number_to_seed) numberToSeed;
+    decltype(&balatro_env_create) envCreate;
+    decltype(&balatro_env_destroy) envDestroy;
+    decltype(&balatro_evaluate) evaluate;
+    decltype(&balatro_feature_count) featureCount;
+    decltype(&balatro_feature_name) featureName;
+    decltype(&balatro_feature_value_name) featureValueName;
+    decltype(&balatro_features) features;
+};
+
+template<typename Fn>
+static bool resolve(void* lib, const char* name, Fn& out) {
+    out = reinterpret_cast<Fn>(dlsym(lib, name));
+    if (!out) std::cerr << "missing symbol " << name << std::endl;
+    return out != nullptr;
+}
+
+static bool load(const char* path, Api& api) {
+    void* lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) {
+        std::cerr << "dlopen: " << dlerror() << std::endl;
+        return false;
+    }
+    return resolve(lib, "balatro_abi_version", api.abiVersion) && resolve(lib, "balatro_last_error", api.lastError) &&
+           resolve(lib, "balatro_filter_name", api.filterName) && resolve(lib, "balatro_result_count", api.resultCount) &&
+           resolve(lib, "balatro_result_name", api.resultName) && resolve(lib, "balatro_seed_to_number", api.seedToNumber) &&
+           resolve(lib, "balatro_number_to_seed", api.numberToSeed) && resolve(lib, "balatro_env_create", api.envCreate) &&
+           resolve(lib, "balatro_env_destroy", api.envDestroy) && resolve(lib, "balatro_evaluate", api.evaluate) &&
+           resolve(lib, "balatro_feature_count", api.featureCount) && resolve(lib, "balatro_feature_name", api.featureName) &&
+           resolve(lib, "balatro_feature_value_name", api.featureValueName) && resolve(lib, "balatro_features", api.features);
+}
+
+struct VectorWriter {
+    std::vector<std::vector<uint16_t>>& columns;
+    void set(size_t column, uint64_t row, uint16_t value) { columns[column][row] = value; }
+};
+
+static void testNames(const Api& api, const SearchDriver<SelectedFilterType>& driver, const SearchFilter& filter) {
+    expect(api.abiVersion() == BALATRO_ABI_VERSION, "ABI version");
+    expect(filter.getName() == api.filterName(), "filter name");
+    const auto& names = driver.resultNames();
+    expect(api.resultCount() == static_cast<int>(names.size()), "result count");
+    for (size_t i = 0; i < names.size(); i++) {
+        const char* name = api.resultName(static_cast<int>(i + 1));
+        expect(name && names[i] == name, "result name " + std::to_string(i + 1));
+    }
+    expect(!api.resultName(0) && !api.resultName(static_cast<int>(names.size()) + 1), "result names are 1-based");
+
+    uint64_t n = 0;
+    char seed[9];
+    expect(api.seedToNumber("ZZZZZZZZ", &n) == BALATRO_OK && n == seedToNumber("ZZZZZZZZ"), "seed to number");
+    expect(api.numberToSeed(n, seed) == BALATRO_OK && std::string(seed) == "ZZZZZZZZ", "number to seed");
+    expect(api.seedToNumber("ZZZZZZZ", &n) == BALATRO_EINVAL && *api.lastError(), "short seed rejected");
+    expect(api.seedToNumber("ZZZZZZZ0", &n) == BALATRO_EINVAL, "'0' is not a seed character");
+    expect(api.numberToSeed(SEED_COUNT, seed) == BALATRO_EINVAL, "seed number out of range");
+}
+
+static void testEnv(const Api& api, SearchDriver<SelectedFilterType>& driver, const char* json, const std::vector<uint64_t>& seeds) {
+    const std::string label = std::string("env ") + json;
+    EnvConfig config;
+    expect(parseEnvJson(json, config), label + " parses");
+    balatro_env* env = api.envCreate(json);
+    expect(env != nullptr, label + " created");
+    if (!env) return;
+
+    // Direct results, in this process
+    setGlobalEnv(config);
+    std::ostream discard(nullptr);
+    std::vector<uint16_t> direct(seeds.size());
+    for (size_t i = 0; i < seeds.size(); i++) direct[i] = static_cast<uint16_t>(driver.apply(numberToSeed(seeds[i]), discard));
+
+    const int shopSlots = 4;
+    const FeatureColumns::Schema schema(shopSlots);
+    std::vector<std::vector<uint16_t>> directColumns(schema.columns().size(), std::vector<uint16_t>(seeds.size()));
+    VectorWriter dw{directColumns};
+    for (size_t i = 0; i < seeds.size(); i++) schema.extract(numberToSeed(seeds[i]), config, dw, i);
+
+    expect(api.featureCount(shopSlots) == static_cast<int>(schema.columns().size()), "feature count");
+    for (size_t c = 0; c < schema.columns().size(); c++) {
+        const char* name = api.featureName(shopSlots, static_cast<int>(c));
+        expect(name && schema.columns()[c].spec.name == name, "feature name " + std::to_string(c));
+    }
+
+    for (int threads : {1, 3, 0}) {
+        const std::string at = label + " threads=" + std::to_string(threads);
+        std::vector<uint16_t> levels(seeds.size(), 0xFFFF);
+        expect(api.evaluate(env, seeds.data(), seeds.size(), levels.data(), threads) == BALATRO_OK, at + " evaluate");
+        expect(levels == direct, at + " levels match the filter");
+
+        std::vector<std::vector<uint16_t>> columns(schema.columns().size(), std::vector<uint16_t>(seeds.size(), 0xFFFF));
+        std::vector<uint16_t*> pointers;
+        for (auto& c : columns) pointers.push_back(c.data());
+        expect(api.features(env, seeds.data(), seeds.size(), shopSlots, pointers.data(), threads) == BALATRO_OK, at + " features");
+        expect(columns == directColumns, at + " features match the schema");
+    }
+
+    // Every value written is nameable
+    for (size_t c = 0; c < directColumns.size(); c++) {
+        for (uint16_t v : directColumns[c]) {
+            if (!api.featureValueName(shopSlots, static_cast<int>(c), v)) {
+                expect(false, label + " unnamed value in " + schema.columns()[c].spec.name);
+                break;
+            }
+        }
+    }
+    api.envDestroy(env);
+}
+
+// Tags unlocked by the env reach the tag columns, even with no evaluate call to install the env first
+static void testUnlockedTags(const Api& api, const std::vector<uint64_t>& seeds) {
+    const char* json = "{\"unlockedTags\": [\"Meteor Tag\", \"Buffoon Tag\", \"Handy Tag\"]}";
+    EnvConfig config;
+    expect(parseEnvJson(json, config) && config.unlockedTags.size() == 3, "unlockedTags parses");
+    balatro_env* env = api.envCreate(json);
+    expect(env != nullptr, "unlockedTags env created");
+    if (!env) return;
+
+    const int shopSlots = 1;
+    const FeatureColumns::Schema schema(shopSlots);
+    std::vector<std::vector<uint16_t>> unlocked(schema.columns().size(), std::vector<uint16_t>(seeds.size()));
+    std::vector<std::vector<uint16_t>> locked = unlocked;
+    VectorWriter uw{unlocked}, lw{locked};
+    setGlobalEnv(config);
+    for (size_t i = 0; i < seeds.size(); i++) schema.extract(numberToSeed(seeds[i]), config, uw, i);
+    setGlobalEnv(EnvConfig());
+    for (size_t i = 0; i < seeds.size(); i++) schema.extract(numberToSeed(seeds[i]), EnvConfig(), lw, i);
+    expect(unlocked != locked, "unlocked tags change some tag columns");
+
+    std::vector<std::vector<uint16_t>> columns(schema.columns().size(), std::vector<uint16_t>(seeds.size(), 0xFFFF));
+    std::vector<uint16_t*> pointers;
+    for (auto& c : columns) pointers.push_back(c.data());
+    expect(api.features(env, seeds.data(), seeds.size(), shopSlots, pointers.data(), 0) == BALATRO_OK, "unlockedTags features");
+    expect(columns == unlocked, "features apply the env's unlocked tags");
+    api.envDestroy(env);
+}
+
+static void testErrors(const Api& api) {
+    balatro_env* env = api.envCreate(nullptr);
+    expect(env != nullptr, "null JSON gives the default env");
+    expect(!api.envCreate("{\"deck\": "), "malformed env rejected");
+    expect(*api.lastError() != '\0', "env error message");
+
+    const uint64_t bad[] = {0, SEED_COUNT};
+    uint16_t levels[2];
+    expect(api.evaluate(env, bad, 2, levels, 0) == BALATRO_EINVAL, "out-of-range seed number rejected");
+    expect(std::string(api.lastError()).find("seeds[1]") != std::string::npos, "error names the bad index");
+    expect(api.evaluate(nullptr, bad, 1, levels, 0) == BALATRO_EINVAL, "null env rejected");
+    expect(api.evaluate(env, nullptr, 0, nullptr, 0) == BALATRO_OK, "empty batch");
+    expect(api.featureCount(0) == BALATRO_EINVAL && api.featureCount(FeatureColumns::MAX_SHOP_SLOTS + 1) == BALATRO_EINVAL,
+           "shop slot range");
+    uint16_t* columns[1] = {nullptr};
+    expect(api.features(env, bad, 1, 1, columns, 0) == BALATRO_EINVAL, "null column rejected");
+    api.envDestroy(env);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <libbalatro path> [seed_count]" << std::endl;
+        return 2;
+    }
+    const size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 3000;
+    Api api;
+    if (!load(argv[1], api)) return 2;
+
+    std::unique_ptr<SearchFilter> filter(createFilter());
+    SearchDriver<SelectedFilterType> driver = makeSelectedDriver(*filter);
+
+    // Spread over the whole seed space rather than one prefix
+    std::vector<uint64_t> seeds;
+    for (size_t i = 0; i < count; i++) seeds.push_back((SEED_COUNT / count) * i + i % 97);
+
+    testNames(api, driver, *filter);
+    testEnv(api, driver, "{}", seeds);
+    testEnv(api, driver, "{\"deck\": \"Ghost Deck\", \"stake\": \"Gold Stake\", \"freshProfile\": true}", seeds);
+    testUnlockedTags(api, seeds);
+    testErrors(api);
+    std::cout << "libbalatro: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
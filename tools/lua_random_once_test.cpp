@@ -0,0 +1,128 @@
+// Parity test for lua_random_once()/lua_randint_once() against LuaRandom.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/lua_random_once_test tools/lua_random_once_test.cpp
+// Usage: dist/lua_random_once_test [random_count]
+// Checks every table entry against eleven real generator steps, then compares
+// both paths on special values, random doubles, random bit patterns and node
+// values taken from real seeds, and prints the per-draw cost of each path.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "rand_util.hpp"
+#include "seed_util.hpp"
+
+using namespace std::chrono;
+
+static int failures = 0;
+
+static uint64_t bitsOf(double d) {
+    uint64_t u;
+    std::memcpy(&u, &d, sizeof(u));
+    return u;
+}
+
+static double fromBits(uint64_t u) {
+    double d;
+    std::memcpy(&d, &u, sizeof(d));
+    return d;
+}
+
+static void check(double seed) {
+    LuaRandom rng(seed);
+    const double want = rng.random();
+    const double got = lua_random_once(seed);
+    // Compare bit patterns so NaN seeds are checked too
+    if (bitsOf(want) != bitsOf(got)) {
+        if (failures++ < 10) {
+            std::cerr << "MISMATCH seed bits 0x" << std::hex << bitsOf(seed) << std::dec
+                      << ": " << want << " vs " << got << std::endl;
+        }
+    }
+    static const int RANGES[][2] = {{0, 1}, {0, 4}, {1, 6}, {0, 51}, {0, 149}, {-3, 3}};
+    for (const auto& r : RANGES) {
+        if (LuaRandom(seed).randint(r[0], r[1]) != lua_randint_once(seed, r[0], r[1])) {
+            if (failures++ < 10) std::cerr << "MISMATCH randint seed " << seed << std::endl;
+        }
+    }
+}
+
+// Each table entry must equal eleven steps of the generator from a state
+// holding only that byte; by linearity this covers every possible state
+static void checkTables() {
+    const LuaRandomJump::Table& t = LuaRandomJump::Tables<>::value;
+    for (int w = 0; w < 4; w++) {
+        for (int b = 0; b < 8; b++) {
+            for (uint64_t v = 0; v < 256; v++) {
+                LuaRandom rng(0);
+                for (int i = 0; i < 4; i++) rng.state[i] = 0;
+                rng.state[w] = v << (b * 8);
+                uint64_t out = 0;
+                for (int i = 0; i < LuaRandomJump::STEPS; i++) out = rng._randint();
+                if (out != t.byWord[w][b][v] && failures++ < 10) {
+                    std::cerr << "TABLE MISMATCH word " << w << " byte " << b << " value " << v << std::endl;
+                }
+            }
+        }
+    }
+}
+
+template<typename Fn>
+static double nsPerDraw(const std::vector<double>& seeds, Fn fn) {
+    double sink = 0;
+    auto t0 = steady_clock::now();
+    for (double s : seeds) sink += fn(s);
+    double ns = duration<double, std::nano>(steady_clock::now() - t0).count() / seeds.size();
+    if (sink == -1.0) std::cout << "";  // Keep the loop alive
+    return ns;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    checkTables();
+    std::cout << "tables: " << (failures ? "FAILED" : "ok") << std::endl;
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double specials[] = {
+        0.0, -0.0, 1.0, -1.0, 0.5, 0.25, 0.9999999999999999, 1e-300, -1e-300,
+        std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::min(),
+        std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::epsilon(), 123456.789, -2.7182818284590452354 / 3.14159265358979323846,
+        inf, -inf, std::numeric_limits<double>::quiet_NaN()};
+    for (double s : specials) check(s);
+    std::cout << "special values: " << (failures ? "FAILED" : "ok") << std::endl;
+
+    std::mt19937_64 gen(20240601);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> unitSeeds;
+    unitSeeds.reserve(count);
+    for (uint64_t i = 0; i < count; i++) unitSeeds.push_back(unit(gen));
+    for (double s : unitSeeds) check(s);
+    for (uint64_t i = 0; i < count / 4; i++) check(fromBits(gen()));
+    std::cout << "random doubles: " << (failures ? "FAILED" : "ok") << std::endl;
+
+    // Node values as the search produces them
+    const char* keys[] = {"Tag1", "ar11", "soul_Tarot1", "Joker1sho1", "cdt1", "erratic"};
+    for (uint64_t i = 0; i < count / 64; i++) {
+        std::string seed = numberToSeed(i * 7919ull * 104729ull % 1785793904896ull);
+        double hashed = pseudohash(seed);
+        for (const char* key : keys) {
+            double node = pseudohash(key + seed);
+            for (int draw = 0; draw < 4; draw++) check(pseudoseed_advance(node, hashed));
+        }
+    }
+    std::cout << "seed nodes: " << (failures ? "FAILED" : "ok") << std::endl;
+
+    double full = nsPerDraw(unitSeeds, [](double s) { return LuaRandom(s).random(); });
+    double once = nsPerDraw(unitSeeds, [](double s) { return lua_random_once(s); });
+    std::cout << "LuaRandom(seed).random(): " << full << " ns/draw, lua_random_once: " << once
+              << " ns/draw (" << full / once << "x)" << std::endl;
+    return failures ? 1 : 0;
+}
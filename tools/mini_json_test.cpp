@@ -0,0 +1,63 @@
+// Tests for the --serve request parser: values, escapes, exact integers and
+// malformed input.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -I. -o dist/mini_json_test tools/mini_json_test.cpp
+// Usage: dist/mini_json_test
+
+#include <iostream>
+#include <string>
+#include "mini_json.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+static void testValues() {
+    MiniJson::Value v;
+    std::string error;
+    expect(MiniJson::parse(" {\"id\": 7, \"cmd\": \"evaluate\", \"seeds\": [\"AAAAAAAA\", \"B\"], \"ok\": true, \"x\": null,"
+                           " \"f\": -1.5e3, \"o\": {}} ", v, error), "request parses: " + error);
+    expect(v.isObject() && v.members.size() == 7, "object members in order");
+    const MiniJson::Value* seeds = v.get("seeds");
+    expect(seeds && seeds->isArray() && seeds->items.size() == 2 && seeds->items[1].text == "B", "array of strings");
+    expect(v.get("ok") && v.get("ok")->boolean, "true");
+    expect(v.get("x") && v.get("x")->isNull(), "null");
+    expect(v.get("f") && v.get("f")->asDouble() == -1500.0, "exponent");
+    expect(v.get("o") && v.get("o")->isObject() && v.get("o")->members.empty(), "empty object");
+    expect(!v.get("missing"), "absent key");
+
+    uint64_t n = 0;
+    expect(MiniJson::parse("18446744073709551615", v, error) && v.asUint(n) && n == 18446744073709551615ull, "exact uint64");
+    expect(MiniJson::parse("18446744073709551616", v, error) && !v.asUint(n), "uint64 overflow rejected");
+    expect(MiniJson::parse("1.0", v, error) && !v.asUint(n), "fraction is not an integer");
+    expect(MiniJson::parse("{\"a\": 1, \"a\": 2}", v, error) && v.get("a")->text == "2", "last repeated key wins");
+}
+
+static void testStrings() {
+    MiniJson::Value v;
+    std::string error;
+    expect(MiniJson::parse("\"a\\\"b\\\\c\\/d\\n\\u00e9\\ud83d\\ude00\"", v, error) && v.text == "a\"b\\c/d\n\xc3\xa9\xf0\x9f\x98\x80",
+           "escapes and surrogate pairs");
+    const std::string raw = std::string("q\"b\\n\n\x01");
+    expect(MiniJson::parse(MiniJson::quote(raw), v, error) && v.text == raw, "quote() round-trips");
+}
+
+static void testErrors() {
+    MiniJson::Value v;
+    std::string error;
+    const char* bad[] = {"", "{", "[1,]", "{\"a\" 1}", "{'a': 1}", "01", "1.", "tru", "\"abc", "\"a\nb\"", "\"\\x\"", "{} x", "-"};
+    for (const char* text : bad) expect(!MiniJson::parse(text, v, error), std::string("rejects ") + text);
+    std::string deep(100, '[');
+    deep += std::string(100, ']');
+    expect(!MiniJson::parse(deep, v, error), "nesting limit");
+}
+
+int main() {
+    testValues();
+    testStrings();
+    testErrors();
+    std::cout << "mini-json: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,280 @@
+// Tests for the run engine: generator streams against QueryServer::simulate,
+// the ante-1 Charm/Soul/Perkeo path against the enum Perkeo filter, owned
+// jokers leaving the pools, determinism and early exit. Ends with the
+// simulated antes per second of two policies.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/run_engine_test tools/run_engine_test.cpp env.cpp -lpthread
+// Usage: dist/run_engine_test [seed_count]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include "run_engine.hpp"
+#include "filters/enum_perkeo_filter.hpp"
+#include "query_server.hpp"
+#include "seed_util.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+// Names as QueryServer::simulate writes them
+static std::string cardName(const RunEngine::Card& card, bool stickers) {
+    switch (card.type) {
+        case RunEngine::Card::Type::JOKER: {
+            const Items::OptimizedJokerData& j = card.joker_data;
+            std::string name;
+            if (j.edition != Items::Edition::NO_EDITION) name += std::string(Items::toString(j.edition)) + " ";
+            if (stickers && j.eternal) name += "Eternal ";
+            if (stickers && j.perishable) name += "Perishable ";
+            if (stickers && j.rental) name += "Rental ";
+            return name + Items::toString(card.item.joker);
+        }
+        case RunEngine::Card::Type::TAROT: return Items::toString(card.item.tarot);
+        case RunEngine::Card::Type::PLANET: return Items::toString(card.item.planet);
+        case RunEngine::Card::Type::SPECTRAL: return Items::toString(card.item.spectral);
+        default: return "Playing Card";
+    }
+}
+
+struct AnteTrace {
+    std::vector<std::string> head;   // Boss, voucher, two tags
+    std::vector<std::string> shop;
+    std::vector<std::vector<std::string>> packs;  // Type, then the cards
+};
+
+// Default decisions, recording everything the run generates
+struct Recorder : RunEngine::Policy {
+    std::vector<AnteTrace> antes;
+
+    void ante(RunEngine::State&, const RunEngine::Ante& a) {
+        antes.push_back(AnteTrace());
+        antes.back().head = {Items::toString(a.boss), Items::toString(a.voucher), Items::toString(a.tags[0]),
+                             Items::toString(a.tags[1])};
+    }
+    bool buy(RunEngine::State&, const RunEngine::Card& item) {
+        antes.back().shop.push_back(cardName(item, true));
+        return false;
+    }
+    uint32_t pick(RunEngine::State&, const RunEngine::Pack& pack) {
+        std::vector<std::string> p = {Items::toString(pack.type)};
+        if (pack.type == Items::Pack::STANDARD_PACK) {
+            for (const auto& c : pack.playingCards) {
+                p.push_back(c.base + " " + Items::toString(c.enhancement) + " " + Items::toString(c.edition) + " " +
+                            Items::toString(c.seal));
+            }
+        } else {
+            for (int i = 0; i < pack.size; i++) p.push_back(cardName(pack.cards[i], false));
+        }
+        antes.back().packs.push_back(p);
+        return 0;
+    }
+};
+
+static std::vector<std::string> strings(const MiniJson::Value* v) {
+    std::vector<std::string> out;
+    if (v) {
+        for (const auto& item : v->items) out.push_back(item.text);
+    }
+    return out;
+}
+
+// Without purchases the streams do not interact, so three shops of two items
+// and two packs give simulate's shop queue of six and its first packs
+static void testStreams(uint64_t seeds) {
+    const EnvConfig env;
+    for (uint64_t n = 0; n < seeds; n++) {
+        const std::string seed = numberToSeed(n * 7919);
+        Recorder recorder;
+        RunEngine::Engine<Recorder> engine(recorder);
+        expect(engine.run(seed, env) == 8, "default run plays 8 antes");
+        expect(recorder.antes.size() == 8, "one ante hook per ante");
+        expect(engine.state().vouchers.size() == 8 && engine.state().jokers.empty(), "default policy buys vouchers only");
+
+        MiniJson::Value sim;
+        std::string error;
+        expect(MiniJson::parse(QueryServer::simulate(seed, 8, 6, env), sim, error), "simulate JSON: " + error);
+        const MiniJson::Value* antes = sim.get("antes");
+        if (!antes || antes->items.size() != 8 || recorder.antes.size() != 8) continue;
+        for (size_t a = 0; a < 8; a++) {
+            const MiniJson::Value& want = antes->items[a];
+            const AnteTrace& got = recorder.antes[a];
+            std::vector<std::string> head = {want.get("boss")->text, want.get("voucher")->text};
+            for (const auto& t : strings(want.get("tags"))) head.push_back(t);
+            expect(got.head == head, seed + ": boss, voucher and tags of ante " + std::to_string(a + 1));
+            // Overstock adds a slot to every shop after it is bought
+            const std::vector<std::string> queue = strings(want.get("shop"));
+            const size_t slots = got.shop.size() / 3;
+            expect(got.shop.size() % 3 == 0 && slots >= 2 && slots <= 4 && got.shop.size() >= queue.size() &&
+                   std::equal(queue.begin(), queue.end(), got.shop.begin()),
+                   seed + ": shop queue of ante " + std::to_string(a + 1));
+            const auto& packs = want.get("packs")->items;
+            expect(got.packs.size() == 6 && packs.size() <= got.packs.size(), seed + ": pack count");
+            for (size_t p = 0; p < packs.size() && p < got.packs.size(); p++) {
+                std::vector<std::string> pack = {packs[p].get("pack")->text};
+                for (const auto& c : strings(packs[p].get("cards"))) pack.push_back(c);
+                expect(got.packs[p] == pack, seed + ": pack " + std::to_string(p) + " of ante " + std::to_string(a + 1));
+            }
+        }
+
+        // Without the shop queue every other draw is unchanged
+        Recorder noShop;
+        RunEngine::Config config;
+        config.shopSlots = 0;
+        RunEngine::Engine<Recorder> skipped(noShop, config);
+        skipped.run(seed, env);
+        bool same = noShop.antes.size() == recorder.antes.size();
+        for (size_t a = 0; same && a < recorder.antes.size(); a++) {
+            same = noShop.antes[a].head == recorder.antes[a].head && noShop.antes[a].packs == recorder.antes[a].packs &&
+                   noShop.antes[a].shop.empty();
+        }
+        expect(same && skipped.state().shopItems == 0, seed + ": skipping the shop queue leaves the rest of the run");
+    }
+}
+
+// Skip the first small blind for a Charm Tag and use The Soul from its pack
+struct CharmSoul : RunEngine::Policy {
+    bool perkeo = false;
+
+    bool skip(RunEngine::State& s, RunEngine::Blind blind, Items::Tag tag) {
+        if (blind == RunEngine::Blind::SMALL && tag == Items::Tag::CHARM_TAG) return true;
+        s.stop();
+        return false;
+    }
+    uint32_t pick(RunEngine::State& s, const RunEngine::Pack& pack) {
+        for (int i = 0; i < pack.size; i++) {
+            const RunEngine::Card& c = pack.cards[i];
+            if ((c.type == RunEngine::Card::Type::TAROT && c.item.tarot == Items::Tarot::SPECIAL_THE_SOUL) ||
+                (c.type == RunEngine::Card::Type::SPECTRAL && c.item.spectral == Items::Spectral::SPECTRAL_THE_SOUL)) {
+                return 1u << i;
+            }
+        }
+        s.stop();
+        return 0;
+    }
+    void gained(RunEngine::State& s, const Items::OptimizedJokerData& joker, RunEngine::Source source) {
+        perkeo = source == RunEngine::Source::SOUL && joker.joker == Items::Joker::PERKEO;
+        s.stop();
+    }
+};
+
+static void testCharmSoul(uint64_t seeds) {
+    const EnvConfig env;
+    setGlobalEnv(env);
+    EnumPerkeoFilter filter;
+    CharmSoul policy;
+    RunEngine::Engine<CharmSoul> engine(policy);
+    uint64_t matches = 0;
+    // Charm Tags are ~1 in 20 and Perkeo from it far rarer, so walk a known-rich range
+    for (uint64_t n = 0; n < seeds * 20; n++) {
+        const std::string seed = numberToSeed(n);
+        policy.perkeo = false;
+        expect(engine.run(seed, env) == 1, seed + ": the policy stops in ante 1");
+        const bool want = filter.apply(seed) == 1;
+        expect(policy.perkeo == want, seed + ": Charm/Soul/Perkeo agrees with the enum Perkeo filter");
+        matches += want;
+    }
+    expect(engine.run("AAAAAIGP", env) == 1 && policy.perkeo, "AAAAAIGP has Perkeo from its first Charm Tag");
+    (void)matches;
+}
+
+// Fills five joker slots from the shops and Buffoon packs, rerolls once per
+// shop, takes everything else packs offer and skips for every pack tag
+struct Greedy : RunEngine::Policy {
+    static constexpr size_t SLOTS = 5;
+
+    int stopAtAnte = 0;
+    bool rerolled = false;
+    uint64_t trace = 1469598103934665603ULL;
+
+    void mix(uint64_t v) { trace = (trace ^ v) * 1099511628211ULL; }
+
+    void ante(RunEngine::State& s, const RunEngine::Ante& a) {
+        if (stopAtAnte && a.ante > stopAtAnte) s.stop();
+        mix(static_cast<uint64_t>(a.boss) << 8 | static_cast<uint64_t>(a.voucher));
+    }
+    bool skip(RunEngine::State&, RunEngine::Blind, Items::Tag tag) {
+        return RunEngine::tagPack(tag) != Items::Pack::INVALID;
+    }
+    bool buy(RunEngine::State& s, const RunEngine::Card& item) {
+        mix(static_cast<uint64_t>(item.type) << 16 | item.item.raw_value);
+        return item.type == RunEngine::Card::Type::JOKER && s.jokers.size() < SLOTS;
+    }
+    bool reroll(RunEngine::State&) {
+        rerolled = !rerolled;
+        return rerolled;
+    }
+    uint32_t pick(RunEngine::State& s, const RunEngine::Pack& pack) {
+        mix(static_cast<uint64_t>(pack.offer));
+        if (pack.type == Items::Pack::STANDARD_PACK) return 0;
+        for (int i = 0; i < pack.size; i++) mix(pack.cards[i].item.raw_value);
+        if (pack.type == Items::Pack::BUFFOON_PACK && s.jokers.size() >= SLOTS) return 0;
+        return 0x1F;
+    }
+    void gained(RunEngine::State&, const Items::OptimizedJokerData& joker, RunEngine::Source source) {
+        mix(static_cast<uint64_t>(joker.joker) << 4 | static_cast<uint64_t>(source));
+    }
+};
+
+static void testGreedy(uint64_t seeds) {
+    EnvConfig env;
+    for (uint64_t n = 0; n < seeds; n++) {
+        const std::string seed = numberToSeed(n * 104729 + 3);
+        Greedy a, b;
+        RunEngine::Engine<Greedy> ea(a), eb(b);
+        expect(ea.run(seed, env) == 8 && eb.run(seed, env) == 8, "greedy runs play 8 antes");
+        expect(a.trace == b.trace && ea.state().jokers.size() == eb.state().jokers.size(), seed + ": runs are deterministic");
+        expect(!ea.state().jokers.empty(), seed + ": greedy policy owns jokers");
+
+        std::set<Items::Joker> distinct;
+        for (const auto& j : ea.state().jokers) distinct.insert(j.joker);
+        expect(distinct.size() == ea.state().jokers.size(), seed + ": owned jokers leave the pools");
+
+        Greedy early;
+        early.stopAtAnte = 3;
+        RunEngine::Engine<Greedy> ee(early);
+        expect(ee.run(seed, env) == 4, seed + ": stopping in the ante-4 hook returns 4");
+        expect(ee.state().stopped && ee.state().jokers.size() <= ea.state().jokers.size(), seed + ": early exit keeps a prefix");
+        for (size_t i = 0; i < ee.state().jokers.size(); i++) {
+            expect(ee.state().jokers[i].joker == ea.state().jokers[i].joker, seed + ": early run is a prefix of the full run");
+        }
+    }
+
+    // With Showman nothing is locked, so the same seed may repeat jokers but
+    // the run is still deterministic
+    env.showman = true;
+    Greedy a, b;
+    RunEngine::Engine<Greedy> ea(a), eb(b);
+    ea.run("AAAAAIGP", env);
+    eb.run("AAAAAIGP", env);
+    expect(a.trace == b.trace, "Showman runs are deterministic");
+}
+
+template<typename P>
+static double antesPerSecond(uint64_t seeds) {
+    const EnvConfig env;
+    P policy;
+    RunEngine::Engine<P> engine(policy);
+    uint64_t antes = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < seeds; n++) antes += engine.run(numberToSeed(n), env);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return antes / secs;
+}
+
+int main(int argc, char** argv) {
+    const uint64_t seeds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200;
+    testStreams(seeds);
+    testCharmSoul(seeds);
+    testGreedy(seeds);
+    std::cout << "run_engine: " << (failures ? "FAILED" : "ok") << std::endl;
+    std::cout << "  default policy: " << static_cast<uint64_t>(antesPerSecond<RunEngine::Policy>(seeds * 10)) << " antes/s" << std::endl;
+    std::cout << "  greedy policy:  " << static_cast<uint64_t>(antesPerSecond<Greedy>(seeds * 10)) << " antes/s" << std::endl;
+    return failures ? 1 : 0;
+}
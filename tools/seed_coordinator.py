@@ -0,0 +1,410 @@
+#!/usr/bin/env python3
+"""Split a seed range into work units and scan them with many worker processes.
+
+A job lives in a shared directory. Workers claim units by creating lease
+files there, so they can run on one host or on several hosts that share the
+directory. Each unit is scanned by an ordinary filter binary from
+tools/build.sh in bounded mode (immolate --start N --count K). Because the
+binaries are deterministic, a unit that ends up scanned twice gives the same
+result both times.
+
+Job directory layout:
+  job.json                  range, unit size, binary, env, lease length
+  leases/unit_NNNNNNNN.lease  claimed units; the holder touches the file as a heartbeat
+  done/unit_NNNNNNNN.json     per-unit summary (seeds, match counts per level)
+  results/unit_NNNNNNNN.csv   per-unit matches (immolate CSV rows)
+  work/<worker>-<host>-<pid>/ scratch cwd for the binary (its dist/ output, log)
+  matches.csv, summary.json   merged output, written once every unit is done
+
+A lease whose file has not been touched for --lease-seconds is expired. The
+coordinator or any worker can then remove it and re-issue the unit.
+
+Usage:
+  python3 tools/seed_coordinator.py init JOB --binary dist/immolate_perkeo --start 0 --count 1000000000
+        [--unit-size N] [--env FILE] [--threads N] [--lease-seconds S]
+  python3 tools/seed_coordinator.py run JOB --workers 4     # local workers, re-issue, merge
+  python3 tools/seed_coordinator.py worker JOB [--id NAME]  # one worker, e.g. on another host
+  python3 tools/seed_coordinator.py status JOB
+  python3 tools/seed_coordinator.py merge JOB
+"""
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import time
+
+SEED_COUNT = 34 ** 8  # seed_util.hpp SEED_COUNT
+
+
+class JobError(Exception):
+    pass
+
+
+def unit_name(index):
+    return 'unit_%08d' % index
+
+
+def write_json(path, data):
+    """Writes `path` atomically (temporary file + rename)."""
+    tmp = '%s.tmp.%d' % (path, os.getpid())
+    with open(tmp, 'w') as f:
+        json.dump(data, f, indent=2)
+    os.replace(tmp, path)
+
+
+def read_json(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+class Job:
+    def __init__(self, root):
+        self.root = os.path.abspath(root)
+        path = os.path.join(self.root, 'job.json')
+        if not os.path.exists(path):
+            raise JobError('%s is not a job directory (no job.json); run init first' % root)
+        self.cfg = read_json(path)
+
+    def path(self, *parts):
+        return os.path.join(self.root, *parts)
+
+    @property
+    def unit_count(self):
+        size = self.cfg['unit_size']
+        return (self.cfg['end'] - self.cfg['start'] + size - 1) // size
+
+    def unit_range(self, index):
+        start = self.cfg['start'] + index * self.cfg['unit_size']
+        return start, min(self.cfg['end'], start + self.cfg['unit_size'])
+
+    def lease_path(self, index):
+        return self.path('leases', unit_name(index) + '.lease')
+
+    def done_path(self, index):
+        return self.path('done', unit_name(index) + '.json')
+
+    def result_path(self, index):
+        return self.path('results', unit_name(index) + '.csv')
+
+    def is_done(self, index):
+        return os.path.exists(self.done_path(index))
+
+    def done_count(self):
+        return len(glob.glob(self.path('done', 'unit_*.json')))
+
+    def unclaimed(self):
+        """Units that are neither done nor leased."""
+        return [i for i in range(self.unit_count) if not self.is_done(i) and not os.path.exists(self.lease_path(i))]
+
+    def claim(self, worker):
+        """Claims the first unit that is neither done nor leased; None when there is none."""
+        for index in range(self.unit_count):
+            if self.is_done(index):
+                continue
+            try:
+                fd = os.open(self.lease_path(index), os.O_CREAT | os.O_EXCL | os.O_WRONLY, 0o644)
+            except FileExistsError:
+                continue
+            with os.fdopen(fd, 'w') as f:
+                json.dump({'worker': worker, 'host': socket.gethostname(), 'pid': os.getpid(),
+                           'claimed': time.time()}, f)
+            # The unit may have finished between the check and the claim
+            if self.is_done(index):
+                self.release(index)
+                continue
+            return index
+        return None
+
+    def release(self, index):
+        try:
+            os.remove(self.lease_path(index))
+        except FileNotFoundError:
+            pass
+
+    def reap_expired(self):
+        """Removes leases whose holder stopped heartbeating; returns the unit indexes re-issued."""
+        reissued = []
+        now = time.time()
+        for path in glob.glob(self.path('leases', 'unit_*.lease')):
+            try:
+                age = now - os.path.getmtime(path)
+            except FileNotFoundError:
+                continue
+            if age <= self.cfg['lease_seconds']:
+                continue
+            # Rename first so two reapers cannot both remove a fresh re-claim
+            stale = '%s.expired.%d' % (path, os.getpid())
+            try:
+                os.rename(path, stale)
+            except FileNotFoundError:
+                continue
+            os.remove(stale)
+            reissued.append(int(os.path.basename(path)[5:13]))
+        return reissued
+
+
+def parse_csv_rows(path):
+    """Match rows of an immolate CSV (header dropped) and their count per level."""
+    rows, counts = [], {}
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip('\n')
+            if not line or line.startswith('seed,'):
+                continue
+            rows.append(line)
+            level = line.split(',')[1]
+            counts[level] = counts.get(level, 0) + 1
+    return rows, counts
+
+
+def run_unit(job, index, worker):
+    """Scans one unit with the filter binary; returns the per-unit summary or raises JobError."""
+    start, end = job.unit_range(index)
+    # Scratch directory private to this process, even if two workers share a name
+    work = job.path('work', '%s-%s-%d' % (worker, socket.gethostname(), os.getpid()))
+    shutil.rmtree(work, ignore_errors=True)
+    os.makedirs(os.path.join(work, 'dist'))
+    cmd = [job.cfg['binary'], '--start', str(start), '--end', str(end)]
+    if job.cfg.get('threads'):
+        cmd += ['--threads', str(job.cfg['threads'])]
+    if job.cfg.get('env'):
+        cmd += ['--env', job.cfg['env']]
+
+    heartbeat = max(1.0, job.cfg['lease_seconds'] / 4.0)
+    began = time.time()
+    with open(os.path.join(work, 'output.log'), 'w') as log:
+        proc = subprocess.Popen(cmd, cwd=work, stdout=log, stderr=subprocess.STDOUT)
+        while True:
+            try:
+                proc.wait(timeout=heartbeat)
+                break
+            except subprocess.TimeoutExpired:
+                try:
+                    os.utime(job.lease_path(index))
+                except FileNotFoundError:
+                    pass  # Re-issued meanwhile; finishing is still harmless
+    if proc.returncode != 0:
+        raise JobError('%s exited with %d for %s (see %s)' % (cmd[0], proc.returncode, unit_name(index),
+                                                                os.path.join(work, 'output.log')))
+    csvs = glob.glob(os.path.join(work, 'dist', 'matches_*.csv'))
+    if len(csvs) != 1:
+        raise JobError('expected one matches CSV in %s, found %d' % (os.path.join(work, 'dist'), len(csvs)))
+    rows, counts = parse_csv_rows(csvs[0])
+    tmp = '%s.tmp.%d' % (job.result_path(index), os.getpid())
+    with open(tmp, 'w') as f:
+        f.writelines(r + '\n' for r in rows)
+    os.replace(tmp, job.result_path(index))
+    shutil.rmtree(work, ignore_errors=True)
+    return {'unit': index, 'start': start, 'end': end, 'seeds': end - start, 'matches': len(rows),
+            'counts': counts, 'worker': worker, 'host': socket.gethostname(),
+            'seconds': round(time.time() - began, 3)}
+
+
+def cmd_init(args):
+    start, end = args.start, args.end
+    if args.count is not None:
+        end = start + args.count
+    if end is None or not 0 <= start < end <= SEED_COUNT:
+        print('need 0 <= --start < end <= %d (give --end or --count)' % SEED_COUNT, file=sys.stderr)
+        return 1
+    binary = os.path.abspath(args.binary)
+    if not os.access(binary, os.X_OK):
+        print('%s is not an executable; build it with tools/build.sh' % args.binary, file=sys.stderr)
+        return 1
+    if os.path.exists(os.path.join(args.job, 'job.json')):
+        print('%s already holds a job' % args.job, file=sys.stderr)
+        return 1
+    names = []
+    try:
+        res = subprocess.run([binary, '--list-results'], capture_output=True, text=True, timeout=30)
+        names = json.loads(res.stdout)
+    except (subprocess.SubprocessError, ValueError):
+        pass
+    for sub in ('leases', 'done', 'results', 'work'):
+        os.makedirs(os.path.join(args.job, sub), exist_ok=True)
+    write_json(os.path.join(args.job, 'job.json'), {
+        'binary': binary, 'env': os.path.abspath(args.env) if args.env else None,
+        'start': start, 'end': end, 'unit_size': args.unit_size, 'threads': args.threads,
+        'lease_seconds': args.lease_seconds, 'result_names': names})
+    job = Job(args.job)
+    print('%s: %d seeds in %d units of %d' % (args.job, end - start, job.unit_count, args.unit_size))
+    return 0
+
+
+def cmd_worker(args):
+    job = Job(args.job)
+    worker = args.id or '%s-%d' % (socket.gethostname(), os.getpid())
+    failures = 0
+    while True:
+        job.reap_expired()
+        index = job.claim(worker)
+        if index is None:
+            return 0
+        try:
+            summary = run_unit(job, index, worker)
+        except (JobError, OSError) as e:
+            print('[%s] %s' % (worker, e), file=sys.stderr)
+            job.release(index)
+            failures += 1
+            if failures >= 3:
+                return 1
+            continue
+        failures = 0
+        if not job.is_done(index):
+            write_json(job.done_path(index), summary)
+        job.release(index)
+        print('[%s] %s done: %d seeds, %d matches, %.1fs' % (worker, unit_name(index), summary['seeds'],
+                                                             summary['matches'], summary['seconds']), flush=True)
+
+
+def merge(job):
+    """Writes matches.csv (units in order) and summary.json; the job must be complete."""
+    missing = [i for i in range(job.unit_count) if not job.is_done(i)]
+    if missing:
+        raise JobError('%d of %d units are not done (first: %s)' % (len(missing), job.unit_count, unit_name(missing[0])))
+    seeds, counts, matches = 0, {}, 0
+    tmp = job.path('matches.csv.tmp')
+    with open(tmp, 'w') as out:
+        out.write('seed,match_level\n')
+        for i in range(job.unit_count):
+            summary = read_json(job.done_path(i))
+            seeds += summary['seeds']
+            matches += summary['matches']
+            for level, n in summary['counts'].items():
+                counts[level] = counts.get(level, 0) + n
+            with open(job.result_path(i)) as f:
+                shutil.copyfileobj(f, out)
+    os.replace(tmp, job.path('matches.csv'))
+    names = job.cfg.get('result_names') or []
+    per_level = {}
+    for level, n in sorted(counts.items(), key=lambda kv: int(kv[0])):
+        lv = int(level)
+        per_level[names[lv - 1] if 0 < lv <= len(names) else level] = n
+    summary = {'start': job.cfg['start'], 'end': job.cfg['end'], 'seeds': seeds, 'units': job.unit_count,
+               'matches': matches, 'per_level': per_level}
+    write_json(job.path('summary.json'), summary)
+    return summary
+
+
+def print_summary(job, summary):
+    print('%d seeds in %d units, %d matches -> %s' % (summary['seeds'], summary['units'], summary['matches'],
+                                                      job.path('matches.csv')))
+    for name, n in summary['per_level'].items():
+        print('  %-25s %d' % (name + ':', n))
+
+
+def cmd_merge(args):
+    job = Job(args.job)
+    print_summary(job, merge(job))
+    return 0
+
+
+def cmd_status(args):
+    job = Job(args.job)
+    leases = sorted(glob.glob(job.path('leases', 'unit_*.lease')))
+    print('%d of %d units done, %d leased' % (job.done_count(), job.unit_count, len(leases)))
+    now = time.time()
+    for path in leases:
+        try:
+            holder = read_json(path)
+            age = now - os.path.getmtime(path)
+        except (OSError, ValueError):
+            continue
+        state = 'expired' if age > job.cfg['lease_seconds'] else 'active'
+        print('  %s  %s@%s  heartbeat %.0fs ago (%s)' % (os.path.basename(path)[:13], holder.get('worker'),
+                                                         holder.get('host'), age, state))
+    return 0
+
+
+def cmd_run(args):
+    job = Job(args.job)
+    script = os.path.abspath(__file__)
+
+    def spawn(i):
+        return subprocess.Popen([sys.executable, script, 'worker', job.root, '--id', 'local-%d' % i])
+
+    procs = [spawn(i) for i in range(args.workers)]
+    failures = 0
+    began = time.time()
+    try:
+        while job.done_count() < job.unit_count:
+            for index in job.reap_expired():
+                print('re-issued %s (lease expired)' % unit_name(index), flush=True)
+            # Replace workers that exited while units are still waiting, e.g.
+            # ones re-issued after the other workers ran out of work
+            for i, p in enumerate(procs):
+                if p.poll() is None or not job.unclaimed():
+                    continue
+                failures += p.returncode != 0
+                if failures > 3 * args.workers:
+                    break
+                procs[i] = spawn(i)
+            if failures > 3 * args.workers or (all(p.poll() is not None for p in procs) and
+                                               not glob.glob(job.path('leases', 'unit_*.lease'))):
+                break
+            time.sleep(1.0)
+    except KeyboardInterrupt:
+        for p in procs:
+            p.terminate()
+        print('interrupted; leases expire after %ds and the job can be resumed with run' % job.cfg['lease_seconds'])
+        return 1
+    if job.done_count() < job.unit_count:
+        print('workers stopped with %d of %d units done' % (job.done_count(), job.unit_count), file=sys.stderr)
+        return 1
+    summary = merge(job)
+    print_summary(job, summary)
+    elapsed = time.time() - began
+    print('%.1fs, %.0f seeds/s' % (elapsed, summary['seeds'] / elapsed if elapsed > 0 else 0))
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Scan a seed range with many worker processes using lease files')
+    sub = ap.add_subparsers(dest='command')
+    sub.required = True
+
+    p = sub.add_parser('init', help='create a job directory')
+    p.add_argument('job')
+    p.add_argument('--binary', required=True, help='filter binary from tools/build.sh, e.g. dist/immolate_perkeo')
+    p.add_argument('--start', type=int, default=0, help='first seed number')
+    p.add_argument('--end', type=int, help='seed number to stop before')
+    p.add_argument('--count', type=int, help='number of seeds (alternative to --end)')
+    p.add_argument('--unit-size', type=int, default=100000000, help='seeds per work unit (default 1e8)')
+    p.add_argument('--threads', type=int, default=0, help='--threads for each binary (default: auto)')
+    p.add_argument('--env', help='env JSON passed to the binary')
+    p.add_argument('--lease-seconds', type=int, default=60, help='heartbeat timeout before a unit is re-issued')
+    p.set_defaults(func=cmd_init)
+
+    p = sub.add_parser('run', help='run local workers until the job is done, then merge')
+    p.add_argument('job')
+    p.add_argument('--workers', type=int, default=2)
+    p.set_defaults(func=cmd_run)
+
+    p = sub.add_parser('worker', help='claim and scan units until none are left')
+    p.add_argument('job')
+    p.add_argument('--id', help='worker name (default host-pid)')
+    p.set_defaults(func=cmd_worker)
+
+    p = sub.add_parser('status', help='show progress and leases')
+    p.add_argument('job')
+    p.set_defaults(func=cmd_status)
+
+    p = sub.add_parser('merge', help='merge finished units into matches.csv and summary.json')
+    p.add_argument('job')
+    p.set_defaults(func=cmd_merge)
+
+    args = ap.parse_args()
+    try:
+        return args.func(args)
+    except JobError as e:
+        print(e, file=sys.stderr)
+        return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../instance.hpp"
+#include "item_lookup.hpp"
+#include "../items_to_string.hpp"
+
+// Rare ante-1 events recorded by tools/seed_indexer.cpp. Each seed is run
+// once through Instance in a fixed order (first tag, ante-1 voucher, the
+// 5-card arcana pack a Charm Tag opens, the Soul's joker, the first shop
+// items) and every event it hits sets one bit.
+namespace SeedIndexEvents {
+
+    constexpr int SHOP_SLOTS = 2;
+    constexpr size_t MAX_EVENTS = 64;
+
+    struct Event {
+        std::string name;
+        std::string description;
+    };
+
+    struct VoucherTagPair {
+        Items::Voucher voucher;
+        Items::Tag tag;
+    };
+
+    using ItemLookup::normalize;
+    using ItemLookup::lookup;
+
+    // "Voucher Name:Tag Name", matched case- and punctuation-insensitively
+    inline bool parsePair(const std::string& spec, VoucherTagPair& out, std::string& error) {
+        auto colon = spec.find(':');
+        if (colon == std::string::npos) {
+            error = "expected VOUCHER:TAG, got '" + spec + "'";
+            return false;
+        }
+        if (!lookup(spec.substr(0, colon), out.voucher)) {
+            error = "unknown voucher '" + spec.substr(0, colon) + "'";
+            return false;
+        }
+        if (!lookup(spec.substr(colon + 1), out.tag)) {
+            error = "unknown tag '" + spec.substr(colon + 1) + "'";
+            return false;
+        }
+        return true;
+    }
+
+    class EventSet {
+    public:
+        explicit EventSet(const std::vector<VoucherTagPair>& voucherTagPairs = {}) : pairs(voucherTagPairs) {
+            list.push_back({"charm_soul", "First tag is a Charm Tag and its pack holds The Soul"});
+            list.push_back({"soul_arcana", "The Soul in the first arcana pack"});
+            for (Items::Joker j : Items::LEGENDARY_JOKERS) {
+                list.push_back({"soul_" + normalize(Items::toString(j)),
+                                std::string("The Soul in the first arcana pack, giving ") + Items::toString(j)});
+            }
+            list.push_back({"negative_shop_joker", "Negative joker in the first " + std::to_string(SHOP_SLOTS) + " shop slots"});
+            for (const auto& p : pairs) {
+                list.push_back({"pair_" + normalize(Items::toString(p.voucher)) + "_" + normalize(Items::toString(p.tag)),
+                                std::string(Items::toString(p.voucher)) + " voucher with " + Items::toString(p.tag) + " first"});
+            }
+        }
+
+        const std::vector<Event>& events() const { return list; }
+        bool valid() const { return list.size() <= MAX_EVENTS; }
+
+        // Bit i is set when the seed hits events()[i]
+        uint64_t evaluate(const std::string& seed, const EnvConfig& e) const {
+            Instance::Instance inst(seed);
+            if (!e.deck.empty()) inst.setDeck(e.deck);
+            if (!e.stake.empty()) inst.setStake(e.stake);
+            inst.setShowman(e.showman);
+            inst.setSixesFactor(e.sixesFactor);
+            inst.setVersion(e.version);
+            inst.setForceAllContent(e.forceAllContent);
+            inst.initLocks(1, e.freshProfile, e.freshRun);
+
+            uint64_t hits = 0;
+            const Items::Tag tag = inst.nextTag_enum(1);
+            const Items::Voucher voucher = inst.nextVoucher_enum(1);
+
+            auto pack = inst.nextArcanaPack_enum(5, 1);
+            bool soul = false;
+            for (size_t i = 0; i < pack.tarots.size(); i++) {
+                if (pack.isSpectral[i] ? pack.spectrals[i] == Items::Spectral::SPECTRAL_THE_SOUL
+                                       : pack.tarots[i] == Items::Tarot::SPECIAL_THE_SOUL) soul = true;
+            }
+            if (soul) {
+                hits |= bit(SOUL_ARCANA);
+                if (tag == Items::Tag::CHARM_TAG) hits |= bit(CHARM_SOUL);
+                const Items::Joker legendary = inst.nextJoker_enum("sou", 1, false).joker;
+                for (size_t i = 0; i < Items::LEGENDARY_JOKERS.size(); i++) {
+                    if (Items::LEGENDARY_JOKERS[i] == legendary) hits |= bit(SOUL_LEGENDARY + i);
+                }
+            }
+
+            for (int i = 0; i < SHOP_SLOTS; i++) {
+                auto item = inst.nextShopItem_enum(1);
+                if (item.type == Items::OptimizedShopItem::Type::JOKER && item.joker_data.edition == Items::Edition::NEGATIVE) {
+                    hits |= bit(NEGATIVE_SHOP_JOKER);
+                }
+            }
+
+            for (size_t i = 0; i < pairs.size(); i++) {
+                if (pairs[i].voucher == voucher && pairs[i].tag == tag) hits |= bit(PAIRS + i);
+            }
+            return hits;
+        }
+
+    private:
+        enum : size_t {
+            CHARM_SOUL = 0,
+            SOUL_ARCANA = 1,
+            SOUL_LEGENDARY = 2,
+            NEGATIVE_SHOP_JOKER = SOUL_LEGENDARY + 5,
+            PAIRS = NEGATIVE_SHOP_JOKER + 1
+        };
+
+        static uint64_t bit(size_t i) { return 1ull << i; }
+
+        std::vector<VoucherTagPair> pairs;
+        std::vector<Event> list;
+    };
+}
@@ -0,0 +1,104 @@
+// Tests for the seed index: shard round trips and event parity with filters.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/seed_index_test tools/seed_index_test.cpp env.cpp
+// Usage: dist/seed_index_test [seed_count]
+// Writes shards to a temporary directory, reads them back, and checks that
+// charm_soul + soul_perkeo selects exactly the seeds EnumPerkeoFilter accepts.
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "seed_index.hpp"
+#include "seed_util.hpp"
+#include "tools/seed_index_events.hpp"
+#include "filters/enum_perkeo_filter.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+static void testRoundTrip(const std::string& dir) {
+    std::mt19937_64 gen(7);
+    SeedIndex::ShardHeader h;
+    h.envHash = 0x0123456789abcdefull;
+    h.gameVersion = 10106;
+    h.rangeStart = 1000;
+    h.rangeEnd = SEED_COUNT;
+
+    std::vector<SeedIndex::EventList> lists(4);
+    lists[0].name = "empty";
+    lists[1].name = "dense";
+    for (uint64_t n = h.rangeStart; n < h.rangeStart + 5000; n++) lists[1].seeds.push_back(n);
+    lists[2].name = "sparse";
+    for (uint64_t n = h.rangeStart; n < h.rangeEnd; n += 1 + gen() % 100000000000ull) lists[2].seeds.push_back(n);
+    lists[3].name = "edges";
+    lists[3].seeds = {h.rangeStart, h.rangeStart + 127, h.rangeStart + 128, h.rangeEnd - 1};
+
+    const std::string path = dir + "/" + SeedIndex::shardFileName(h.rangeStart, h.rangeEnd);
+    std::string error;
+    expect(SeedIndex::writeShard(path, h, lists, error), "writeShard: " + error);
+
+    SeedIndex::ShardReader r;
+    expect(r.open(path, error), "open: " + error);
+    expect(r.header().envHash == h.envHash && r.header().gameVersion == h.gameVersion &&
+           r.header().rangeStart == h.rangeStart && r.header().rangeEnd == h.rangeEnd, "header round trip");
+    // Read out of order to exercise payload offsets
+    for (int i = 3; i >= 0; i--) {
+        std::vector<uint64_t> got;
+        expect(r.read(lists[i].name, got, error), "read " + lists[i].name + ": " + error);
+        expect(got == lists[i].seeds, "payload round trip for " + lists[i].name);
+        expect(r.count(lists[i].name) == lists[i].seeds.size(), "count for " + lists[i].name);
+    }
+    std::vector<uint64_t> none;
+    expect(!r.read("missing", none, error), "unknown event is rejected");
+    expect(SeedIndex::listShards(dir).size() == 1, "listShards finds the shard");
+    std::remove(path.c_str());
+
+    std::vector<uint64_t> a = {1, 3, 5, 7, 9}, b = {2, 3, 4, 9, 10};
+    expect(SeedIndex::intersect(a, b) == std::vector<uint64_t>({3, 9}), "intersect");
+}
+
+static void testPerkeoParity(uint64_t count) {
+    const EnvConfig env;
+    setGlobalEnv(env);
+    const SeedIndexEvents::EventSet events;
+    size_t charmSoul = events.events().size(), perkeo = events.events().size();
+    for (size_t i = 0; i < events.events().size(); i++) {
+        if (events.events()[i].name == "charm_soul") charmSoul = i;
+        if (events.events()[i].name == "soul_perkeo") perkeo = i;
+    }
+    expect(charmSoul < events.events().size() && perkeo < events.events().size(), "charm_soul and soul_perkeo exist");
+    if (failures) return;
+
+    EnumPerkeoFilter filter;
+    uint64_t matches = 0;
+    for (uint64_t n = 0; n < count; n++) {
+        const std::string seed = numberToSeed(n * 7919ull * 104729ull % SEED_COUNT);
+        const uint64_t hits = events.evaluate(seed, env);
+        const bool indexed = (hits >> charmSoul & 1) && (hits >> perkeo & 1);
+        const bool filtered = filter.apply(seed) > 0;
+        matches += filtered;
+        expect(indexed == filtered, "perkeo parity for " + seed);
+    }
+    std::cout << "perkeo parity: " << count << " seeds, " << matches << " matches" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    char tmpl[] = "/tmp/seed_index_test_XXXXXX";
+    const char* dir = mkdtemp(tmpl);
+    if (!dir) {
+        std::cerr << "could not create a temporary directory" << std::endl;
+        return 1;
+    }
+    testRoundTrip(dir);
+    std::cout << "shard round trip: " << (failures ? "FAILED" : "ok") << std::endl;
+    std::remove(dir);
+    testPerkeoParity(count);
+    return failures ? 1 : 0;
+}
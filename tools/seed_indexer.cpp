@@ -0,0 +1,302 @@
+// Seed index builder and query tool. `build` sweeps a seed range once and
+// writes one shard per --shard-size seeds (see seed_index.hpp) listing the
+// seeds that hit each event in tools/seed_index_events.hpp; `query` then
+// answers "which seeds hit all of these events" from the shards alone.
+// Build with tools/build-indexer.sh, or from the repo root:
+//   g++ -std=c++14 -O3 -ffp-contract=off -I. -o dist/seed_indexer tools/seed_indexer.cpp env.cpp -lpthread
+// Usage:
+//   seed_indexer build --out DIR [--env FILE] [--start SEED | --start-number N] [--count N]
+//                      [--shard-size N] [--threads N] [--pair "VOUCHER:TAG"]...
+//   seed_indexer query --index DIR [--env FILE] [--limit N] EVENT [EVENT...]
+//   seed_indexer info  --index DIR
+// Shards that already exist are skipped, so an interrupted build resumes
+// where it stopped. Queries refuse shards built for a different env.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+#include <vector>
+#include "env.hpp"
+#include "seed_index.hpp"
+#include "seed_util.hpp"
+#include "tools/seed_index_events.hpp"
+
+using namespace std::chrono;
+
+struct Options {
+    std::string command;
+    std::string dir;
+    std::string envFile;
+    uint64_t start = 0;
+    uint64_t count = 10000000;
+    uint64_t shardSize = 1000000;
+    unsigned int threads = 0;
+    uint64_t limit = 0;
+    std::vector<SeedIndexEvents::VoucherTagPair> pairs;
+    std::vector<std::string> events;
+};
+
+static void usage(const char* prog) {
+    std::cerr << "Usage:\n"
+              << "  " << prog << " build --out DIR [--env FILE] [--start SEED | --start-number N] [--count N]\n"
+              << "        [--shard-size N] [--threads N] [--pair \"VOUCHER:TAG\"]...\n"
+              << "  " << prog << " query --index DIR [--env FILE] [--limit N] EVENT [EVENT...]\n"
+              << "  " << prog << " info --index DIR\n";
+}
+
+static bool parseNumber(const std::string& s, uint64_t& out) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    out = std::strtoull(s.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+static bool parseOptions(int argc, char* argv[], Options& o) {
+    if (argc < 2) return false;
+    o.command = argv[1];
+    for (int i = 2; i < argc; i++) {
+        std::string a = argv[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        std::string v;
+        if (a == "--out" || a == "--index") {
+            if (!value(o.dir)) return false;
+        } else if (a == "--env") {
+            if (!value(o.envFile)) return false;
+        } else if (a == "--start") {
+            if (!value(v)) return false;
+            o.start = seedToNumber(v);
+        } else if (a == "--start-number") {
+            if (!value(v) || !parseNumber(v, o.start)) return false;
+        } else if (a == "--count") {
+            if (!value(v) || !parseNumber(v, o.count)) return false;
+        } else if (a == "--shard-size") {
+            if (!value(v) || !parseNumber(v, o.shardSize) || o.shardSize == 0) return false;
+        } else if (a == "--threads") {
+            uint64_t n;
+            if (!value(v) || !parseNumber(v, n)) return false;
+            o.threads = static_cast<unsigned int>(n);
+        } else if (a == "--limit") {
+            if (!value(v) || !parseNumber(v, o.limit)) return false;
+        } else if (a == "--pair") {
+            SeedIndexEvents::VoucherTagPair p;
+            std::string error;
+            if (!value(v)) return false;
+            if (!SeedIndexEvents::parsePair(v, p, error)) {
+                std::cerr << "--pair: " << error << std::endl;
+                return false;
+            }
+            o.pairs.push_back(p);
+        } else if (!a.empty() && a[0] != '-') {
+            o.events.push_back(a);
+        } else {
+            std::cerr << "Unknown option " << a << std::endl;
+            return false;
+        }
+    }
+    return !o.dir.empty();
+}
+
+static bool loadEnv(const Options& o, EnvConfig& env) {
+    if (!o.envFile.empty() && !loadEnvFile(o.envFile, env)) {
+        std::cerr << "Could not read env file " << o.envFile << std::endl;
+        return false;
+    }
+    setGlobalEnv(env);
+    return true;
+}
+
+static void makeDir(const std::string& dir) {
+#ifdef _WIN32
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+}
+
+// An existing shard is reused only if it was built with the same env and events
+static bool shardIsComplete(const std::string& path, const SeedIndex::ShardHeader& want, const std::vector<SeedIndex::EventList>& lists) {
+    SeedIndex::ShardReader r;
+    std::string error;
+    if (!r.open(path, error) || r.header().envHash != want.envHash || r.header().gameVersion != want.gameVersion) return false;
+    std::vector<std::string> names = r.eventNames();
+    if (names.size() != lists.size()) return false;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] != lists[i].name) return false;
+    }
+    return true;
+}
+
+static int build(const Options& o) {
+    EnvConfig env;
+    if (!loadEnv(o, env)) return 1;
+    const SeedIndexEvents::EventSet events(o.pairs);
+    if (!events.valid()) {
+        std::cerr << "Too many events (max " << SeedIndexEvents::MAX_EVENTS << ")" << std::endl;
+        return 1;
+    }
+    if (o.start >= SEED_COUNT) {
+        std::cerr << "--start is past the last seed" << std::endl;
+        return 1;
+    }
+    makeDir(o.dir);
+
+    const uint64_t end = std::min(SEED_COUNT, o.start + o.count);
+    const uint64_t shardCount = (end - o.start + o.shardSize - 1) / o.shardSize;
+    unsigned int threads = o.threads ? o.threads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 4;
+
+    SeedIndex::ShardHeader base;
+    base.envHash = envConfigHash(env);
+    base.gameVersion = env.version;
+
+    std::cout << "Indexing " << numberToSeed(o.start) << " .. " << numberToSeed(end - 1) << " (" << (end - o.start)
+              << " seeds, " << shardCount << " shards, " << threads << " threads) into " << o.dir << std::endl;
+
+    std::atomic<uint64_t> nextShard{0};
+    std::atomic<uint64_t> seedsDone{0};
+    std::atomic<bool> failed{false};
+    std::mutex outMutex;
+    auto t0 = steady_clock::now();
+
+    auto worker = [&]() {
+        std::vector<SeedIndex::EventList> lists(events.events().size());
+        for (size_t i = 0; i < lists.size(); i++) lists[i].name = events.events()[i].name;
+        for (uint64_t s = nextShard++; s < shardCount && !failed.load(); s = nextShard++) {
+            SeedIndex::ShardHeader h = base;
+            h.rangeStart = o.start + s * o.shardSize;
+            h.rangeEnd = std::min(end, h.rangeStart + o.shardSize);
+            const std::string path = o.dir + "/" + SeedIndex::shardFileName(h.rangeStart, h.rangeEnd);
+            if (shardIsComplete(path, h, lists)) continue;
+
+            for (auto& l : lists) l.seeds.clear();
+            for (uint64_t n = h.rangeStart; n < h.rangeEnd; n++) {
+                uint64_t hits = events.evaluate(numberToSeed(n), env);
+                while (hits) {
+                    const int e = __builtin_ctzll(hits);
+                    lists[e].seeds.push_back(n);
+                    hits &= hits - 1;
+                }
+            }
+            std::string error;
+            if (!SeedIndex::writeShard(path, h, lists, error)) {
+                std::lock_guard<std::mutex> lk(outMutex);
+                std::cerr << error << std::endl;
+                failed = true;
+                return;
+            }
+            uint64_t done = seedsDone += h.rangeEnd - h.rangeStart;
+            double secs = duration<double>(steady_clock::now() - t0).count();
+            std::lock_guard<std::mutex> lk(outMutex);
+            std::cout << "  " << SeedIndex::shardFileName(h.rangeStart, h.rangeEnd) << "  " << static_cast<uint64_t>(done / secs)
+                      << " seeds/s" << std::endl;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 0; i < threads; i++) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+    return failed ? 1 : 0;
+}
+
+static int query(const Options& o) {
+    EnvConfig env;
+    if (!loadEnv(o, env)) return 1;
+    if (o.events.empty()) {
+        std::cerr << "query needs at least one event name" << std::endl;
+        return 1;
+    }
+    const uint64_t envHash = envConfigHash(env);
+    const auto shards = SeedIndex::listShards(o.dir);
+    if (shards.empty()) {
+        std::cerr << "No shards in " << o.dir << std::endl;
+        return 1;
+    }
+    uint64_t printed = 0, covered = 0;
+    for (const auto& path : shards) {
+        SeedIndex::ShardReader r;
+        std::string error;
+        if (!r.open(path, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        if (r.header().envHash != envHash || r.header().gameVersion != env.version) {
+            std::cerr << path << " was built for a different env (hash/version mismatch); rebuild or pass the matching --env" << std::endl;
+            return 1;
+        }
+        std::vector<uint64_t> result, next;
+        for (size_t i = 0; i < o.events.size(); i++) {
+            if (!r.read(o.events[i], i == 0 ? result : next, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            if (i > 0) result = SeedIndex::intersect(result, next);
+        }
+        covered += r.header().rangeEnd - r.header().rangeStart;
+        for (uint64_t n : result) {
+            std::cout << numberToSeed(n) << "\n";
+            if (o.limit && ++printed >= o.limit) return 0;
+        }
+    }
+    std::cerr << covered << " seeds covered by " << shards.size() << " shards" << std::endl;
+    return 0;
+}
+
+static int info(const Options& o) {
+    const auto shards = SeedIndex::listShards(o.dir);
+    if (shards.empty()) {
+        std::cerr << "No shards in " << o.dir << std::endl;
+        return 1;
+    }
+    std::vector<std::string> names;
+    std::vector<uint64_t> totals;
+    uint64_t covered = 0;
+    SeedIndex::ShardHeader first;
+    for (size_t s = 0; s < shards.size(); s++) {
+        SeedIndex::ShardReader r;
+        std::string error;
+        if (!r.open(shards[s], error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        if (s == 0) {
+            first = r.header();
+            names = r.eventNames();
+            totals.assign(names.size(), 0);
+        }
+        for (size_t i = 0; i < names.size(); i++) totals[i] += r.count(names[i]);
+        covered += r.header().rangeEnd - r.header().rangeStart;
+    }
+    std::cout << shards.size() << " shards, " << covered << " seeds, env hash " << std::hex << first.envHash << std::dec
+              << ", version " << first.gameVersion << std::endl;
+    for (size_t i = 0; i < names.size(); i++) {
+        std::cout << "  " << names[i] << ": " << totals[i];
+        if (totals[i]) std::cout << " (1 in " << covered / totals[i] << ")";
+        std::cout << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (o.command == "build") return build(o);
+    if (o.command == "query") return query(o);
+    if (o.command == "info") return info(o);
+    usage(argv[0]);
+    return 1;
+}
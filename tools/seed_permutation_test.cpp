@@ -0,0 +1,79 @@
+// Tests for SeedPermutation: it is a bijection on small domains of every
+// shape, indexOf() inverts at() on the full seed space, the order depends
+// on the key, and a prefix of it is spread uniformly over the space.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -I. -o dist/seed_permutation_test tools/seed_permutation_test.cpp
+// Usage: dist/seed_permutation_test
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "seed_permutation.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+// Every position maps to a distinct number inside the domain
+static void testBijection() {
+    const uint64_t domains[] = {1, 2, 3, 7, 1000, 4096, 4097, 34 * 34 * 34 * 34};
+    for (uint64_t domain : domains) {
+        for (uint64_t key : {0ull, 1ull, 0xDEADBEEFull}) {
+            SeedPermutation perm(key, domain);
+            std::vector<bool> seen(domain, false);
+            bool ok = true;
+            for (uint64_t i = 0; i < domain && ok; i++) {
+                const uint64_t x = perm.at(i);
+                ok = x < domain && !seen[x] && perm.indexOf(x) == i;
+                if (ok) seen[x] = true;
+            }
+            expect(ok, "bijection on domain " + std::to_string(domain) + " key " + std::to_string(key));
+        }
+    }
+}
+
+static void testFullSpace() {
+    SeedPermutation perm(1);
+    expect(perm.size() == SEED_COUNT, "default domain is the seed space");
+    bool ok = true;
+    for (uint64_t i = 0; i < 200000 && ok; i++) {
+        const uint64_t index = i * 8929123ull % SEED_COUNT;
+        const uint64_t x = perm.at(index);
+        ok = x < SEED_COUNT && perm.indexOf(x) == index;
+    }
+    expect(ok, "indexOf inverts at on the seed space");
+    expect(perm.at(SEED_COUNT - 1) < SEED_COUNT, "last position stays in range");
+
+    SeedPermutation same(1), other(2);
+    int differ = 0;
+    for (uint64_t i = 0; i < 100; i++) {
+        expect(same.at(i) == perm.at(i), "same key gives the same order");
+        if (other.at(i) != perm.at(i)) differ++;
+    }
+    expect(differ > 90, "another key gives another order");
+}
+
+// The first 2^20 positions fall evenly into 64 equal slices of the space
+static void testUniformPrefix() {
+    SeedPermutation perm(7);
+    const int buckets = 64;
+    const uint64_t n = 1 << 20;
+    std::vector<uint64_t> counts(buckets, 0);
+    for (uint64_t i = 0; i < n; i++) counts[perm.at(i) / (SEED_COUNT / buckets + 1)]++;
+    double chi2 = 0;
+    const double expected = static_cast<double>(n) / buckets;
+    for (uint64_t c : counts) chi2 += (c - expected) * (c - expected) / expected;
+    // 63 degrees of freedom: the 99.99th percentile is about 120
+    expect(chi2 < 120, "prefix is uniform (chi2 " + std::to_string(chi2) + ")");
+}
+
+int main() {
+    testBijection();
+    testFullSpace();
+    testUniformPrefix();
+    std::cout << "seed permutation: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+// Tests for the shop lookahead: stream contents against nextShopItem_enum,
+// Overstock slot counts, slot addressing, find() against a brute-force scan,
+// lazy drawing, and agreement with the run engine's shops.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/shop_stream_test tools/shop_stream_test.cpp env.cpp
+// Usage: dist/shop_stream_test [seed_count]
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "shop_stream.hpp"
+#include "run_engine.hpp"
+#include "seed_util.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+static bool same(const ShopStream::Item& a, const ShopStream::Item& b) {
+    if (a.type != b.type || a.item.raw_value != b.item.raw_value) return false;
+    return a.type != ShopStream::Item::Type::JOKER || a.joker_data.edition == b.joker_data.edition;
+}
+
+static Instance::Instance fresh(const std::string& seed) {
+    const EnvConfig e;
+    Instance::Instance inst(seed);
+    inst.initLocks(1, e.freshProfile, e.freshRun);
+    return inst;
+}
+
+// Each ante's stream is its own: reading ante 2 first, or drawing vouchers
+// in between, leaves every card where nextShopItem_enum puts it
+static void testStreams(uint64_t seeds) {
+    const EnvConfig env;
+    uint64_t overstocked = 0;
+    for (uint64_t n = 0; n < seeds; n++) {
+        const std::string seed = numberToSeed(n * 31337 + 11);
+        ShopStream::Lookahead shop(seed, env);
+        Instance::Instance direct = fresh(seed);
+        for (int a : {2, 1, 3}) {
+            for (int i = 0; i < 12; i++) {
+                expect(same(shop.at(a, i), direct.nextShopItem_enum(a)), seed + ": card " + std::to_string(i) + " of ante " + std::to_string(a));
+            }
+        }
+        expect(shop.drawn(1) == 12 && shop.drawn(4) == 0, seed + ": only the cards read are drawn");
+
+        // Slots grow with each Overstock bought, and not without vouchers
+        ShopStream::Options none;
+        none.vouchers = ShopStream::Vouchers::NONE;
+        ShopStream::Lookahead plain(seed, env, none);
+        int slots = ShopStream::BASE_SLOTS;
+        for (int a = 1; a <= ShopStream::MAX_ANTE; a++) {
+            slots += ShopStream::slotsAdded(shop.voucher(a));
+            expect(shop.slots(a) == slots, seed + ": Overstock slots in ante " + std::to_string(a));
+            expect(plain.slots(a) == ShopStream::BASE_SLOTS, seed + ": no vouchers, two slots");
+        }
+        overstocked += shop.slots(ShopStream::MAX_ANTE) > ShopStream::BASE_SLOTS;
+    }
+    expect(overstocked > 0, "some runs buy Overstock");
+}
+
+static void testAddressing() {
+    ShopStream::Lookahead shop("AAAAAAAA", EnvConfig());
+    const int s = shop.slots(1);
+    ShopStream::Slot slot;
+    slot.ante = 1;
+    slot.visit = 1;
+    slot.reroll = 2;
+    slot.index = 1;
+    expect(shop.position(slot) == 3 * s + 1, "visit 1 after 2 rerolls");
+    expect(shop.position(slot, 4) == 7 * s + 1, "rerolls in earlier visits push the visit back");
+    expect(same(shop.at(slot, 4), shop.at(1, 7 * s + 1)), "at(slot) reads the same card");
+}
+
+// Fewest rerolls an ante needs to show `joker`, or -1 past the budget
+static int bruteRerolls(const std::string& seed, int ante, Items::Joker joker, int visits, int maxRerolls, int& index) {
+    ShopStream::Lookahead shop(seed, EnvConfig());
+    const int s = shop.slots(ante);
+    Instance::Instance direct = fresh(seed);
+    for (int shopNo = 0; shopNo < visits + maxRerolls; shopNo++) {
+        for (int i = 0; i < s; i++) {
+            const ShopStream::Item item = direct.nextShopItem_enum(ante);
+            if (item.type == ShopStream::Item::Type::JOKER && item.item.joker == joker) {
+                index = i;
+                return shopNo < visits ? 0 : shopNo - visits + 1;
+            }
+        }
+    }
+    return -1;
+}
+
+static void testFind(uint64_t seeds) {
+    const EnvConfig env;
+    uint64_t hits = 0;
+    for (uint64_t n = 0; n < seeds; n++) {
+        const std::string seed = numberToSeed(n * 7 + 5);
+        for (Items::Joker joker : {Items::Joker::BLUEPRINT, Items::Joker::JOKER, Items::Joker::FOUR_FINGERS}) {
+            for (int budget : {0, 4}) {
+                ShopStream::Lookahead shop(seed, env);
+                ShopStream::Hit hit;
+                const bool found = shop.findJoker(joker, 1, 2, budget, &hit);
+                int index = 0, wantAnte = 0, wantRerolls = -1;
+                for (int a = 1; a <= 2 && wantRerolls < 0; a++) {
+                    wantRerolls = bruteRerolls(seed, a, joker, 3, budget, index);
+                    wantAnte = a;
+                }
+                expect(found == (wantRerolls >= 0), seed + ": find agrees with a brute-force scan");
+                if (!found) {
+                    const int reach = (3 + budget) * shop.slots(1);
+                    expect(shop.drawn(1) == reach, seed + ": a miss reads the whole budget");
+                    continue;
+                }
+                hits++;
+                expect(hit.slot.ante == wantAnte && hit.rerolls == wantRerolls && hit.slot.index == index,
+                       seed + ": hit slot and rerolls");
+                expect(hit.slot.reroll == hit.rerolls && (hit.rerolls == 0 || hit.slot.visit == 2), seed + ": rerolls go in the last visit");
+                expect(same(shop.at(hit.slot), hit.item), seed + ": the hit's slot holds its card");
+                const int pos = shop.position(hit.slot);
+                expect(shop.drawn(hit.slot.ante) == pos + 1, seed + ": nothing is drawn past the hit");
+                if (hit.slot.ante == 2) expect(shop.drawn(1) == (3 + budget) * shop.slots(1), seed + ": ante 1 read to its budget");
+                else expect(shop.drawn(2) == 0, seed + ": ante 2 untouched after an ante-1 hit");
+            }
+        }
+    }
+    expect(hits > 0, "some jokers are found");
+}
+
+// The run engine's shops show the same cards, with the same Overstock slots
+struct ShopRecorder : RunEngine::Policy {
+    std::vector<std::vector<ShopStream::Item>> antes;
+    void ante(RunEngine::State&, const RunEngine::Ante&) { antes.emplace_back(); }
+    bool buy(RunEngine::State&, const RunEngine::Card& item) {
+        antes.back().push_back(item);
+        return false;
+    }
+};
+
+static void testRunEngine(uint64_t seeds) {
+    const EnvConfig env;
+    for (uint64_t n = 0; n < seeds; n++) {
+        const std::string seed = numberToSeed(n * 977 + 1);
+        ShopRecorder recorder;
+        RunEngine::Engine<ShopRecorder> engine(recorder);
+        engine.run(seed, env);
+        ShopStream::Lookahead shop(seed, env);
+        for (int a = 1; a <= 8; a++) {
+            const std::vector<ShopStream::Item>& got = recorder.antes[a - 1];
+            expect(static_cast<int>(got.size()) == 3 * shop.slots(a), seed + ": engine shows three shops of the ante's slots");
+            bool ok = true;
+            for (size_t i = 0; i < got.size(); i++) ok = ok && same(got[i], shop.at(a, static_cast<int>(i)));
+            expect(ok, seed + ": engine shop cards of ante " + std::to_string(a));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint64_t seeds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 300;
+    testStreams(seeds);
+    testAddressing();
+    testFind(seeds);
+    testRunEngine(seeds);
+    std::cout << "shop_stream: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
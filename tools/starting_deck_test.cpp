@@ -0,0 +1,134 @@
+// Tests for the starting-deck generator: Erratic decks against Instance's
+// "erratic" stream and Items::CARDS, the fixed decks and histogram
+// consistency. Ends with decks per second.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -ffp-contract=off -I. -o dist/starting_deck_test tools/starting_deck_test.cpp env.cpp
+// Usage: dist/starting_deck_test [seed_count]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "instance.hpp"
+#include "starting_deck.hpp"
+#include "seed_util.hpp"
+
+using StartingDeck::Deck;
+using StartingDeck::Rank;
+using StartingDeck::Suit;
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+static bool sameDeck(const Deck& a, const Deck& b) {
+    return std::memcmp(&a, &b, sizeof(Deck)) == 0;
+}
+
+// Histograms and size agree with the per-card counts
+static bool consistent(const Deck& d) {
+    int suits[StartingDeck::SUITS] = {};
+    int ranks[StartingDeck::RANKS] = {};
+    int size = 0;
+    for (int s = 0; s < StartingDeck::SUITS; s++) {
+        for (int r = 0; r < StartingDeck::RANKS; r++) {
+            const int n = d.count(static_cast<Suit>(s), static_cast<Rank>(r));
+            suits[s] += n;
+            ranks[r] += n;
+            size += n;
+        }
+    }
+    for (int s = 0; s < StartingDeck::SUITS; s++) if (suits[s] != d.suits[s]) return false;
+    for (int r = 0; r < StartingDeck::RANKS; r++) if (ranks[r] != d.ranks[r]) return false;
+    return size == d.size;
+}
+
+// The deck as the game builds it: 52 picks of Items::CARDS from the "erratic" stream
+static Deck erraticReference(const std::string& seed) {
+    static const char RANK_CHARS[] = "23456789TJQKA";
+    static const char SUIT_CHARS[] = "CDHS";
+    Instance::Instance inst(seed);
+    Deck d;
+    d.clear();
+    for (int i = 0; i < StartingDeck::CARDS; i++) {
+        const std::string& card = Items::CARDS[lua_randint_once(inst.node("erratic"), 0, Items::CARDS.size() - 1)];
+        const int s = static_cast<int>(std::strchr(SUIT_CHARS, card[0]) - SUIT_CHARS);
+        const int r = static_cast<int>(std::strchr(RANK_CHARS, card[2]) - RANK_CHARS);
+        d.add(static_cast<Suit>(s), static_cast<Rank>(r));
+    }
+    return d;
+}
+
+static void testFixedDecks() {
+    const Deck red = StartingDeck::Generator("Red Deck").generate("AAAAAAAA");
+    expect(red.size == 52 && red.distinct() == 52 && red.faces() == 12 && consistent(red), "standard deck");
+    expect(sameDeck(red, StartingDeck::Generator("Ghost Deck").generate("BBBBBBBB")), "other decks start standard");
+
+    const Deck abandoned = StartingDeck::Generator("Abandoned Deck").generate("AAAAAAAA");
+    expect(abandoned.size == 40 && abandoned.faces() == 0 && abandoned.count(Rank::ACE) == 4, "Abandoned Deck has no faces");
+
+    const Deck checkered = StartingDeck::Generator("Checkered Deck").generate("AAAAAAAA");
+    expect(checkered.count(Suit::SPADES) == 26 && checkered.count(Suit::HEARTS) == 26 &&
+           checkered.count(Suit::CLUBS) == 0 && checkered.count(Suit::SPADES, Rank::KING) == 2, "Checkered Deck is Spades and Hearts");
+    expect(!StartingDeck::Generator("Checkered Deck").seeded(), "only Erratic depends on the seed");
+}
+
+static void testErratic(uint64_t seeds) {
+    const StartingDeck::Generator erratic("Erratic Deck");
+    uint64_t faces = 0, lopsided = 0;
+    for (uint64_t n = 0; n < seeds; n++) {
+        const std::string seed = numberToSeed(n * 104729 + 3);
+        const Deck d = erratic.generate(seed);
+        expect(sameDeck(d, erraticReference(seed)), seed + ": Erratic deck matches the erratic stream");
+        expect(d.size == 52 && consistent(d), seed + ": histograms");
+        faces += d.faces();
+        lopsided += d.count(d.topSuit()) >= 18;
+    }
+    // 52 uniform picks: 12 faces on average, and a suit of 18+ is common but not the rule
+    const double meanFaces = static_cast<double>(faces) / seeds;
+    expect(meanFaces > 11.0 && meanFaces < 13.0, "mean face count near 12");
+    expect(lopsided > 0 && lopsided < seeds / 2, "some decks lean on one suit");
+
+    // Seeds of other lengths hash the same way as Instance does
+    for (const char* seed : {"A", "1234", "ZZZZZZZZZ"}) {
+        expect(sameDeck(erratic.generate(seed), erraticReference(seed)), std::string(seed) + ": seed length");
+    }
+}
+
+static volatile uint64_t sink;
+
+// `fn(count)` builds `count` decks and returns a checksum so the work is kept
+template<typename Fn>
+static double decksPerSecond(uint64_t count, Fn fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    sink = fn(count);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return count / secs;
+}
+
+int main(int argc, char** argv) {
+    const uint64_t seeds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    testFixedDecks();
+    testErratic(seeds);
+
+    const StartingDeck::Generator erratic("Erratic Deck");
+    const uint64_t count = seeds * 100;
+    std::vector<std::string> list;
+    for (uint64_t n = 0; n < count; n++) list.push_back(numberToSeed(n));
+    std::cout << "Erratic decks: " << static_cast<uint64_t>(decksPerSecond(count, [&](uint64_t c) {
+        uint64_t faces = 0;
+        Deck d;
+        for (uint64_t i = 0; i < c; i++) {
+            erratic.generate(list[i], d);
+            faces += d.faces();
+        }
+        return faces;
+    })) << " decks/s" << std::endl;
+
+    std::cout << "starting_deck: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+// Tests for the --top-k lists: bounded keep order, ties, duplicates,
+// per-thread merging and the file round trip used by --resume.
+// Build from the repo root:
+//   g++ -std=c++14 -O2 -I. -o dist/top_k_test tools/top_k_test.cpp -lpthread
+// Usage: dist/top_k_test
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "top_k.hpp"
+
+static int failures = 0;
+
+static void expect(bool ok, const std::string& what) {
+    if (!ok && failures++ < 10) std::cerr << "FAIL: " << what << std::endl;
+}
+
+static void testHeap() {
+    TopK::Heap h(3);
+    h.push({1.0, 10, 1, 0});
+    h.push({5.0, 11, 2, 0});
+    h.push({3.0, 12, 1, 0});
+    h.push({0.5, 13, 1, 0});
+    h.push({3.0, 9, 1, 0});   // Ties 12 on score; the lower seed number wins
+    h.push({3.0, 9, 1, 0});   // Same seed again
+    std::vector<TopK::Entry> v(h.items().begin(), h.items().end());
+    expect(v.size() == 3, "heap is bounded");
+    expect(v.size() == 3 && v[0].number == 11 && v[1].number == 9 && v[2].number == 12, "best first, ties by seed number");
+    expect(h.full() && h.worst() == 3.0, "worst kept score");
+}
+
+// Threads merging their own heaps end with the same list as one thread
+static void testCollector() {
+    const size_t k = 50;
+    auto scoreOf = [](uint64_t n) { return static_cast<double>((n * 2654435761u) % 97); };
+    TopK::Collector single(k);
+    TopK::Heap one(k);
+    for (uint64_t n = 0; n < 20000; n++) one.push({scoreOf(n), n, 1, n});
+    single.merge(one);
+
+    TopK::Collector shared(k);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            TopK::Heap local(k);
+            double cutoff = shared.cutoff();
+            for (uint64_t n = t; n < 20000; n += 4) {
+                if (scoreOf(n) >= cutoff) local.push({scoreOf(n), n, 1, n});
+                if (n % 1000 < 4) cutoff = shared.merge(local);
+            }
+            shared.merge(local);
+        });
+    }
+    for (auto& th : threads) th.join();
+    const auto a = single.snapshot(), b = shared.snapshot();
+    bool same = a.size() == k && a.size() == b.size();
+    for (size_t i = 0; same && i < a.size(); i++) same = a[i].number == b[i].number && a[i].score == b[i].score;
+    expect(same, "merged per-thread heaps match a single heap");
+}
+
+static void testSaveLoad() {
+    const std::string path = "top_k_test.csv";
+    std::vector<TopK::Entry> in = {{0.1 + 0.2, 123456, 2, 77}, {-1e-9, 0, 1, 0}, {1e300, 1785793904895ull, 3, ~0ull}};
+    const bool saved = TopK::save(path, in, [](int level) { return level == 2 ? std::string("a \"quoted\", name") : std::string(); },
+                                  [](uint64_t p) { return p ? std::string("x, y") : std::string(); });
+    std::vector<TopK::Entry> out;
+    expect(saved && TopK::load(path, out), "save and load");
+    bool same = out.size() == in.size();
+    for (size_t i = 0; same && i < in.size(); i++) {
+        same = out[i].score == in[i].score && out[i].number == in[i].number && out[i].level == in[i].level &&
+               out[i].payload == in[i].payload;
+    }
+    expect(same, "entries round-trip exactly");
+    std::remove(path.c_str());
+    expect(!TopK::load(path, out), "missing file is not loaded");
+}
+
+int main() {
+    testHeap();
+    testCollector();
+    testSaveLoad();
+    std::cout << "top-k: " << (failures ? "FAILED" : "ok") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "atomic_file.hpp"
+#include "seed_util.hpp"
+
+// --top-k: keep the K best-scoring seeds instead of logging every hit.
+// Each worker thread fills its own bounded set without locking and merges it
+// into the shared Collector when it finishes a chunk. Seeds below the shared
+// cutoff are dropped before they reach the thread's set. Output is the
+// Collector's contents, rewritten at each checkpoint, so I/O scales with K
+// rather than with the number of hits.
+//
+// Order: higher score first; equal scores keep the lower seed number. The
+// kept set is therefore the same whatever the thread count and timing. A
+// seed seen twice (a chunk redone on resume) compares equal to itself and
+// is stored once.
+namespace TopK {
+
+    struct Entry {
+        double score;
+        uint64_t number;
+        uint16_t level;
+        uint64_t payload;
+    };
+
+    struct Better {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.score != b.score ? a.score > b.score : a.number < b.number;
+        }
+    };
+
+    // The best `capacity` entries pushed so far
+    class Heap {
+    public:
+        explicit Heap(size_t k) : capacity(k) {}
+
+        void push(const Entry& e) {
+            if (entries.size() >= capacity && !Better()(e, *entries.rbegin())) return;
+            entries.insert(e);
+            if (entries.size() > capacity) entries.erase(std::prev(entries.end()));
+        }
+
+        bool full() const { return entries.size() >= capacity; }
+        // Score of the worst kept entry; only meaningful when full()
+        double worst() const { return entries.rbegin()->score; }
+        size_t size() const { return entries.size(); }
+        void clear() { entries.clear(); }
+        const std::set<Entry, Better>& items() const { return entries; }
+
+    private:
+        size_t capacity;
+        std::set<Entry, Better> entries;
+    };
+
+    // Shared top-K of a run, fed by the worker threads' Heaps
+    class Collector {
+    public:
+        explicit Collector(size_t k) : heap(k) {}
+
+        // Moves a thread's entries in and clears them. Returns the score a
+        // new seed needs to be worth keeping (lowest double while not full).
+        double merge(Heap& local) {
+            std::lock_guard<std::mutex> lk(mutex);
+            for (const Entry& e : local.items()) heap.push(e);
+            local.clear();
+            return cutoff();
+        }
+
+        void add(const Entry& e) {
+            std::lock_guard<std::mutex> lk(mutex);
+            heap.push(e);
+        }
+
+        double cutoff() const { return heap.full() ? heap.worst() : -std::numeric_limits<double>::infinity(); }
+
+        // Best first
+        std::vector<Entry> snapshot() const {
+            std::lock_guard<std::mutex> lk(mutex);
+            return std::vector<Entry>(heap.items().begin(), heap.items().end());
+        }
+
+    private:
+        mutable std::mutex mutex;
+        Heap heap;
+    };
+
+    inline std::string csvField(const std::string& s) {
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    // Writes rank,seed,score,level,name,payload,detail rows to `path`
+    // atomically (atomic_file.hpp), so readers never see a partial list. Scores use 17
+    // significant digits so load() restores them exactly.
+    inline bool save(const std::string& path, const std::vector<Entry>& entries,
+                     const std::function<std::string(int)>& levelName,
+                     const std::function<std::string(uint64_t)>& describe) {
+        std::ostringstream out;
+        out << "rank,seed,score,level,name,payload,detail\n";
+        char score[32];
+        for (size_t i = 0; i < entries.size(); i++) {
+            const Entry& e = entries[i];
+            std::snprintf(score, sizeof(score), "%.17g", e.score);
+            out << i + 1 << "," << numberToSeed(e.number) << "," << score << "," << e.level << ","
+                << csvField(levelName(e.level)) << "," << e.payload << "," << csvField(describe(e.payload)) << "\n";
+        }
+        std::string error;
+        return AtomicFile::write(path, out.str(), error);
+    }
+
+    // Splits one CSV row, undoing csvField()'s quoting
+    inline std::vector<std::string> splitRow(const std::string& line) {
+        std::vector<std::string> fields(1);
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); i++) {
+            const char c = line[i];
+            if (quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = !quoted;
+            } else if (c == ',' && !quoted) {
+                fields.emplace_back();
+            } else {
+                fields.back() += c;
+            }
+        }
+        return fields;
+    }
+
+    // Reads the entries of a file written by save(); false if it is missing or malformed
+    inline bool load(const std::string& path, std::vector<Entry>& entries) {
+        std::ifstream in(path);
+        std::string line;
+        if (!in.is_open() || !std::getline(in, line) || line.compare(0, 5, "rank,") != 0) return false;
+        entries.clear();
+        while (std::getline(in, line)) {
+            const std::vector<std::string> f = splitRow(line);
+            if (f.size() != 7 || f[1].size() != 8) return false;
+            Entry e;
+            e.number = seedToNumber(f[1]);
+            e.score = std::strtod(f[2].c_str(), nullptr);
+            e.level = static_cast<uint16_t>(std::strtoul(f[3].c_str(), nullptr, 10));
+            e.payload = std::strtoull(f[5].c_str(), nullptr, 10);
+            entries.push_back(e);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads for --serve and libbalatro. Interactive tasks are
+// taken before background ones, so a long background job (a --serve scan)
+// delays a request by at most one task per thread.
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned int n) {
+        for (unsigned int i = 0; i < n; i++) threads.emplace_back(&WorkerPool::run, this);
+    }
+
+    // Runs what is queued, then joins
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    void submit(std::function<void()> task, bool urgent) {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            (urgent ? interactive : background).push_back(std::move(task));
+        }
+        ready.notify_one();
+    }
+
+    // Runs `tasks` as interactive work and returns once all have finished.
+    // If any task throws, the first exception is rethrown here after the
+    // others have finished.
+    void runAll(const std::vector<std::function<void()>>& tasks) {
+        std::mutex doneMutex;
+        std::condition_variable done;
+        size_t left = tasks.size();
+        std::exception_ptr error;
+        for (const auto& task : tasks) {
+            submit([&, task]() {
+                std::exception_ptr failure;
+                try {
+                    task();
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lk(doneMutex);
+                if (failure && !error) error = failure;
+                if (--left == 0) done.notify_all();
+            }, true);
+        }
+        std::unique_lock<std::mutex> lk(doneMutex);
+        done.wait(lk, [&] { return left == 0; });
+        if (error) std::rethrow_exception(error);
+    }
+
+    unsigned int size() const { return static_cast<unsigned int>(threads.size()); }
+
+private:
+    void run() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lk(mutex);
+                ready.wait(lk, [&] { return stopping || !interactive.empty() || !background.empty(); });
+                std::deque<std::function<void()>>& from = !interactive.empty() ? interactive : background;
+                if (from.empty()) return;
+                task = std::move(from.front());
+                from.pop_front();
+            }
+            try {
+                task();
+            } catch (...) {
+                // A failing task must not take the thread down
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::function<void()>> interactive;
+    std::deque<std::function<void()>> background;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+};